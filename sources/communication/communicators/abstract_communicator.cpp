@@ -6,6 +6,7 @@
 
 // Internal
 #include "abstract_link.h"
+#include "timing_wheel.h"
 
 namespace
 {
@@ -15,9 +16,11 @@ namespace
 using namespace comm;
 
 AbstractCommunicator::AbstractCommunicator(QObject* parent):
-    QObject(parent)
+    QObject(parent),
+    m_timingWheel(new utils::TimingWheel(10, this))
 {
     qRegisterMetaType<Protocol>("Protocol");
+    qRegisterMetaType<dto::LinkTraffic>("dto::LinkTraffic");
 
     m_statisticsTimer = this->startTimer(::second);
 }
@@ -27,6 +30,11 @@ QList<AbstractLink*> AbstractCommunicator::links() const
     return m_links;
 }
 
+utils::TimingWheel* AbstractCommunicator::timingWheel() const
+{
+    return m_timingWheel;
+}
+
 void AbstractCommunicator::sendDataAllLinks(const QByteArray& data)
 {
     for (AbstractLink* link: m_links)
@@ -59,8 +67,15 @@ void AbstractCommunicator::timerEvent(QTimerEvent* event)
 
     for (AbstractLink* link: m_links)
     {
+        this->updateLinkStatistics(link);
+
         emit linkStatisticsChanged(link,
                                    link->takeBytesReceived(),
                                    link->takeBytesSent());
     }
 }
+
+void AbstractCommunicator::updateLinkStatistics(AbstractLink* link)
+{
+    Q_UNUSED(link)
+}
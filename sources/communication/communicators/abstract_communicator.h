@@ -3,6 +3,14 @@
 
 #include <QObject>
 
+// Internal
+#include "link_traffic.h"
+
+namespace utils
+{
+    class TimingWheel;
+}
+
 namespace comm
 {
     class AbstractLink;
@@ -22,6 +30,8 @@ namespace comm
         AbstractCommunicator(QObject* parent);
 
         QList<AbstractLink*> links() const;
+        // Shared by handlers for retries and timeouts, lives in communicator's thread
+        utils::TimingWheel* timingWheel() const;
 
         virtual bool isAddLinkEnabled() = 0;
 
@@ -40,15 +50,20 @@ namespace comm
         // TODO: to MavLinkCommunicator
         void mavLinkStatisticsChanged(AbstractLink* link, int packetsReceived, int packetsDrops);
         void mavLinkProtocolChanged(AbstractLink* link, Protocol protocol);
+        void linkLatencyChanged(AbstractLink* link, int roundTrip, int roundTripP95);
+        void linkTrafficChanged(AbstractLink* link, const dto::LinkTraffic& traffic);
 
     protected slots:
         virtual void onDataReceived(const QByteArray& data) = 0;
 
     protected:
         void timerEvent(QTimerEvent* event) override;
+        // Called every second for each link before bytes statistics are emitted
+        virtual void updateLinkStatistics(AbstractLink* link);
 
     private:
         QList<AbstractLink*> m_links;
+        utils::TimingWheel* const m_timingWheel;
         int m_statisticsTimer = 0;
 
         Q_ENUM(Protocol)
@@ -73,7 +73,7 @@ public:
 };
 
 CommandHandler::CommandHandler(MavLinkCommunicator* communicator):
-    AbstractCommandHandler(communicator),
+    AbstractCommandHandler(communicator->timingWheel(), communicator),
     AbstractMavLinkHandler(communicator),
     d(new Impl())
 {
@@ -224,58 +224,77 @@ void CommandHandler::sendCommand(int vehicleId, const dto::CommandPtr& command,
     }
 }
 
-void CommandHandler::sendCommandLong(quint8 mavId, quint16 commandId,
-                                     const QVariantList& args, int attempt)
+void CommandHandler::sendGroupCommand(const QMap<int, dto::CommandPtr>& commands, int attempt)
 {
-    mavlink_message_t message;
-    mavlink_command_long_t mavCommand;
+    if (commands.isEmpty()) return;
 
-    mavCommand.target_system = mavId;
-    mavCommand.target_component = 0;
-    mavCommand.confirmation = attempt;
-    mavCommand.command = commandId;
+    const dto::CommandPtr& command = commands.first();
+    bool isCommandLong = ::mavCommandLongMap.values().contains(command->type());
+    if (!isCommandLong && command->type() != dto::Command::SetMode)
+    {
+        return AbstractCommandHandler::sendGroupCommand(commands, attempt);
+    }
 
-    if (args.count() > 0) mavCommand.param1 = args.at(0).toFloat();
-    if (args.count() > 1) mavCommand.param2 = args.at(1).toFloat();
-    if (args.count() > 2) mavCommand.param3 = args.at(2).toFloat();
-    if (args.count() > 3) mavCommand.param4 = args.at(3).toFloat();
-    if (args.count() > 4) mavCommand.param5 = args.at(4).toFloat();
-    if (args.count() > 5) mavCommand.param6 = args.at(5).toFloat();
-    if (args.count() > 6) mavCommand.param7 = args.at(6).toFloat();
+    QMap<AbstractLink*, QList<quint8> > linkTargets;
+    for (int vehicleId: commands.keys())
+    {
+        dto::VehiclePtr vehicle = d->vehicleService->vehicle(vehicleId);
+        if (vehicle.isNull()) continue;
+
+        AbstractLink* link = m_communicator->mavSystemLink(vehicle->mavId());
+        if (link) linkTargets[link].append(vehicle->mavId());
+    }
+
+    qDebug() << "MAV group:" << commands.keys() << command->type() << attempt;
+
+    for (auto it = linkTargets.constBegin(); it != linkTargets.constEnd(); ++it)
+    {
+        QList<mavlink_message_t> messages;
+        mavlink_message_t message;
 
+        if (isCommandLong)
+        {
+            quint16 commandId = ::mavCommandLongMap.key(command->type());
+
+            // Always targeted: link may carry systems outside of the group
+            for (quint8 mavId: it.value())
+            {
+                this->encodeCommandLong(mavId, commandId, command->arguments(), attempt,
+                                        it.key(), message);
+                messages.append(message);
+            }
+        }
+        else
+        {
+            domain::vehicle::Mode mode = command->arguments().value(0).value<domain::vehicle::Mode>();
+            for (quint8 mavId: it.value())
+            {
+                if (this->encodeSetMode(mavId, mode, it.key(), message)) messages.append(message);
+            }
+        }
+
+        m_communicator->sendMessages(messages, it.key());
+    }
+}
+
+void CommandHandler::sendCommandLong(quint8 mavId, quint16 commandId,
+                                     const QVariantList& args, int attempt)
+{
     AbstractLink* link = m_communicator->mavSystemLink(mavId);
     if (!link) return;
 
-    mavlink_msg_command_long_encode_chan(m_communicator->systemId(),
-                                         m_communicator->componentId(),
-                                         m_communicator->linkChannel(link),
-                                         &message, &mavCommand);
+    mavlink_message_t message;
+    this->encodeCommandLong(mavId, commandId, args, attempt, link, message);
     m_communicator->sendMessage(message, link);
 }
 
 void CommandHandler::sendSetMode(quint8 mavId, domain::vehicle::Mode mode)
 {
-    if (d->modeHelper.isNull()) return;
-
-    mavlink_message_t message;
-    mavlink_set_mode_t setMode;
-
-    setMode.target_system = mavId;
-    setMode.base_mode = d->modes[mavId].baseMode;
-
-    d->modes[mavId].requestedCustomMode = d->modeHelper->modeToCustomMode(mode);
-    if (d->modes[mavId].requestedCustomMode < 0) return;
-
-    setMode.custom_mode = d->modes[mavId].requestedCustomMode;
-
     AbstractLink* link = m_communicator->mavSystemLink(mavId);
     if (!link) return;
 
-    mavlink_msg_set_mode_encode_chan(m_communicator->systemId(),
-                                     m_communicator->componentId(),
-                                     m_communicator->linkChannel(link),
-                                     &message, &setMode);
-    m_communicator->sendMessage(message, link);
+    mavlink_message_t message;
+    if (this->encodeSetMode(mavId, mode, link, message)) m_communicator->sendMessage(message, link);
 }
 
 void CommandHandler::sendCurrentItem(quint8 mavId, quint16 seq)
@@ -410,3 +429,49 @@ void CommandHandler::sendManualControl(quint8 mavId, float pitch, float roll,
                      dto::Command::ManualImpacts, dto::Command::Completed);
 }
 
+
+void CommandHandler::encodeCommandLong(quint8 mavId, quint16 commandId, const QVariantList& args,
+                                       int attempt, AbstractLink* link, mavlink_message_t& message)
+{
+    mavlink_command_long_t mavCommand = {};
+
+    mavCommand.target_system = mavId;
+    mavCommand.target_component = 0;
+    mavCommand.confirmation = attempt;
+    mavCommand.command = commandId;
+
+    if (args.count() > 0) mavCommand.param1 = args.at(0).toFloat();
+    if (args.count() > 1) mavCommand.param2 = args.at(1).toFloat();
+    if (args.count() > 2) mavCommand.param3 = args.at(2).toFloat();
+    if (args.count() > 3) mavCommand.param4 = args.at(3).toFloat();
+    if (args.count() > 4) mavCommand.param5 = args.at(4).toFloat();
+    if (args.count() > 5) mavCommand.param6 = args.at(5).toFloat();
+    if (args.count() > 6) mavCommand.param7 = args.at(6).toFloat();
+
+    mavlink_msg_command_long_encode_chan(m_communicator->systemId(),
+                                         m_communicator->componentId(),
+                                         m_communicator->linkChannel(link),
+                                         &message, &mavCommand);
+}
+
+bool CommandHandler::encodeSetMode(quint8 mavId, domain::vehicle::Mode mode,
+                                   AbstractLink* link, mavlink_message_t& message)
+{
+    if (d->modeHelper.isNull()) return false;
+
+    mavlink_set_mode_t setMode;
+
+    setMode.target_system = mavId;
+    setMode.base_mode = d->modes[mavId].baseMode;
+
+    d->modes[mavId].requestedCustomMode = d->modeHelper->modeToCustomMode(mode);
+    if (d->modes[mavId].requestedCustomMode < 0) return false;
+
+    setMode.custom_mode = d->modes[mavId].requestedCustomMode;
+
+    mavlink_msg_set_mode_encode_chan(m_communicator->systemId(),
+                                     m_communicator->componentId(),
+                                     m_communicator->linkChannel(link),
+                                     &message, &setMode);
+    return true;
+}
@@ -9,6 +9,8 @@
 
 namespace comm
 {
+    class AbstractLink;
+
     class CommandHandler: // Rename to MavLinkCommandHandler
             public domain::AbstractCommandHandler,
             public AbstractMavLinkHandler
@@ -27,6 +29,7 @@ namespace comm
 
     protected:
         void sendCommand(int vehicleId, const dto::CommandPtr& command, int attempt = 0) override;
+        void sendGroupCommand(const QMap<int, dto::CommandPtr>& commands, int attempt) override;
 
     private slots:
         // TODO: move command to processors/handlers/senders
@@ -39,6 +42,11 @@ namespace comm
         void sendManualControl(quint8 mavId, float pitch, float roll, float yaw, float thrust);
 
     private:
+        void encodeCommandLong(quint8 mavId, quint16 commandId, const QVariantList& args,
+                               int attempt, AbstractLink* link, mavlink_message_t& message);
+        bool encodeSetMode(quint8 mavId, domain::vehicle::Mode mode,
+                           AbstractLink* link, mavlink_message_t& message);
+
         class Impl;
         QScopedPointer<Impl> const d;
     };
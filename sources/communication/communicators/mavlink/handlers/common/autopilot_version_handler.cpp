@@ -5,15 +5,16 @@
 
 // Qt
 #include <QMap>
-#include <QTimerEvent>
 #include <QDebug>
 
 // Internal
 #include "mavlink_communicator.h"
+#include "timing_wheel.h"
 
 namespace
 {
     const int interval = 2000;
+    const int maxInterval = 16000;
 }
 
 using namespace comm;
@@ -47,6 +48,10 @@ void AutopilotVersionHandler::processMessage(const mavlink_message_t& message)
         if (ack.result == MAV_RESULT_DENIED || ack.result == MAV_RESULT_UNSUPPORTED)
         {
              d->obtainedMavs[message.sysid] = false;
+             if (d->mavTimers.contains(message.sysid))
+             {
+                 m_communicator->timingWheel()->stop(d->mavTimers.take(message.sysid));
+             }
         }
     }
     else if (message.msgid == MAVLINK_MSG_ID_AUTOPILOT_VERSION)
@@ -54,7 +59,7 @@ void AutopilotVersionHandler::processMessage(const mavlink_message_t& message)
         d->obtainedMavs[message.sysid] = true;
         if (d->mavTimers.contains(message.sysid))
         {
-            this->killTimer(d->mavTimers.take(message.sysid));
+            m_communicator->timingWheel()->stop(d->mavTimers.take(message.sysid));
         }
 
         mavlink_autopilot_version_t version;
@@ -68,7 +73,7 @@ void AutopilotVersionHandler::processMessage(const mavlink_message_t& message)
     }
     else if (!d->obtainedMavs.contains(message.sysid) && !d->mavTimers.contains(message.sysid))
     {
-        d->mavTimers[message.sysid] = this->startTimer(::interval);
+        this->startRequestTimer(message.sysid, 0);
     }
 }
 
@@ -92,8 +97,11 @@ void AutopilotVersionHandler::requestVersion(quint8 mavId)
     m_communicator->sendMessage(message, link);
 }
 
-void AutopilotVersionHandler::timerEvent(QTimerEvent* event)
+void AutopilotVersionHandler::startRequestTimer(quint8 mavId, int attempt)
 {
-    quint8 mavId = d->mavTimers.key(event->timerId(), 0);
-    if (mavId > 0) this->requestVersion(mavId);
+    int timeout = utils::TimingWheel::backoff(::interval, attempt, ::maxInterval);
+    d->mavTimers[mavId] = m_communicator->timingWheel()->start(timeout, this, [this, mavId, attempt]() {
+        this->requestVersion(mavId);
+        this->startRequestTimer(mavId, attempt + 1);
+    });
 }
@@ -27,10 +27,9 @@ namespace comm
     public slots:
         void requestVersion(quint8 mavId);
 
-    protected:
-        void timerEvent(QTimerEvent* event) override;
-
     private:
+        void startRequestTimer(quint8 mavId, int attempt);
+
         class Impl;
         QScopedPointer<Impl> const d;
     };
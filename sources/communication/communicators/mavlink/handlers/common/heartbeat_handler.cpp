@@ -4,9 +4,7 @@
 #include <mavlink.h>
 
 // Qt
-#include <QMap>
 #include <QTimerEvent>
-#include <QBasicTimer>
 #include <QDebug>
 
 // Internal
@@ -24,12 +22,15 @@
 
 #include "mavlink_communicator.h"
 #include "mode_helper_factory.h"
+#include "liveness_tracker.h"
 
 using namespace comm;
 using namespace domain;
 
 namespace
 {
+    const int sweepInterval = 250;
+
     dto::Vehicle::Type decodeType(quint8 type)
     {
         switch (type) //TODO: other vehicles
@@ -86,8 +87,9 @@ public:
     VehicleService* vehicleService = serviceRegistry->vehicleService();
     domain::TelemetryService* telemetryService = serviceRegistry->telemetryService();
 
-    QMap <int, QBasicTimer*> vehicleTimers;
+    LivenessTracker tracker;
     int sendTimer;
+    int sweepTimer;
 
     QScopedPointer<IModeHelper> modeHelper;
 };
@@ -99,12 +101,11 @@ HeartbeatHandler::HeartbeatHandler(MavLinkCommunicator* communicator):
 {
     d->sendTimer = this->startTimer(settings::Provider::value(
                                     settings::communication::heartbeat).toInt());
+    d->sweepTimer = this->startTimer(::sweepInterval, Qt::CoarseTimer);
 }
 
 HeartbeatHandler::~HeartbeatHandler()
-{
-    for (QBasicTimer* timer: d->vehicleTimers.values()) delete timer;
-}
+{}
 
 void HeartbeatHandler::processMessage(const mavlink_message_t& message)
 {
@@ -115,17 +116,19 @@ void HeartbeatHandler::processMessage(const mavlink_message_t& message)
 
     if (message.sysid == m_communicator->systemId() || message.sysid == 0) return;
 
+    d->tracker.beat(message.sysid);
     int vehicleId = d->vehicleService->vehicleIdByMavId(message.sysid);
 
     dto::VehiclePtr vehicle = d->vehicleService->vehicle(vehicleId);
 
+    // Saved by vehicle service later, telemetry goes to provisional node meanwhile
     if (!vehicle && settings::Provider::value(settings::communication::autoAdd).toBool())
     {
-        vehicle = dto::VehiclePtr::create();
-        vehicle->setMavId(message.sysid);
-        vehicle->setType(dto::Vehicle::Auto);
-        vehicle->setName(tr("MAV %1").arg(message.sysid));
-        d->vehicleService->save(vehicle);
+        dto::VehiclePtr discovered = dto::VehiclePtr::create();
+        discovered->setMavId(message.sysid);
+        discovered->setType(::decodeType(heartbeat.type));
+        discovered->setName(tr("MAV %1").arg(message.sysid));
+        d->vehicleService->discoverVehicle(discovered);
     }
 
     if (vehicle)
@@ -140,14 +143,6 @@ void HeartbeatHandler::processMessage(const mavlink_message_t& message)
                         dto::LogMessage::Positive);
         }
 
-        if (!d->vehicleTimers.contains(vehicleId))
-        {
-            d->vehicleTimers[vehicleId] = new QBasicTimer();
-        }
-        d->vehicleTimers[vehicleId]->start(
-                    settings::Provider::value(settings::communication::timeout).toInt(),
-                    this);
-
         if (vehicle->type() == dto::Vehicle::Auto)
         {
             vehicle->setType(::decodeType(heartbeat.type));
@@ -158,6 +153,13 @@ void HeartbeatHandler::processMessage(const mavlink_message_t& message)
 
     TelemetryPortion portion(d->telemetryService->mavNode(message.sysid));
 
+    portion.setParameter({ Telemetry::Heartbeat, Telemetry::Interval },
+                         d->tracker.interval(message.sysid));
+    portion.setParameter({ Telemetry::Heartbeat, Telemetry::Jitter },
+                         d->tracker.jitter(message.sysid));
+    portion.setParameter({ Telemetry::Heartbeat, Telemetry::Quality },
+                         d->tracker.quality(message.sysid));
+
     portion.setParameter({ Telemetry::System, Telemetry::Armed },
                          bool(heartbeat.base_mode & MAV_MODE_FLAG_DECODE_POSITION_SAFETY));
     portion.setParameter({ Telemetry::System, Telemetry::Auto },
@@ -209,30 +211,28 @@ void HeartbeatHandler::sendHeartbeat()
 
 void HeartbeatHandler::timerEvent(QTimerEvent* event)
 {
-    if (event->timerId() == d->sendTimer)
-    {
-        this->sendHeartbeat();
-    }
-    else
+    if (event->timerId() == d->sendTimer) this->sendHeartbeat();
+    else if (event->timerId() == d->sweepTimer) this->sweep();
+    else QObject::timerEvent(event);
+}
+
+void HeartbeatHandler::sweep()
+{
+    int timeout = settings::Provider::value(settings::communication::timeout).toInt();
+
+    for (quint8 mavId: d->tracker.sweep(timeout))
     {
-        for (QBasicTimer* timer: d->vehicleTimers.values())
-        {
-            if (timer->timerId() != event->timerId()) continue;
-
-            dto::VehiclePtr vehicle = d->vehicleService->vehicle(d->vehicleTimers.key(timer));
-            if (vehicle.isNull())
-            {
-                delete timer;
-                d->vehicleTimers.remove(d->vehicleTimers.key(timer));
-                return;
-            }
-
-            timer->stop();
-            vehicle->setOnline(false);
-            d->vehicleService->save(vehicle);
-
-            LogBus::log(tr("Vehicle %1 gone offline").arg(vehicle->name()),
-                        dto::LogMessage::Warning);
-        }
+        TelemetryPortion portion(d->telemetryService->mavNode(mavId));
+        portion.setParameter({ Telemetry::Heartbeat, Telemetry::Quality }, 0);
+
+        dto::VehiclePtr vehicle = d->vehicleService->vehicle(
+                                      d->vehicleService->vehicleIdByMavId(mavId));
+        if (vehicle.isNull() || !vehicle->isOnline()) continue;
+
+        vehicle->setOnline(false);
+        d->vehicleService->save(vehicle);
+
+        LogBus::log(tr("Vehicle %1 gone offline").arg(vehicle->name()),
+                    dto::LogMessage::Warning);
     }
 }
@@ -26,6 +26,8 @@ namespace comm
         void timerEvent(QTimerEvent* event) override;
 
     private:
+        void sweep();
+
         class Impl;
         QScopedPointer<Impl> const d;
     };
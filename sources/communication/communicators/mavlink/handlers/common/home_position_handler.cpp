@@ -7,7 +7,6 @@
 #include <QMap>
 #include <QVariant>
 #include <QVector3D>
-#include <QTimerEvent>
 #include <QDebug>
 
 // Internal
@@ -15,6 +14,7 @@
 
 #include "mavlink_communicator.h"
 #include "mavlink_protocol_helpers.h"
+#include "timing_wheel.h"
 
 #include "service_registry.h"
 #include "vehicle_service.h"
@@ -114,22 +114,25 @@ void HomePositionHandler::sendHomePositionRequest(quint8 mavId)
      m_communicator->sendMessage(message, link);
 }
 
-void HomePositionHandler::timerEvent(QTimerEvent* event)
-{
-    dto::VehiclePtr vehicle = d->vehicleService->vehicle(
-                                  d->vehiclesTimers.key(event->timerId(), -1));
-    if (vehicle.isNull()) return QObject::timerEvent(event);
-
-    this->sendHomePositionRequest(vehicle->mavId());
-}
-
 void HomePositionHandler::addVehicleTimer(int vehicleId)
 {
     if (d->vehiclesTimers.contains(vehicleId)) this->removeVehicleTimer(vehicleId);
-    d->vehiclesTimers[vehicleId] = this->startTimer(::interval);
+    d->vehiclesTimers[vehicleId] = m_communicator->timingWheel()->start(
+                                       ::interval, this, [this, vehicleId]() {
+        d->vehiclesTimers.remove(vehicleId);
+
+        dto::VehiclePtr vehicle = d->vehicleService->vehicle(vehicleId);
+        if (vehicle.isNull()) return;
+
+        this->sendHomePositionRequest(vehicle->mavId());
+        this->addVehicleTimer(vehicleId);
+    });
 }
 
 void HomePositionHandler::removeVehicleTimer(int vehicleId)
 {
-    if (d->vehiclesTimers.contains(vehicleId)) this->killTimer(d->vehiclesTimers.take(vehicleId));
+    if (d->vehiclesTimers.contains(vehicleId))
+    {
+        m_communicator->timingWheel()->stop(d->vehiclesTimers.take(vehicleId));
+    }
 }
@@ -22,9 +22,6 @@ namespace comm
     public slots:
         void sendHomePositionRequest(quint8 mavId);
 
-    protected:
-        void timerEvent(QTimerEvent* event);
-
     private slots:
         void addVehicleTimer(int vehicleId);
         void removeVehicleTimer(int vehicleId);
@@ -0,0 +1,95 @@
+#include "liveness_tracker.h"
+
+// Qt
+#include <QtMath>
+
+using namespace comm;
+
+namespace
+{
+    const float nominalInterval = 1000; // MAVLink heartbeat rate is 1 Hz
+    const float intervalGain = 1.0 / 8;
+    const float jitterGain = 1.0 / 16;
+}
+
+LivenessTracker::LivenessTracker()
+{
+    m_clock.start();
+}
+
+bool LivenessTracker::beat(quint8 sysId)
+{
+    Entry& entry = m_entries[sysId];
+    qint64 now = m_clock.elapsed();
+
+    if (entry.position > -1)
+    {
+        float gap = now - entry.lastSeen;
+        entry.jitter += (qAbs(gap - entry.interval) - entry.jitter) * ::jitterGain;
+        entry.interval += (gap - entry.interval) * ::intervalGain;
+
+        // Each gap spanning n nominal periods means n - 1 heartbeats were lost
+        float received = 1 / qMax(1.0f, qRound(gap / ::nominalInterval) * 1.0f);
+        entry.quality += (received - entry.quality) * ::intervalGain;
+    }
+
+    entry.lastSeen = now;
+    if (entry.position > -1) return false;
+
+    entry.position = m_online.count();
+    entry.interval = ::nominalInterval;
+    entry.jitter = 0;
+    entry.quality = 1;
+    m_online.append(sysId);
+    return true;
+}
+
+QVector<quint8> LivenessTracker::sweep(int timeout)
+{
+    QVector<quint8> timedOut;
+    qint64 now = m_clock.elapsed();
+
+    for (int i = 0; i < m_online.count();)
+    {
+        Entry& entry = m_entries[m_online.at(i)];
+        if (now - entry.lastSeen <= timeout)
+        {
+            ++i;
+            continue;
+        }
+
+        timedOut.append(m_online.at(i));
+        entry.position = -1;
+        entry.quality = 0;
+
+        // Last one takes the freed place to keep online list dense
+        quint8 last = m_online.takeLast();
+        if (i < m_online.count())
+        {
+            m_online[i] = last;
+            m_entries[last].position = i;
+        }
+    }
+
+    return timedOut;
+}
+
+bool LivenessTracker::isOnline(quint8 sysId) const
+{
+    return m_entries[sysId].position > -1;
+}
+
+int LivenessTracker::interval(quint8 sysId) const
+{
+    return qRound(m_entries[sysId].interval);
+}
+
+int LivenessTracker::jitter(quint8 sysId) const
+{
+    return qRound(m_entries[sysId].jitter);
+}
+
+int LivenessTracker::quality(quint8 sysId) const
+{
+    return qRound(m_entries[sysId].quality * 100);
+}
@@ -0,0 +1,47 @@
+#ifndef LIVENESS_TRACKER_H
+#define LIVENESS_TRACKER_H
+
+// Qt
+#include <QElapsedTimer>
+#include <QVector>
+
+// Std
+#include <array>
+
+namespace comm
+{
+    // Heartbeat bookkeeping for every MAVLink system id. Last seen times live in a flat
+    // array indexed by sysid, so a heartbeat costs O(1), and one periodic sweep over
+    // online systems replaces per vehicle timers
+    class LivenessTracker
+    {
+    public:
+        LivenessTracker();
+
+        // Returns true if system was offline before this heartbeat
+        bool beat(quint8 sysId);
+        // Marks systems silent longer than timeout offline and returns them
+        QVector<quint8> sweep(int timeout);
+
+        bool isOnline(quint8 sysId) const;
+        int interval(quint8 sysId) const; // Smoothed heartbeat gap, ms
+        int jitter(quint8 sysId) const; // Smoothed deviation of gap, ms
+        int quality(quint8 sysId) const; // Share of expected heartbeats received, %
+
+    private:
+        struct Entry
+        {
+            qint64 lastSeen = 0;
+            float interval = 0;
+            float jitter = 0;
+            float quality = 0;
+            int position = -1; // Index in m_online, -1 if offline
+        };
+
+        std::array<Entry, 256> m_entries;
+        QVector<quint8> m_online;
+        QElapsedTimer m_clock;
+    };
+}
+
+#endif // LIVENESS_TRACKER_H
@@ -0,0 +1,356 @@
+#include "log_download_handler.h"
+
+// MAVLink
+#include <mavlink.h>
+
+// Qt
+#include <QMap>
+#include <QFile>
+#include <QBitArray>
+#include <QSharedPointer>
+#include <QDebug>
+
+// Internal
+#include "service_registry.h"
+#include "vehicle_service.h"
+#include "onboard_log_service.h"
+
+#include "mavlink_communicator.h"
+#include "timing_wheel.h"
+
+using namespace comm;
+using namespace domain;
+
+namespace
+{
+    const int chunkSize = MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN;
+
+    const int listTimeout = 1000;
+    const int listRetries = 3;
+
+    const int dataTimeout = 500; // Silence after which missing range is requested
+    const int dataRetries = 10; // Requests in row without any new chunk
+    const int progressStep = 128; // Chunks
+}
+
+class LogDownloadHandler::Impl
+{
+public:
+    VehicleService* vehicleService = serviceRegistry->vehicleService();
+    OnboardLogService* logService = serviceRegistry->onboardLogService();
+
+    struct Listing
+    {
+        int vehicleId = 0;
+        int expected = -1; // Unknown until first LOG_ENTRY
+        QMap<int, OnboardLog> logs;
+        int timer = 0;
+        int retries = 0;
+    };
+
+    struct Download
+    {
+        int vehicleId = 0;
+        int logId = 0;
+        quint32 size = 0;
+        QFile file;
+
+        QBitArray chunks; // Received ones, data itself is on disk only
+        int receivedChunks = 0;
+        int firstMissing = 0;
+        int requestEnd = 0; // Chunk after the last one currently requested
+
+        int timer = 0;
+        int retries = 0;
+    };
+
+    QMap<quint8, Listing> listings;
+    QMap<quint8, QSharedPointer<Download> > downloads;
+};
+
+LogDownloadHandler::LogDownloadHandler(MavLinkCommunicator* communicator):
+    QObject(communicator),
+    AbstractMavLinkHandler(communicator),
+    d(new Impl())
+{
+    connect(d->logService, &OnboardLogService::listRequested,
+            this, &LogDownloadHandler::requestList);
+    connect(d->logService, &OnboardLogService::downloadRequested,
+            this, &LogDownloadHandler::download);
+    connect(d->logService, &OnboardLogService::downloadCanceled,
+            this, &LogDownloadHandler::cancelDownload);
+}
+
+LogDownloadHandler::~LogDownloadHandler()
+{}
+
+void LogDownloadHandler::processMessage(const mavlink_message_t& message)
+{
+    if (message.msgid == MAVLINK_MSG_ID_LOG_ENTRY) this->processLogEntry(message);
+    else if (message.msgid == MAVLINK_MSG_ID_LOG_DATA) this->processLogData(message);
+}
+
+void LogDownloadHandler::requestList(int vehicleId)
+{
+    int mavId = d->vehicleService->mavIdByVehicleId(vehicleId);
+    if (mavId < 1) return;
+
+    Impl::Listing& listing = d->listings[mavId];
+    m_communicator->timingWheel()->stop(listing.timer);
+    listing = Impl::Listing();
+    listing.vehicleId = vehicleId;
+
+    listing.timer = m_communicator->timingWheel()->start(::listTimeout, this, [this, mavId]() {
+        this->onListTimeout(mavId);
+    });
+    this->sendLogRequestList(mavId);
+}
+
+void LogDownloadHandler::download(int vehicleId, int logId, const QString& fileName)
+{
+    int mavId = d->vehicleService->mavIdByVehicleId(vehicleId);
+    if (mavId < 1) return;
+
+    if (d->downloads.contains(mavId)) this->finishDownload(mavId, false);
+
+    OnboardLog log;
+    for (const OnboardLog& candidate: d->logService->logs(vehicleId))
+    {
+        if (candidate.id == logId) log = candidate;
+    }
+
+    QSharedPointer<Impl::Download> download = QSharedPointer<Impl::Download>::create();
+    download->vehicleId = vehicleId;
+    download->logId = logId;
+    download->size = log.size;
+    download->file.setFileName(fileName);
+
+    // File is preallocated, chunks are written in place in whatever order they come
+    if (log.id != logId || !download->file.open(QIODevice::WriteOnly) ||
+        !download->file.resize(log.size))
+    {
+        d->logService->setDownloadFinished(vehicleId, logId, false);
+        return;
+    }
+
+    download->chunks.resize((log.size + ::chunkSize - 1) / ::chunkSize);
+    d->downloads[mavId] = download;
+
+    if (download->chunks.isEmpty()) return this->finishDownload(mavId, true);
+
+    this->requestGap(mavId);
+}
+
+void LogDownloadHandler::cancelDownload(int vehicleId)
+{
+    int mavId = d->vehicleService->mavIdByVehicleId(vehicleId);
+    if (d->downloads.contains(mavId)) this->finishDownload(mavId, false);
+}
+
+void LogDownloadHandler::processLogEntry(const mavlink_message_t& message)
+{
+    auto it = d->listings.find(message.sysid);
+    if (it == d->listings.end() || !it->timer) return;
+
+    mavlink_log_entry_t entry;
+    mavlink_msg_log_entry_decode(&message, &entry);
+
+    it->expected = entry.num_logs;
+    it->retries = 0;
+
+    if (entry.num_logs > 0)
+    {
+        OnboardLog log;
+        log.id = entry.id;
+        log.size = entry.size;
+        if (entry.time_utc > 0) log.time = QDateTime::fromTime_t(entry.time_utc, Qt::UTC);
+        it->logs[log.id] = log;
+    }
+
+    if (it->logs.count() >= it->expected) return this->finishList(message.sysid);
+
+    quint8 mavId = message.sysid;
+    m_communicator->timingWheel()->stop(it->timer);
+    it->timer = m_communicator->timingWheel()->start(::listTimeout, this, [this, mavId]() {
+        this->onListTimeout(mavId);
+    });
+}
+
+void LogDownloadHandler::processLogData(const mavlink_message_t& message)
+{
+    auto it = d->downloads.find(message.sysid);
+    if (it == d->downloads.end()) return;
+
+    mavlink_log_data_t data;
+    mavlink_msg_log_data_decode(&message, &data);
+
+    Impl::Download* download = it->data();
+    if (data.id != download->logId || data.count == 0 || data.ofs % ::chunkSize) return;
+
+    int chunk = data.ofs / ::chunkSize;
+    if (chunk >= download->chunks.size() || download->chunks.testBit(chunk)) return;
+
+    qint64 count = qMin<quint32>(data.count, download->size - data.ofs);
+    if (!download->file.seek(data.ofs) ||
+        download->file.write(reinterpret_cast<const char*>(data.data), count) != count)
+    {
+        // Disk full or gone, marking the chunk received would leave a hole in the log
+        qWarning("Log download write error: '%s'!", qPrintable(download->file.errorString()));
+        return this->finishDownload(message.sysid, false);
+    }
+
+    download->chunks.setBit(chunk);
+    download->retries = 0;
+
+    if (++download->receivedChunks == download->chunks.size())
+    {
+        return this->finishDownload(message.sysid, true);
+    }
+
+    if (download->receivedChunks % ::progressStep == 0)
+    {
+        d->logService->setDownloadProgress(download->vehicleId, download->logId,
+                                           qMin<quint32>(download->receivedChunks * ::chunkSize,
+                                                         download->size), download->size);
+    }
+
+    // End of requested range, there is no need to wait for silence to ask for the next gap
+    if (chunk + 1 == download->requestEnd) return this->requestGap(message.sysid);
+
+    quint8 mavId = message.sysid;
+    m_communicator->timingWheel()->stop(download->timer);
+    download->timer = m_communicator->timingWheel()->start(::dataTimeout, this, [this, mavId]() {
+        this->onDataTimeout(mavId);
+    });
+}
+
+void LogDownloadHandler::onListTimeout(quint8 mavId)
+{
+    Impl::Listing& listing = d->listings[mavId];
+    listing.timer = 0;
+
+    if (listing.expected == 0 || ++listing.retries > ::listRetries) return this->finishList(mavId);
+
+    listing.timer = m_communicator->timingWheel()->start(::listTimeout, this, [this, mavId]() {
+        this->onListTimeout(mavId);
+    });
+    this->sendLogRequestList(mavId);
+}
+
+void LogDownloadHandler::finishList(quint8 mavId)
+{
+    Impl::Listing listing = d->listings.take(mavId);
+    m_communicator->timingWheel()->stop(listing.timer);
+
+    d->logService->setLogs(listing.vehicleId, listing.logs.values());
+}
+
+void LogDownloadHandler::requestGap(quint8 mavId)
+{
+    Impl::Download* download = d->downloads.value(mavId).data();
+
+    // Bits are only ever set, so first missing chunk never moves back
+    while (download->firstMissing < download->chunks.size() &&
+           download->chunks.testBit(download->firstMissing)) download->firstMissing++;
+
+    int end = download->firstMissing + 1;
+    while (end < download->chunks.size() && !download->chunks.testBit(end)) end++;
+
+    download->requestEnd = end;
+
+    quint32 offset = download->firstMissing * ::chunkSize;
+    quint32 count = qMin<quint32>(end * ::chunkSize, download->size) - offset;
+    this->sendLogRequestData(mavId, download->logId, offset, count);
+
+    m_communicator->timingWheel()->stop(download->timer);
+    download->timer = m_communicator->timingWheel()->start(::dataTimeout, this, [this, mavId]() {
+        this->onDataTimeout(mavId);
+    });
+}
+
+void LogDownloadHandler::onDataTimeout(quint8 mavId)
+{
+    Impl::Download* download = d->downloads.value(mavId).data();
+    download->timer = 0;
+
+    if (++download->retries > ::dataRetries) return this->finishDownload(mavId, false);
+
+    this->requestGap(mavId);
+}
+
+void LogDownloadHandler::finishDownload(quint8 mavId, bool success)
+{
+    QSharedPointer<Impl::Download> download = d->downloads.take(mavId);
+    m_communicator->timingWheel()->stop(download->timer);
+
+    this->sendLogRequestEnd(mavId);
+
+    download->file.close();
+    if (!success) download->file.remove();
+
+    if (success)
+    {
+        d->logService->setDownloadProgress(download->vehicleId, download->logId,
+                                           download->size, download->size);
+    }
+    d->logService->setDownloadFinished(download->vehicleId, download->logId, success);
+}
+
+void LogDownloadHandler::sendLogRequestList(quint8 mavId)
+{
+    mavlink_message_t message;
+    mavlink_log_request_list_t request;
+
+    request.target_system = mavId;
+    request.target_component = 0;
+    request.start = 0;
+    request.end = 0xFFFF;
+
+    AbstractLink* link = m_communicator->mavSystemLink(mavId);
+    if (!link) return;
+
+    mavlink_msg_log_request_list_encode_chan(m_communicator->systemId(),
+                                             m_communicator->componentId(),
+                                             m_communicator->linkChannel(link),
+                                             &message, &request);
+    m_communicator->sendMessage(message, link);
+}
+
+void LogDownloadHandler::sendLogRequestData(quint8 mavId, int logId, quint32 offset, quint32 count)
+{
+    mavlink_message_t message;
+    mavlink_log_request_data_t request;
+
+    request.target_system = mavId;
+    request.target_component = 0;
+    request.id = logId;
+    request.ofs = offset;
+    request.count = count;
+
+    AbstractLink* link = m_communicator->mavSystemLink(mavId);
+    if (!link) return;
+
+    mavlink_msg_log_request_data_encode_chan(m_communicator->systemId(),
+                                             m_communicator->componentId(),
+                                             m_communicator->linkChannel(link),
+                                             &message, &request);
+    m_communicator->sendMessage(message, link);
+}
+
+void LogDownloadHandler::sendLogRequestEnd(quint8 mavId)
+{
+    mavlink_message_t message;
+    mavlink_log_request_end_t request;
+
+    request.target_system = mavId;
+    request.target_component = 0;
+
+    AbstractLink* link = m_communicator->mavSystemLink(mavId);
+    if (!link) return;
+
+    mavlink_msg_log_request_end_encode_chan(m_communicator->systemId(),
+                                            m_communicator->componentId(),
+                                            m_communicator->linkChannel(link),
+                                            &message, &request);
+    m_communicator->sendMessage(message, link);
+}
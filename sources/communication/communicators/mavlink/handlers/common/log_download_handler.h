@@ -0,0 +1,49 @@
+#ifndef LOG_DOWNLOAD_HANDLER_H
+#define LOG_DOWNLOAD_HANDLER_H
+
+// Qt
+#include <QObject>
+
+// Internal
+#include "abstract_mavlink_handler.h"
+
+namespace comm
+{
+    // Onboard log listing and download. Whole log is requested at once, so vehicle
+    // streams LOG_DATA at full link rate, then only missing ranges are requested again
+    class LogDownloadHandler: public QObject, public AbstractMavLinkHandler
+    {
+        Q_OBJECT
+
+    public:
+        explicit LogDownloadHandler(MavLinkCommunicator* communicator);
+        ~LogDownloadHandler() override;
+
+        void processMessage(const mavlink_message_t& message) override;
+
+    public slots:
+        void requestList(int vehicleId);
+        void download(int vehicleId, int logId, const QString& fileName);
+        void cancelDownload(int vehicleId);
+
+    private:
+        void processLogEntry(const mavlink_message_t& message);
+        void processLogData(const mavlink_message_t& message);
+
+        void onListTimeout(quint8 mavId);
+        void finishList(quint8 mavId);
+
+        void requestGap(quint8 mavId);
+        void onDataTimeout(quint8 mavId);
+        void finishDownload(quint8 mavId, bool success);
+
+        void sendLogRequestList(quint8 mavId);
+        void sendLogRequestData(quint8 mavId, int logId, quint32 offset, quint32 count);
+        void sendLogRequestEnd(quint8 mavId);
+
+        class Impl;
+        QScopedPointer<Impl> const d;
+    };
+}
+
+#endif // LOG_DOWNLOAD_HANDLER_H
@@ -0,0 +1,656 @@
+#include "parameter_handler.h"
+
+// MAVLink
+#include <mavlink.h>
+
+// Qt
+#include <QMap>
+#include <QBitArray>
+#include <QDebug>
+
+// Internal
+#include "vehicle.h"
+
+#include "service_registry.h"
+#include "vehicle_service.h"
+#include "parameter_service.h"
+
+#include "log_bus.h"
+
+#include "mavlink_communicator.h"
+#include "timing_wheel.h"
+
+using namespace comm;
+using namespace domain;
+
+namespace
+{
+    const int versionTimeout = 3000; // Firmware without AUTOPILOT_VERSION is cached by vehicle only
+    const int hashTimeout = 1500;
+    const int listTimeout = 700; // Silence after which missing indexes are requested
+    const int listRetries = 6; // Passes without any progress before giving up
+    const int gapRequests = 16; // PARAM_REQUEST_READ sent per pass
+    const int progressStep = 32;
+
+    const int writeWindow = 8;
+    const int writeTimeout = 1000;
+    const int writeRetries = 3;
+
+    const int paramIdLength = 16;
+    const QString hashCheckId = "_HASH_CHECK";
+
+    QString decodeId(const char* id)
+    {
+        return QString::fromLatin1(id, qstrnlen(id, ::paramIdLength));
+    }
+
+    void encodeId(const QString& name, char* id)
+    {
+        QByteArray latin = name.toLatin1();
+        memset(id, 0, ::paramIdLength);
+        memcpy(id, latin.constData(), qMin(latin.size(), ::paramIdLength));
+    }
+
+    union ParamUnion
+    {
+        float real;
+        qint32 int32;
+        quint32 uint32;
+        qint16 int16;
+        quint16 uint16;
+        qint8 int8;
+        quint8 uint8;
+    };
+
+    // Bytewise autopilots put integers into float bytes, others cast them to float
+    QVariant decodeValue(float raw, quint8 type, bool bytewise)
+    {
+        if (type == MAV_PARAM_TYPE_REAL32) return raw;
+
+        ParamUnion value;
+        value.uint32 = 0;
+        value.real = raw;
+
+        switch (type)
+        {
+        case MAV_PARAM_TYPE_UINT8: return bytewise ? uint(value.uint8) : uint(raw);
+        case MAV_PARAM_TYPE_INT8: return bytewise ? int(value.int8) : int(raw);
+        case MAV_PARAM_TYPE_UINT16: return bytewise ? uint(value.uint16) : uint(raw);
+        case MAV_PARAM_TYPE_INT16: return bytewise ? int(value.int16) : int(raw);
+        case MAV_PARAM_TYPE_UINT32: return bytewise ? value.uint32 : quint32(raw);
+        case MAV_PARAM_TYPE_INT32: return bytewise ? value.int32 : qint32(raw);
+        default: return raw;
+        }
+    }
+
+    float encodeValue(const QVariant& value, quint8 type, bool bytewise)
+    {
+        if (type == MAV_PARAM_TYPE_REAL32 || !bytewise) return value.toFloat();
+
+        ParamUnion raw;
+        raw.uint32 = 0;
+
+        switch (type)
+        {
+        case MAV_PARAM_TYPE_UINT8: raw.uint8 = value.toUInt(); break;
+        case MAV_PARAM_TYPE_INT8: raw.int8 = value.toInt(); break;
+        case MAV_PARAM_TYPE_UINT16: raw.uint16 = value.toUInt(); break;
+        case MAV_PARAM_TYPE_INT16: raw.int16 = value.toInt(); break;
+        case MAV_PARAM_TYPE_UINT32: raw.uint32 = value.toUInt(); break;
+        case MAV_PARAM_TYPE_INT32: raw.int32 = value.toInt(); break;
+        default: return value.toFloat();
+        }
+        return raw.real;
+    }
+
+    quint32 rawBits(float value)
+    {
+        quint32 bits;
+        memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+
+    // CRC32 without pre and post inversion, as autopilots compute _HASH_CHECK
+    quint32 crc32(const char* data, int length, quint32 crc)
+    {
+        for (int i = 0; i < length; ++i)
+        {
+            crc ^= quint8(data[i]);
+            for (int bit = 0; bit < 8; ++bit) crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+        }
+        return crc;
+    }
+
+    quint32 parametersHash(const VehicleParameterMap& parameters, bool bytewise)
+    {
+        QMap<int, QString> ordered;
+        for (auto it = parameters.constBegin(); it != parameters.constEnd(); ++it)
+        {
+            ordered[it.value().index] = it.key();
+        }
+
+        quint32 hash = 0;
+        for (const QString& name: ordered)
+        {
+            const VehicleParameter& parameter = parameters[name];
+            QByteArray latin = name.toLatin1();
+            hash = ::crc32(latin.constData(), latin.size(), hash);
+
+            float value = ::encodeValue(parameter.value, parameter.type, bytewise);
+            hash = ::crc32(reinterpret_cast<const char*>(&value), sizeof(value), hash);
+        }
+        return hash;
+    }
+}
+
+class ParameterHandler::Impl
+{
+public:
+    VehicleService* vehicleService = serviceRegistry->vehicleService();
+    ParameterService* parameterService = serviceRegistry->parameterService();
+
+    struct Write
+    {
+        QVariant value;
+        quint8 type = 0;
+        int attempts = 0;
+        int timer = 0;
+    };
+
+    struct Session
+    {
+        enum Stage
+        {
+            AwaitingVersion,
+            Verifying,
+            Listing,
+            Synced,
+            Failed
+        };
+
+        int vehicleId = 0;
+        Stage stage = AwaitingVersion;
+        QString firmware;
+        bool bytewise = false;
+        int timer = 0;
+
+        // Bulk download, complete set goes to service only at the end
+        int total = 0;
+        QBitArray received;
+        int receivedCount = 0;
+        int retries = 0;
+        VehicleParameterMap parameters;
+
+        QList<QString> writeQueue;
+        QMap<QString, Write> writes;
+        QStringList writeFailed;
+    };
+
+    QMap<quint8, Session> sessions;
+};
+
+ParameterHandler::ParameterHandler(MavLinkCommunicator* communicator):
+    QObject(communicator),
+    AbstractMavLinkHandler(communicator),
+    d(new Impl())
+{
+    connect(d->parameterService, &ParameterService::downloadRequested,
+            this, &ParameterHandler::download);
+    connect(d->parameterService, &ParameterService::writeRequested,
+            this, &ParameterHandler::write);
+
+    connect(d->vehicleService, &VehicleService::vehicleChanged,
+            this, [this](const dto::VehiclePtr& vehicle) {
+        if (!vehicle->isOnline()) this->dropSession(vehicle->id());
+    });
+    connect(d->vehicleService, &VehicleService::vehicleRemoved,
+            this, [this](const dto::VehiclePtr& vehicle) {
+        this->dropSession(vehicle->id());
+    });
+}
+
+ParameterHandler::~ParameterHandler()
+{}
+
+void ParameterHandler::processMessage(const mavlink_message_t& message)
+{
+    switch (message.msgid)
+    {
+    case MAVLINK_MSG_ID_HEARTBEAT:
+        this->processHeartbeat(message);
+        break;
+    case MAVLINK_MSG_ID_AUTOPILOT_VERSION:
+        this->processAutopilotVersion(message);
+        break;
+    case MAVLINK_MSG_ID_PARAM_VALUE:
+        this->processParamValue(message);
+        break;
+    default:
+        break;
+    }
+}
+
+void ParameterHandler::download(int vehicleId)
+{
+    int mavId = d->vehicleService->mavIdByVehicleId(vehicleId);
+    if (!d->sessions.contains(mavId)) return;
+
+    this->startList(mavId);
+}
+
+void ParameterHandler::write(int vehicleId, const QVariantMap& values)
+{
+    int mavId = d->vehicleService->mavIdByVehicleId(vehicleId);
+    if (!d->sessions.contains(mavId))
+    {
+        // Vehicle is not connected, nothing of the request is written
+        return d->parameterService->setWriteFinished(vehicleId, values.keys());
+    }
+
+    Impl::Session& session = d->sessions[mavId];
+    VehicleParameterMap parameters = d->parameterService->parameters(vehicleId);
+
+    for (auto it = values.constBegin(); it != values.constEnd(); ++it)
+    {
+        // Storage type is known only for parameters reported by vehicle
+        if (!parameters.contains(it.key()))
+        {
+            session.writeFailed.append(it.key());
+            continue;
+        }
+
+        Impl::Write& write = session.writes[it.key()];
+        if (write.timer) m_communicator->timingWheel()->stop(write.timer);
+
+        write.value = it.value();
+        write.type = parameters[it.key()].type;
+        write.attempts = 0;
+        write.timer = 0;
+
+        session.writeQueue.removeOne(it.key());
+        session.writeQueue.append(it.key());
+    }
+
+    this->sendWrites(mavId);
+}
+
+void ParameterHandler::processHeartbeat(const mavlink_message_t& message)
+{
+    if (message.sysid == m_communicator->systemId() || d->sessions.contains(message.sysid)) return;
+
+    int vehicleId = d->vehicleService->vehicleIdByMavId(message.sysid);
+    if (!vehicleId) return;
+
+    quint8 mavId = message.sysid;
+    Impl::Session& session = d->sessions[mavId];
+    session.vehicleId = vehicleId;
+    session.timer = m_communicator->timingWheel()->start(::versionTimeout, this, [this, mavId]() {
+        d->sessions[mavId].timer = 0;
+        this->startSync(mavId);
+    });
+}
+
+void ParameterHandler::processAutopilotVersion(const mavlink_message_t& message)
+{
+    auto it = d->sessions.find(message.sysid);
+    if (it == d->sessions.end() || it->stage != Impl::Session::AwaitingVersion) return;
+
+    mavlink_autopilot_version_t version;
+    mavlink_msg_autopilot_version_decode(&message, &version);
+
+    m_communicator->timingWheel()->stop(it->timer);
+    it->timer = 0;
+    it->firmware = QString("%1-%2").arg(version.flight_sw_version, 8, 16, QChar('0')).arg(
+                       QString(QByteArray(reinterpret_cast<const char*>(version.flight_custom_version),
+                                          sizeof(version.flight_custom_version)).toHex()));
+    it->bytewise = version.capabilities & MAV_PROTOCOL_CAPABILITY_PARAM_UNION;
+
+    this->startSync(message.sysid);
+}
+
+void ParameterHandler::processParamValue(const mavlink_message_t& message)
+{
+    auto it = d->sessions.find(message.sysid);
+    if (it == d->sessions.end()) return;
+
+    mavlink_param_value_t value;
+    mavlink_msg_param_value_decode(&message, &value);
+
+    QString name = ::decodeId(value.param_id);
+    quint8 mavId = message.sysid;
+
+    if (name == ::hashCheckId)
+    {
+        if (it->stage != Impl::Session::Verifying) return;
+
+        m_communicator->timingWheel()->stop(it->timer);
+        it->timer = 0;
+
+        VehicleParameterMap cached = d->parameterService->parameters(it->vehicleId);
+        if (::rawBits(value.param_value) == ::parametersHash(cached, it->bytewise))
+        {
+            it->stage = Impl::Session::Synced;
+            d->parameterService->setProgress(it->vehicleId, cached.count(), cached.count());
+        }
+        else
+        {
+            this->startList(mavId);
+        }
+        return;
+    }
+
+    VehicleParameter parameter;
+    parameter.index = value.param_index;
+    parameter.type = value.param_type;
+    parameter.value = ::decodeValue(value.param_value, value.param_type, it->bytewise);
+
+    if (it->stage == Impl::Session::Listing)
+    {
+        if (it->total != value.param_count)
+        {
+            it->total = value.param_count;
+            it->received.resize(it->total);
+        }
+
+        if (value.param_index < it->total && !it->received.testBit(value.param_index))
+        {
+            it->received.setBit(value.param_index);
+            it->receivedCount++;
+            it->retries = 0;
+            it->parameters[name] = parameter;
+
+            if (it->receivedCount % ::progressStep == 0)
+            {
+                d->parameterService->setProgress(it->vehicleId, it->receivedCount, it->total);
+            }
+        }
+
+        if (it->receivedCount == it->total) return this->finishList(mavId);
+
+        // Gaps are requested only when stream goes silent
+        m_communicator->timingWheel()->stop(it->timer);
+        it->timer = m_communicator->timingWheel()->start(::listTimeout, this, [this, mavId]() {
+            d->sessions[mavId].timer = 0;
+            this->onListTimeout(mavId);
+        });
+    }
+
+    // Answers on PARAM_SET and PARAM_REQUEST_READ by name come without index
+    if (value.param_index >= value.param_count)
+    {
+        parameter.index = it->parameters.contains(name) ?
+                              it->parameters[name].index :
+                              d->parameterService->parameters(it->vehicleId).value(name).index;
+    }
+
+    // Confirmed write goes to service in any stage and to listing buffer, else list would restore old value
+    bool writing = it->writes.contains(name);
+    if (it->stage != Impl::Session::Listing || writing)
+    {
+        d->parameterService->setParameter(it->vehicleId, name, parameter, !writing);
+    }
+    if (writing && it->stage == Impl::Session::Listing && it->parameters.contains(name))
+    {
+        it->parameters[name] = parameter;
+    }
+
+    if (writing)
+    {
+        const Impl::Write& write = it->writes[name];
+        if (!write.timer) return; // Queued, not sent yet
+
+        float expected = ::encodeValue(write.value, write.type, it->bytewise);
+        this->finishWrite(mavId, name, ::rawBits(expected) == ::rawBits(value.param_value));
+    }
+}
+
+void ParameterHandler::startSync(quint8 mavId)
+{
+    Impl::Session& session = d->sessions[mavId];
+
+    VehicleParameterMap cached = d->parameterService->loadCache(session.vehicleId, session.firmware);
+    if (cached.isEmpty()) return this->startList(mavId);
+
+    // Cached set is already published, vehicle is only asked whether it still matches
+    session.stage = Impl::Session::Verifying;
+    session.timer = m_communicator->timingWheel()->start(::hashTimeout, this, [this, mavId]() {
+        d->sessions[mavId].timer = 0;
+        this->startList(mavId);
+    });
+
+    this->sendParamRequestRead(mavId, ::hashCheckId);
+}
+
+void ParameterHandler::startList(quint8 mavId)
+{
+    Impl::Session& session = d->sessions[mavId];
+
+    m_communicator->timingWheel()->stop(session.timer);
+    session.stage = Impl::Session::Listing;
+    session.total = 0;
+    session.received.clear();
+    session.receivedCount = 0;
+    session.retries = 0;
+    session.parameters.clear();
+
+    session.timer = m_communicator->timingWheel()->start(::listTimeout, this, [this, mavId]() {
+        d->sessions[mavId].timer = 0;
+        this->onListTimeout(mavId);
+    });
+
+    this->sendParamRequestList(mavId);
+}
+
+void ParameterHandler::onListTimeout(quint8 mavId)
+{
+    Impl::Session& session = d->sessions[mavId];
+
+    if (++session.retries > ::listRetries)
+    {
+        session.stage = Impl::Session::Failed;
+        session.parameters.clear();
+
+        dto::VehiclePtr vehicle = d->vehicleService->vehicle(session.vehicleId);
+        LogBus::log(tr("Parameters of %1 are incomplete: %2 of %3 received").arg(
+                        vehicle ? vehicle->name() : QString::number(mavId)).arg(
+                        session.receivedCount).arg(session.total), dto::LogMessage::Warning);
+        return;
+    }
+
+    session.timer = m_communicator->timingWheel()->start(::listTimeout, this, [this, mavId]() {
+        d->sessions[mavId].timer = 0;
+        this->onListTimeout(mavId);
+    });
+
+    if (session.total == 0) return this->sendParamRequestList(mavId);
+
+    AbstractLink* link = m_communicator->mavSystemLink(mavId);
+    if (!link) return;
+
+    // Missing indexes go out in one burst instead of restarting whole list
+    QList<mavlink_message_t> messages;
+    mavlink_message_t message;
+    for (int index = 0; index < session.total && messages.count() < ::gapRequests; ++index)
+    {
+        if (session.received.testBit(index)) continue;
+
+        this->encodeParamRequestRead(mavId, index, link, message);
+        messages.append(message);
+    }
+
+    m_communicator->sendMessages(messages, link);
+}
+
+void ParameterHandler::finishList(quint8 mavId)
+{
+    Impl::Session& session = d->sessions[mavId];
+
+    m_communicator->timingWheel()->stop(session.timer);
+    session.timer = 0;
+    session.stage = Impl::Session::Synced;
+
+    d->parameterService->setParameters(session.vehicleId, session.parameters);
+    d->parameterService->setProgress(session.vehicleId, session.total, session.total);
+
+    session.parameters.clear();
+}
+
+void ParameterHandler::sendWrites(quint8 mavId)
+{
+    Impl::Session& session = d->sessions[mavId];
+
+    int inFlight = session.writes.count() - session.writeQueue.count();
+    if (inFlight == 0 && session.writeQueue.isEmpty())
+    {
+        if (session.writeFailed.isEmpty()) return;
+
+        // Nothing was sent, every requested parameter is unknown
+        d->parameterService->setWriteFinished(session.vehicleId, session.writeFailed);
+        session.writeFailed.clear();
+        return;
+    }
+
+    AbstractLink* link = m_communicator->mavSystemLink(mavId);
+    if (!link) return;
+
+    QList<mavlink_message_t> messages;
+    mavlink_message_t message;
+    while (inFlight < ::writeWindow && !session.writeQueue.isEmpty())
+    {
+        QString name = session.writeQueue.takeFirst();
+        Impl::Write& write = session.writes[name];
+
+        this->encodeParamSet(mavId, name, ::encodeValue(write.value, write.type, session.bytewise),
+                             write.type, link, message);
+        messages.append(message);
+
+        write.timer = m_communicator->timingWheel()->start(::writeTimeout, this, [this, mavId, name]() {
+            this->onWriteTimeout(mavId, name);
+        });
+        inFlight++;
+    }
+
+    m_communicator->sendMessages(messages, link);
+}
+
+void ParameterHandler::onWriteTimeout(quint8 mavId, const QString& name)
+{
+    Impl::Session& session = d->sessions[mavId];
+    Impl::Write& write = session.writes[name];
+
+    if (++write.attempts >= ::writeRetries) return this->finishWrite(mavId, name, false);
+
+    write.timer = m_communicator->timingWheel()->start(::writeTimeout, this, [this, mavId, name]() {
+        this->onWriteTimeout(mavId, name);
+    });
+
+    AbstractLink* link = m_communicator->mavSystemLink(mavId);
+    if (!link) return;
+
+    mavlink_message_t message;
+    this->encodeParamSet(mavId, name, ::encodeValue(write.value, write.type, session.bytewise),
+                         write.type, link, message);
+    m_communicator->sendMessage(message, link);
+}
+
+void ParameterHandler::finishWrite(quint8 mavId, const QString& name, bool confirmed)
+{
+    Impl::Session& session = d->sessions[mavId];
+
+    m_communicator->timingWheel()->stop(session.writes.take(name).timer);
+    if (!confirmed) session.writeFailed.append(name);
+
+    if (session.writes.isEmpty())
+    {
+        d->parameterService->setWriteFinished(session.vehicleId, session.writeFailed);
+        session.writeFailed.clear();
+        return;
+    }
+
+    this->sendWrites(mavId);
+}
+
+void ParameterHandler::sendParamRequestList(quint8 mavId)
+{
+    mavlink_message_t message;
+    mavlink_param_request_list_t request;
+
+    request.target_system = mavId;
+    request.target_component = 0;
+
+    AbstractLink* link = m_communicator->mavSystemLink(mavId);
+    if (!link) return;
+
+    mavlink_msg_param_request_list_encode_chan(m_communicator->systemId(),
+                                               m_communicator->componentId(),
+                                               m_communicator->linkChannel(link),
+                                               &message, &request);
+    m_communicator->sendMessage(message, link);
+}
+
+void ParameterHandler::sendParamRequestRead(quint8 mavId, const QString& name)
+{
+    mavlink_message_t message;
+    mavlink_param_request_read_t request;
+
+    request.target_system = mavId;
+    request.target_component = 0;
+    request.param_index = -1;
+    ::encodeId(name, request.param_id);
+
+    AbstractLink* link = m_communicator->mavSystemLink(mavId);
+    if (!link) return;
+
+    mavlink_msg_param_request_read_encode_chan(m_communicator->systemId(),
+                                               m_communicator->componentId(),
+                                               m_communicator->linkChannel(link),
+                                               &message, &request);
+    m_communicator->sendMessage(message, link);
+}
+
+void ParameterHandler::encodeParamRequestRead(quint8 mavId, int index, AbstractLink* link,
+                                              mavlink_message_t& message)
+{
+    mavlink_param_request_read_t request;
+
+    request.target_system = mavId;
+    request.target_component = 0;
+    request.param_index = index;
+    memset(request.param_id, 0, sizeof(request.param_id));
+
+    mavlink_msg_param_request_read_encode_chan(m_communicator->systemId(),
+                                               m_communicator->componentId(),
+                                               m_communicator->linkChannel(link),
+                                               &message, &request);
+}
+
+void ParameterHandler::encodeParamSet(quint8 mavId, const QString& name, float value, quint8 type,
+                                      AbstractLink* link, mavlink_message_t& message)
+{
+    mavlink_param_set_t setParam;
+
+    setParam.target_system = mavId;
+    setParam.target_component = 0;
+    setParam.param_value = value;
+    setParam.param_type = type;
+    ::encodeId(name, setParam.param_id);
+
+    mavlink_msg_param_set_encode_chan(m_communicator->systemId(),
+                                      m_communicator->componentId(),
+                                      m_communicator->linkChannel(link),
+                                      &message, &setParam);
+}
+
+void ParameterHandler::dropSession(int vehicleId)
+{
+    for (auto it = d->sessions.begin(); it != d->sessions.end(); ++it)
+    {
+        if (it->vehicleId != vehicleId) continue;
+
+        m_communicator->timingWheel()->stop(it->timer);
+        for (const Impl::Write& write: it->writes) m_communicator->timingWheel()->stop(write.timer);
+
+        d->sessions.erase(it);
+        return;
+    }
+}
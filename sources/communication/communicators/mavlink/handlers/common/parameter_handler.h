@@ -0,0 +1,59 @@
+#ifndef PARAMETER_HANDLER_H
+#define PARAMETER_HANDLER_H
+
+// Qt
+#include <QObject>
+#include <QVariantMap>
+
+// Internal
+#include "abstract_mavlink_handler.h"
+
+namespace comm
+{
+    class AbstractLink;
+
+    // Parameter protocol: bulk download with gap re-requests, cache verification
+    // through _HASH_CHECK and windowed PARAM_SET with confirmation of every write
+    class ParameterHandler: public QObject, public AbstractMavLinkHandler
+    {
+        Q_OBJECT
+
+    public:
+        explicit ParameterHandler(MavLinkCommunicator* communicator);
+        ~ParameterHandler() override;
+
+        void processMessage(const mavlink_message_t& message) override;
+
+    public slots:
+        void download(int vehicleId);
+        void write(int vehicleId, const QVariantMap& values);
+
+    private:
+        void processHeartbeat(const mavlink_message_t& message);
+        void processAutopilotVersion(const mavlink_message_t& message);
+        void processParamValue(const mavlink_message_t& message);
+
+        void startSync(quint8 mavId);
+        void startList(quint8 mavId);
+        void onListTimeout(quint8 mavId);
+        void finishList(quint8 mavId);
+
+        void sendWrites(quint8 mavId);
+        void onWriteTimeout(quint8 mavId, const QString& name);
+        void finishWrite(quint8 mavId, const QString& name, bool confirmed);
+
+        void sendParamRequestList(quint8 mavId);
+        void sendParamRequestRead(quint8 mavId, const QString& name);
+        void encodeParamRequestRead(quint8 mavId, int index, AbstractLink* link,
+                                    mavlink_message_t& message);
+        void encodeParamSet(quint8 mavId, const QString& name, float value, quint8 type,
+                            AbstractLink* link, mavlink_message_t& message);
+
+        void dropSession(int vehicleId);
+
+        class Impl;
+        QScopedPointer<Impl> const d;
+    };
+}
+
+#endif // PARAMETER_HANDLER_H
@@ -0,0 +1,233 @@
+#include "stream_rate_handler.h"
+
+// MAVLink
+#include <mavlink.h>
+
+// Qt
+#include <QMap>
+#include <QVector>
+#include <QElapsedTimer>
+#include <QDebug>
+
+// Internal
+#include "service_registry.h"
+#include "telemetry_service.h"
+#include "telemetry.h"
+
+#include "mavlink_communicator.h"
+#include "abstract_link.h"
+
+using namespace comm;
+using namespace domain;
+
+namespace
+{
+    struct Stream
+    {
+        quint8 id; // MAV_DATA_STREAM, for autopilots supporting REQUEST_DATA_STREAM
+        float observedRate;
+        float idleRate;
+        QList<int> messages; // Main messages of the stream, for SET_MESSAGE_INTERVAL
+        Telemetry::TelemetryList nodes; // Telemetry fed by the stream
+    };
+
+    const QList<Stream> streams = {
+        { MAV_DATA_STREAM_EXTENDED_STATUS, 2, 1,
+          { MAVLINK_MSG_ID_SYS_STATUS, MAVLINK_MSG_ID_GPS_RAW_INT,
+            MAVLINK_MSG_ID_NAV_CONTROLLER_OUTPUT },
+          { Telemetry::Satellite, Telemetry::Battery, Telemetry::Navigator,
+            Telemetry::FlightControl } },
+        { MAV_DATA_STREAM_POSITION, 5, 1,
+          { MAVLINK_MSG_ID_GLOBAL_POSITION_INT },
+          { Telemetry::Position } },
+        { MAV_DATA_STREAM_EXTRA1, 10, 2,
+          { MAVLINK_MSG_ID_ATTITUDE },
+          { Telemetry::Ahrs } },
+        { MAV_DATA_STREAM_EXTRA2, 5, 1,
+          { MAVLINK_MSG_ID_VFR_HUD },
+          { Telemetry::Pitot, Telemetry::Barometric, Telemetry::PowerSystem } },
+        { MAV_DATA_STREAM_RAW_SENSORS, 2, 1,
+          { MAVLINK_MSG_ID_SCALED_IMU, MAVLINK_MSG_ID_SCALED_PRESSURE },
+          { Telemetry::Barometric } },
+        { MAV_DATA_STREAM_EXTRA3, 2, 1,
+          { MAVLINK_MSG_ID_WIND, MAVLINK_MSG_ID_VIBRATION },
+          { Telemetry::Wind } }
+    };
+
+    const float inboundShare = 0.5; // Half duplex radios share bandwidth with uplink
+    const float headroom = 0.8;
+    const float minScale = 0.1;
+    const float increase = 0.1;
+    const float decrease = 0.7;
+
+    const int txbufLow = 50;
+    const int txbufHigh = 90;
+    const int radioTimeout = 3000;
+    const int refreshTicks = 10; // Rates are resent periodically, autopilot may reboot
+
+    bool isObserved(Telemetry* root, const Telemetry::TelemetryList& ids)
+    {
+        if (!root) return false;
+
+        for (Telemetry* child: root->childNodes())
+        {
+            if (ids.contains(child->id()) && child->isObserved()) return true;
+        }
+        return false;
+    }
+}
+
+class StreamRateHandler::Impl
+{
+public:
+    TelemetryService* telemetryService = serviceRegistry->telemetryService();
+
+    struct LinkControl
+    {
+        float scale = 1;
+        int ticks = 0;
+
+        qint64 radioSeen = -1;
+        int txbuf = 100;
+        quint16 rxErrors = 0;
+        bool crowded = false; // Radio reported receive errors since last tick
+    };
+
+    QMap<AbstractLink*, LinkControl> links;
+    QMap<quint8, quint8> autopilots; // mavId -> MAV_AUTOPILOT
+    QMap<QPair<quint8, AbstractLink*>, QVector<int> > sentRates; // Rate per stream, by port
+
+    QElapsedTimer clock;
+};
+
+StreamRateHandler::StreamRateHandler(MavLinkCommunicator* communicator):
+    QObject(communicator),
+    AbstractMavLinkHandler(communicator),
+    d(new Impl())
+{
+    d->clock.start();
+
+    connect(communicator, &AbstractCommunicator::linkStatisticsChanged,
+            this, &StreamRateHandler::onLinkStatisticsChanged);
+    connect(communicator, &AbstractCommunicator::linkRemoved,
+            this, &StreamRateHandler::onLinkRemoved);
+}
+
+StreamRateHandler::~StreamRateHandler()
+{}
+
+void StreamRateHandler::processMessage(const mavlink_message_t& message)
+{
+    if (message.msgid == MAVLINK_MSG_ID_HEARTBEAT)
+    {
+        if (message.sysid == m_communicator->systemId() ||
+            message.compid != MAV_COMP_ID_AUTOPILOT1) return;
+
+        d->autopilots[message.sysid] = mavlink_msg_heartbeat_get_autopilot(&message);
+    }
+    else if (message.msgid == MAVLINK_MSG_ID_RADIO_STATUS)
+    {
+        AbstractLink* link = m_communicator->lastReceivedLink();
+        if (!link) return;
+
+        mavlink_radio_status_t radio;
+        mavlink_msg_radio_status_decode(&message, &radio);
+
+        Impl::LinkControl& control = d->links[link];
+        if (control.radioSeen > -1 && radio.rxerrors != control.rxErrors) control.crowded = true;
+
+        control.radioSeen = d->clock.elapsed();
+        control.txbuf = radio.txbuf;
+        control.rxErrors = radio.rxerrors;
+    }
+}
+
+void StreamRateHandler::onLinkStatisticsChanged(AbstractLink* link, int bytesReceived,
+                                                int bytesSent)
+{
+    Q_UNUSED(bytesSent)
+
+    Impl::LinkControl& control = d->links[link];
+
+    int budget = link->bandwidth() * ::inboundShare;
+    bool radio = control.radioSeen > -1 &&
+                 d->clock.elapsed() - control.radioSeen < ::radioTimeout;
+
+    bool overloaded = (budget > 0 && bytesReceived > budget) ||
+                      (radio && (control.txbuf < ::txbufLow || control.crowded));
+    bool spare = (budget == 0 || bytesReceived < budget * ::headroom) &&
+                 (!radio || control.txbuf > ::txbufHigh);
+
+    if (overloaded) control.scale = qMax(::minScale, control.scale * ::decrease);
+    else if (spare) control.scale = qMin(1.0f, control.scale + ::increase);
+
+    control.crowded = false;
+
+    bool refresh = ++control.ticks >= ::refreshTicks;
+    if (refresh) control.ticks = 0;
+
+    for (quint8 mavId: m_communicator->linkMavSystems(link))
+    {
+        this->applyRates(mavId, link, control.scale, refresh);
+    }
+}
+
+void StreamRateHandler::onLinkRemoved(AbstractLink* link)
+{
+    d->links.remove(link);
+
+    for (auto it = d->sentRates.begin(); it != d->sentRates.end();)
+    {
+        if (it.key().second == link) it = d->sentRates.erase(it);
+        else ++it;
+    }
+}
+
+void StreamRateHandler::applyRates(quint8 mavId, AbstractLink* link, float scale, bool refresh)
+{
+    if (!d->autopilots.contains(mavId)) return;
+
+    bool dataStreams = d->autopilots[mavId] == MAV_AUTOPILOT_ARDUPILOTMEGA;
+    Telemetry* node = d->telemetryService->mavNode(mavId);
+
+    QVector<int>& sent = d->sentRates[qMakePair(mavId, link)];
+    if (sent.count() != ::streams.count() || refresh) sent.fill(0, ::streams.count());
+
+    QList<mavlink_message_t> messages;
+    for (int i = 0; i < ::streams.count(); ++i)
+    {
+        const Stream& stream = ::streams.at(i);
+
+        float rate = ::isObserved(node, stream.nodes) ? stream.observedRate * scale :
+                                                        stream.idleRate * scale * scale;
+        int hz = qMax(1, qRound(rate));
+        if (sent.at(i) == hz) continue;
+
+        sent[i] = hz;
+
+        mavlink_message_t message;
+        if (dataStreams)
+        {
+            mavlink_msg_request_data_stream_pack_chan(m_communicator->systemId(),
+                                                      m_communicator->componentId(),
+                                                      m_communicator->linkChannel(link),
+                                                      &message, mavId, MAV_COMP_ID_AUTOPILOT1,
+                                                      stream.id, hz, 1);
+            messages.append(message);
+            continue;
+        }
+
+        for (int messageId: stream.messages)
+        {
+            mavlink_msg_command_long_pack_chan(m_communicator->systemId(),
+                                               m_communicator->componentId(),
+                                               m_communicator->linkChannel(link),
+                                               &message, mavId, MAV_COMP_ID_AUTOPILOT1,
+                                               MAV_CMD_SET_MESSAGE_INTERVAL, 0,
+                                               messageId, 1000000 / hz, 0, 0, 0, 0, 0);
+            messages.append(message);
+        }
+    }
+
+    if (!messages.isEmpty()) m_communicator->sendMessages(messages, link);
+}
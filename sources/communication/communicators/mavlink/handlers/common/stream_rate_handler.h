@@ -0,0 +1,40 @@
+#ifndef STREAM_RATE_HANDLER_H
+#define STREAM_RATE_HANDLER_H
+
+// Qt
+#include <QObject>
+
+// Internal
+#include "abstract_mavlink_handler.h"
+
+namespace comm
+{
+    class AbstractLink;
+
+    // Fits vehicle stream rates to link capacity. Each second inbound bytes are compared
+    // with link budget and RADIO_STATUS congestion, rate scale of the link is adjusted
+    // additively up and multiplicatively down. Streams feeding observed telemetry keep
+    // their rates longer, unobserved ones degrade first
+    class StreamRateHandler: public QObject, public AbstractMavLinkHandler
+    {
+        Q_OBJECT
+
+    public:
+        explicit StreamRateHandler(MavLinkCommunicator* communicator);
+        ~StreamRateHandler() override;
+
+        void processMessage(const mavlink_message_t& message) override;
+
+    private slots:
+        void onLinkStatisticsChanged(AbstractLink* link, int bytesReceived, int bytesSent);
+        void onLinkRemoved(AbstractLink* link);
+
+    private:
+        void applyRates(quint8 mavId, AbstractLink* link, float scale, bool refresh);
+
+        class Impl;
+        QScopedPointer<Impl> const d;
+    };
+}
+
+#endif // STREAM_RATE_HANDLER_H
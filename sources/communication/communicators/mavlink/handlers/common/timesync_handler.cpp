@@ -0,0 +1,241 @@
+#include "timesync_handler.h"
+
+// MAVLink
+#include <mavlink.h>
+
+// Qt
+#include <QMap>
+#include <QVector>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QTimerEvent>
+#include <QDebug>
+
+// Internal
+#include "service_registry.h"
+#include "telemetry_service.h"
+#include "telemetry_portion.h"
+
+#include "mavlink_communicator.h"
+
+// Std
+#include <algorithm>
+
+using namespace comm;
+using namespace domain;
+
+namespace
+{
+    const int probeInterval = 1000;
+    const int sampleCount = 32;
+    const int probesKept = 8; // Late replies to older probes still count
+    const qint64 maxRoundTrip = 5000000000; // ns
+    const qint64 resyncThreshold = 1000000000; // Vehicle clock jumped, e.g. reboot
+
+    const double offsetGain = 0.2;
+    const double driftGain = 0.1;
+
+    // Last round trips, us
+    class RoundTrips
+    {
+    public:
+        void add(int roundTrip)
+        {
+            if (m_samples.count() < ::sampleCount) m_samples.append(roundTrip);
+            else m_samples[m_next] = roundTrip;
+
+            m_next = (m_next + 1) % ::sampleCount;
+        }
+
+        int percentile(int percent) const
+        {
+            if (m_samples.isEmpty()) return 0;
+
+            QVector<int> sorted = m_samples;
+            std::sort(sorted.begin(), sorted.end());
+            return sorted.at((sorted.count() - 1) * percent / 100);
+        }
+
+        int count() const
+        {
+            return m_samples.count();
+        }
+
+    private:
+        QVector<int> m_samples;
+        int m_next = 0;
+    };
+
+    int toMs(int us)
+    {
+        return qRound(us / 1000.0);
+    }
+}
+
+class TimesyncHandler::Impl
+{
+public:
+    TelemetryService* telemetryService = serviceRegistry->telemetryService();
+
+    struct LinkProbe
+    {
+        RoundTrips roundTrips;
+        QList<qint64> probes; // ts1 of probes sent
+    };
+
+    struct Sync
+    {
+        RoundTrips roundTrips;
+        bool synced = false;
+        double offset = 0; // Vehicle time minus local one, ns
+        double drift = 0; // ppm
+        qint64 offsetTime = 0;
+    };
+
+    QMap<AbstractLink*, LinkProbe> links;
+    QMap<QPair<AbstractLink*, quint8>, Sync> syncs;
+
+    QElapsedTimer clock;
+    qint64 epoch = 0; // Wall time of clock start, ns
+    int timer = 0;
+
+    // Wall clock with monotonic resolution
+    qint64 now() const
+    {
+        return epoch + clock.nsecsElapsed();
+    }
+
+    void updateOffset(Sync& sync, qint64 sample, qint64 time)
+    {
+        double predicted = sync.offset + sync.drift * 1e-6 * (time - sync.offsetTime);
+        if (!sync.synced || qAbs(sample - predicted) > ::resyncThreshold)
+        {
+            sync.synced = true;
+            sync.offset = sample;
+            sync.drift = 0;
+            sync.offsetTime = time;
+            return;
+        }
+
+        double offset = predicted + ::offsetGain * (sample - predicted);
+        if (time > sync.offsetTime)
+        {
+            double drift = (offset - sync.offset) * 1e6 / (time - sync.offsetTime);
+            sync.drift += ::driftGain * (drift - sync.drift);
+        }
+
+        sync.offset = offset;
+        sync.offsetTime = time;
+    }
+};
+
+TimesyncHandler::TimesyncHandler(MavLinkCommunicator* communicator):
+    QObject(communicator),
+    AbstractMavLinkHandler(communicator),
+    d(new Impl())
+{
+    d->clock.start();
+    d->epoch = QDateTime::currentMSecsSinceEpoch() * 1000000;
+    d->timer = this->startTimer(::probeInterval);
+
+    connect(communicator, &AbstractCommunicator::linkRemoved,
+            this, &TimesyncHandler::onLinkRemoved);
+}
+
+TimesyncHandler::~TimesyncHandler()
+{}
+
+void TimesyncHandler::processMessage(const mavlink_message_t& message)
+{
+    if (message.msgid != MAVLINK_MSG_ID_TIMESYNC) return;
+
+    AbstractLink* link = m_communicator->lastReceivedLink();
+    if (!link) return;
+
+    mavlink_timesync_t timesync;
+    mavlink_msg_timesync_decode(&message, &timesync);
+
+    qint64 now = d->now();
+
+    if (timesync.tc1 == 0) // Request from vehicle, answer with our time
+    {
+        mavlink_message_t reply;
+        mavlink_msg_timesync_pack_chan(m_communicator->systemId(),
+                                       m_communicator->componentId(),
+                                       m_communicator->linkChannel(link),
+                                       &reply, now, timesync.ts1);
+        m_communicator->sendMessage(reply, link);
+        return;
+    }
+
+    Impl::LinkProbe& probe = d->links[link];
+    if (!probe.probes.contains(timesync.ts1)) return;
+
+    qint64 roundTrip = now - timesync.ts1;
+    if (roundTrip < 0 || roundTrip > ::maxRoundTrip) return;
+
+    int roundTripUs = roundTrip / 1000;
+    probe.roundTrips.add(roundTripUs);
+
+    Impl::Sync& sync = d->syncs[qMakePair(link, message.sysid)];
+    sync.roundTrips.add(roundTripUs);
+
+    // Asymmetric delay of slow exchanges spoils offset, take only ones near median
+    if (sync.roundTrips.count() < 4 || roundTripUs <= 2 * sync.roundTrips.percentile(50))
+    {
+        d->updateOffset(sync, timesync.tc1 - (timesync.ts1 + now) / 2, now);
+    }
+
+    if (m_communicator->mavSystemLink(message.sysid) != link) return;
+
+    TelemetryPortion portion(d->telemetryService->mavNode(message.sysid));
+    portion.setParameter({ Telemetry::Timesync, Telemetry::RoundTrip },
+                         ::toMs(sync.roundTrips.percentile(50)));
+    portion.setParameter({ Telemetry::Timesync, Telemetry::RoundTripP95 },
+                         ::toMs(sync.roundTrips.percentile(95)));
+    portion.setParameter({ Telemetry::Timesync, Telemetry::ClockOffset }, sync.offset / 1e6);
+    portion.setParameter({ Telemetry::Timesync, Telemetry::ClockDrift }, sync.drift);
+}
+
+void TimesyncHandler::probe()
+{
+    for (AbstractLink* link: m_communicator->links())
+    {
+        Impl::LinkProbe& probe = d->links[link];
+
+        if (probe.roundTrips.count())
+        {
+            m_communicator->setLinkLatency(link, ::toMs(probe.roundTrips.percentile(50)),
+                                           ::toMs(probe.roundTrips.percentile(95)));
+        }
+
+        qint64 ts1 = d->now();
+        probe.probes.append(ts1);
+        while (probe.probes.count() > ::probesKept) probe.probes.removeFirst();
+
+        mavlink_message_t message;
+        mavlink_msg_timesync_pack_chan(m_communicator->systemId(),
+                                       m_communicator->componentId(),
+                                       m_communicator->linkChannel(link),
+                                       &message, 0, ts1);
+        m_communicator->sendMessage(message, link);
+    }
+}
+
+void TimesyncHandler::timerEvent(QTimerEvent* event)
+{
+    if (event->timerId() != d->timer) return QObject::timerEvent(event);
+
+    this->probe();
+}
+
+void TimesyncHandler::onLinkRemoved(AbstractLink* link)
+{
+    d->links.remove(link);
+
+    for (auto it = d->syncs.begin(); it != d->syncs.end();)
+    {
+        if (it.key().first == link) it = d->syncs.erase(it);
+        else ++it;
+    }
+}
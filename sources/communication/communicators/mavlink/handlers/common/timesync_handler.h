@@ -0,0 +1,42 @@
+#ifndef TIMESYNC_HANDLER_H
+#define TIMESYNC_HANDLER_H
+
+// Qt
+#include <QObject>
+
+// Internal
+#include "abstract_mavlink_handler.h"
+
+namespace comm
+{
+    class AbstractLink;
+
+    // Probes every link with TIMESYNC each second and answers vehicle's own requests.
+    // Round trips give link latency percentiles, echoed vehicle time gives clock offset,
+    // filtered against outliers, and its drift
+    class TimesyncHandler: public QObject, public AbstractMavLinkHandler
+    {
+        Q_OBJECT
+
+    public:
+        explicit TimesyncHandler(MavLinkCommunicator* communicator);
+        ~TimesyncHandler() override;
+
+        void processMessage(const mavlink_message_t& message) override;
+
+    public slots:
+        void probe();
+
+    protected:
+        void timerEvent(QTimerEvent* event) override;
+
+    private slots:
+        void onLinkRemoved(AbstractLink* link);
+
+    private:
+        class Impl;
+        QScopedPointer<Impl> const d;
+    };
+}
+
+#endif // TIMESYNC_HANDLER_H
@@ -0,0 +1,531 @@
+#include "ftp_handler.h"
+
+// MAVLink
+#include <mavlink.h>
+
+// Qt
+#include <QMap>
+#include <QFile>
+#include <QElapsedTimer>
+#include <QSharedPointer>
+#include <QtEndian>
+#include <QCoreApplication>
+#include <QDebug>
+
+// Internal
+#include "service_registry.h"
+#include "vehicle_service.h"
+#include "file_transfer_service.h"
+
+#include "mavlink_communicator.h"
+#include "timing_wheel.h"
+
+using namespace comm;
+using namespace domain;
+
+namespace
+{
+    enum Opcode: quint8
+    {
+        None = 0,
+        TerminateSession = 1,
+        ListDirectory = 3,
+        OpenFileRO = 4,
+        ReadFile = 5,
+        BurstReadFile = 15,
+        Ack = 128,
+        Nak = 129
+    };
+
+    enum NakError: quint8
+    {
+        NoError = 0,
+        Fail = 1,
+        FailErrno = 2,
+        InvalidDataSize = 3,
+        InvalidSession = 4,
+        NoSessionsAvailable = 5,
+        EndOfFile = 6,
+        UnknownCommand = 7,
+        FileExists = 8,
+        FileProtected = 9,
+        FileNotFound = 10
+    };
+
+    const int headerSize = 12;
+    const int maxDataSize = MAVLINK_MSG_FILE_TRANSFER_PROTOCOL_FIELD_PAYLOAD_LEN - headerSize;
+
+    const int requestTimeout = 1000;
+    const int maxRetries = 5;
+    const int progressInterval = 250;
+
+    struct Packet
+    {
+        quint16 seq = 0;
+        quint8 session = 0;
+        quint8 opcode = None;
+        quint8 reqOpcode = None;
+        bool burstComplete = false;
+        quint32 offset = 0;
+        QByteArray data;
+        int size = -1; // Header size field, bytes asked by read requests, data size if -1
+    };
+
+    void pack(const Packet& packet, uint8_t* payload)
+    {
+        memset(payload, 0, MAVLINK_MSG_FILE_TRANSFER_PROTOCOL_FIELD_PAYLOAD_LEN);
+
+        int size = qMin(packet.data.size(), ::maxDataSize);
+        qToLittleEndian<quint16>(packet.seq, payload);
+        payload[2] = packet.session;
+        payload[3] = packet.opcode;
+        payload[4] = packet.size > -1 ? qMin(packet.size, ::maxDataSize) : size;
+        payload[5] = packet.reqOpcode;
+        payload[6] = packet.burstComplete;
+        qToLittleEndian<quint32>(packet.offset, payload + 8);
+        memcpy(payload + ::headerSize, packet.data.constData(), size);
+    }
+
+    Packet unpack(const uint8_t* payload)
+    {
+        Packet packet;
+        packet.seq = qFromLittleEndian<quint16>(payload);
+        packet.session = payload[2];
+        packet.opcode = payload[3];
+        packet.reqOpcode = payload[5];
+        packet.burstComplete = payload[6];
+        packet.offset = qFromLittleEndian<quint32>(payload + 8);
+        packet.data = QByteArray(reinterpret_cast<const char*>(payload + ::headerSize),
+                                 qMin<int>(payload[4], ::maxDataSize));
+        return packet;
+    }
+
+    QString nakError(const Packet& packet)
+    {
+        switch (packet.data.isEmpty() ? Fail : quint8(packet.data.at(0)))
+        {
+        case FailErrno:
+            return qApp->translate("FtpHandler", "error %1")
+                    .arg(packet.data.size() > 1 ? quint8(packet.data.at(1)) : 0);
+        case InvalidDataSize: return qApp->translate("FtpHandler", "invalid data size");
+        case InvalidSession: return qApp->translate("FtpHandler", "invalid session");
+        case NoSessionsAvailable: return qApp->translate("FtpHandler", "no sessions available");
+        case UnknownCommand: return qApp->translate("FtpHandler", "unsupported");
+        case FileProtected: return qApp->translate("FtpHandler", "file is protected");
+        case FileNotFound: return qApp->translate("FtpHandler", "file not found");
+        case Fail:
+        default: return qApp->translate("FtpHandler", "failed");
+        }
+    }
+
+    bool isEndOfFile(const Packet& packet)
+    {
+        return packet.opcode == Nak && !packet.data.isEmpty() && packet.data.at(0) == EndOfFile;
+    }
+}
+
+class FtpHandler::Impl
+{
+public:
+    VehicleService* vehicleService = serviceRegistry->vehicleService();
+    FileTransferService* service = serviceRegistry->fileTransferService();
+
+    struct Operation
+    {
+        bool listing = false;
+        int vehicleId = 0;
+        quint8 component = 0;
+        QString path;
+
+        Packet request; // Last request, repeated as is when reply is lost
+        quint16 lastSeq = 0;
+        int timer = 0;
+        int retries = 0;
+
+        quint8 session = 0;
+        bool opened = false;
+
+        RemoteFileList files;
+
+        QFile file;
+        quint32 size = 0;
+        quint32 burstOffset = 0; // Next byte expected from burst
+        QList<QPair<quint32, quint32> > gaps; // Missed by burst, [begin, end)
+        bool bursting = false;
+
+        quint32 received = 0;
+        QElapsedTimer clock;
+        qint64 lastProgress = 0;
+    };
+    using OperationPtr = QSharedPointer<Operation>;
+
+    QMap<quint8, OperationPtr> operations; // By vehicle mavId
+
+    FtpHandler* q;
+    MavLinkCommunicator* communicator;
+
+    void transmit(quint8 mavId, const OperationPtr& operation, const Packet& packet)
+    {
+        AbstractLink* link = communicator->mavSystemLink(mavId);
+        if (!link) return;
+
+        mavlink_file_transfer_protocol_t ftp;
+        ftp.target_network = 0;
+        ftp.target_system = mavId;
+        ftp.target_component = operation->component;
+        ::pack(packet, ftp.payload);
+
+        mavlink_message_t message;
+        mavlink_msg_file_transfer_protocol_encode_chan(communicator->systemId(),
+                                                       communicator->componentId(),
+                                                       communicator->linkChannel(link),
+                                                       &message, &ftp);
+        communicator->sendBulkMessage(message, link);
+    }
+
+    void sendRequest(quint8 mavId, const OperationPtr& operation, quint8 opcode,
+                     quint32 offset = 0, const QByteArray& data = QByteArray(), int size = -1)
+    {
+        Packet& request = operation->request;
+        request = Packet();
+        request.seq = ++operation->lastSeq;
+        request.session = operation->session;
+        request.opcode = opcode;
+        request.offset = offset;
+        request.data = data;
+        request.size = size;
+
+        this->transmit(mavId, operation, request);
+        this->armTimer(mavId, operation);
+    }
+
+    void armTimer(quint8 mavId, const OperationPtr& operation)
+    {
+        // Slow links get more time, measured by TIMESYNC probes
+        int timeout = qMax(::requestTimeout,
+                           2 * communicator->linkRoundTrip(communicator->mavSystemLink(mavId)));
+
+        communicator->timingWheel()->stop(operation->timer);
+        operation->timer = communicator->timingWheel()->start(timeout, q, [this, mavId]() {
+            this->onTimeout(mavId);
+        });
+    }
+
+    void onTimeout(quint8 mavId)
+    {
+        OperationPtr operation = operations.value(mavId);
+        if (operation.isNull()) return;
+
+        operation->timer = 0;
+        if (++operation->retries > ::maxRetries)
+        {
+            return this->finish(mavId, false, qApp->translate("FtpHandler", "no response"));
+        }
+
+        // Stalled burst is restarted from the first byte not received yet
+        if (operation->bursting)
+        {
+            operation->bursting = false;
+            return this->next(mavId, operation);
+        }
+
+        this->transmit(mavId, operation, operation->request);
+        this->armTimer(mavId, operation);
+    }
+
+    void processReply(quint8 mavId, const OperationPtr& operation, const Packet& reply)
+    {
+        switch (operation->request.opcode)
+        {
+        case ListDirectory:
+            if (reply.opcode == Ack) return this->processEntries(mavId, operation, reply);
+            return this->finish(mavId, ::isEndOfFile(reply), ::nakError(reply));
+        case OpenFileRO:
+            if (reply.opcode == Nak) return this->finish(mavId, false, ::nakError(reply));
+
+            operation->session = reply.session;
+            operation->opened = true;
+            operation->size = reply.data.size() >= 4 ?
+                                  qFromLittleEndian<quint32>(reply.data.constData()) : 0;
+
+            if (operation->burstOffset > operation->size) // Remote file shrank, nothing to resume
+            {
+                operation->file.resize(0);
+                operation->burstOffset = 0;
+            }
+            return this->next(mavId, operation);
+        case ReadFile:
+            if (reply.opcode == Ack && !reply.data.isEmpty())
+            {
+                if (!this->write(operation, reply.offset, reply.data))
+                {
+                    return this->finish(mavId, false, operation->file.errorString());
+                }
+
+                QPair<quint32, quint32>& gap = operation->gaps.first();
+                gap.first = reply.offset + reply.data.size();
+                if (gap.first >= gap.second) operation->gaps.removeFirst();
+            }
+            else if (::isEndOfFile(reply) || reply.opcode == Ack)
+            {
+                operation->gaps.removeFirst();
+            }
+            else return this->finish(mavId, false, ::nakError(reply));
+
+            return this->next(mavId, operation);
+        default:
+            break;
+        }
+    }
+
+    void processBurst(quint8 mavId, const OperationPtr& operation, const Packet& packet)
+    {
+        if (packet.opcode == Nak && !::isEndOfFile(packet))
+        {
+            return this->finish(mavId, false, ::nakError(packet));
+        }
+
+        if (packet.opcode == Ack && !packet.data.isEmpty())
+        {
+            if (packet.offset > operation->burstOffset)
+            {
+                operation->gaps.append(qMakePair(operation->burstOffset, packet.offset));
+            }
+            if (packet.offset + packet.data.size() > operation->burstOffset)
+            {
+                if (!this->write(operation, packet.offset, packet.data))
+                {
+                    return this->finish(mavId, false, operation->file.errorString());
+                }
+                operation->burstOffset = packet.offset + packet.data.size();
+            }
+        }
+
+        if (packet.burstComplete || ::isEndOfFile(packet) ||
+            operation->burstOffset >= operation->size)
+        {
+            operation->bursting = false;
+            if (::isEndOfFile(packet)) operation->size = qMin(operation->size,
+                                                              operation->burstOffset);
+            return this->next(mavId, operation);
+        }
+
+        this->armTimer(mavId, operation);
+    }
+
+    void processEntries(quint8 mavId, const OperationPtr& operation, const Packet& reply)
+    {
+        QList<QByteArray> entries = reply.data.split('\0');
+        int count = 0;
+        for (const QByteArray& entry: entries)
+        {
+            if (entry.isEmpty()) continue;
+            count++;
+
+            RemoteFile file;
+            QList<QByteArray> fields = entry.mid(1).split('\t');
+            file.name = QString::fromUtf8(fields.value(0));
+            file.size = fields.value(1).toUInt();
+
+            if (entry.at(0) == 'D') file.directory = true;
+            else if (entry.at(0) != 'F') continue; // Skipped entry still takes its index
+
+            if (file.name != "." && file.name != "..") operation->files.append(file);
+        }
+
+        if (count == 0) return this->finish(mavId, true);
+
+        this->sendRequest(mavId, operation, ListDirectory, operation->request.offset + count,
+                          operation->path.toUtf8());
+    }
+
+    void next(quint8 mavId, const OperationPtr& operation)
+    {
+        // Late burst packets must not drive requests in parallel with this one
+        operation->bursting = false;
+
+        if (!operation->gaps.isEmpty())
+        {
+            // Read length goes in header size field, request itself carries no data
+            const QPair<quint32, quint32>& gap = operation->gaps.first();
+            return this->sendRequest(mavId, operation, ReadFile, gap.first, QByteArray(),
+                                     qMin<quint32>(gap.second - gap.first, ::maxDataSize));
+        }
+
+        if (operation->burstOffset < operation->size)
+        {
+            operation->bursting = true;
+            return this->sendRequest(mavId, operation, BurstReadFile, operation->burstOffset,
+                                     QByteArray(), ::maxDataSize);
+        }
+
+        this->finish(mavId, true);
+    }
+
+    bool write(const OperationPtr& operation, quint32 offset, const QByteArray& data)
+    {
+        // Disk full or gone, going on would report success for a file with holes
+        if (!operation->file.seek(offset) ||
+            operation->file.write(data) != data.size()) return false;
+
+        operation->received += data.size();
+        operation->retries = 0;
+
+        qint64 elapsed = operation->clock.elapsed();
+        if (elapsed - operation->lastProgress < ::progressInterval) return true;
+
+        operation->lastProgress = elapsed;
+        service->setTransferProgress(operation->vehicleId, operation->path,
+                                     operation->burstOffset, operation->size,
+                                     this->throughput(operation));
+        return true;
+    }
+
+    int throughput(const OperationPtr& operation) const
+    {
+        qint64 elapsed = operation->clock.elapsed();
+        return elapsed > 0 ? operation->received * 1000 / elapsed : 0;
+    }
+
+    void finish(quint8 mavId, bool success, const QString& error = QString())
+    {
+        OperationPtr operation = operations.take(mavId);
+        if (operation.isNull()) return;
+
+        communicator->timingWheel()->stop(operation->timer);
+
+        // Server session is closed without waiting, lost terminate only leaks until reset
+        if (operation->opened)
+        {
+            Packet terminate;
+            terminate.seq = ++operation->lastSeq;
+            terminate.session = operation->session;
+            terminate.opcode = TerminateSession;
+            this->transmit(mavId, operation, terminate);
+        }
+
+        if (operation->listing)
+        {
+            service->setDirectoryListed(operation->vehicleId, operation->path,
+                                        operation->files, success);
+            return;
+        }
+
+        // Gaps live only in memory, so partial file keeps just its contiguous head,
+        // otherwise resume from file size would leave zero filled holes behind
+        if (!success)
+        {
+            quint32 complete = operation->burstOffset;
+            for (const QPair<quint32, quint32>& gap: operation->gaps)
+            {
+                complete = qMin(complete, gap.first);
+            }
+            if (operation->file.size() > complete) operation->file.resize(complete);
+        }
+
+        operation->file.close();
+        if (success)
+        {
+            service->setTransferProgress(operation->vehicleId, operation->path, operation->size,
+                                         operation->size, this->throughput(operation));
+        }
+        service->setTransferFinished(operation->vehicleId, operation->path, success, error);
+    }
+};
+
+FtpHandler::FtpHandler(MavLinkCommunicator* communicator):
+    QObject(communicator),
+    AbstractMavLinkHandler(communicator),
+    d(new Impl())
+{
+    d->q = this;
+    d->communicator = communicator;
+
+    connect(d->service, &FileTransferService::listRequested, this, &FtpHandler::listDirectory);
+    connect(d->service, &FileTransferService::downloadRequested, this, &FtpHandler::download);
+    connect(d->service, &FileTransferService::cancelRequested, this, &FtpHandler::cancel);
+}
+
+FtpHandler::~FtpHandler()
+{}
+
+void FtpHandler::processMessage(const mavlink_message_t& message)
+{
+    if (message.msgid != MAVLINK_MSG_ID_FILE_TRANSFER_PROTOCOL) return;
+
+    Impl::OperationPtr operation = d->operations.value(message.sysid);
+    if (operation.isNull() || message.compid != operation->component) return;
+
+    mavlink_file_transfer_protocol_t ftp;
+    mavlink_msg_file_transfer_protocol_decode(&message, &ftp);
+    if (ftp.target_system != m_communicator->systemId()) return;
+
+    Packet packet = ::unpack(ftp.payload);
+    if (packet.opcode != Ack && packet.opcode != Nak) return;
+
+    // Burst packets carry their own sequence, lost ones are found by offsets
+    if (operation->bursting && packet.reqOpcode == BurstReadFile)
+    {
+        return d->processBurst(message.sysid, operation, packet);
+    }
+
+    if (packet.seq != quint16(operation->request.seq + 1) ||
+        packet.reqOpcode != operation->request.opcode) return;
+
+    m_communicator->timingWheel()->stop(operation->timer);
+    operation->timer = 0;
+    operation->retries = 0;
+
+    d->processReply(message.sysid, operation, packet);
+}
+
+void FtpHandler::listDirectory(int vehicleId, const QString& path, int component)
+{
+    int mavId = d->vehicleService->mavIdByVehicleId(vehicleId);
+    if (mavId < 1) return;
+
+    if (d->operations.contains(mavId)) d->finish(mavId, false, tr("canceled"));
+
+    Impl::OperationPtr operation = Impl::OperationPtr::create();
+    operation->listing = true;
+    operation->vehicleId = vehicleId;
+    operation->component = component ? component : MAV_COMP_ID_AUTOPILOT1;
+    operation->path = path;
+    d->operations[mavId] = operation;
+
+    d->sendRequest(mavId, operation, ListDirectory, 0, path.toUtf8());
+}
+
+void FtpHandler::download(int vehicleId, const QString& path, const QString& fileName,
+                          bool resume, int component)
+{
+    int mavId = d->vehicleService->mavIdByVehicleId(vehicleId);
+    if (mavId < 1) return;
+
+    if (d->operations.contains(mavId)) d->finish(mavId, false, tr("canceled"));
+
+    Impl::OperationPtr operation = Impl::OperationPtr::create();
+    operation->vehicleId = vehicleId;
+    operation->component = component ? component : MAV_COMP_ID_AUTOPILOT1;
+    operation->path = path;
+    operation->file.setFileName(fileName);
+
+    bool resumed = resume && operation->file.exists();
+    if (!operation->file.open(resumed ? QIODevice::ReadWrite : QIODevice::WriteOnly))
+    {
+        d->service->setTransferFinished(vehicleId, path, false, operation->file.errorString());
+        return;
+    }
+
+    operation->burstOffset = resumed ? operation->file.size() : 0;
+    operation->clock.start();
+    d->operations[mavId] = operation;
+
+    d->sendRequest(mavId, operation, OpenFileRO, 0, path.toUtf8());
+}
+
+void FtpHandler::cancel(int vehicleId)
+{
+    int mavId = d->vehicleService->mavIdByVehicleId(vehicleId);
+    if (d->operations.contains(mavId)) d->finish(mavId, false, tr("canceled"));
+}
@@ -0,0 +1,37 @@
+#ifndef FTP_HANDLER_H
+#define FTP_HANDLER_H
+
+// Qt
+#include <QObject>
+
+// Internal
+#include "abstract_mavlink_handler.h"
+
+namespace comm
+{
+    // MAVLink FTP client, one operation per vehicle at a time. Files are read with
+    // burst sessions, gaps left by lost packets are filled with single reads afterwards.
+    // Requests go as bulk traffic, so they yield link to regular messages
+    class FtpHandler: public QObject, public AbstractMavLinkHandler
+    {
+        Q_OBJECT
+
+    public:
+        explicit FtpHandler(MavLinkCommunicator* communicator);
+        ~FtpHandler() override;
+
+        void processMessage(const mavlink_message_t& message) override;
+
+    public slots:
+        void listDirectory(int vehicleId, const QString& path, int component);
+        void download(int vehicleId, const QString& path, const QString& fileName,
+                      bool resume, int component);
+        void cancel(int vehicleId);
+
+    private:
+        class Impl;
+        QScopedPointer<Impl> const d;
+    };
+}
+
+#endif // FTP_HANDLER_H
@@ -5,7 +5,6 @@
 
 // Qt
 #include <QMap>
-#include <QTimerEvent>
 #include <QCoreApplication>
 #include <QDebug>
 
@@ -16,6 +15,9 @@
 #include "mission_assignment.h"
 
 #include "mavlink_communicator.h"
+#include "mission_item_convertor.h"
+#include "mavlink_protocol_helpers.h"
+#include "mission_transfer_session.h"
 
 #include "service_registry.h"
 #include "command_service.h"
@@ -29,34 +31,6 @@
 
 namespace
 {
-    const int interval = 2000;
-
-    const QMap<quint16, dto::MissionItem::Command> mavCommandLongMap =
-    {
-        { MAV_CMD_NAV_TAKEOFF, dto::MissionItem::Takeoff },
-        { MAV_CMD_NAV_LAND, dto::MissionItem::Landing },
-        { MAV_CMD_NAV_WAYPOINT, dto::MissionItem::Waypoint },
-        { MAV_CMD_NAV_LOITER_UNLIM, dto::MissionItem::LoiterUnlim },
-        { MAV_CMD_NAV_LOITER_TO_ALT, dto::MissionItem::LoiterAltitude },
-        { MAV_CMD_NAV_LOITER_TURNS, dto::MissionItem::LoiterTurns },
-        { MAV_CMD_NAV_LOITER_TIME, dto::MissionItem::LoiterTime },
-        { MAV_CMD_NAV_CONTINUE_AND_CHANGE_ALT, dto::MissionItem::Continue },
-        { MAV_CMD_NAV_RETURN_TO_LAUNCH, dto::MissionItem::Return },
-
-        { MAV_CMD_DO_CHANGE_SPEED, dto::MissionItem::SetSpeed },
-        { MAV_CMD_DO_JUMP, dto::MissionItem::JumpTo },
-
-        { MAV_CMD_DO_SET_SERVO, dto::MissionItem::SetServo },
-        { MAV_CMD_DO_SET_RELAY, dto::MissionItem::SetRelay },
-        { MAV_CMD_DO_REPEAT_SERVO, dto::MissionItem::RepeatServo },
-        { MAV_CMD_DO_REPEAT_RELAY, dto::MissionItem::RepeatRelay },
-
-        { MAV_CMD_DO_SET_ROI, dto::MissionItem::SetRoi },
-        { MAV_CMD_DO_MOUNT_CONTROL, dto::MissionItem::MountControl },
-        { MAV_CMD_DO_SET_CAM_TRIGG_DIST, dto::MissionItem::SetCameraTriggerDistance },
-        { MAV_CMD_DO_DIGICAM_CONTROL, dto::MissionItem::CameraControl }
-    };
-
     QString decodeCommandResult(int result)
     {
         switch (result) {
@@ -97,10 +71,29 @@ public:
     TelemetryService* telemetryService = serviceRegistry->telemetryService();
     MissionService* missionService = serviceRegistry->missionService();
 
-    QMap <quint8, MissionHandler::Stage> mavStages;
-    QMap <quint8, int> mavTimers;
-    QMap <quint8, QList<int> > mavSequencer;
-    int lastSendedSequence = -1;
+    MissionHandler* q;
+    MavLinkCommunicator* communicator;
+    QMap<quint8, MissionTransferSession*> sessions;
+    QMap<int, quint8> vehicleMavIds; // To notice mav id reassignment
+
+    void invalidateOnboard(quint8 mavId)
+    {
+        if (sessions.contains(mavId)) sessions[mavId]->invalidateOnboard();
+    }
+
+    void resetVehicle(quint8 mavId)
+    {
+        if (sessions.contains(mavId)) sessions[mavId]->resetVehicle();
+    }
+
+    MissionTransferSession* session(quint8 mavId)
+    {
+        MissionTransferSession*& entry = sessions[mavId];
+        if (!entry) entry = new MissionTransferSession(mavId, q, communicator->timingWheel(), q);
+        return entry;
+    }
+
+    MissionItemConvertor convertor;
 };
 
 MissionHandler::MissionHandler(MavLinkCommunicator* communicator):
@@ -108,13 +101,23 @@ MissionHandler::MissionHandler(MavLinkCommunicator* communicator):
     AbstractMavLinkHandler(communicator),
     d(new Impl())
 {
+    d->q = this;
+    d->communicator = communicator;
+
     connect(d->missionService, &MissionService::download, this, &MissionHandler::download);
     connect(d->missionService, &MissionService::upload, this, &MissionHandler::upload);
     connect(d->missionService, &MissionService::cancelSync, this, &MissionHandler::cancelSync);
+
+    connect(d->vehicleService, &VehicleService::vehicleChanged,
+            this, &MissionHandler::onVehicleChanged);
+    connect(d->vehicleService, &VehicleService::vehicleRemoved,
+            this, &MissionHandler::onVehicleRemoved);
 }
 
 MissionHandler::~MissionHandler()
-{}
+{
+    qDeleteAll(d->sessions);
+}
 
 void MissionHandler::processMessage(const mavlink_message_t& message)
 {
@@ -126,9 +129,15 @@ void MissionHandler::processMessage(const mavlink_message_t& message)
     case MAVLINK_MSG_ID_MISSION_ITEM:
         this->processMissionItem(message);
         break;
+    case MAVLINK_MSG_ID_MISSION_ITEM_INT:
+        this->processMissionItemInt(message);
+        break;
     case MAVLINK_MSG_ID_MISSION_REQUEST:
         this->processMissionRequest(message);
         break;
+    case MAVLINK_MSG_ID_MISSION_REQUEST_INT:
+        this->processMissionRequestInt(message);
+        break;
     case MAVLINK_MSG_ID_MISSION_ACK:
         this->processMissionAck(message);
         break;
@@ -152,8 +161,7 @@ void MissionHandler::download(const dto::MissionAssignmentPtr& assignment)
     assignment->setProgress(0);
     d->missionService->assignmentChanged(assignment);
 
-    this->enterStage(Stage::WaitingCount, vehicle->mavId());
-    this->requestMissionCount(vehicle->mavId());
+    d->session(vehicle->mavId())->startDownload();
 }
 
 void MissionHandler::upload(const dto::MissionAssignmentPtr& assignment)
@@ -161,33 +169,72 @@ void MissionHandler::upload(const dto::MissionAssignmentPtr& assignment)
     dto::VehiclePtr vehicle = d->vehicleService->vehicle(assignment->vehicleId());
     if (vehicle.isNull()) return;
 
-    d->mavSequencer[vehicle->mavId()].clear();
-    for (const dto::MissionItemPtr& item: d->missionService->missionItems(assignment->missionId()))
+    MissionTransferSession* session = d->session(vehicle->mavId());
+    dto::MissionItemPtrList items = d->missionService->missionItems(assignment->missionId());
+
+    QList<MavMissionItem> pending = this->encodeMission(items);
+
+    // Compare with onboard copy to send only changed range
+    int first = -1;
+    int last = -1;
+    bool diffable = !session->isPartialUnsupported() &&
+                    session->onboard().count() == pending.count();
+    if (diffable)
     {
-        d->mavSequencer[vehicle->mavId()].append(item->sequence());
-        item->setStatus(dto::MissionItem::NotActual);
-        d->missionService->missionItemChanged(item);
+        for (int i = 0; i < pending.count(); ++i)
+        {
+            if (pending.at(i) == session->onboard().at(i)) continue;
+
+            if (first == -1) first = i;
+            last = i;
+        }
     }
 
-    if (d->mavSequencer.isEmpty())
+    if (!items.isEmpty() && diffable && first == -1)
     {
-        this->enterStage(Stage::Idle, vehicle->mavId());
+        // Nothing to send, vehicle already has this mission
+        for (const dto::MissionItemPtr& item: items)
+        {
+            item->setStatus(dto::MissionItem::Actual);
+            d->missionService->missionItemChanged(item);
+        }
+
+        session->stop();
+
+        assignment->setStatus(dto::MissionAssignment::Actual);
+        d->missionService->assignmentChanged(assignment);
+        return;
     }
-    else
+
+    // Empty mission still goes as MISSION_COUNT 0, so vehicle clears its own
+    if (!diffable || items.isEmpty())
     {
-        assignment->setStatus(dto::MissionAssignment::Uploading);
-        assignment->setProgress(0);
-        d->missionService->assignmentChanged(assignment);
+        diffable = false;
+        first = 0;
+        last = items.count() - 1;
+    }
 
-        d->lastSendedSequence = -1;
-        this->enterStage(Stage::SendingCount, vehicle->mavId());
-        this->sendMissionCount(vehicle->mavId());
+    for (int seq = first; seq <= last; ++seq)
+    {
+        dto::MissionItemPtr item = items.at(seq);
+        item->setStatus(dto::MissionItem::NotActual);
+        d->missionService->missionItemChanged(item);
     }
+
+    assignment->setStatus(dto::MissionAssignment::Uploading);
+    assignment->setProgress(items.count() - (last - first + 1));
+    d->missionService->assignmentChanged(assignment);
+
+    session->startUpload(pending, first, last, diffable);
 }
 
 void MissionHandler::cancelSync(const dto::MissionAssignmentPtr& assignment)
 {
-    this->enterStage(Stage::Idle, d->vehicleService->mavIdByVehicleId(assignment->vehicleId()));
+    // Unknown vehicle has no session, as in download and upload
+    int mavId = d->vehicleService->mavIdByVehicleId(assignment->vehicleId());
+    if (mavId < 1) return;
+
+    d->session(mavId)->fail();
 
     assignment->setStatus(dto::MissionAssignment::NotActual);
     assignment->setProgress(0);
@@ -214,24 +261,44 @@ void MissionHandler::requestMissionCount(quint8 mavId)
 
 void MissionHandler::requestMissionItem(quint8 mavId, quint16 seq)
 {
-    dto::MissionAssignmentPtr assignment = d->missionService->vehicleAssignment(
-                                               d->vehicleService->vehicleIdByMavId(mavId));
-    if (assignment.isNull()) return;
+    AbstractLink* link = m_communicator->mavSystemLink(mavId);
+    if (!link) return;
 
     mavlink_message_t message;
-    mavlink_mission_request_t missionRequest;
 
-    missionRequest.target_system = mavId;
-    missionRequest.target_component = MAV_COMP_ID_MISSIONPLANNER;
-    missionRequest.seq = seq;
+    if (d->session(mavId)->isLegacyItems())
+    {
+        mavlink_mission_request_t missionRequest;
 
-    AbstractLink* link = m_communicator->mavSystemLink(mavId);
-    if (!link) return;
+        missionRequest.target_system = mavId;
+        missionRequest.target_component = MAV_COMP_ID_MISSIONPLANNER;
+        missionRequest.seq = seq;
+#ifdef MAVLINK_V2
+        missionRequest.mission_type = MAV_MISSION_TYPE_MISSION;
+#endif
+
+        mavlink_msg_mission_request_encode_chan(m_communicator->systemId(),
+                                                m_communicator->componentId(),
+                                                m_communicator->linkChannel(link),
+                                                &message, &missionRequest);
+    }
+    else
+    {
+        mavlink_mission_request_int_t missionRequest;
+
+        missionRequest.target_system = mavId;
+        missionRequest.target_component = MAV_COMP_ID_MISSIONPLANNER;
+        missionRequest.seq = seq;
+#ifdef MAVLINK_V2
+        missionRequest.mission_type = MAV_MISSION_TYPE_MISSION;
+#endif
+
+        mavlink_msg_mission_request_int_encode_chan(m_communicator->systemId(),
+                                                    m_communicator->componentId(),
+                                                    m_communicator->linkChannel(link),
+                                                    &message, &missionRequest);
+    }
 
-    mavlink_msg_mission_request_encode_chan(m_communicator->systemId(),
-                                            m_communicator->componentId(),
-                                            m_communicator->linkChannel(link),
-                                            &message, &missionRequest);
     m_communicator->sendMessage(message, link);
 }
 
@@ -241,6 +308,13 @@ void MissionHandler::sendMissionCount(quint8 mavId)
                                                d->vehicleService->vehicleIdByMavId(mavId));
     if (assignment.isNull()) return;
 
+    MissionTransferSession* session = d->session(mavId);
+    if (session->isPartial())
+    {
+        this->sendMissionPartialList(session);
+        return;
+    }
+
     dto::MissionPtr mission = d->missionService->mission(assignment->missionId());
 
     mavlink_message_t message;
@@ -249,6 +323,9 @@ void MissionHandler::sendMissionCount(quint8 mavId)
     countMessage.target_system = mavId;
     countMessage.target_component = MAV_COMP_ID_MISSIONPLANNER;
     countMessage.count = mission->count();
+#ifdef MAVLINK_V2
+    countMessage.mission_type = MAV_MISSION_TYPE_MISSION;
+#endif
 
     AbstractLink* link = m_communicator->mavSystemLink(mavId);
     if (!link) return;
@@ -260,112 +337,111 @@ void MissionHandler::sendMissionCount(quint8 mavId)
     m_communicator->sendMessage(message, link);
 }
 
-void MissionHandler::sendMissionItem(quint8 mavId, quint16 seq)
+void MissionHandler::sendMissionPartialList(MissionTransferSession* session)
+{
+    mavlink_message_t message;
+    mavlink_mission_write_partial_list_t partialList;
+
+    partialList.target_system = session->mavId();
+    partialList.target_component = MAV_COMP_ID_MISSIONPLANNER;
+    partialList.start_index = session->partialStart();
+    partialList.end_index = session->partialEnd();
+#ifdef MAVLINK_V2
+    partialList.mission_type = MAV_MISSION_TYPE_MISSION;
+#endif
+
+    AbstractLink* link = m_communicator->mavSystemLink(session->mavId());
+    if (!link) return;
+
+    mavlink_msg_mission_write_partial_list_encode_chan(m_communicator->systemId(),
+                                                       m_communicator->componentId(),
+                                                       m_communicator->linkChannel(link),
+                                                       &message, &partialList);
+    m_communicator->sendMessage(message, link);
+}
+
+void MissionHandler::sendMissionItem(quint8 mavId, quint16 seq, bool intCoordinates)
 {
     int vehicleId = d->vehicleService->vehicleIdByMavId(mavId);
     dto::MissionAssignmentPtr assignment = d->missionService->vehicleAssignment(vehicleId);
     if (assignment.isNull()) return;
 
-    mavlink_message_t message;
-    mavlink_mission_item_t msgItem;
-
-    msgItem.target_system = mavId;
-    msgItem.target_component = MAV_COMP_ID_MISSIONPLANNER;
-
-    // TODO: mission item to message convertor class
     dto::MissionItemPtr item = d->missionService->missionItem(assignment->missionId(), seq);
     if (item.isNull()) return;
 
-    msgItem.seq = seq;
-    msgItem.autocontinue = seq < d->missionService->mission(assignment->missionId())->count() - 1;
+    MavMissionItem mavItem;
+    mavItem.seq = seq;
+    mavItem.autocontinue = seq < d->missionService->mission(assignment->missionId())->count() - 1;
+    d->convertor.fromItem(item, mavItem);
 
-    if (seq) msgItem.command = ::mavCommandLongMap.key(item->command(), 0);
-    else msgItem.command = MAV_CMD_NAV_WAYPOINT; // Home is waypoint
+    AbstractLink* link = m_communicator->mavSystemLink(mavId);
+    if (!link) return;
 
-    if (item->isAltitudedItem())
-    {
-        msgItem.frame = item->isAltitudeRelative() ? MAV_FRAME_GLOBAL_RELATIVE_ALT :
-                                                      MAV_FRAME_GLOBAL;
-        msgItem.z = item->altitude();
-    }
+    mavlink_message_t message;
 
-    if (item->isPositionatedItem())
-    {
-        msgItem.x = item->latitude();
-        msgItem.y = item->longitude();
-    }
+    if (intCoordinates)
+    {
+        mavlink_mission_item_int_t msgItem;
+
+        msgItem.target_system = mavId;
+        msgItem.target_component = MAV_COMP_ID_MISSIONPLANNER;
+        msgItem.seq = seq;
+        msgItem.autocontinue = mavItem.autocontinue;
+        msgItem.current = 0;
+        msgItem.command = mavItem.command;
+        msgItem.frame = mavItem.frame;
+        msgItem.param1 = mavItem.param1;
+        msgItem.param2 = mavItem.param2;
+        msgItem.param3 = mavItem.param3;
+        msgItem.param4 = mavItem.param4;
+        msgItem.x = encodeLatLon(mavItem.x);
+        msgItem.y = encodeLatLon(mavItem.y);
+        msgItem.z = mavItem.z;
+#ifdef MAVLINK_V2
+        msgItem.mission_type = MAV_MISSION_TYPE_MISSION;
+#endif
 
-    if (msgItem.command == MAV_CMD_NAV_TAKEOFF)
-    {
-        msgItem.param1 = item->parameter(dto::MissionItem::Pitch).toFloat();
-    }
-    else if (msgItem.command == MAV_CMD_NAV_LAND)
-    {
-        msgItem.param1 = item->parameter(dto::MissionItem::AbortAltitude).toFloat();
-        msgItem.param4 = item->parameter(dto::MissionItem::Yaw).toFloat();
-    }
-    else if (msgItem.command == MAV_CMD_NAV_WAYPOINT)
-    {
-        msgItem.param2 = item->parameter(dto::MissionItem::Radius).toFloat();
-    }
-    else if (msgItem.command == MAV_CMD_NAV_LOITER_UNLIM ||
-             msgItem.command == MAV_CMD_NAV_LOITER_TURNS ||
-             msgItem.command == MAV_CMD_NAV_LOITER_TIME)
-    {
-        msgItem.param3 = item->parameter(dto::MissionItem::Clockwise).toBool() ?
-                             item->parameter(dto::MissionItem::Radius).toFloat() :
-                             -1 * item->parameter(dto::MissionItem::Radius).toFloat();
-        msgItem.param4 = item->parameter(dto::MissionItem::Yaw).toFloat();
-    }
-    else if (msgItem.command == MAV_CMD_NAV_LOITER_TO_ALT)
-    {
-        msgItem.param1 = item->parameter(dto::MissionItem::HeadingRequired).toBool();
-        msgItem.param2 = item->parameter(dto::MissionItem::Clockwise).toBool() ?
-                             item->parameter(dto::MissionItem::Radius).toFloat() :
-                             -1 * item->parameter(dto::MissionItem::Radius).toFloat();
+        mavlink_msg_mission_item_int_encode_chan(m_communicator->systemId(),
+                                                 m_communicator->componentId(),
+                                                 m_communicator->linkChannel(link),
+                                                 &message, &msgItem);
     }
-    else if (msgItem.command == MAV_CMD_DO_CHANGE_SPEED)
+    else
     {
-        msgItem.param1 = item->parameter(dto::MissionItem::IsGroundSpeed).toBool();
-        msgItem.param2 = item->parameter(dto::MissionItem::Speed, -1).toFloat();
-        msgItem.param3 = item->parameter(dto::MissionItem::Throttle, -1).toInt();
-    }
+        mavlink_mission_item_t msgItem;
+
+        msgItem.target_system = mavId;
+        msgItem.target_component = MAV_COMP_ID_MISSIONPLANNER;
+        msgItem.seq = seq;
+        msgItem.autocontinue = mavItem.autocontinue;
+        msgItem.current = 0;
+        msgItem.command = mavItem.command;
+        msgItem.frame = mavItem.frame;
+        msgItem.param1 = mavItem.param1;
+        msgItem.param2 = mavItem.param2;
+        msgItem.param3 = mavItem.param3;
+        msgItem.param4 = mavItem.param4;
+        msgItem.x = mavItem.x;
+        msgItem.y = mavItem.y;
+        msgItem.z = mavItem.z;
+#ifdef MAVLINK_V2
+        msgItem.mission_type = MAV_MISSION_TYPE_MISSION;
+#endif
 
-    if (msgItem.command == MAV_CMD_NAV_LOITER_TURNS)
-    {
-        msgItem.param1 = item->parameter(dto::MissionItem::Repeats).toInt();
-    }
-    else if (msgItem.command == MAV_CMD_NAV_LOITER_TIME)
-    {
-        msgItem.param1 = item->parameter(dto::MissionItem::Time).toFloat();
+        mavlink_msg_mission_item_encode_chan(m_communicator->systemId(),
+                                             m_communicator->componentId(),
+                                             m_communicator->linkChannel(link),
+                                             &message, &msgItem);
     }
 
-//    if (msgItem.command == MAV_CMD_NAV_CONTINUE_AND_CHANGE_ALT)
-//    {
-//  TODO: In Plane 3.4 (and later) the param1 value sets how close the vehicle
-//        altitude must be to target altitude for command completion.
-//    }
-
-    AbstractLink* link = m_communicator->mavSystemLink(mavId);
-    if (!link) return;
-
-    mavlink_msg_mission_item_encode_chan(m_communicator->systemId(),
-                                         m_communicator->componentId(),
-                                         m_communicator->linkChannel(link),
-                                         &message, &msgItem);
     m_communicator->sendMessage(message, link);
 
     item->setStatus(dto::MissionItem::Actual);
-    d->lastSendedSequence = seq;
     d->missionService->missionItemChanged(item);
 
-    if (d->mavStages[mavId] == Stage::SendingItem)
+    if (d->session(mavId)->itemSent(seq))
     {
-        d->mavSequencer[mavId].removeOne(seq);
         assignment->addProgress();
-
-        if (d->mavSequencer[mavId].isEmpty()) this->enterStage(Stage::WaitongAck, mavId);
-
         d->missionService->assignmentChanged(assignment);
     }
 }
@@ -396,7 +472,8 @@ void MissionHandler::sendMissionAck(quint8 mavId)
 void MissionHandler::processMissionCount(const mavlink_message_t& message)
 {
     // Ignore mission_count, if we are not downloading mission
-    if (d->mavStages.value(message.sysid, Stage::Idle) != Stage::WaitingCount) return;
+    MissionTransferSession* session = d->sessions.value(message.sysid);
+    if (!session || session->stage() != Stage::WaitingCount) return;
 
     int vehicleId = d->vehicleService->vehicleIdByMavId(message.sysid);
     dto::MissionAssignmentPtr assignment = d->missionService->vehicleAssignment(vehicleId);
@@ -412,127 +489,117 @@ void MissionHandler::processMissionCount(const mavlink_message_t& message)
         if (item->sequence() > missionCount.count - 1) d->missionService->remove(item);
     }
 
-    // TODO: append fake items
-    d->mavSequencer[message.sysid].clear();
-    for (int seq = 0; seq < missionCount.count; ++seq)
-    {
-        d->mavSequencer[message.sysid].append(seq);
-    }
-
-    this->enterStage(Stage::WaitingItem, message.sysid);
-    this->requestMissionItem(message.sysid, 0);
+    if (!session->countReceived(missionCount.count)) this->finishDownload(session);
 }
 
 void MissionHandler::processMissionItem(const mavlink_message_t& message)
 {
-    int vehicleId = d->vehicleService->vehicleIdByMavId(message.sysid);
+    mavlink_mission_item_t msgItem;
+    mavlink_msg_mission_item_decode(&message, &msgItem);
+
+#ifdef MAVLINK_V2
+    if (msgItem.mission_type != MAV_MISSION_TYPE_MISSION) return;
+#endif
+
+    MavMissionItem mavItem;
+    mavItem.seq = msgItem.seq;
+    mavItem.command = msgItem.command;
+    mavItem.frame = msgItem.frame;
+    mavItem.param1 = msgItem.param1;
+    mavItem.param2 = msgItem.param2;
+    mavItem.param3 = msgItem.param3;
+    mavItem.param4 = msgItem.param4;
+    mavItem.x = msgItem.x;
+    mavItem.y = msgItem.y;
+    mavItem.z = msgItem.z;
+
+    this->processMavMissionItem(message.sysid, mavItem);
+}
+
+void MissionHandler::processMissionItemInt(const mavlink_message_t& message)
+{
+    mavlink_mission_item_int_t msgItem;
+    mavlink_msg_mission_item_int_decode(&message, &msgItem);
+
+#ifdef MAVLINK_V2
+    if (msgItem.mission_type != MAV_MISSION_TYPE_MISSION) return;
+#endif
+
+    MavMissionItem mavItem;
+    mavItem.seq = msgItem.seq;
+    mavItem.command = msgItem.command;
+    mavItem.frame = msgItem.frame;
+    mavItem.param1 = msgItem.param1;
+    mavItem.param2 = msgItem.param2;
+    mavItem.param3 = msgItem.param3;
+    mavItem.param4 = msgItem.param4;
+    mavItem.x = decodeLatLon(msgItem.x);
+    mavItem.y = decodeLatLon(msgItem.y);
+    mavItem.z = msgItem.z;
+
+    this->processMavMissionItem(message.sysid, mavItem);
+}
+
+void MissionHandler::processMavMissionItem(quint8 mavId, const MavMissionItem& mavItem)
+{
+    int vehicleId = d->vehicleService->vehicleIdByMavId(mavId);
     dto::MissionAssignmentPtr assignment = d->missionService->vehicleAssignment(vehicleId);
     if (assignment.isNull()) return;
 
-    mavlink_mission_item_t msgItem;
-    mavlink_msg_mission_item_decode(&message, &msgItem);
+    MissionTransferSession* session = d->session(mavId);
+    bool downloading = session->stage() == Stage::WaitingItem;
 
     // Don't allow mav to change items while not in downloading stage(except home)
-    if (d->mavStages.value(message.sysid, Stage::Idle) != Stage::WaitingItem &&
-        msgItem.seq != 0) return;
+    if (!downloading && mavItem.seq != 0) return;
 
-    dto::MissionItemPtr item = d->missionService->missionItem(assignment->missionId(), msgItem.seq);
+    // Ignore duplicates and replies to requests we've already got answer for
+    if (downloading && !session->isRequested(mavItem.seq)) return;
+
+    dto::MissionItemPtr item = d->missionService->missionItem(assignment->missionId(), mavItem.seq);
     if (item.isNull())
     {
         item = dto::MissionItemPtr::create();
         item->setMissionId(assignment->missionId());
-        item->setSequence(msgItem.seq);
+        item->setSequence(mavItem.seq);
     }
 
-    item->setCommand(msgItem.seq > 0 ?
-                         ::mavCommandLongMap.value(msgItem.command, dto::MissionItem::UnknownCommand) :
-                         dto::MissionItem::Home);
+    d->convertor.toItem(mavItem, item);
+    item->setStatus(dto::MissionItem::Actual);
 
-    if (item->isAltitudedItem())
+    if (!downloading)
     {
-        item->setAltitudeRelative(msgItem.frame == MAV_FRAME_GLOBAL_RELATIVE_ALT);
-        item->setAltitude(msgItem.z);
+        d->missionService->save(item);
+        return;
     }
 
-    if (item->isPositionatedItem())
-    {
-        item->setLatitude(msgItem.x);
-        item->setLongitude(msgItem.y);
-    }
+    session->itemReceived(mavItem.seq, item);
+    assignment->addProgress();
 
-    if (msgItem.command == MAV_CMD_NAV_TAKEOFF)
-    {
-        item->setParameter(dto::MissionItem::Pitch, msgItem.param1);
-    }
-    else if (msgItem.command == MAV_CMD_NAV_LAND)
-    {
-        item->setParameter(dto::MissionItem::AbortAltitude, msgItem.param1);
-        item->setParameter(dto::MissionItem::Yaw, msgItem.param4);
-    }
-    else if (msgItem.command == MAV_CMD_NAV_WAYPOINT)
-    {
-        item->setParameter(dto::MissionItem::Radius, msgItem.param2);
-    }
-    else if (msgItem.command == MAV_CMD_NAV_LOITER_UNLIM ||
-             msgItem.command == MAV_CMD_NAV_LOITER_TURNS ||
-             msgItem.command == MAV_CMD_NAV_LOITER_TIME)
-    {
-        item->setParameter(dto::MissionItem::Radius, qAbs(msgItem.param3));
-        item->setParameter(dto::MissionItem::Clockwise, bool(msgItem.param3 > 0));
-        item->setParameter(dto::MissionItem::Yaw, msgItem.param4);
-    }
-    else if (msgItem.command == MAV_CMD_NAV_LOITER_TO_ALT)
-    {
-        item->setParameter(dto::MissionItem::HeadingRequired, bool(msgItem.param1));
-        item->setParameter(dto::MissionItem::Radius, qAbs(msgItem.param2));
-        item->setParameter(dto::MissionItem::Clockwise, bool(msgItem.param2 > 0));
-    }
-    else if (msgItem.command == MAV_CMD_DO_CHANGE_SPEED)
-    {
-        item->setParameter(dto::MissionItem::IsGroundSpeed, bool(msgItem.param1));
-        if (msgItem.param2 != -1) item->setParameter(dto::MissionItem::Speed, msgItem.param2);
-        if (msgItem.param3 != -1) item->setParameter(dto::MissionItem::Throttle, int(msgItem.param3));
-    }
+    if (session->isDownloadComplete()) this->finishDownload(session);
+    else d->missionService->assignmentChanged(assignment);
+}
 
-    if (msgItem.command == MAV_CMD_NAV_LOITER_TURNS)
+void MissionHandler::finishDownload(MissionTransferSession* session)
+{
+    dto::MissionItemPtrList items = session->finishDownload();
+    session->setOnboard(this->encodeMission(items));
+
+    int vehicleId = d->vehicleService->vehicleIdByMavId(session->mavId());
+    dto::MissionAssignmentPtr assignment = d->missionService->vehicleAssignment(vehicleId);
+    if (assignment.isNull()) return;
+
+    // Whole mission in one transaction instead of one per item
+    if (d->missionService->save(items))
     {
-        item->setParameter(dto::MissionItem::Repeats, int(msgItem.param1));
+        assignment->setStatus(dto::MissionAssignment::Actual);
+        this->sendMissionAck(session->mavId());
     }
-    else if (msgItem.command == MAV_CMD_NAV_LOITER_TIME)
+    else
     {
-        item->setParameter(dto::MissionItem::Time, msgItem.param1);
+        assignment->setStatus(dto::MissionAssignment::NotActual);
     }
 
-//    if (msgItem.command == MAV_CMD_NAV_CONTINUE_AND_CHANGE_ALT)
-//    {
-//  TODO: In APM Plane 3.4 (and later) the param1 value sets how close the vehicle
-//        altitude must be to target altitude for command completion.
-//    }
-
-    item->setStatus(dto::MissionItem::Actual);
-    d->missionService->save(item);
-
-    if (d->mavSequencer[message.sysid].contains(msgItem.seq) &&
-        d->mavStages.value(message.sysid, Stage::Idle) == Stage::WaitingItem)
-    {
-        d->mavSequencer[message.sysid].removeOne(msgItem.seq);
-        assignment->addProgress();
-
-        if (d->mavSequencer[message.sysid].isEmpty())
-        {
-            assignment->setStatus(dto::MissionAssignment::Actual);
-
-            this->sendMissionAck(message.sysid);
-            this->enterStage(Stage::Idle, message.sysid);
-        }
-        else
-        {
-            this->enterStage(Stage::WaitingItem, message.sysid);
-            this->requestMissionItem(message.sysid, d->mavSequencer[message.sysid].first());
-        }
-
-        d->missionService->assignmentChanged(assignment);
-    }
+    d->missionService->assignmentChanged(assignment);
 }
 
 void MissionHandler::processMissionRequest(const mavlink_message_t& message)
@@ -540,21 +607,28 @@ void MissionHandler::processMissionRequest(const mavlink_message_t& message)
     mavlink_mission_request_t request;
     mavlink_msg_mission_request_decode(&message, &request);
 
-    if (d->mavStages.value(message.sysid, Stage::Idle) == Stage::SendingCount)
-    {
-        this->enterStage(Stage::SendingItem, message.sysid);
-    }
+    this->processItemRequest(message.sysid, request.seq, false);
+}
 
-    if (d->lastSendedSequence != -1 && d->lastSendedSequence != request.seq)
-    {
-        d->mavSequencer[message.sysid].removeOne(d->lastSendedSequence);
+void MissionHandler::processMissionRequestInt(const mavlink_message_t& message)
+{
+    mavlink_mission_request_int_t request;
+    mavlink_msg_mission_request_int_decode(&message, &request);
+
+    this->processItemRequest(message.sysid, request.seq, true);
+}
 
-        int vehicleId = d->vehicleService->vehicleIdByMavId(message.sysid);
+void MissionHandler::processItemRequest(quint8 mavId, quint16 seq, bool intCoordinates)
+{
+    int previous = d->session(mavId)->itemRequested(seq);
+    if (previous != -1)
+    {
+        int vehicleId = d->vehicleService->vehicleIdByMavId(mavId);
         dto::MissionAssignmentPtr assignment = d->missionService->vehicleAssignment(vehicleId);
         if (assignment)
         {
             dto::MissionItemPtr item = d->missionService->missionItem(assignment->missionId(),
-                                                                      d->lastSendedSequence);
+                                                                      previous);
             if (item)
             {
                 item->setStatus(dto::MissionItem::Actual);
@@ -563,15 +637,11 @@ void MissionHandler::processMissionRequest(const mavlink_message_t& message)
         }
     }
 
-    this->sendMissionItem(message.sysid, request.seq);
+    this->sendMissionItem(mavId, seq, intCoordinates);
 }
 
 void MissionHandler::processMissionAck(const mavlink_message_t& message)
 {
-    int vehicleId = d->vehicleService->vehicleIdByMavId(message.sysid);
-    dto::MissionAssignmentPtr assignment = d->missionService->vehicleAssignment(vehicleId);
-    if (assignment.isNull()) return;
-
     mavlink_mission_ack_t ack;
     mavlink_msg_mission_ack_decode(&message, &ack);
 
@@ -579,17 +649,43 @@ void MissionHandler::processMissionAck(const mavlink_message_t& message)
     if (ack.mission_type != MAV_MISSION_TYPE_MISSION) return;
 #endif
 
+    // Vehicle accepted mission from another ground station, ours is not onboard anymore
+    if (ack.target_system != m_communicator->systemId())
+    {
+        if (ack.type == MAV_MISSION_ACCEPTED) d->invalidateOnboard(message.sysid);
+        return;
+    }
+
+    int vehicleId = d->vehicleService->vehicleIdByMavId(message.sysid);
+    dto::MissionAssignmentPtr assignment = d->missionService->vehicleAssignment(vehicleId);
+    if (assignment.isNull()) return;
+
+    MissionTransferSession* session = d->session(message.sysid);
+    bool downloading = session->stage() == Stage::WaitingCount ||
+                       session->stage() == Stage::WaitingItem;
+
     if (ack.type == MAV_MISSION_ACCEPTED)
     {
-        if (d->mavStages.value(message.sysid, Stage::Idle) == Stage::WaitongAck)
-        {
-            assignment->setStatus(dto::MissionAssignment::Actual);
-        }
+        if (session->acknowledged()) assignment->setStatus(dto::MissionAssignment::Actual);
+    }
+    else if (downloading)
+    {
+        LogBus::instance()->log(tr("Error downloading mission, %1").arg(
+                                    ::decodeCommandResult(ack.type)));
+        session->fail();
+        assignment->setStatus(dto::MissionAssignment::NotActual);
+    }
+    else if (session->isPartial() && session->stage() == Stage::SendingCount)
+    {
+        // Autopilot refused MISSION_WRITE_PARTIAL_LIST itself, send everything instead
+        this->fallbackToFullUpload(message.sysid);
+        return;
     }
     else
     {
         LogBus::instance()->log(tr("Error uploading mission item, %1").arg(
                                     ::decodeCommandResult(ack.type)));
+        session->fail();
         assignment->setStatus(dto::MissionAssignment::NotActual);
     }
 
@@ -626,43 +722,47 @@ void MissionHandler::processMissionReached(const mavlink_message_t& message)
     }
 }
 
-void MissionHandler::enterStage(Stage stage, quint8 mavId)
+QList<MavMissionItem> MissionHandler::encodeMission(const dto::MissionItemPtrList& items) const
 {
-    if (d->mavTimers.contains(mavId))
+    QList<MavMissionItem> mavItems;
+    for (const dto::MissionItemPtr& item: items)
     {
-        this->killTimer(d->mavTimers.take(mavId));
+        MavMissionItem mavItem;
+        mavItem.seq = item->sequence();
+        mavItem.autocontinue = item->sequence() < items.count() - 1;
+        d->convertor.fromItem(item, mavItem);
+        mavItems.append(mavItem);
     }
+    return mavItems;
+}
 
-    d->mavStages[mavId] = stage;
-    if (stage != Stage::Idle &&
-        stage != Stage::SendingItem &&
-        stage != Stage::WaitongAck)
-    {
-        d->mavTimers[mavId] = this->startTimer(::interval);
-    }
+void MissionHandler::fallbackToFullUpload(quint8 mavId)
+{
+    int vehicleId = d->vehicleService->vehicleIdByMavId(mavId);
+    dto::MissionAssignmentPtr assignment = d->missionService->vehicleAssignment(vehicleId);
+    if (assignment.isNull()) return;
+
+    d->session(mavId)->partialRefused();
+
+    LogBus::instance()->log(tr("Partial mission write is not supported, uploading whole mission"));
+    this->upload(assignment);
 }
 
-void MissionHandler::timerEvent(QTimerEvent* event)
+void MissionHandler::onVehicleChanged(const dto::VehiclePtr& vehicle)
 {
-    quint8 mavId = d->mavTimers.key(event->timerId(), 0);
-    if (!mavId) QObject::timerEvent(event);
+    quint8 previous = d->vehicleMavIds.value(vehicle->id(), vehicle->mavId());
+    d->vehicleMavIds[vehicle->id()] = vehicle->mavId();
 
-    switch (d->mavStages.value(mavId, Stage::Idle))
+    // Offline vehicle may come back rebooted or reflashed, onboard mission is unknown then
+    if (!vehicle->isOnline() || previous != vehicle->mavId())
     {
-    case Stage::WaitingCount:
-        this->requestMissionCount(mavId);
-        break;
-    case Stage::WaitingItem:
-    {
-        const QList<int>& list = d->mavSequencer[mavId];
-        if (list.isEmpty()) this->enterStage(Stage::Idle, mavId);
-        else this->requestMissionItem(mavId, list.first());
-        break;
-    }
-    case Stage::SendingCount:
-        this->sendMissionCount(mavId);
-    case Stage::Idle:
-    default:
-        break;
+        d->resetVehicle(previous);
+        d->resetVehicle(vehicle->mavId());
     }
 }
+
+void MissionHandler::onVehicleRemoved(const dto::VehiclePtr& vehicle)
+{
+    d->vehicleMavIds.remove(vehicle->id());
+    d->resetVehicle(vehicle->mavId());
+}
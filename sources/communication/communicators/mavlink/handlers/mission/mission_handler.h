@@ -7,6 +7,7 @@
 // Internal
 #include "abstract_mavlink_handler.h"
 #include "dto_traits.h"
+#include "mission_transfer_session.h"
 
 namespace domain
 {
@@ -17,20 +18,13 @@ namespace domain
 
 namespace comm
 {
-    class MissionHandler: public QObject, public AbstractMavLinkHandler
+    class MissionHandler: public QObject, public AbstractMavLinkHandler,
+            public MissionTransferSession::Transport
     {
         Q_OBJECT
 
     public:
-        enum class Stage
-        {
-            Idle,
-            WaitingCount,
-            WaitingItem,
-            WaitongAck,
-            SendingCount,
-            SendingItem
-        };
+        using Stage = MissionTransferSession::Stage;
 
         explicit MissionHandler(MavLinkCommunicator* communicator);
         ~MissionHandler() override;
@@ -42,29 +36,40 @@ namespace comm
        void upload(const dto::MissionAssignmentPtr& assignment);
        void cancelSync(const dto::MissionAssignmentPtr& assignment);
 
-       void requestMissionCount(quint8 mavId);
-       void requestMissionItem(quint8 mavId, quint16 seq);
+       void requestMissionCount(quint8 mavId) override;
+       void requestMissionItem(quint8 mavId, quint16 seq) override;
 
-       void sendMissionCount(quint8 mavId);
-       void sendMissionItem(quint8 mavId, quint16 seq);
+       void sendMissionCount(quint8 mavId) override;
+       void sendMissionItem(quint8 mavId, quint16 seq, bool intCoordinates = false);
        void sendMissionAck(quint8 mavId);
 
+       void fallbackToFullUpload(quint8 mavId) override;
+
+    private slots:
+       void onVehicleChanged(const dto::VehiclePtr& vehicle);
+       void onVehicleRemoved(const dto::VehiclePtr& vehicle);
+
     protected:
         void processMissionCount(const mavlink_message_t& message);
         void processMissionItem(const mavlink_message_t& message);
+        void processMissionItemInt(const mavlink_message_t& message);
         void processMissionRequest(const mavlink_message_t& message);
+        void processMissionRequestInt(const mavlink_message_t& message);
         void processMissionAck(const mavlink_message_t& message);
         void processMissionCurrent(const mavlink_message_t& message);
         void processMissionReached(const mavlink_message_t& message);
 
-        void enterStage(Stage stage, quint8 mavId);
-        void timerEvent(QTimerEvent* event);
+        void processMavMissionItem(quint8 mavId, const domain::MavMissionItem& mavItem);
+        void processItemRequest(quint8 mavId, quint16 seq, bool intCoordinates);
+
+        void finishDownload(MissionTransferSession* session);
+
+        void sendMissionPartialList(MissionTransferSession* session);
+        QList<domain::MavMissionItem> encodeMission(const dto::MissionItemPtrList& items) const;
 
     private:
         class Impl;
         QScopedPointer<Impl> const d;
-
-        Q_ENUM(Stage)
     };
 }
 
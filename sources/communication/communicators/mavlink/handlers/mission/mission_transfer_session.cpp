@@ -0,0 +1,330 @@
+#include "mission_transfer_session.h"
+
+using namespace comm;
+
+namespace
+{
+    const int interval = 2000;
+    const int downloadWindow = 5; // Item requests kept in flight while downloading
+    const int intFallbackTimeouts = 2; // Silent timeouts before giving up MISSION_REQUEST_INT
+    const int partialFallbackTimeouts = 2; // Unanswered partial lists before full upload
+}
+
+MissionTransferSession::MissionTransferSession(quint8 mavId, Transport* transport,
+                                               utils::TimingWheel* wheel, QObject* context):
+    m_mavId(mavId),
+    m_transport(transport),
+    m_wheel(wheel),
+    m_context(context)
+{
+    m_clock.start();
+}
+
+MissionTransferSession::~MissionTransferSession()
+{
+    m_wheel->stop(m_timer);
+}
+
+quint8 MissionTransferSession::mavId() const
+{
+    return m_mavId;
+}
+
+MissionTransferSession::Stage MissionTransferSession::stage() const
+{
+    return m_stage;
+}
+
+const MissionTransferSession::Statistics& MissionTransferSession::statistics() const
+{
+    return m_stats;
+}
+
+void MissionTransferSession::startDownload()
+{
+    this->start(QList<int>());
+    m_window = ::downloadWindow;
+    this->enterStage(Stage::WaitingCount);
+    m_transport->requestMissionCount(m_mavId);
+}
+
+bool MissionTransferSession::countReceived(int count)
+{
+    QList<int> sequences;
+    for (int seq = 0; seq < count; ++seq) sequences.append(seq);
+    this->start(sequences);
+
+    if (count == 0) return false;
+
+    this->enterStage(Stage::WaitingItem);
+    this->fillDownloadWindow();
+    return true;
+}
+
+bool MissionTransferSession::isRequested(quint16 seq) const
+{
+    return m_inFlight.contains(seq);
+}
+
+void MissionTransferSession::itemReceived(quint16 seq, const dto::MissionItemPtr& item)
+{
+    qint64 requested = m_inFlight.take(seq);
+    if (!m_retransmitted.remove(seq)) m_rtt.addSample(m_clock.elapsed() - requested);
+
+    m_timeouts = 0;
+    m_received[seq] = item;
+    m_stats.items++;
+
+    if (this->isDownloadComplete()) return;
+
+    this->enterStage(Stage::WaitingItem); // Restart timer with fresh timeout
+    this->fillDownloadWindow();
+}
+
+bool MissionTransferSession::isDownloadComplete() const
+{
+    return m_inFlight.isEmpty() && m_sequencer.isEmpty();
+}
+
+dto::MissionItemPtrList MissionTransferSession::finishDownload()
+{
+    dto::MissionItemPtrList items = m_received.values();
+    this->finish();
+    this->enterStage(Stage::Idle);
+    return items;
+}
+
+bool MissionTransferSession::isLegacyItems() const
+{
+    return m_legacyItems;
+}
+
+void MissionTransferSession::startUpload(const QList<domain::MavMissionItem>& pending,
+                                         int first, int last, bool partial)
+{
+    QList<int> sequences;
+    for (int seq = first; seq <= last; ++seq) sequences.append(seq);
+    this->start(sequences);
+
+    m_pending = pending;
+    if (partial)
+    {
+        m_partialStart = first;
+        m_partialEnd = last;
+    }
+
+    this->enterStage(Stage::SendingCount);
+    m_transport->sendMissionCount(m_mavId);
+}
+
+bool MissionTransferSession::isPartial() const
+{
+    return m_partialStart != -1;
+}
+
+int MissionTransferSession::partialStart() const
+{
+    return m_partialStart;
+}
+
+int MissionTransferSession::partialEnd() const
+{
+    return m_partialEnd;
+}
+
+bool MissionTransferSession::isPartialUnsupported() const
+{
+    return m_partialUnsupported;
+}
+
+void MissionTransferSession::partialRefused()
+{
+    if (m_stage != Stage::SendingCount || !this->isPartial()) return;
+
+    m_partialUnsupported = true;
+    m_onboard.clear();
+}
+
+int MissionTransferSession::itemRequested(quint16 seq)
+{
+    if (m_stage == Stage::SendingCount) this->enterStage(Stage::SendingItem);
+
+    if (m_lastSentSequence == -1 || m_lastSentSequence == seq) return -1;
+
+    m_sequencer.removeOne(m_lastSentSequence);
+    return m_lastSentSequence;
+}
+
+bool MissionTransferSession::itemSent(quint16 seq)
+{
+    m_lastSentSequence = seq;
+    if (m_stage != Stage::SendingItem) return false;
+
+    if (m_sequencer.removeOne(seq)) m_stats.items++;
+    else m_stats.retransmissions++;
+
+    if (m_sequencer.isEmpty()) this->enterStage(Stage::WaitongAck);
+    return true;
+}
+
+bool MissionTransferSession::acknowledged()
+{
+    // Empty mission has no items to send, count itself is acknowledged
+    bool emptyMission = m_stage == Stage::SendingCount && m_pending.isEmpty();
+    if (m_stage != Stage::WaitongAck && !emptyMission) return false;
+
+    m_onboard = m_pending;
+    this->finish();
+    this->enterStage(Stage::Idle);
+    return true;
+}
+
+const QList<domain::MavMissionItem>& MissionTransferSession::onboard() const
+{
+    return m_onboard;
+}
+
+void MissionTransferSession::setOnboard(const QList<domain::MavMissionItem>& onboard)
+{
+    m_onboard = onboard;
+}
+
+void MissionTransferSession::invalidateOnboard()
+{
+    m_onboard.clear();
+}
+
+void MissionTransferSession::resetVehicle()
+{
+    m_onboard.clear();
+    m_partialUnsupported = false;
+    m_legacyItems = false;
+}
+
+void MissionTransferSession::stop()
+{
+    this->finish();
+    this->enterStage(Stage::Idle);
+}
+
+void MissionTransferSession::fail()
+{
+    this->stop();
+    m_onboard.clear(); // Transfer was interrupted, don't know what is onboard now
+}
+
+void MissionTransferSession::enterStage(Stage stage)
+{
+    m_wheel->stop(m_timer);
+    m_timer = 0;
+    m_stage = stage;
+
+    int timeout = 0;
+    if (stage == Stage::WaitingItem) timeout = m_rtt.timeout();
+    else if (stage == Stage::WaitingCount || stage == Stage::SendingCount) timeout = ::interval;
+
+    if (timeout > 0) m_timer = m_wheel->start(timeout, m_context, [this]() { this->onTimeout(); });
+}
+
+void MissionTransferSession::onTimeout()
+{
+    m_timer = 0;
+
+    switch (m_stage)
+    {
+    case Stage::WaitingCount:
+        m_transport->requestMissionCount(m_mavId);
+        this->enterStage(Stage::WaitingCount);
+        break;
+    case Stage::WaitingItem:
+        this->onDownloadTimeout();
+        break;
+    case Stage::SendingCount:
+        if (this->isPartial() && ++m_timeouts >= ::partialFallbackTimeouts)
+        {
+            return m_transport->fallbackToFullUpload(m_mavId);
+        }
+
+        m_transport->sendMissionCount(m_mavId);
+        this->enterStage(Stage::SendingCount);
+        break;
+    case Stage::Idle:
+    default:
+        break;
+    }
+}
+
+void MissionTransferSession::onDownloadTimeout()
+{
+    if (this->isDownloadComplete()) return this->enterStage(Stage::Idle);
+
+    // Autopilot keeps silence on MISSION_REQUEST_INT, it must be an old one
+    if (m_received.isEmpty() && !m_legacyItems && ++m_timeouts >= ::intFallbackTimeouts)
+    {
+        m_legacyItems = true;
+    }
+
+    // Some autopilots (PX4) refuse requests out of order, so window is dropped and
+    // missing items are asked again one by one, starting from the first of them
+    QList<quint16> missing = m_inFlight.keys();
+    m_inFlight.clear();
+    m_window = 1;
+
+    for (auto it = missing.crbegin(); it != missing.crend(); ++it)
+    {
+        m_retransmitted.insert(*it);
+        m_sequencer.prepend(*it);
+        m_stats.retransmissions++;
+    }
+
+    m_rtt.backoff();
+    this->enterStage(Stage::WaitingItem);
+    this->fillDownloadWindow();
+}
+
+void MissionTransferSession::start(const QList<int>& sequences)
+{
+    m_sequencer = sequences;
+    m_lastSentSequence = -1;
+
+    m_inFlight.clear();
+    m_retransmitted.clear();
+    m_received.clear();
+    m_timeouts = 0;
+    m_partialStart = -1;
+    m_partialEnd = -1;
+
+    m_stats = Statistics();
+    m_stats.started = m_clock.elapsed();
+}
+
+void MissionTransferSession::finish()
+{
+    m_inFlight.clear();
+    m_retransmitted.clear();
+    m_received.clear();
+    m_sequencer.clear();
+
+    m_stats.finished = m_clock.elapsed();
+}
+
+void MissionTransferSession::fillDownloadWindow()
+{
+    while (m_inFlight.count() < m_window && !m_sequencer.isEmpty())
+    {
+        this->requestItem(m_sequencer.takeFirst());
+    }
+}
+
+void MissionTransferSession::requestItem(quint16 seq)
+{
+    m_transport->requestMissionItem(m_mavId, seq);
+
+    if (m_inFlight.contains(seq))
+    {
+        m_retransmitted.insert(seq);
+        m_stats.retransmissions++;
+    }
+    m_inFlight[seq] = m_clock.elapsed();
+    m_stats.requests++;
+}
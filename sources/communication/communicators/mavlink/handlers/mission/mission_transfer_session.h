@@ -0,0 +1,142 @@
+#ifndef MISSION_TRANSFER_SESSION_H
+#define MISSION_TRANSFER_SESSION_H
+
+// Qt
+#include <QMap>
+#include <QSet>
+#include <QElapsedTimer>
+
+// Internal
+#include "dto_traits.h"
+#include "rtt_estimator.h"
+#include "mission_item_convertor.h"
+#include "timing_wheel.h"
+
+namespace comm
+{
+    // Mission upload/download state machine of one vehicle, so transfers to different
+    // vehicles never mix. Session owns stages, retries and timeouts, and asks transport
+    // to put requests on the wire; handler only feeds it received messages
+    class MissionTransferSession
+    {
+    public:
+        enum class Stage
+        {
+            Idle,
+            WaitingCount,
+            WaitingItem,
+            WaitongAck,
+            SendingCount,
+            SendingItem
+        };
+
+        class Transport
+        {
+        public:
+            virtual ~Transport() {}
+
+            virtual void requestMissionCount(quint8 mavId) = 0;
+            virtual void requestMissionItem(quint8 mavId, quint16 seq) = 0;
+            virtual void sendMissionCount(quint8 mavId) = 0;
+            virtual void fallbackToFullUpload(quint8 mavId) = 0;
+        };
+
+        struct Statistics
+        {
+            int requests = 0;
+            int retransmissions = 0;
+            int items = 0;
+            qint64 started = 0;
+            qint64 finished = 0;
+        };
+
+        MissionTransferSession(quint8 mavId, Transport* transport,
+                               utils::TimingWheel* wheel, QObject* context);
+        ~MissionTransferSession();
+
+        quint8 mavId() const;
+        Stage stage() const;
+        const Statistics& statistics() const;
+
+        // Download
+        void startDownload();
+        // Returns false when there are no items to wait for
+        bool countReceived(int count);
+        bool isRequested(quint16 seq) const;
+        void itemReceived(quint16 seq, const dto::MissionItemPtr& item);
+        bool isDownloadComplete() const;
+        dto::MissionItemPtrList finishDownload();
+        bool isLegacyItems() const; // Vehicle doesn't answer MISSION_REQUEST_INT
+
+        // Upload, range is MISSION_WRITE_PARTIAL_LIST one or -1 for full upload
+        void startUpload(const QList<domain::MavMissionItem>& pending,
+                         int first, int last, bool partial);
+        bool isPartial() const;
+        int partialStart() const;
+        int partialEnd() const;
+        bool isPartialUnsupported() const;
+        // Autopilot refused MISSION_WRITE_PARTIAL_LIST, not just one of the items
+        void partialRefused();
+
+        // Returns sequence vehicle moved on from, -1 if none
+        int itemRequested(quint16 seq);
+        // Returns true if item counts as upload progress
+        bool itemSent(quint16 seq);
+        // Returns true if upload is complete, vehicle has pending mission now
+        bool acknowledged();
+
+        // Mission as vehicle acknowledged it last time, empty when unknown
+        const QList<domain::MavMissionItem>& onboard() const;
+        void setOnboard(const QList<domain::MavMissionItem>& onboard);
+        void invalidateOnboard();
+        // Next connection may be another autopilot, forgets everything learned about this one
+        void resetVehicle();
+
+        // Stops transfer, failed one also forgets what is onboard
+        void stop();
+        void fail();
+
+    private:
+        void enterStage(Stage stage);
+        void onTimeout();
+        void onDownloadTimeout();
+
+        void start(const QList<int>& sequences);
+        void finish();
+        void fillDownloadWindow();
+        void requestItem(quint16 seq);
+
+        const quint8 m_mavId;
+        Transport* const m_transport;
+        utils::TimingWheel* const m_wheel;
+        QObject* const m_context;
+
+        Stage m_stage = Stage::Idle;
+        int m_timer = 0;
+        int m_timeouts = 0;
+        QElapsedTimer m_clock;
+
+        // Sequences still to be requested or sent
+        QList<int> m_sequencer;
+        int m_lastSentSequence = -1;
+
+        // Download window
+        QMap<quint16, qint64> m_inFlight; // seq -> request time
+        QSet<quint16> m_retransmitted;
+        QMap<quint16, dto::MissionItemPtr> m_received;
+        bool m_legacyItems = false;
+        int m_window = 0; // Shrinks to one request after a timeout, so requests stay in order
+
+        QList<domain::MavMissionItem> m_onboard;
+        QList<domain::MavMissionItem> m_pending; // Being uploaded, becomes onboard on ack
+
+        int m_partialStart = -1;
+        int m_partialEnd = -1;
+        bool m_partialUnsupported = false;
+
+        RttEstimator m_rtt;
+        Statistics m_stats;
+    };
+}
+
+#endif // MISSION_TRANSFER_SESSION_H
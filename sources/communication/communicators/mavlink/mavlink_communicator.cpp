@@ -7,14 +7,38 @@
 
 // Qt
 #include <QMap>
+#include <QHash>
+#include <QTimerEvent>
+#include <QQueue>
+#include <QElapsedTimer>
 #include <QDebug>
 
 // Internal
 #include "abstract_link.h"
 #include "abstract_mavlink_handler.h"
+#include "timing_wheel.h"
+#include "message_counter.h"
+#include "mavlink_router.h"
+
+// Std
+#include <bitset>
+#include <array>
 
 using namespace comm;
 
+namespace
+{
+    const double bulkShare = 0.75; // Of link bandwidth, rest is always left to regular traffic
+    const int bulkTick = 20;
+
+    const int pathInterval = 500;
+    const int pathTimeout = 2000; // Link is no more a path to the system
+    const int sourceTimeout = 3000; // Sequence history is stale, e.g. system rebooted
+    const float lossGain = 0.1;
+    const int lossPenalty = 1000; // ms of round trip equal to losing every packet
+    const float switchRatio = 0.8; // Hysteresis, new path must be that much better
+}
+
 class MavLinkCommunicator::Impl
 {
 public:
@@ -22,14 +46,125 @@ public:
     quint8 componentId;
 
     QMap<AbstractLink*, quint8> linkChannels;
-    QMap<quint8, AbstractLink*> mavSystemLinks;
+    QMap<quint8, AbstractLink*> mavSystemLinks; // Selected paths
+
+    struct Path
+    {
+        qint64 lastHeard = 0;
+        float loss = 0;
+    };
+    QMap<quint8, QMap<AbstractLink*, Path> > paths; // mavId -> links it is heard on
+    QElapsedTimer pathClock;
+    int pathTimer = 0;
+
+    // Recent sequence numbers of a sender, to drop copies arrived by other links
+    struct Source
+    {
+        std::bitset<256> seen;
+        std::array<quint32, 256> messages;
+        quint8 last = 0;
+        qint64 lastHeard = -1;
+    };
+    QHash<quint16, Source> sources; // sysid << 8 | compid
+    QMap<AbstractLink*, int> linkRoundTrips;
+    QMap<AbstractLink*, MessageCounter> messageCounters;
     QList<quint8> avalibleChannels;
     AbstractLink* receivedLink = nullptr;
 
     QList<AbstractMavLinkHandler*> handlers;
+    QScopedPointer<MavLinkRouter> router;
+    QMap<AbstractLink*, QByteArray> routeTails; // Last received bytes, for frames split by reads
 
     int oldPacketsReceived = 0;
     int oldPacketsDrops = 0;
+
+    // Token bucket per link, regular messages take tokens too but never wait for them
+    struct BulkQueue
+    {
+        QQueue<QByteArray> packets;
+        double tokens = 0;
+    };
+    QMap<AbstractLink*, BulkQueue> bulkQueues;
+    QElapsedTimer bulkClock;
+    qint64 lastRefill = 0;
+    int bulkTimer = 0;
+
+    void consume(AbstractLink* link, int bytes)
+    {
+        auto it = bulkQueues.find(link);
+        if (it != bulkQueues.end()) it->tokens -= bytes;
+    }
+
+    bool isDuplicate(const mavlink_message_t& message, qint64 now)
+    {
+        Source& source = sources[(message.sysid << 8) | message.compid];
+        if (source.lastHeard < 0 || now - source.lastHeard > ::sourceTimeout)
+        {
+            source.seen.reset();
+            source.last = message.seq;
+        }
+
+        quint8 ahead = message.seq - source.last;
+        if (ahead == 0 || ahead >= 128) // Same or older sequence
+        {
+            if (source.seen.test(message.seq) &&
+                source.messages[message.seq] == message.msgid) return true;
+        }
+        else
+        {
+            for (quint8 seq = source.last + 1; seq != message.seq; ++seq) source.seen.reset(seq);
+            source.last = message.seq;
+        }
+
+        source.seen.set(message.seq);
+        source.messages[message.seq] = message.msgid;
+        source.lastHeard = now;
+        return false;
+    }
+
+    int pathScore(AbstractLink* link, const Path& path, int unmeasured) const
+    {
+        // Link without round trip yet can't outrank measured ones
+        int roundTrip = linkRoundTrips.value(link, 0);
+        return (roundTrip > 0 ? roundTrip : unmeasured) + path.loss * ::lossPenalty;
+    }
+
+    AbstractLink* selectPath(quint8 mavId, qint64 now)
+    {
+        const QMap<AbstractLink*, Path>& links = paths.value(mavId);
+        AbstractLink* current = mavSystemLinks.value(mavId, nullptr);
+
+        int unmeasured = 0;
+        for (auto it = links.begin(); it != links.end(); ++it)
+        {
+            unmeasured = qMax(unmeasured, linkRoundTrips.value(it.key(), 0));
+        }
+
+        AbstractLink* best = nullptr;
+        int bestScore = 0;
+        for (auto it = links.begin(); it != links.end(); ++it)
+        {
+            if (now - it->lastHeard > ::pathTimeout) continue;
+
+            int score = this->pathScore(it.key(), it.value(), unmeasured);
+            if (!best || score < bestScore)
+            {
+                best = it.key();
+                bestScore = score;
+            }
+        }
+
+        if (!best) return current; // Nothing better than silence
+        if (current && current != best && links.contains(current) &&
+            now - links[current].lastHeard <= ::pathTimeout &&
+            bestScore >= this->pathScore(current, links[current], unmeasured) * ::switchRatio)
+        {
+            return current;
+        }
+
+        mavSystemLinks[mavId] = best;
+        return best;
+    }
 };
 
 MavLinkCommunicator::MavLinkCommunicator(quint8 systemId, quint8 componentId, QObject* parent):
@@ -45,6 +180,9 @@ MavLinkCommunicator::MavLinkCommunicator(quint8 systemId, quint8 componentId, QO
     {
         d->avalibleChannels.append(channel);
     }
+
+    d->pathClock.start();
+    d->pathTimer = this->startTimer(::pathInterval);
 }
 
 MavLinkCommunicator::~MavLinkCommunicator()
@@ -82,7 +220,38 @@ AbstractLink* MavLinkCommunicator::lastReceivedLink() const
 
 AbstractLink* MavLinkCommunicator::mavSystemLink(quint8 systemId)
 {
-    return d->mavSystemLinks.value(systemId, nullptr);
+    AbstractLink* link = d->mavSystemLinks.value(systemId, nullptr);
+    if (!link) return nullptr;
+
+    // Immediate failover, without waiting for periodic reselection
+    qint64 now = d->pathClock.elapsed();
+    if (now - d->paths[systemId][link].lastHeard > ::pathTimeout)
+    {
+        return d->selectPath(systemId, now);
+    }
+    return link;
+}
+
+QList<quint8> MavLinkCommunicator::linkMavSystems(AbstractLink* link) const
+{
+    QList<quint8> systems;
+    qint64 now = d->pathClock.elapsed();
+    for (auto it = d->paths.begin(); it != d->paths.end(); ++it)
+    {
+        auto path = it->find(link);
+        if (path != it->end() && now - path->lastHeard <= ::pathTimeout) systems.append(it.key());
+    }
+    return systems;
+}
+
+int MavLinkCommunicator::linkRoundTrip(AbstractLink* link) const
+{
+    return d->linkRoundTrips.value(link, 0);
+}
+
+bool MavLinkCommunicator::isRoutingEnabled() const
+{
+    return !d->router.isNull();
 }
 
 void MavLinkCommunicator::addLink(AbstractLink* link)
@@ -105,8 +274,20 @@ void MavLinkCommunicator::removeLink(AbstractLink* link)
     d->linkChannels.remove(link);
     d->avalibleChannels.prepend(channel);
 
-    quint8 mavId = d->mavSystemLinks.key(link, 0);
-    if (mavId) d->mavSystemLinks.remove(mavId);
+    for (auto it = d->paths.begin(); it != d->paths.end(); ++it)
+    {
+        it->remove(link);
+    }
+    for (quint8 mavId: d->mavSystemLinks.keys(link))
+    {
+        d->mavSystemLinks.remove(mavId);
+        d->selectPath(mavId, d->pathClock.elapsed());
+    }
+    d->bulkQueues.remove(link);
+    d->linkRoundTrips.remove(link);
+    d->messageCounters.remove(link);
+    if (d->router) d->router->removeLink(link);
+    d->routeTails.remove(link);
 
     if (link == d->receivedLink) d->receivedLink = nullptr;
 
@@ -136,6 +317,12 @@ void MavLinkCommunicator::switchLinkProtocol(AbstractLink* link, AbstractCommuni
     emit mavLinkProtocolChanged(link, MavLink1);
 }
 
+void MavLinkCommunicator::setLinkLatency(AbstractLink* link, int roundTrip, int roundTripP95)
+{
+    d->linkRoundTrips[link] = roundTripP95;
+    emit linkLatencyChanged(link, roundTrip, roundTripP95);
+}
+
 void MavLinkCommunicator::setSystemId(quint8 systemId)
 {
     if (d->systemId == systemId) return;
@@ -152,6 +339,14 @@ void MavLinkCommunicator::setComponentId(quint8 componentId)
     emit componentIdChanged(componentId);
 }
 
+void MavLinkCommunicator::setRoutingEnabled(bool enabled)
+{
+    if (this->isRoutingEnabled() == enabled) return;
+
+    d->router.reset(enabled ? new MavLinkRouter() : nullptr);
+    d->routeTails.clear();
+}
+
 void MavLinkCommunicator::addHandler(AbstractMavLinkHandler* handler)
 {
     d->handlers.append(handler);
@@ -161,13 +356,40 @@ void MavLinkCommunicator::sendMessage(mavlink_message_t& message, AbstractLink*
 {
     if (!link || !link->isConnected()) return;
 
-    this->finalizeMessage(message);
+    QByteArray data = this->encodeMessage(message);
+    if (data.isEmpty()) return;
 
-    quint8 buffer[MAVLINK_MAX_PACKET_LEN];
-    int lenght = mavlink_msg_to_send_buffer(buffer, &message);
+    d->consume(link, data.size());
+    link->sendData(data);
+}
+
+void MavLinkCommunicator::sendMessages(QList<mavlink_message_t>& messages, AbstractLink* link)
+{
+    if (!link || !link->isConnected()) return;
+
+    QByteArray data;
+    data.reserve(messages.count() * MAVLINK_MAX_PACKET_LEN);
+
+    for (mavlink_message_t& message: messages) data.append(this->encodeMessage(message));
+    if (data.isEmpty()) return;
+
+    d->consume(link, data.size());
+    link->sendData(data);
+}
+
+void MavLinkCommunicator::sendBulkMessage(mavlink_message_t& message, AbstractLink* link)
+{
+    if (!link || !link->isConnected()) return;
+
+    QByteArray data = this->encodeMessage(message);
+    if (data.isEmpty()) return;
 
-    if (!lenght) return;
-    link->sendData(QByteArray((const char*)buffer, lenght));
+    if (link->bandwidth() <= 0) return link->sendData(data);
+
+    if (!d->bulkClock.isValid()) d->bulkClock.start();
+
+    d->bulkQueues[link].packets.enqueue(data);
+    this->drainBulk();
 }
 
 void MavLinkCommunicator::onDataReceived(const QByteArray& data)
@@ -179,6 +401,7 @@ void MavLinkCommunicator::onDataReceived(const QByteArray& data)
     mavlink_status_t status;
 
     quint8 channel = this->linkChannel(d->receivedLink);
+    MessageCounter& counter = d->messageCounters[d->receivedLink];
     for (int pos = 0; pos < data.length(); ++pos)
     {
         if (!mavlink_parse_char(channel, (quint8)data[pos], &message, &status)) continue;
@@ -192,7 +415,27 @@ void MavLinkCommunicator::onDataReceived(const QByteArray& data)
         }
 #endif
 
-        d->mavSystemLinks[message.sysid] = d->receivedLink;
+        int lost = counter.count(message);
+
+        qint64 now = d->pathClock.elapsed();
+        Impl::Path& path = d->paths[message.sysid][d->receivedLink];
+        path.lastHeard = now;
+        path.loss += ::lossGain * (float(lost) / (lost + 1) - path.loss);
+        if (!d->mavSystemLinks.contains(message.sysid)) d->selectPath(message.sysid, now);
+
+        // Same packet heard on redundant link, handlers already got it
+        if (d->isDuplicate(message, now)) continue;
+
+        if (d->router)
+        {
+            // Frame as the parser consumed it, ends with this byte, may start in previous read
+            int end = pos + 1;
+            int size = MessageCounter::packetSize(message);
+            QByteArray frame = end >= size ? data.mid(end - size, size) :
+                                             d->routeTails.value(d->receivedLink).right(size - end) +
+                                             data.left(end);
+            this->forwardFrame(message, frame);
+        }
 
         for (AbstractMavLinkHandler* handler: d->handlers)
         {
@@ -200,6 +443,15 @@ void MavLinkCommunicator::onDataReceived(const QByteArray& data)
         }
     }
 
+    counter.setDropsTotal(status.packet_rx_drop_count);
+
+    if (d->router)
+    {
+        QByteArray& tail = d->routeTails[d->receivedLink];
+        tail = data.size() >= MAVLINK_MAX_PACKET_LEN ? data.right(MAVLINK_MAX_PACKET_LEN) :
+                                                       (tail + data).right(MAVLINK_MAX_PACKET_LEN);
+    }
+
     if (d->oldPacketsReceived != status.packet_rx_success_count ||
         d->oldPacketsDrops != status.packet_rx_drop_count)
     {
@@ -216,3 +468,73 @@ void MavLinkCommunicator::finalizeMessage(mavlink_message_t& message)
 {
     Q_UNUSED(message)
 }
+
+void MavLinkCommunicator::timerEvent(QTimerEvent* event)
+{
+    if (event->timerId() != d->pathTimer) return AbstractCommunicator::timerEvent(event);
+
+    qint64 now = d->pathClock.elapsed();
+    for (quint8 mavId: d->paths.keys())
+    {
+        d->selectPath(mavId, now);
+    }
+}
+
+void MavLinkCommunicator::updateLinkStatistics(AbstractLink* link)
+{
+    auto it = d->messageCounters.find(link);
+    if (it == d->messageCounters.end()) return;
+
+    emit linkTrafficChanged(link, it->take());
+}
+
+QByteArray MavLinkCommunicator::encodeMessage(mavlink_message_t& message)
+{
+    this->finalizeMessage(message);
+
+    quint8 buffer[MAVLINK_MAX_PACKET_LEN];
+    int lenght = mavlink_msg_to_send_buffer(buffer, &message);
+
+    return QByteArray((const char*)buffer, lenght);
+}
+
+void MavLinkCommunicator::forwardFrame(const mavlink_message_t& message, const QByteArray& frame)
+{
+    for (AbstractLink* link: d->router->route(message, frame.size(),
+                                              d->receivedLink, this->links()))
+    {
+        d->consume(link, frame.size());
+        link->sendData(frame);
+    }
+}
+
+void MavLinkCommunicator::drainBulk()
+{
+    qint64 now = d->bulkClock.elapsed();
+    qint64 elapsed = now - d->lastRefill;
+    d->lastRefill = now;
+
+    bool pending = false;
+    for (auto it = d->bulkQueues.begin(); it != d->bulkQueues.end(); ++it)
+    {
+        AbstractLink* link = it.key();
+        double rate = link->bandwidth() * ::bulkShare / 1000;
+
+        // Bucket holds no more than one tick of traffic, idle time is not saved up
+        double capacity = qMax(rate * ::bulkTick, double(MAVLINK_MAX_PACKET_LEN));
+        it->tokens = qMin(it->tokens + elapsed * rate, capacity);
+
+        while (!it->packets.isEmpty() && it->tokens >= it->packets.head().size())
+        {
+            QByteArray data = it->packets.dequeue();
+            it->tokens -= data.size();
+            if (link->isConnected()) link->sendData(data);
+        }
+
+        if (!it->packets.isEmpty()) pending = true;
+    }
+
+    if (!pending || this->timingWheel()->isActive(d->bulkTimer)) return;
+
+    d->bulkTimer = this->timingWheel()->start(::bulkTick, this, [this]() { this->drainBulk(); });
+}
@@ -26,20 +26,36 @@ namespace comm
         quint8 linkChannel(AbstractLink* link) const;
 
         AbstractLink* lastReceivedLink() const;
+        // Best link to the system by recent latency and loss, fails over to
+        // another link the system is heard on when this one goes silent
         AbstractLink* mavSystemLink(quint8 systemId);
+        // Systems recently heard on the link, whether it is their selected path or not
+        QList<quint8> linkMavSystems(AbstractLink* link) const;
+        // 95th percentile of TIMESYNC round trip, ms, 0 if not measured yet
+        int linkRoundTrip(AbstractLink* link) const;
+
+        bool isRoutingEnabled() const;
 
     public slots:
         void addLink(AbstractLink* link) override;
         void removeLink(AbstractLink* link) override;
 
         void switchLinkProtocol(AbstractLink* link, Protocol protocol);
+        void setLinkLatency(AbstractLink* link, int roundTrip, int roundTripP95);
 
         void setSystemId(quint8 systemId);
         void setComponentId(quint8 componentId);
+        // Forward frames between links by their target, as is, without repacking
+        void setRoutingEnabled(bool enabled);
 
         void addHandler(AbstractMavLinkHandler* handler);
 
         void sendMessage(mavlink_message_t& message, AbstractLink* link);
+        // Packs messages into one write, so radio sends them as one burst
+        void sendMessages(QList<mavlink_message_t>& messages, AbstractLink* link);
+        // Low priority traffic: queued and sent only within link bandwidth left
+        // by regular messages, so bulk transfers never delay heartbeats or control
+        void sendBulkMessage(mavlink_message_t& message, AbstractLink* link);
 
     signals:
         void systemIdChanged(quint8 systemId);
@@ -50,6 +66,13 @@ namespace comm
 
     protected:
         virtual void finalizeMessage(mavlink_message_t& message);
+        void updateLinkStatistics(AbstractLink* link) override;
+        void timerEvent(QTimerEvent* event) override;
+
+    private:
+        QByteArray encodeMessage(mavlink_message_t& message);
+        void drainBulk();
+        void forwardFrame(const mavlink_message_t& message, const QByteArray& frame);
 
     private:
         class Impl;
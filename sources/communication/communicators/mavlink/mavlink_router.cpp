@@ -0,0 +1,154 @@
+#include "mavlink_router.h"
+
+// MAVLink
+#include <mavlink.h>
+
+// Qt
+#include <QVector>
+
+// Internal
+#include "abstract_link.h"
+
+using namespace comm;
+
+namespace
+{
+    const int burstWindow = 250; // ms of rate limited traffic allowed at once
+
+    void learn(QList<AbstractLink*>& links, AbstractLink* link)
+    {
+        if (!links.contains(link)) links.append(link);
+    }
+
+    // Target of the message, 0 for broadcast or messages without target
+    void target(const mavlink_message_t& message, quint8& system, quint8& component)
+    {
+        system = 0;
+        component = 0;
+#ifdef MAVLINK_V2
+        const mavlink_msg_entry_t* entry = mavlink_get_msg_entry(message.msgid);
+        if (!entry) return;
+
+        const quint8* payload = reinterpret_cast<const quint8*>(_MAV_PAYLOAD(&message));
+        // Trailing zeros of MAVLink 2 payload are truncated, so offset past length is 0
+        if ((entry->flags & MAV_MSG_ENTRY_FLAG_HAVE_TARGET_SYSTEM) &&
+            entry->target_system_ofs < message.len)
+        {
+            system = payload[entry->target_system_ofs];
+        }
+        if ((entry->flags & MAV_MSG_ENTRY_FLAG_HAVE_TARGET_COMPONENT) &&
+            entry->target_component_ofs < message.len)
+        {
+            component = payload[entry->target_component_ofs];
+        }
+#else
+        // MAVLink 1 has no entry table, offsets are looked up in message info once
+        struct Offsets
+        {
+            int system = -1;
+            int component = -1;
+        };
+        static const QVector<Offsets> offsets = []() {
+            static const mavlink_message_info_t infos[256] = MAVLINK_MESSAGE_INFO;
+
+            QVector<Offsets> result(256);
+            for (int msgid = 0; msgid < 256; ++msgid)
+            {
+                for (unsigned i = 0; i < infos[msgid].num_fields; ++i)
+                {
+                    const mavlink_field_info_t& field = infos[msgid].fields[i];
+                    if (qstrcmp(field.name, "target_system") == 0)
+                    {
+                        result[msgid].system = field.wire_offset;
+                    }
+                    else if (qstrcmp(field.name, "target_component") == 0)
+                    {
+                        result[msgid].component = field.wire_offset;
+                    }
+                }
+            }
+            return result;
+        }();
+
+        const Offsets& entry = offsets.at(message.msgid);
+        const quint8* payload = reinterpret_cast<const quint8*>(_MAV_PAYLOAD(&message));
+        if (entry.system > -1 && entry.system < message.len) system = payload[entry.system];
+        if (entry.component > -1 && entry.component < message.len)
+        {
+            component = payload[entry.component];
+        }
+#endif
+    }
+}
+
+MavLinkRouter::MavLinkRouter()
+{
+    m_clock.start();
+}
+
+QList<AbstractLink*> MavLinkRouter::route(const mavlink_message_t& message, int size,
+                                          AbstractLink* source, const QList<AbstractLink*>& links)
+{
+    ::learn(m_systems[message.sysid], source);
+    ::learn(m_components[(message.sysid << 8) | message.compid], source);
+
+    quint8 system;
+    quint8 component;
+    ::target(message, system, component);
+
+    QList<AbstractLink*> candidates;
+    if (system != 0)
+    {
+        candidates = component == 0 ? m_systems.value(system) :
+                                      m_components.value((system << 8) | component,
+                                                         m_systems.value(system));
+    }
+
+    // Broadcast, and targets not heard yet, go everywhere but back where the sender lives
+    if (candidates.isEmpty())
+    {
+        const QList<AbstractLink*>& senderLinks = m_systems.value(message.sysid);
+        for (AbstractLink* link: links)
+        {
+            if (!senderLinks.contains(link)) candidates.append(link);
+        }
+    }
+    candidates.removeAll(source);
+
+    QList<AbstractLink*> result;
+    for (AbstractLink* link: candidates)
+    {
+        if (this->accepts(link, message, size)) result.append(link);
+    }
+    return result;
+}
+
+void MavLinkRouter::removeLink(AbstractLink* link)
+{
+    for (auto it = m_systems.begin(); it != m_systems.end(); ++it) it->removeAll(link);
+    for (auto it = m_components.begin(); it != m_components.end(); ++it) it->removeAll(link);
+    m_buckets.remove(link);
+}
+
+bool MavLinkRouter::accepts(AbstractLink* link, const mavlink_message_t& message, int size)
+{
+    if (!link->isConnected()) return false;
+
+    const RouteFilter& filter = link->routeFilter();
+    if (!filter.accepts(message.msgid)) return false;
+    if (filter.maxRate <= 0) return true;
+
+    // Each link refills for its own idle time, however rarely it is a candidate
+    Bucket& bucket = m_buckets[link];
+    qint64 now = m_clock.elapsed();
+    double capacity = filter.maxRate * ::burstWindow / 1000.0;
+    bucket.tokens = bucket.lastRefill < 0 ? capacity :
+                        qMin(bucket.tokens + (now - bucket.lastRefill) * filter.maxRate / 1000.0,
+                             capacity);
+    bucket.lastRefill = now;
+
+    if (bucket.tokens < size) return false;
+
+    bucket.tokens -= size;
+    return true;
+}
@@ -0,0 +1,47 @@
+#ifndef MAVLINK_ROUTER_H
+#define MAVLINK_ROUTER_H
+
+// MAVLink
+#include <mavlink_types.h>
+
+// Qt
+#include <QMap>
+#include <QHash>
+#include <QElapsedTimer>
+
+namespace comm
+{
+    class AbstractLink;
+
+    // Forwards frames between links by their target, like mavlink-router does:
+    // learns where every system and component is heard, sends targeted frames
+    // only there and broadcasts, or targets not heard yet, to every other link.
+    // Owned by communicator's thread
+    class MavLinkRouter
+    {
+    public:
+        MavLinkRouter();
+
+        // Links message heard on source link should be forwarded to,
+        // filtered by per link route filters and rate limits
+        QList<AbstractLink*> route(const mavlink_message_t& message, int size,
+                                   AbstractLink* source, const QList<AbstractLink*>& links);
+
+        void removeLink(AbstractLink* link);
+
+    private:
+        bool accepts(AbstractLink* link, const mavlink_message_t& message, int size);
+
+        QHash<quint8, QList<AbstractLink*> > m_systems; // sysid -> links it is heard on
+        QHash<quint16, QList<AbstractLink*> > m_components; // sysid << 8 | compid -> links
+        struct Bucket
+        {
+            double tokens = 0;
+            qint64 lastRefill = -1;
+        };
+        QMap<AbstractLink*, Bucket> m_buckets; // Rate limited links only
+        QElapsedTimer m_clock;
+    };
+}
+
+#endif // MAVLINK_ROUTER_H
@@ -0,0 +1,97 @@
+#include "message_counter.h"
+
+// MAVLink
+#include <mavlink.h>
+
+using namespace comm;
+
+namespace
+{
+    void add(dto::TrafficCounters& counters, int bytes)
+    {
+        counters.packets++;
+        counters.bytes += bytes;
+    }
+
+    template <typename Array>
+    void collect(Array& counters, QMap<int, dto::TrafficCounters>& map)
+    {
+        for (int id = 0; id < int(counters.size()); ++id)
+        {
+            if (counters[id].packets == 0) continue;
+
+            map[id] = counters[id];
+            counters[id] = dto::TrafficCounters();
+        }
+    }
+}
+
+MessageCounter::MessageCounter()
+{}
+
+int MessageCounter::count(const mavlink_message_t& message)
+{
+    int bytes = MessageCounter::packetSize(message);
+
+    dto::TrafficCounters& system = m_systems[message.sysid];
+    ::add(system, bytes);
+
+    if (message.msgid < m_messages.size()) ::add(m_messages[message.msgid], bytes);
+    else ::add(m_extendedMessages[message.msgid], bytes);
+
+    quint16 key = (message.sysid << 8) | message.compid;
+    auto it = m_sequences.find(key);
+    if (it == m_sequences.end())
+    {
+        m_sequences.insert(key, message.seq);
+        return 0;
+    }
+
+    // Sequence wraps at 256, short forward jump is a loss, long one is reordering
+    quint8 lost = message.seq - it.value() - 1;
+    it.value() = message.seq;
+    if (lost >= 128) return 0;
+
+    system.gaps += lost;
+    return lost;
+}
+
+void MessageCounter::setDropsTotal(int drops)
+{
+    if (m_dropsTotal > -1 && drops >= m_dropsTotal) m_drops += drops - m_dropsTotal;
+    m_dropsTotal = drops;
+}
+
+dto::LinkTraffic MessageCounter::take()
+{
+    dto::LinkTraffic traffic;
+
+    ::collect(m_systems, traffic.systems);
+    ::collect(m_messages, traffic.messages);
+
+    for (auto it = m_extendedMessages.begin(); it != m_extendedMessages.end(); ++it)
+    {
+        if (it.value().packets == 0) continue;
+
+        traffic.messages[it.key()] = it.value();
+        it.value() = dto::TrafficCounters();
+    }
+
+    traffic.drops = m_drops;
+    m_drops = 0;
+
+    return traffic;
+}
+
+int MessageCounter::packetSize(const mavlink_message_t& message)
+{
+#ifdef MAVLINK_V2
+    if (message.magic == MAVLINK_STX_MAVLINK1) return message.len + 8;
+
+    int size = message.len + MAVLINK_NUM_NON_PAYLOAD_BYTES;
+    if (message.incompat_flags & MAVLINK_IFLAG_SIGNED) size += MAVLINK_SIGNATURE_BLOCK_LEN;
+    return size;
+#else
+    return message.len + MAVLINK_NUM_NON_PAYLOAD_BYTES;
+#endif
+}
@@ -0,0 +1,45 @@
+#ifndef MESSAGE_COUNTER_H
+#define MESSAGE_COUNTER_H
+
+// MAVLink
+#include <mavlink_types.h>
+
+// Qt
+#include <QHash>
+
+// Internal
+#include "link_traffic.h"
+
+// Std
+#include <array>
+
+namespace comm
+{
+    // Traffic counters of one link, owned and updated by communicator's thread only,
+    // so parse path needs no locks. Common ids hit flat arrays, rare ones a hash
+    class MessageCounter
+    {
+    public:
+        MessageCounter();
+
+        // Returns packets of the sender lost just before this one
+        int count(const mavlink_message_t& message);
+        void setDropsTotal(int drops); // Parser's cumulative drop count
+
+        // Counters since previous take, resets them
+        dto::LinkTraffic take();
+
+        // Bytes of the frame message was parsed from, as it was on the wire
+        static int packetSize(const mavlink_message_t& message);
+
+    private:
+        std::array<dto::TrafficCounters, 256> m_systems;
+        std::array<dto::TrafficCounters, 256> m_messages;
+        QHash<quint32, dto::TrafficCounters> m_extendedMessages; // MAVLink 2 ids above 255
+        QHash<quint16, quint8> m_sequences; // sysid << 8 | compid -> last seq
+        int m_drops = 0;
+        int m_dropsTotal = -1;
+    };
+}
+
+#endif // MESSAGE_COUNTER_H
@@ -0,0 +1,57 @@
+#include "rtt_estimator.h"
+
+namespace
+{
+    const double alpha = 0.125;
+    const double beta = 0.25;
+    const int varianceFactor = 4;
+}
+
+using namespace comm;
+
+RttEstimator::RttEstimator(int initialTimeout, int minTimeout, int maxTimeout):
+    m_initialTimeout(initialTimeout),
+    m_minTimeout(minTimeout),
+    m_maxTimeout(maxTimeout),
+    m_timeout(initialTimeout)
+{}
+
+int RttEstimator::timeout() const
+{
+    return m_timeout;
+}
+
+int RttEstimator::smoothedRtt() const
+{
+    return m_srtt;
+}
+
+void RttEstimator::addSample(int rtt)
+{
+    if (m_hasSample)
+    {
+        m_rttvar = (1 - ::beta) * m_rttvar + ::beta * qAbs(m_srtt - rtt);
+        m_srtt = (1 - ::alpha) * m_srtt + ::alpha * rtt;
+    }
+    else
+    {
+        m_srtt = rtt;
+        m_rttvar = rtt / 2.0;
+        m_hasSample = true;
+    }
+
+    m_timeout = qBound(m_minTimeout, int(m_srtt + ::varianceFactor * m_rttvar), m_maxTimeout);
+}
+
+void RttEstimator::backoff()
+{
+    m_timeout = qMin(m_timeout * 2, m_maxTimeout);
+}
+
+void RttEstimator::reset()
+{
+    m_srtt = 0;
+    m_rttvar = 0;
+    m_timeout = m_initialTimeout;
+    m_hasSample = false;
+}
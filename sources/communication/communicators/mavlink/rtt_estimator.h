@@ -0,0 +1,35 @@
+#ifndef RTT_ESTIMATOR_H
+#define RTT_ESTIMATOR_H
+
+// Qt
+#include <QtGlobal>
+
+namespace comm
+{
+    // Retransmission timeout from smoothed round trip time and its variance (RFC 6298)
+    class RttEstimator
+    {
+    public:
+        RttEstimator(int initialTimeout = 2000, int minTimeout = 100, int maxTimeout = 10000);
+
+        int timeout() const;
+        int smoothedRtt() const;
+
+        // Feed only replies to requests sent once, retransmitted ones are ambiguous (Karn)
+        void addSample(int rtt);
+        void backoff();
+        void reset();
+
+    private:
+        int m_initialTimeout;
+        int m_minTimeout;
+        int m_maxTimeout;
+
+        double m_srtt = 0;
+        double m_rttvar = 0;
+        int m_timeout;
+        bool m_hasSample = false;
+    };
+}
+
+#endif // RTT_ESTIMATOR_H
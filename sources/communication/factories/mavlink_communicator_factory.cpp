@@ -8,7 +8,10 @@
 #include "heartbeat_handler.h"
 #include "system_status_handler.h"
 #include "system_time_handler.h"
+#include "timesync_handler.h"
 #include "autopilot_version_handler.h"
+#include "parameter_handler.h"
+#include "log_download_handler.h"
 #include "attitude_handler.h"
 #include "imu_handler.h"
 #include "vibration_handler.h"
@@ -24,10 +27,12 @@
 #include "wind_handler.h"
 #include "radio_status_handler.h"
 #include "radio_handler.h"
+#include "stream_rate_handler.h"
 #include "nav_controller_handler.h"
 #include "target_position_handler.h"
 #include "command_handler.h"
 #include "mission_handler.h"
+#include "ftp_handler.h"
 #include "attitude_target_handler.h"
 #include "land_target_handler.h"
 
@@ -37,21 +42,27 @@
 
 using namespace comm;
 
-MavLinkCommunicatorFactory::MavLinkCommunicatorFactory(quint8 systemId, quint8 componentId):
+MavLinkCommunicatorFactory::MavLinkCommunicatorFactory(quint8 systemId, quint8 componentId,
+                                                       bool routing):
     ICommunicatorFactory(),
     m_systemId(systemId),
-    m_componentId(componentId)
+    m_componentId(componentId),
+    m_routing(routing)
 {}
 
 AbstractCommunicator* MavLinkCommunicatorFactory::create()
 {
     auto communicator = new MavLinkCommunicator(m_systemId, m_componentId);
+    communicator->setRoutingEnabled(m_routing);
 
     communicator->addHandler(new PingHandler(communicator));
     communicator->addHandler(new HeartbeatHandler(communicator));
     communicator->addHandler(new SystemStatusHandler(communicator));
     communicator->addHandler(new SystemTimeHandler(communicator));
+    communicator->addHandler(new TimesyncHandler(communicator));
     communicator->addHandler(new AutopilotVersionHandler(communicator));
+    communicator->addHandler(new ParameterHandler(communicator));
+    communicator->addHandler(new LogDownloadHandler(communicator));
     communicator->addHandler(new AttitudeHandler(communicator));
     communicator->addHandler(new ImuHandler(communicator));
     communicator->addHandler(new VibrationHandler(communicator));
@@ -67,10 +78,12 @@ AbstractCommunicator* MavLinkCommunicatorFactory::create()
     communicator->addHandler(new WindHandler(communicator));
     communicator->addHandler(new RadioStatusHandler(communicator));
     communicator->addHandler(new RadioHandler(communicator));
+    communicator->addHandler(new StreamRateHandler(communicator));
     communicator->addHandler(new NavControllerHandler(communicator));
     communicator->addHandler(new TargetPositionHandler(communicator));
     communicator->addHandler(new CommandHandler(communicator));
     communicator->addHandler(new MissionHandler(communicator));
+    communicator->addHandler(new FtpHandler(communicator));
     communicator->addHandler(new AttitudeTargetHandler(communicator));
     communicator->addHandler(new LandTargetHandler(communicator));
 
@@ -8,13 +8,14 @@ namespace comm
     class MavLinkCommunicatorFactory: public ICommunicatorFactory
     {
     public:
-        MavLinkCommunicatorFactory(quint8 systemId, quint8 componentId);
+        MavLinkCommunicatorFactory(quint8 systemId, quint8 componentId, bool routing = false);
 
         AbstractCommunicator* create() override;
 
     private:
         quint8 m_systemId;
         quint8 m_componentId;
+        bool m_routing;
     };
 }
 
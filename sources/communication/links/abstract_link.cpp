@@ -9,6 +9,21 @@ AbstractLink::AbstractLink(QObject* parent):
     QObject(parent)
 {}
 
+int AbstractLink::bandwidth() const
+{
+    return 0;
+}
+
+const RouteFilter& AbstractLink::routeFilter() const
+{
+    return m_routeFilter;
+}
+
+void AbstractLink::setRouteFilter(const RouteFilter& filter)
+{
+    m_routeFilter = filter;
+}
+
 int AbstractLink::takeBytesReceived()
 {
     int value = m_bytesReceived;
@@ -4,6 +4,9 @@
 // Qt
 #include <QObject>
 
+// Internal
+#include "route_filter.h"
+
 namespace comm
 {
     class AbstractLink: public QObject
@@ -14,6 +17,11 @@ namespace comm
         explicit AbstractLink(QObject* parent = nullptr);
 
         virtual bool isConnected() const = 0;
+        // Outgoing bytes per second, 0 if link is not rate limited
+        virtual int bandwidth() const;
+
+        const RouteFilter& routeFilter() const;
+        void setRouteFilter(const RouteFilter& filter);
 
         int takeBytesReceived();
         int takeBytesSent();
@@ -38,6 +46,7 @@ namespace comm
     private:
         int m_bytesReceived = 0;
         int m_bytesSent = 0;
+        RouteFilter m_routeFilter;
     };
 }
 
@@ -11,8 +11,30 @@ using namespace comm;
 
 namespace
 {
+    QSet<quint32> parseIds(const QString& ids)
+    {
+        QSet<quint32> set;
+        for (const QString& id: ids.split(",", QString::SkipEmptyParts))
+        {
+            set.insert(id.trimmed().toUInt());
+        }
+        return set;
+    }
+
+    void updateRouteFilter(AbstractLink* link, const LinkDescriptionPtr& description)
+    {
+        RouteFilter filter;
+        filter.allowedMessages = ::parseIds(
+                    description->parameter(dto::LinkDescription::RouteAllowed).toString());
+        filter.blockedMessages = ::parseIds(
+                    description->parameter(dto::LinkDescription::RouteBlocked).toString());
+        filter.maxRate = description->parameter(dto::LinkDescription::RouteRate).toInt();
+        link->setRouteFilter(filter);
+    }
+
     UdpLink* updateUdpLink(UdpLink* udpLink, const LinkDescriptionPtr& description)
     {
+        ::updateRouteFilter(udpLink, description);
         udpLink->setPort(description->parameter(dto::LinkDescription::Port).toInt());
 
         udpLink->setAutoResponse(
@@ -37,6 +59,7 @@ namespace
 
     SerialLink* updateSerialLink(SerialLink* serialLink, const LinkDescriptionPtr& description)
     {
+        ::updateRouteFilter(serialLink, description);
         serialLink->setDevice(description->parameter(dto::LinkDescription::Device).toString());
         serialLink->setBaudRate(description->parameter(dto::LinkDescription::BaudRate).toInt());
 
@@ -0,0 +1,24 @@
+#ifndef ROUTE_FILTER_H
+#define ROUTE_FILTER_H
+
+// Qt
+#include <QSet>
+
+namespace comm
+{
+    // What link takes from router, applies only to frames forwarded from other links
+    struct RouteFilter
+    {
+        QSet<quint32> allowedMessages; // Empty allows all
+        QSet<quint32> blockedMessages;
+        int maxRate = 0; // Bytes per second, 0 is unlimited
+
+        bool accepts(quint32 msgId) const
+        {
+            return !blockedMessages.contains(msgId) &&
+                    (allowedMessages.isEmpty() || allowedMessages.contains(msgId));
+        }
+    };
+}
+
+#endif // ROUTE_FILTER_H
@@ -4,14 +4,32 @@
 #include <QSerialPort>
 #include <QDebug>
 
+// Internal
+#include "serial_reader.h"
+
 using namespace comm;
 
+namespace
+{
+    const int delayWindow = 5000; // ms
+    const qint64 delayBound = 10000; // us from read to parser, reported if exceeded
+    const int receivedReserve = 16384;
+}
+
 SerialLink::SerialLink(const QString& portName, qint32 baudRate,
                        QObject* parent):
     AbstractLink(parent),
-    m_port(new QSerialPort(portName, this))
+    m_port(new QSerialPort(portName, this)),
+    m_reader(new SerialReader(this))
 {
     m_port->setBaudRate(baudRate);
+    m_received.reserve(::receivedReserve);
+    m_delayWindow.start();
+
+    connect(m_reader, &SerialReader::readyRead, this, &SerialLink::readReaderData,
+            Qt::QueuedConnection);
+    connect(m_reader, &SerialReader::failed, this, &SerialLink::onReaderFailed,
+            Qt::QueuedConnection);
 
     connect(m_port, &QSerialPort::readyRead, this, &SerialLink::readSerialData);
     connect(m_port, static_cast<void(QSerialPort::*)
@@ -21,7 +39,12 @@ SerialLink::SerialLink(const QString& portName, qint32 baudRate,
 
 bool SerialLink::isConnected() const
 {
-    return m_port->isOpen();
+    return m_reader->isOpen() || m_port->isOpen();
+}
+
+int SerialLink::bandwidth() const
+{
+    return m_port->baudRate() / 10; // Start and stop bits for every byte
 }
 
 QString SerialLink::device() const
@@ -38,6 +61,14 @@ void SerialLink::connectLink()
 {
     if (this->isConnected()) return;
 
+    if (m_reader->open(m_port->portName(), m_port->baudRate()))
+    {
+        emit upChanged(true);
+        return;
+    }
+    qWarning("Serial reader unavailable: '%s', using event loop",
+           qPrintable(m_reader->errorString()));
+
     if (!m_port->open(QIODevice::ReadWrite))
     {
         qWarning("Serial port connection error: '%s'!",
@@ -55,13 +86,15 @@ void SerialLink::disconnectLink()
 {
     if (!this->isConnected()) return;
 
+    m_reader->close();
     m_port->close();
     emit upChanged(false);
 }
 
 void SerialLink::sendDataImpl(const QByteArray& data)
 {
-    m_port->write(data.data(), data.size());
+    if (m_reader->isOpen()) m_reader->write(data);
+    else m_port->write(data.data(), data.size());
 }
 
 void SerialLink::setDevice(QString device)
@@ -78,6 +111,12 @@ void SerialLink::setBaudRate(qint32 baudRate)
 
     m_port->setBaudRate(baudRate);
     emit baudRateChanged(m_port->baudRate());
+
+    if (m_reader->isOpen()) // Reader can't change speed on the fly, reopen it
+    {
+        this->disconnectLink();
+        this->connectLink();
+    }
 }
 
 void SerialLink::readSerialData()
@@ -85,7 +124,43 @@ void SerialLink::readSerialData()
     this->receiveData(m_port->readAll());
 }
 
+void SerialLink::readReaderData()
+{
+    qint64 delay = m_reader->take(m_received);
+    if (m_received.isEmpty()) return;
+
+    this->receiveData(m_received);
+    this->measureDelay(delay);
+}
+
 void SerialLink::onError()
 {
     if (m_port->error() == QSerialPort::ResourceError && this->isConnected()) this->disconnectLink();
 }
+
+void SerialLink::onReaderFailed()
+{
+    qWarning("Serial port read error: '%s'!", qPrintable(m_reader->errorString()));
+
+    this->disconnectLink();
+}
+
+void SerialLink::measureDelay(qint64 delay)
+{
+    m_delayMax = qMax(m_delayMax, delay);
+    m_delaySum += delay;
+    m_delayCount++;
+
+    if (m_delayWindow.elapsed() < ::delayWindow) return;
+
+    if (m_delayMax > ::delayBound)
+    {
+        qWarning("Serial read delay on '%s': mean %lld us, max %lld us",
+                 qPrintable(m_port->portName()), m_delaySum / m_delayCount, m_delayMax);
+    }
+
+    m_delayWindow.restart();
+    m_delayMax = 0;
+    m_delaySum = 0;
+    m_delayCount = 0;
+}
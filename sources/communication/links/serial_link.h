@@ -3,10 +3,17 @@
 
 #include "abstract_link.h"
 
+// Qt
+#include <QElapsedTimer>
+
 class QSerialPort;
 
 namespace comm
 {
+    class SerialReader;
+
+    // Uses SerialReader thread where platform and baud rate allow it,
+    // QSerialPort on the communication event loop otherwise
     class SerialLink: public AbstractLink
     {
         Q_OBJECT
@@ -16,6 +23,7 @@ namespace comm
                    qint32 baudRate = 0, QObject* parent = nullptr);
 
         bool isConnected() const override;
+        int bandwidth() const override;
 
         QString device() const;
         qint32 baudRate() const;
@@ -35,10 +43,21 @@ namespace comm
 
     private slots:
         void readSerialData();
+        void readReaderData();
         void onError();
+        void onReaderFailed();
 
     private:
+        void measureDelay(qint64 delay);
+
         QSerialPort* m_port;
+        SerialReader* m_reader;
+        QByteArray m_received; // Reused for every batch from reader
+
+        QElapsedTimer m_delayWindow;
+        qint64 m_delayMax = 0;
+        qint64 m_delaySum = 0;
+        int m_delayCount = 0;
     };
 }
 
@@ -0,0 +1,331 @@
+#include "serial_reader.h"
+
+// Qt
+#include <QMutexLocker>
+
+#ifdef Q_OS_UNIX
+// Std
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <sys/ioctl.h>
+#ifdef Q_OS_LINUX
+#include <linux/serial.h>
+#endif
+#endif
+
+using namespace comm;
+
+namespace
+{
+    const int bufferSize = 4096;
+    const int pendingReserve = 16384;
+    const int maxOutgoing = 65536; // About a second of 460800 baud, more is stale anyway
+    const int pollTimeout = 100; // ms
+
+#ifdef Q_OS_UNIX
+    speed_t speed(qint32 baudRate)
+    {
+        switch (baudRate)
+        {
+        case 9600: return B9600;
+        case 19200: return B19200;
+        case 38400: return B38400;
+        case 57600: return B57600;
+        case 115200: return B115200;
+        case 230400: return B230400;
+#ifdef B460800
+        case 460800: return B460800;
+#endif
+#ifdef B500000
+        case 500000: return B500000;
+#endif
+#ifdef B921600
+        case 921600: return B921600;
+#endif
+#ifdef B1500000
+        case 1500000: return B1500000;
+#endif
+        default: return B0;
+        }
+    }
+#endif
+}
+
+SerialReader::SerialReader(QObject* parent):
+    QThread(parent)
+{
+    m_pending.reserve(::pendingReserve);
+    m_clock.start();
+}
+
+SerialReader::~SerialReader()
+{
+    this->close();
+}
+
+bool SerialReader::open(const QString& device, qint32 baudRate)
+{
+    this->close();
+
+#ifdef Q_OS_UNIX
+    speed_t baud = ::speed(baudRate);
+    if (baud == B0)
+    {
+        m_errorString = tr("Unsupported baud rate");
+        return false;
+    }
+
+    QString path = device.startsWith('/') ? device : "/dev/" + device;
+    m_fd = ::open(path.toLocal8Bit().constData(), O_RDWR | O_NOCTTY | O_CLOEXEC | O_NONBLOCK);
+    if (m_fd < 0)
+    {
+        m_errorString = QString::fromLocal8Bit(::strerror(errno));
+        return false;
+    }
+
+    if (::pipe(m_wake) < 0)
+    {
+        m_errorString = QString::fromLocal8Bit(::strerror(errno));
+        this->close();
+        return false;
+    }
+    for (int fd: m_wake)
+    {
+        ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+        ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+    }
+
+    termios options;
+    if (::ioctl(m_fd, TIOCEXCL) < 0 || ::tcgetattr(m_fd, &options) < 0)
+    {
+        m_errorString = QString::fromLocal8Bit(::strerror(errno));
+        this->close();
+        return false;
+    }
+
+    ::cfmakeraw(&options);
+    options.c_cflag |= CLOCAL | CREAD;
+    options.c_cflag &= ~(CSTOPB | PARENB | CRTSCTS);
+    // Readiness comes from poll, reads just take what is there
+    options.c_cc[VMIN] = 0;
+    options.c_cc[VTIME] = 0;
+    ::cfsetispeed(&options, baud);
+    ::cfsetospeed(&options, baud);
+
+    if (::tcsetattr(m_fd, TCSANOW, &options) < 0)
+    {
+        m_errorString = QString::fromLocal8Bit(::strerror(errno));
+        this->close();
+        return false;
+    }
+    ::tcflush(m_fd, TCIOFLUSH);
+
+#ifdef Q_OS_LINUX
+    // Drivers supporting it (e.g. FTDI) drop their latency timer from 16 ms to 1 ms
+    serial_struct serial;
+    if (::ioctl(m_fd, TIOCGSERIAL, &serial) == 0)
+    {
+        serial.flags |= ASYNC_LOW_LATENCY;
+        ::ioctl(m_fd, TIOCSSERIAL, &serial);
+    }
+#endif
+
+    this->start(QThread::TimeCriticalPriority);
+    return true;
+#else
+    Q_UNUSED(device)
+    Q_UNUSED(baudRate)
+    m_errorString = tr("Not supported on this platform");
+    return false;
+#endif
+}
+
+void SerialReader::close()
+{
+    if (this->isRunning())
+    {
+        this->requestInterruption();
+        this->wake();
+        this->wait();
+    }
+
+#ifdef Q_OS_UNIX
+    if (m_fd >= 0) ::close(m_fd);
+    for (int& fd: m_wake)
+    {
+        if (fd >= 0) ::close(fd);
+        fd = -1;
+    }
+#endif
+    m_fd = -1;
+
+    {
+        QMutexLocker locker(&m_writeMutex);
+        m_outgoing.clear();
+    }
+
+    QMutexLocker locker(&m_mutex);
+    m_pending.resize(0);
+}
+
+bool SerialReader::isOpen() const
+{
+    return m_fd >= 0;
+}
+
+QString SerialReader::errorString() const
+{
+    return m_errorString;
+}
+
+qint64 SerialReader::write(const QByteArray& data)
+{
+#ifdef Q_OS_UNIX
+    if (m_fd < 0) return -1;
+
+    QMutexLocker locker(&m_writeMutex);
+
+    qint64 written = 0;
+    while (m_outgoing.isEmpty() && written < data.size()) // Queued bytes go first
+    {
+        ssize_t result = ::write(m_fd, data.constData() + written, data.size() - written);
+        if (result < 0)
+        {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN) break;
+            return -1;
+        }
+        written += result;
+    }
+    if (written == data.size()) return written;
+
+    if (m_outgoing.size() + data.size() - written > ::maxOutgoing) return written;
+
+    bool idle = m_outgoing.isEmpty();
+    m_outgoing.append(data.constData() + written, data.size() - written);
+    if (idle) this->wake();
+
+    return data.size();
+#else
+    Q_UNUSED(data)
+    return -1;
+#endif
+}
+
+qint64 SerialReader::take(QByteArray& data)
+{
+    data.resize(0);
+
+    QMutexLocker locker(&m_mutex);
+    if (m_pending.isEmpty()) return 0;
+
+    m_pending.swap(data);
+    return (m_clock.nsecsElapsed() - m_pendingSince) / 1000;
+}
+
+void SerialReader::run()
+{
+#ifdef Q_OS_UNIX
+    char buffer[::bufferSize];
+    pollfd fds[2];
+    fds[0].fd = m_fd;
+    fds[1].fd = m_wake[0];
+    fds[1].events = POLLIN;
+
+    while (!this->isInterruptionRequested())
+    {
+        {
+            QMutexLocker locker(&m_writeMutex);
+            fds[0].events = m_outgoing.isEmpty() ? POLLIN : POLLIN | POLLOUT;
+        }
+
+        int ready = ::poll(fds, 2, ::pollTimeout);
+        if (ready < 0 && errno != EINTR)
+        {
+            m_errorString = QString::fromLocal8Bit(::strerror(errno));
+            emit failed();
+            return;
+        }
+        if (ready <= 0) continue;
+
+        if (fds[1].revents & POLLIN)
+        {
+            while (::read(m_wake[0], buffer, sizeof(buffer)) > 0);
+        }
+
+        if (fds[0].revents & (POLLERR | POLLHUP | POLLNVAL))
+        {
+            m_errorString = tr("Serial device disconnected");
+            emit failed();
+            return;
+        }
+
+        if ((fds[0].revents & POLLOUT) && !this->flush())
+        {
+            emit failed();
+            return;
+        }
+
+        if (!(fds[0].revents & POLLIN)) continue;
+
+        ssize_t result = ::read(m_fd, buffer, sizeof(buffer));
+        if (result == 0) continue;
+        if (result < 0)
+        {
+            if (errno == EINTR || errno == EAGAIN) continue;
+
+            m_errorString = QString::fromLocal8Bit(::strerror(errno));
+            emit failed();
+            return;
+        }
+
+        bool notify;
+        {
+            QMutexLocker locker(&m_mutex);
+            notify = m_pending.isEmpty();
+            if (notify) m_pendingSince = m_clock.nsecsElapsed();
+            m_pending.append(buffer, result);
+        }
+
+        // Owner takes everything at once, no need to flood its event queue
+        if (notify) emit readyRead();
+    }
+#endif
+}
+
+bool SerialReader::flush()
+{
+#ifdef Q_OS_UNIX
+    QMutexLocker locker(&m_writeMutex);
+
+    while (!m_outgoing.isEmpty())
+    {
+        ssize_t result = ::write(m_fd, m_outgoing.constData(), m_outgoing.size());
+        if (result < 0)
+        {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN) return true;
+
+            m_errorString = QString::fromLocal8Bit(::strerror(errno));
+            return false;
+        }
+        m_outgoing.remove(0, result);
+    }
+#endif
+    return true;
+}
+
+void SerialReader::wake()
+{
+#ifdef Q_OS_UNIX
+    char byte = 0;
+    if (m_wake[1] >= 0 && ::write(m_wake[1], &byte, 1) < 0)
+    {
+        // Pipe full means thread is to be woken anyway
+    }
+#endif
+}
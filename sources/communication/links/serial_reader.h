@@ -0,0 +1,61 @@
+#ifndef SERIAL_READER_H
+#define SERIAL_READER_H
+
+// Qt
+#include <QThread>
+#include <QMutex>
+#include <QElapsedTimer>
+
+namespace comm
+{
+    // Serial port backend polling the port on its own thread, so incoming
+    // bytes don't wait for a busy event loop to notice them. Reads are coalesced
+    // into one pending buffer, owner is notified once per batch, not per read.
+    // Writes never block the caller, what the driver can't take yet is queued
+    // and flushed by the thread. Available on Unix only, open() fails elsewhere
+    // and QSerialPort is used instead
+    class SerialReader: public QThread
+    {
+        Q_OBJECT
+
+    public:
+        explicit SerialReader(QObject* parent = nullptr);
+        ~SerialReader() override;
+
+        bool open(const QString& device, qint32 baudRate);
+        void close();
+        bool isOpen() const;
+        QString errorString() const;
+
+        // Returns bytes written or queued, bytes over the queue limit are dropped
+        qint64 write(const QByteArray& data);
+
+        // Swaps pending bytes into data, so both buffers keep their capacity.
+        // Returns how long the oldest of them waited, microseconds
+        qint64 take(QByteArray& data);
+
+    signals:
+        void readyRead();
+        void failed();
+
+    protected:
+        void run() override;
+        bool flush();
+        void wake();
+
+    private:
+        int m_fd = -1;
+        int m_wake[2] = { -1, -1 }; // Pipe interrupting poll for writes and close
+        QString m_errorString;
+
+        QMutex m_writeMutex;
+        QByteArray m_outgoing;
+
+        QMutex m_mutex;
+        QByteArray m_pending;
+        qint64 m_pendingSince = 0;
+        QElapsedTimer m_clock;
+    };
+}
+
+#endif // SERIAL_READER_H
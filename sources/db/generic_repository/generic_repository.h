@@ -4,6 +4,7 @@
 // Qt
 #include <QSqlQuery>
 #include <QHash>
+#include <QVariantMap>
 #include <QSharedPointer>
 
 namespace db
@@ -19,8 +20,10 @@ namespace db
         bool insert(const QSharedPointer<T>& entity);
         bool update(const QSharedPointer<T>& entity);
         bool remove(const QSharedPointer<T>& entity);
+        bool remove(const QList< QSharedPointer<T> >& entities); // All or nothing, in one statement
 
         bool save(const QSharedPointer<T>& entity);
+        bool save(const QList< QSharedPointer<T> >& entities); // All or nothing, in one transaction
         bool contains(int id);
         void unload(int id);
         void clear();
@@ -37,11 +40,16 @@ namespace db
         void bindQuery(QSqlQuery& query, const QMetaObject& meta, T* entity);
         void updateFromQuery(const QSqlQuery& query, const QMetaObject& meta, T* entity);
 
+        QVariantMap columnValues(const QMetaObject& meta, T* entity);
+
     private:
         QSqlQuery m_query;
+        QSqlQuery m_insertQuery; // Column set never changes, so it is prepared once
         const QString m_tableName;
         QStringList m_columnNames;
         QHash<int, QSharedPointer<T> > m_map;
+        QHash<int, QVariantMap> m_persisted; // Last values written to/read from the table
+
     };
 }
 
@@ -5,6 +5,7 @@
 
 // Qt
 #include <QMetaProperty>
+#include <QSqlDatabase>
 #include <QSqlError>
 #include <QDebug>
 
@@ -25,27 +26,35 @@ GenericRepository<T>::~GenericRepository()
 template<class T>
 bool GenericRepository<T>::insert(const QSharedPointer<T>& entity)
 {
-    QStringList names;
-    QStringList values;
-
-    for (const QString& name: this->propertyNames(T::staticMetaObject))
+    if (m_insertQuery.lastQuery().isEmpty())
     {
-        if (!m_columnNames.contains(name)) continue;
+        QStringList names;
+        QStringList values;
+
+        for (const QString& name: this->propertyNames(T::staticMetaObject))
+        {
+            if (!m_columnNames.contains(name)) continue;
 
-        names.append(name);
-        values.append(":" + name);
+            names.append(name);
+            values.append(":" + name);
+        }
+
+        m_insertQuery.prepare("INSERT INTO " + m_tableName + " (" +
+                              names.join(", ") + ") VALUES (" + values.join(", ") + ")");
     }
 
-    m_query.prepare("INSERT INTO " + m_tableName + " (" +
-                    names.join(", ") + ") VALUES (" + values.join(", ") + ")");
-    this->bindQuery(m_query, T::staticMetaObject, entity.data());
+    this->bindQuery(m_insertQuery, T::staticMetaObject, entity.data());
 
-    if (this->runQuerry())
+    if (m_insertQuery.exec())
     {
-        entity->setId(m_query.lastInsertId().toInt());
+        entity->setId(m_insertQuery.lastInsertId().toInt());
         m_map[entity->id()] = entity;
+        m_persisted[entity->id()] = this->columnValues(T::staticMetaObject, entity.data());
         return true;
     }
+
+    // TODO: log with db log level
+    qDebug() << m_insertQuery.lastError() << m_insertQuery.executedQuery();
     return false;
 }
 
@@ -66,6 +75,7 @@ QSharedPointer<T> GenericRepository<T>::read(int id, bool reload)
             entity->setId(id);
             this->updateFromQuery(m_query, T::staticMetaObject, entity.data());
             m_map[id] = entity;
+            m_persisted[id] = this->columnValues(T::staticMetaObject, entity.data());
             return entity;
         }
         return QSharedPointer<T>();
@@ -76,21 +86,42 @@ QSharedPointer<T> GenericRepository<T>::read(int id, bool reload)
 template<class T>
 bool GenericRepository<T>::update(const QSharedPointer<T>& entity)
 {
-    QStringList placeholders;
+    QVariantMap values = this->columnValues(T::staticMetaObject, entity.data());
+    QHash<int, QVariantMap>::const_iterator persisted = m_persisted.constFind(entity->id());
 
-    for (const QString& name: this->propertyNames(T::staticMetaObject))
+    // Write only columns changed since last read or write, unknown state means all of them
+    QStringList changed;
+    for (const QString& name: values.keys())
     {
-        if (m_columnNames.contains(name)) placeholders.append(name + " = :" + name);
+        if (persisted == m_persisted.constEnd() || persisted->value(name) != values.value(name))
+        {
+            changed.append(name);
+        }
     }
 
+    m_map[entity->id()] = entity;
+    if (changed.isEmpty()) return true;
+
+    QStringList placeholders;
+    for (const QString& name: changed) placeholders.append(name + " = :" + name);
+
     m_query.prepare("UPDATE " + m_tableName + " SET " +
                     placeholders.join(", ") + " WHERE id = :id");
 
     m_query.bindValue(":id", entity->id());
-    this->bindQuery(m_query, T::staticMetaObject, entity.data());
+
+    const QMetaObject& meta = T::staticMetaObject;
+    for (int i = meta.propertyOffset(); i < meta.propertyCount(); ++i)
+    {
+        QString name = meta.property(i).name();
+        if (!changed.contains(name)) continue;
+
+        m_query.bindValue(QString(":") + name, meta.property(i).readOnGadget(entity.data()));
+    }
 
     if (!this->runQuerry()) return false;
-    m_map[entity->id()] = entity;
+
+    m_persisted[entity->id()] = values;
     return true;
 }
 
@@ -105,6 +136,22 @@ bool GenericRepository<T>::remove(const QSharedPointer<T>& entity)
     return true;
 }
 
+template<class T>
+bool GenericRepository<T>::remove(const QList<QSharedPointer<T> >& entities)
+{
+    if (entities.isEmpty()) return true;
+
+    QStringList ids;
+    for (const QSharedPointer<T>& entity: entities) ids.append(QString::number(entity->id()));
+
+    // One statement for whole list, ids are integers, so they are safe to inline
+    m_query.prepare("DELETE FROM " + m_tableName + " WHERE id IN (" + ids.join(",") + ")");
+    if (!this->runQuerry()) return false;
+
+    for (const QSharedPointer<T>& entity: entities) this->unload(entity->id());
+    return true;
+}
+
 template<class T>
 bool GenericRepository<T>::save(const QSharedPointer<T>& entity)
 {
@@ -119,6 +166,42 @@ bool GenericRepository<T>::save(const QSharedPointer<T>& entity)
     return true;
 }
 
+template<class T>
+bool GenericRepository<T>::save(const QList<QSharedPointer<T> >& entities)
+{
+    QSqlDatabase database = QSqlDatabase::database();
+    if (!database.transaction()) return false;
+
+    QList<QSharedPointer<T> > inserted;
+    bool ok = true;
+    for (const QSharedPointer<T>& entity: entities)
+    {
+        bool isNew = entity->id() == 0;
+        if (!this->save(entity))
+        {
+            ok = false;
+            break;
+        }
+        if (isNew) inserted.append(entity);
+    }
+
+    if (ok && database.commit()) return true;
+
+    database.rollback();
+
+    // Forget everything written within transaction, table has nothing of it now
+    for (const QSharedPointer<T>& entity: inserted)
+    {
+        this->unload(entity->id());
+        entity->setId(0);
+    }
+    for (const QSharedPointer<T>& entity: entities)
+    {
+        if (entity->id() > 0) m_persisted.remove(entity->id());
+    }
+    return false;
+}
+
 template<class T>
 bool GenericRepository<T>::contains(int id)
 {
@@ -129,12 +212,14 @@ template<class T>
 void GenericRepository<T>::unload(int id)
 {
     m_map.remove(id);
+    m_persisted.remove(id);
 }
 
 template<class T>
 void GenericRepository<T>::clear()
 {
     m_map.clear();
+    m_persisted.clear();
 }
 
 template<class T>
@@ -218,4 +303,23 @@ void GenericRepository<T>::updateFromQuery(const QSqlQuery& query, const QMetaOb
     }
 }
 
+template<class T>
+QVariantMap GenericRepository<T>::columnValues(const QMetaObject& meta, T* entity)
+{
+    QVariantMap values;
+
+    for (int i = meta.propertyOffset(); i < meta.propertyCount(); ++i)
+    {
+        QMetaProperty property = meta.property(i);
+        if (!m_columnNames.contains(property.name())) continue;
+
+        QVariant value = property.readOnGadget(entity);
+
+        // Enums are compared by value, as they are stored in the table
+        values[property.name()] = property.isEnumType() ? QVariant(value.toInt()) : value;
+    }
+
+    return values;
+}
+
 #endif // GENERIC_REPOSITORY_IMPL_H
@@ -5,6 +5,8 @@
 #include "default_params_migration.h"
 #include "alter_mission_migration.h"
 #include "alter_link_description_migration.h"
+#include "binary_parameters_migration.h"
+#include "parameter_cache_migration.h"
 
 using namespace db;
 
@@ -16,6 +18,8 @@ MigrationList DbMigrationFactory::create()
     list.append(new DefaultParamsMigration());
     list.append(new AlterMissionMigration());
     list.append(new AlterLinkDescriptionMigration());
+    list.append(new BinaryParametersMigration());
+    list.append(new ParameterCacheMigration());
 
     return list;
 }
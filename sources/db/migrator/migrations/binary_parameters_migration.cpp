@@ -0,0 +1,137 @@
+#include "binary_parameters_migration.h"
+
+// Qt
+#include <QSqlDatabase>
+#include <QMetaEnum>
+#include <QDebug>
+
+// Internal
+#include "mission_item.h"
+#include "link_description.h"
+#include "parameters_blob.h"
+
+using namespace dto;
+using namespace db;
+
+namespace
+{
+    QVariant fromLegacyValue(const QString& value)
+    {
+        if (value == "true") return true;
+        if (value == "false") return false;
+
+        bool ok = false;
+        int intValue = value.toInt(&ok);
+        if (ok) return intValue;
+
+        double doubleValue = value.toDouble(&ok);
+        if (ok) return doubleValue;
+
+        return value;
+    }
+
+    // Legacy "Key:value;Key:value" format
+    QMap<int, QVariant> parseLegacy(const QString& text, const QMetaEnum& enumerator)
+    {
+        QMap<int, QVariant> parameters;
+
+        for (const QString& pairs: text.split(";"))
+        {
+            QStringList pairList = pairs.split(":");
+            if (pairList.count() < 2) continue;
+
+            int key = enumerator.keyToValue(qPrintable(pairList.at(0)));
+            if (key > 0) parameters[key] = ::fromLegacyValue(pairList.at(1));
+        }
+
+        return parameters;
+    }
+
+    QString toLegacy(const QMap<int, QVariant>& parameters, const QMetaEnum& enumerator)
+    {
+        QStringList list;
+
+        for (int key: parameters.keys())
+        {
+            list.append(QString(enumerator.valueToKey(key)) + ":" +
+                        parameters.value(key).toString());
+        }
+
+        return list.join(";");
+    }
+}
+
+bool BinaryParametersMigration::up()
+{
+    if (!this->convertTable("mission_items", MissionItem::staticMetaObject, true)) return false;
+    if (!this->convertTable("links", LinkDescription::staticMetaObject, true)) return false;
+
+    return DbMigration::up();
+}
+
+bool BinaryParametersMigration::down()
+{
+    if (!this->convertTable("mission_items", MissionItem::staticMetaObject, false)) return false;
+    if (!this->convertTable("links", LinkDescription::staticMetaObject, false)) return false;
+
+    return true;
+}
+
+QDateTime BinaryParametersMigration::version() const
+{
+    return QDateTime::fromString("2018.05.24-16:20:00", format);
+}
+
+bool BinaryParametersMigration::convertTable(const QString& table, const QMetaObject& meta,
+                                             bool toBinary)
+{
+    QMetaEnum enumerator = meta.enumerator(meta.indexOfEnumerator("Parameter"));
+
+    if (!m_query.prepare("SELECT id, parameters FROM " + table) || !m_query.exec()) return false;
+
+    // SQLite keeps BLOB values as is in TEXT affinity columns, so there is no need to
+    // recreate tables, values are only converted in place
+    QMap<int, QVariant> converted;
+    while (m_query.next())
+    {
+        QVariant value = m_query.value(1);
+        if (value.isNull()) continue;
+
+        bool isText = value.type() == QVariant::String;
+        if (toBinary && isText)
+        {
+            converted[m_query.value(0).toInt()] =
+                    packParameters(::parseLegacy(value.toString(), enumerator));
+        }
+        else if (!toBinary && !isText)
+        {
+            converted[m_query.value(0).toInt()] =
+                    ::toLegacy(unpackParameters<int>(value.toByteArray()), enumerator);
+        }
+    }
+
+    if (converted.isEmpty()) return true;
+
+    QSqlDatabase db = QSqlDatabase::database();
+    db.transaction();
+
+    if (!m_query.prepare("UPDATE " + table + " SET parameters = :parameters WHERE id = :id"))
+    {
+        db.rollback();
+        return false;
+    }
+
+    for (int id: converted.keys())
+    {
+        m_query.bindValue(":id", id);
+        m_query.bindValue(":parameters", converted.value(id));
+
+        if (!m_query.exec())
+        {
+            db.rollback();
+            return false;
+        }
+    }
+
+    return db.commit();
+}
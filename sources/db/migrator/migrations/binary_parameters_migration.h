@@ -0,0 +1,21 @@
+#ifndef BINARY_PARAMETERS_MIGRATION_H
+#define BINARY_PARAMETERS_MIGRATION_H
+
+#include "db_migration.h"
+
+namespace db
+{
+    class BinaryParametersMigration: public DbMigration
+    {
+    public:
+        bool up() override;
+        bool down() override;
+
+        QDateTime version() const override;
+
+    private:
+        bool convertTable(const QString& table, const QMetaObject& meta, bool toBinary);
+    };
+}
+
+#endif // BINARY_PARAMETERS_MIGRATION_H
@@ -0,0 +1,29 @@
+#include "parameter_cache_migration.h"
+
+// Qt
+#include <QDebug>
+
+using namespace db;
+
+bool ParameterCacheMigration::up()
+{
+    if (!m_query.prepare("CREATE TABLE parameter_caches ("
+                         "id INTEGER PRIMARY KEY NOT NULL,"
+                         "vehicleId INTEGER,"
+                         "firmware STRING,"
+                         "parameters BLOB,"
+                         "FOREIGN KEY(vehicleId) REFERENCES vehicles(id))") ||
+            !m_query.exec()) return false;
+
+    return DbMigration::up();
+}
+
+bool ParameterCacheMigration::down()
+{
+    return m_query.prepare("DROP TABLE parameter_caches") && m_query.exec();
+}
+
+QDateTime ParameterCacheMigration::version() const
+{
+    return QDateTime::fromString("2018.06.04-12:00:00", format);
+}
@@ -0,0 +1,18 @@
+#ifndef PARAMETER_CACHE_MIGRATION_H
+#define PARAMETER_CACHE_MIGRATION_H
+
+#include "db_migration.h"
+
+namespace db
+{
+    class ParameterCacheMigration: public DbMigration
+    {
+    public:
+        bool up() override;
+        bool down() override;
+
+        QDateTime version() const override;
+    };
+}
+
+#endif // PARAMETER_CACHE_MIGRATION_H
@@ -2,12 +2,15 @@
 
 // Qt
 #include <QMap>
-#include <QTimerEvent>
 #include <QDebug>
 
+// Internal
+#include "timing_wheel.h"
+
 namespace
 {
     const int interval = 700;
+    const int maxInterval = 4000;
     const int maxAttemps = 5;
 }
 
@@ -16,37 +19,48 @@ using namespace domain;
 class AbstractCommandHandler::Impl
 {
 public:
+    utils::TimingWheel* timingWheel;
+
     QMultiMap<int, dto::CommandPtr> vehicleCommands;
     QMap <dto::CommandPtr, int> attemps;
     QMap <dto::CommandPtr, int> commandTimers;
+
+    struct Group
+    {
+        QMap<int, dto::CommandPtr> members; // By vehicle id
+        int attempt = 0;
+        int timer = 0;
+    };
+    QMap<dto::CommandPtr, Group> groups;
+    QMap<dto::CommandPtr, dto::CommandPtr> memberGroups;
+
+    void startTimer(AbstractCommandHandler* handler, int vehicleId, const dto::CommandPtr& command)
+    {
+        // Backing off gives a congested link room instead of flooding it with repeats
+        int timeout = utils::TimingWheel::backoff(::interval, attemps.value(command), ::maxInterval);
+        commandTimers[command] = timingWheel->start(timeout, handler, [handler, vehicleId, command]() {
+            handler->retryCommand(vehicleId, command);
+        });
+    }
 };
 
-AbstractCommandHandler::AbstractCommandHandler(QObject* parent):
+AbstractCommandHandler::AbstractCommandHandler(utils::TimingWheel* timingWheel, QObject* parent):
     QObject(parent),
     d(new Impl())
-{}
+{
+    d->timingWheel = timingWheel;
+}
 
 AbstractCommandHandler::~AbstractCommandHandler()
 {}
 
 void AbstractCommandHandler::executeCommand(int vehicleId, const dto::CommandPtr& command)
 {
-    for (const dto::CommandPtr& timedCommand: d->commandTimers.keys())
-    {
-        if (timedCommand->type() != command->type() ||
-            !d->vehicleCommands.values(vehicleId).contains(timedCommand)) continue;
-
-        this->stopCommand(vehicleId, timedCommand);
-
-        timedCommand->setStatus(dto::Command::Canceled);
-        emit commandChanged(timedCommand);
-
-        break;
-    }
+    this->cancelPrevious(vehicleId, command->type());
 
     d->vehicleCommands.insert(vehicleId, command);
     d->attemps[command] = 0;
-    d->commandTimers[command] = this->startTimer(::interval);
+    d->startTimer(this, vehicleId, command);
     command->setStatus(dto::Command::Sending);
 
     this->sendCommand(vehicleId, command);
@@ -59,6 +73,56 @@ void AbstractCommandHandler::cancelCommand(int vehicleId, dto::Command::CommandT
     this->ackCommand(vehicleId, type, dto::Command::Canceled);
 }
 
+void AbstractCommandHandler::executeGroupCommand(const QList<int>& vehicleIds,
+                                                 const dto::CommandPtr& command)
+{
+    if (d->groups.contains(command) || vehicleIds.isEmpty()) return;
+
+    Impl::Group& group = d->groups[command];
+    for (int vehicleId: vehicleIds)
+    {
+        if (group.members.contains(vehicleId)) continue;
+
+        this->cancelPrevious(vehicleId, command->type());
+
+        dto::CommandPtr member = dto::CommandPtr::create(*command);
+        member->setStatus(dto::Command::Sending);
+
+        d->vehicleCommands.insert(vehicleId, member);
+        d->attemps[member] = 0;
+        d->memberGroups[member] = command;
+        group.members[vehicleId] = member;
+    }
+
+    command->setStatus(dto::Command::Sending);
+    group.timer = d->timingWheel->start(::interval, this, [this, command]() {
+        this->retryGroupCommand(command);
+    });
+
+    QMap<int, dto::CommandPtr> members = group.members;
+
+    emit commandChanged(command);
+    emit groupCommandProgress(command, 0, 0, members.count());
+
+    // Some senders acknowledge at once, so group may be finished after this
+    this->sendGroupCommand(members, 0);
+}
+
+void AbstractCommandHandler::cancelGroupCommand(const dto::CommandPtr& command)
+{
+    if (!d->groups.contains(command)) return;
+
+    for (const dto::CommandPtr& member: d->groups[command].members)
+    {
+        if (member->isFinished()) continue;
+
+        member->setStatus(dto::Command::Canceled);
+        emit commandChanged(member);
+    }
+
+    this->updateGroupCommand(command);
+}
+
 void AbstractCommandHandler::ackCommand(int vehicleId, dto::Command::CommandType type,
                                         dto::Command::CommandStatus status)
 {
@@ -66,10 +130,12 @@ void AbstractCommandHandler::ackCommand(int vehicleId, dto::Command::CommandType
     {
         if (command->type() != type) continue;
 
-        if (command->isFinished()) this->stopCommand(vehicleId, command);
-
+        // Finished command is not repeated anymore, whether sent alone or in a group
         command->setStatus(status);
+        if (command->isFinished()) this->stopCommand(vehicleId, command);
         emit commandChanged(command);
+
+        if (d->memberGroups.contains(command)) this->updateGroupCommand(d->memberGroups[command]);
     }
 }
 
@@ -79,22 +145,136 @@ void AbstractCommandHandler::stopCommand(int vehicleId, const dto::CommandPtr& c
     d->attemps.remove(command);
     if (d->commandTimers.contains(command))
     {
-        this->killTimer(d->commandTimers.take(command));
+        d->timingWheel->stop(d->commandTimers.take(command));
     }
 }
 
-void AbstractCommandHandler::timerEvent(QTimerEvent* event)
+void AbstractCommandHandler::retryCommand(int vehicleId, const dto::CommandPtr& command)
 {
-    dto::CommandPtr command = d->commandTimers.key(event->timerId());
-    if (command.isNull()) return QObject::timerEvent(event);
-
-    int vehicleId = d->vehicleCommands.key(command, 0);
+    d->commandTimers.remove(command);
     this->sendCommand(vehicleId, command, ++d->attemps[command]);
 
-    if (d->attemps[command] < ::maxAttemps) return;
+    if (d->attemps[command] < ::maxAttemps)
+    {
+        d->startTimer(this, vehicleId, command);
+        return;
+    }
+
+    this->expireCommand(vehicleId, command);
+}
 
+void AbstractCommandHandler::expireCommand(int vehicleId, const dto::CommandPtr& command)
+{
     this->stopCommand(vehicleId, command);
 
     command->setStatus(dto::Command::Rejected);
     emit commandChanged(command);
 }
+
+void AbstractCommandHandler::sendGroupCommand(const QMap<int, dto::CommandPtr>& commands, int attempt)
+{
+    for (auto it = commands.constBegin(); it != commands.constEnd(); ++it)
+    {
+        this->sendCommand(it.key(), it.value(), attempt);
+    }
+}
+
+void AbstractCommandHandler::cancelPrevious(int vehicleId, dto::Command::CommandType type)
+{
+    // Group members have no timers of their own, so in-flight ones are looked up by vehicle
+    for (const dto::CommandPtr& previous: d->vehicleCommands.values(vehicleId))
+    {
+        if (previous->type() != type || previous->isFinished()) continue;
+
+        this->stopCommand(vehicleId, previous);
+
+        previous->setStatus(dto::Command::Canceled);
+        emit commandChanged(previous);
+
+        if (d->memberGroups.contains(previous))
+        {
+            this->updateGroupCommand(d->memberGroups.value(previous));
+        }
+    }
+}
+
+void AbstractCommandHandler::retryGroupCommand(const dto::CommandPtr& command)
+{
+    auto it = d->groups.find(command);
+    if (it == d->groups.end()) return;
+
+    QMap<int, dto::CommandPtr> pending;
+    for (auto member = it->members.constBegin(); member != it->members.constEnd(); ++member)
+    {
+        if (member.value()->isFinished()) continue;
+
+        pending[member.key()] = member.value();
+        d->attemps[member.value()]++;
+    }
+
+    int attempt = ++it->attempt;
+    this->sendGroupCommand(pending, attempt);
+
+    it = d->groups.find(command);
+    if (it == d->groups.end()) return;
+
+    if (attempt < ::maxAttemps)
+    {
+        int timeout = utils::TimingWheel::backoff(::interval, attempt, ::maxInterval);
+        it->timer = d->timingWheel->start(timeout, this, [this, command]() {
+            this->retryGroupCommand(command);
+        });
+        return;
+    }
+
+    it->timer = 0;
+    for (auto member = pending.constBegin(); member != pending.constEnd(); ++member)
+    {
+        if (!member.value()->isFinished()) this->expireCommand(member.key(), member.value());
+    }
+    this->updateGroupCommand(command);
+}
+
+void AbstractCommandHandler::updateGroupCommand(const dto::CommandPtr& command)
+{
+    auto it = d->groups.find(command);
+    if (it == d->groups.end()) return;
+
+    int completed = 0;
+    int failed = 0;
+    int canceled = 0;
+    bool inProgress = false;
+    for (const dto::CommandPtr& member: it->members)
+    {
+        if (member->status() == dto::Command::Completed) completed++;
+        else if (member->status() == dto::Command::Canceled) canceled++;
+        else if (member->isFinished()) failed++;
+        else if (member->status() == dto::Command::InProgress) inProgress = true;
+    }
+
+    int total = it->members.count();
+    emit groupCommandProgress(command, completed, failed + canceled, total);
+
+    dto::Command::CommandStatus status = inProgress ? dto::Command::InProgress :
+                                                      dto::Command::Sending;
+    if (completed + failed + canceled == total)
+    {
+        d->timingWheel->stop(it->timer);
+        for (auto member = it->members.constBegin(); member != it->members.constEnd(); ++member)
+        {
+            d->memberGroups.remove(member.value());
+            this->stopCommand(member.key(), member.value());
+        }
+        d->groups.erase(it);
+
+        // Partial success is still a failure for the group, progress tells the rest
+        if (completed == total) status = dto::Command::Completed;
+        else if (canceled == total) status = dto::Command::Canceled;
+        else status = dto::Command::Rejected;
+    }
+
+    if (command->status() == status) return;
+
+    command->setStatus(status);
+    emit commandChanged(command);
+}
@@ -2,11 +2,17 @@
 #define ABSTRACT_COMMAND_HANDLER_H
 
 #include <QObject>
+#include <QMap>
 
 // Internal
 #include "dto_traits.h"
 #include "command.h"
 
+namespace utils
+{
+    class TimingWheel;
+}
+
 namespace domain
 {
     class AbstractCommandHandler: public QObject
@@ -14,24 +20,38 @@ namespace domain
         Q_OBJECT
 
     public:
-        explicit AbstractCommandHandler(QObject* parent = nullptr);
+        explicit AbstractCommandHandler(utils::TimingWheel* timingWheel, QObject* parent = nullptr);
         ~AbstractCommandHandler() override;
 
     public slots:
         void executeCommand(int vehicleId, const dto::CommandPtr& command);
         void cancelCommand(int vehicleId, dto::Command::CommandType type);
 
+        // Sends copies of command to every vehicle in one pass and retries only
+        // silent ones, command itself carries the aggregated status
+        void executeGroupCommand(const QList<int>& vehicleIds, const dto::CommandPtr& command);
+        void cancelGroupCommand(const dto::CommandPtr& command);
+
     signals:
         void commandChanged(dto::CommandPtr command);
+        void groupCommandProgress(dto::CommandPtr command, int completed, int failed, int total);
 
     protected:
         void ackCommand(int vehicleId, dto::Command::CommandType type, dto::Command::CommandStatus status);
         void stopCommand(int vehicleId, const dto::CommandPtr& command);
-        void timerEvent(QTimerEvent* event) override;
+        void retryCommand(int vehicleId, const dto::CommandPtr& command);
+        // Out of attempts, single command and group member alike
+        void expireCommand(int vehicleId, const dto::CommandPtr& command);
 
         virtual void sendCommand(int vehicleId, const dto::CommandPtr& command, int attempt = 0) = 0;
+        // Commands mapped by vehicle id, default implementation sends them one by one
+        virtual void sendGroupCommand(const QMap<int, dto::CommandPtr>& commands, int attempt);
 
     private:
+        void cancelPrevious(int vehicleId, dto::Command::CommandType type);
+        void retryGroupCommand(const dto::CommandPtr& command);
+        void updateGroupCommand(const dto::CommandPtr& command);
+
         class Impl;
         QScopedPointer<Impl> const d;
     };
@@ -14,14 +14,21 @@ CommandService::CommandService(QObject* parent):
     qRegisterMetaType<dto::CommandPtr>("dto::CommandPtr");
     qRegisterMetaType<dto::Command::CommandType>("dto::Command::CommandType");
     qRegisterMetaType<dto::Command::CommandStatus>("dto::Command::CommandStatus");
+    qRegisterMetaType<QList<int> >("QList<int>");
 }
 
 void CommandService::addHandler(AbstractCommandHandler* handler)
 {
     connect(this, &CommandService::executeCommand, handler, &AbstractCommandHandler::executeCommand);
     connect(this, &CommandService::cancelCommand, handler, &AbstractCommandHandler::cancelCommand);
+    connect(this, &CommandService::executeGroupCommand,
+            handler, &AbstractCommandHandler::executeGroupCommand);
+    connect(this, &CommandService::cancelGroupCommand,
+            handler, &AbstractCommandHandler::cancelGroupCommand);
 
     connect(handler, &AbstractCommandHandler::commandChanged, this, &CommandService::commandChanged);
+    connect(handler, &AbstractCommandHandler::groupCommandProgress,
+            this, &CommandService::groupCommandProgress);
 }
 
 void CommandService::removeHandler(AbstractCommandHandler* handler)
@@ -27,7 +27,11 @@ namespace domain
         void executeCommand(int vehicleId, const dto::CommandPtr& command);
         void cancelCommand(int vehicleId, dto::Command::CommandType type);
 
+        void executeGroupCommand(const QList<int>& vehicleIds, const dto::CommandPtr& command);
+        void cancelGroupCommand(const dto::CommandPtr& command);
+
         void commandChanged(dto::CommandPtr command);
+        void groupCommandProgress(dto::CommandPtr command, int completed, int failed, int total);
     };
 }
 
@@ -83,6 +83,10 @@ CommunicationService::CommunicationService(SerialPortService* serialPortService,
             this, &CommunicationService::onMavLinkStatisticsChanged);
     connect(d->commWorker, &CommunicatorWorker::mavLinkProtocolChanged,
             this, &CommunicationService::onMavlinkProtocolChanged);
+    connect(d->commWorker, &CommunicatorWorker::linkLatencyChanged,
+            this, &CommunicationService::onLinkLatencyChanged);
+    connect(d->commWorker, &CommunicatorWorker::linkTrafficChanged,
+            this, &CommunicationService::onLinkTrafficChanged);
 
     d->loadDescriptions();
 }
@@ -129,7 +133,8 @@ void CommunicationService::init()
     // TODO: different link protocols
     comm::MavLinkCommunicatorFactory commFactory(
                 settings::Provider::value(settings::communication::systemId).toInt(),
-                settings::Provider::value(settings::communication::componentId).toInt());
+                settings::Provider::value(settings::communication::componentId).toInt(),
+                settings::Provider::value(settings::communication::routing).toBool());
 
     comm::AbstractCommunicator* communicator = commFactory.create();
     communicator->moveToThread(d->commThread);
@@ -246,8 +251,21 @@ void CommunicationService::onMavLinkStatisticsChanged(int linkId,
 
     statistics->setPacketsRecv(packetsReceived);
     statistics->setPacketDrops(packetsDrops);
+}
+
+void CommunicationService::onLinkLatencyChanged(int linkId, int roundTrip, int roundTripP95)
+{
+    dto::LinkStatisticsPtr statistics = d->getlinkStatistics(linkId);
 
-    // TODO: No handle for MavLinkStatistics yet
+    // Reported with the next traffic statistics
+    statistics->setRoundTrip(roundTrip);
+    statistics->setRoundTripP95(roundTripP95);
+}
+
+void CommunicationService::onLinkTrafficChanged(int linkId, const dto::LinkTraffic& traffic)
+{
+    // Comes just before bytes statistics of the same second, emitted with them
+    d->getlinkStatistics(linkId)->setTraffic(traffic);
 }
 
 void CommunicationService::onMavlinkProtocolChanged(int linkId,
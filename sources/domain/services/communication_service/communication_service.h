@@ -7,6 +7,7 @@
 // Internal
 #include "dto_traits.h"
 #include "link_description.h"
+#include "link_traffic.h"
 
 namespace comm
 {
@@ -55,6 +56,8 @@ namespace domain
         void onMavLinkStatisticsChanged(int linkId,
                                         int packetsReceived,
                                         int packetsDrops);
+        void onLinkLatencyChanged(int linkId, int roundTrip, int roundTripP95);
+        void onLinkTrafficChanged(int linkId, const dto::LinkTraffic& traffic);
         void onMavlinkProtocolChanged(int linkId,
                                       dto::LinkDescription::Protocol protocol);
         void onDevicesChanged();
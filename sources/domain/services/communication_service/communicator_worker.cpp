@@ -82,6 +82,23 @@ void CommunicatorWorker::onMavLinkProtocolChanged(AbstractLink* link,
     emit mavLinkProtocolChanged(linkId, ::toDaoProtocol(protocol));
 }
 
+void CommunicatorWorker::onLinkLatencyChanged(AbstractLink* link, int roundTrip,
+                                              int roundTripP95)
+{
+    int linkId = d->descriptedLinks.key(link, 0);
+    if (!linkId) return;
+
+    emit linkLatencyChanged(linkId, roundTrip, roundTripP95);
+}
+
+void CommunicatorWorker::onLinkTrafficChanged(AbstractLink* link, const dto::LinkTraffic& traffic)
+{
+    int linkId = d->descriptedLinks.key(link, 0);
+    if (!linkId) return;
+
+    emit linkTrafficChanged(linkId, traffic);
+}
+
 void CommunicatorWorker::setCommunicatorImpl(AbstractCommunicator* communicator)
 {
     // TODO: if several communicators, who owns the link?
@@ -109,6 +126,10 @@ void CommunicatorWorker::setCommunicatorImpl(AbstractCommunicator* communicator)
                 this, &CommunicatorWorker::onMavLinkStatisticsChanged);
         connect(d->communicator, &AbstractCommunicator::mavLinkProtocolChanged,
                 this, &CommunicatorWorker::onMavLinkProtocolChanged);
+        connect(d->communicator, &AbstractCommunicator::linkLatencyChanged,
+                this, &CommunicatorWorker::onLinkLatencyChanged);
+        connect(d->communicator, &AbstractCommunicator::linkTrafficChanged,
+                this, &CommunicatorWorker::onLinkTrafficChanged);
 
         for (AbstractLink* link: d->descriptedLinks.values())
         {
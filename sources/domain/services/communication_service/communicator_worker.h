@@ -40,6 +40,8 @@ namespace domain
                                       int packetsDrops);
         void mavLinkProtocolChanged(int linkId,
                                     dto::LinkDescription::Protocol protocol);
+        void linkLatencyChanged(int linkId, int roundTrip, int roundTripP95);
+        void linkTrafficChanged(int linkId, const dto::LinkTraffic& traffic);
 
     private slots:
         void onLinkStatisticsChanged(comm::AbstractLink* link, int bytesReceived,
@@ -49,6 +51,8 @@ namespace domain
                                         int packetsDrops);
         void onMavLinkProtocolChanged(comm::AbstractLink* link,
                                       comm::AbstractCommunicator::Protocol protocol);
+        void onLinkLatencyChanged(comm::AbstractLink* link, int roundTrip, int roundTripP95);
+        void onLinkTrafficChanged(comm::AbstractLink* link, const dto::LinkTraffic& traffic);
 
         void setCommunicatorImpl(comm::AbstractCommunicator* communicator);
         void updateLinkImpl(int linkId, const comm::LinkFactoryPtr& factory,
@@ -0,0 +1,43 @@
+#include "file_transfer_service.h"
+
+using namespace domain;
+
+FileTransferService::FileTransferService(QObject* parent):
+    QObject(parent)
+{
+    qRegisterMetaType<domain::RemoteFileList>("domain::RemoteFileList");
+}
+
+void FileTransferService::setDirectoryListed(int vehicleId, const QString& path,
+                                             const RemoteFileList& files, bool success)
+{
+    emit directoryListed(vehicleId, path, files, success);
+}
+
+void FileTransferService::setTransferProgress(int vehicleId, const QString& path, quint32 received,
+                                              quint32 size, int bytesPerSecond)
+{
+    emit transferProgress(vehicleId, path, received, size, bytesPerSecond);
+}
+
+void FileTransferService::setTransferFinished(int vehicleId, const QString& path, bool success,
+                                              const QString& error)
+{
+    emit transferFinished(vehicleId, path, success, error);
+}
+
+void FileTransferService::listDirectory(int vehicleId, const QString& path, int component)
+{
+    emit listRequested(vehicleId, path, component);
+}
+
+void FileTransferService::download(int vehicleId, const QString& path, const QString& fileName,
+                                   bool resume, int component)
+{
+    emit downloadRequested(vehicleId, path, fileName, resume, component);
+}
+
+void FileTransferService::cancel(int vehicleId)
+{
+    emit cancelRequested(vehicleId);
+}
@@ -0,0 +1,52 @@
+#ifndef FILE_TRANSFER_SERVICE_H
+#define FILE_TRANSFER_SERVICE_H
+
+// Qt
+#include <QObject>
+
+// Internal
+#include "remote_file.h"
+
+namespace domain
+{
+    // Files on vehicle side: autopilot (component 0) or onboard computers by their component id
+    class FileTransferService: public QObject
+    {
+        Q_OBJECT
+
+    public:
+        explicit FileTransferService(QObject* parent = nullptr);
+
+        // For protocol handlers
+        void setDirectoryListed(int vehicleId, const QString& path, const RemoteFileList& files,
+                                bool success);
+        void setTransferProgress(int vehicleId, const QString& path, quint32 received,
+                                 quint32 size, int bytesPerSecond);
+        void setTransferFinished(int vehicleId, const QString& path, bool success,
+                                 const QString& error = QString());
+
+    public slots:
+        void listDirectory(int vehicleId, const QString& path, int component = 0);
+        // With resume, transfer continues from the size of existing local file
+        void download(int vehicleId, const QString& path, const QString& fileName,
+                      bool resume = false, int component = 0);
+        void cancel(int vehicleId);
+
+    signals:
+        void listRequested(int vehicleId, const QString& path, int component);
+        void downloadRequested(int vehicleId, const QString& path, const QString& fileName,
+                               bool resume, int component);
+        void cancelRequested(int vehicleId);
+
+        void directoryListed(int vehicleId, const QString& path,
+                             const domain::RemoteFileList& files, bool success);
+        void transferProgress(int vehicleId, const QString& path, quint32 received,
+                              quint32 size, int bytesPerSecond);
+        void transferFinished(int vehicleId, const QString& path, bool success,
+                              const QString& error);
+    };
+}
+
+Q_DECLARE_METATYPE(domain::RemoteFileList)
+
+#endif // FILE_TRANSFER_SERVICE_H
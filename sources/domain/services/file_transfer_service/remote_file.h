@@ -0,0 +1,21 @@
+#ifndef REMOTE_FILE_H
+#define REMOTE_FILE_H
+
+// Qt
+#include <QString>
+#include <QList>
+
+namespace domain
+{
+    // Directory entry on vehicle or companion computer file system
+    struct RemoteFile
+    {
+        QString name;
+        bool directory = false;
+        quint32 size = 0;
+    };
+
+    using RemoteFileList = QList<RemoteFile>;
+}
+
+#endif // REMOTE_FILE_H
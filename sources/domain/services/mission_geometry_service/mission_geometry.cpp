@@ -0,0 +1,283 @@
+#include "mission_geometry.h"
+
+// Internal
+#include "mission_item.h"
+
+using namespace domain;
+
+namespace
+{
+    const int homeSequence = 0;
+
+    template <typename T>
+    void insertCounted(QMap<T, int>& set, T value)
+    {
+        set[value]++;
+    }
+
+    template <typename T>
+    void removeCounted(QMap<T, int>& set, T value)
+    {
+        auto it = set.find(value);
+        if (it != set.end() && --it.value() < 1) set.erase(it);
+    }
+}
+
+void MissionGeometry::rebuild(const dto::MissionItemPtrList& items)
+{
+    m_points.clear();
+    m_indexes.clear();
+    m_absoluteAltitudes.clear();
+    m_relativeAltitudes.clear();
+    m_latitudes.clear();
+    m_longitudes.clear();
+    m_path.clear();
+    m_pathIndexes.clear();
+    m_homeReturns.clear();
+
+    for (const dto::MissionItemPtr& item: items)
+    {
+        Point point;
+        point.sequence = item->sequence();
+        point.altituded = item->isAltitudedItem();
+        point.returnHome = item->command() == dto::MissionItem::Return;
+        if (!point.altituded && !point.returnHome) continue;
+
+        if (item->isPositionatedItem())
+        {
+            point.coordinate = QGeoCoordinate(item->latitude(), item->longitude());
+        }
+        point.altitude = item->altitude();
+        point.relative = item->isAltitudeRelative();
+
+        m_indexes[point.sequence] = m_points.count();
+        m_points.append(point);
+    }
+
+    m_legTree.fill(0, m_points.count() + 1);
+
+    int previous = -1;
+    for (int index = 0; index < m_points.count(); ++index)
+    {
+        Point& point = m_points[index];
+        this->insertAltitude(point);
+
+        if (point.coordinate.isValid())
+        {
+            if (previous > -1)
+            {
+                const QGeoCoordinate& from = m_points.at(previous).coordinate;
+                point.leg = from.distanceTo(point.coordinate);
+                point.heading = from.azimuthTo(point.coordinate);
+                this->addLeg(index, point.leg);
+            }
+            previous = index;
+
+            this->insertCoordinate(point.coordinate);
+            m_pathIndexes[index] = m_path.count();
+            m_path.append(QVariant::fromValue(point.coordinate));
+        }
+        else if (point.returnHome && !m_path.isEmpty())
+        {
+            m_homeReturns.append(m_path.count());
+            m_path.append(m_path.first()); // Return to home line
+        }
+    }
+}
+
+int MissionGeometry::update(const dto::MissionItemPtr& item)
+{
+    int index = m_indexes.value(item->sequence(), -1);
+    if (index == -1)
+    {
+        bool participates = item->isAltitudedItem() || item->command() == dto::MissionItem::Return;
+        return participates ? -1 : m_points.count();
+    }
+
+    Point& point = m_points[index];
+    QGeoCoordinate coordinate;
+    if (item->isPositionatedItem())
+    {
+        coordinate = QGeoCoordinate(item->latitude(), item->longitude());
+    }
+
+    // Kind of point changed, it shifts legs and path, so only rebuild can handle it
+    if (point.altituded != item->isAltitudedItem() ||
+        point.returnHome != (item->command() == dto::MissionItem::Return) ||
+        point.coordinate.isValid() != coordinate.isValid()) return -1;
+
+    bool moved = coordinate.isValid() && coordinate != point.coordinate;
+    if (!moved && point.altitude == item->altitude() &&
+        point.relative == item->isAltitudeRelative()) return m_points.count();
+
+    this->removeAltitude(point);
+    point.altitude = item->altitude();
+    point.relative = item->isAltitudeRelative();
+    this->insertAltitude(point);
+
+    if (moved)
+    {
+        this->removeCoordinate(point.coordinate);
+        point.coordinate = coordinate;
+        this->insertCoordinate(coordinate);
+
+        this->recalcLeg(index);
+        int next = this->nextPositioned(index);
+        if (next > -1) this->recalcLeg(next);
+
+        int pathIndex = m_pathIndexes.value(index);
+        m_path[pathIndex] = QVariant::fromValue(coordinate);
+        if (pathIndex == 0)
+        {
+            for (int homeReturn: m_homeReturns) m_path[homeReturn] = m_path.first();
+        }
+    }
+
+    return index;
+}
+
+int MissionGeometry::count() const
+{
+    return m_points.count();
+}
+
+const MissionGeometry::Point& MissionGeometry::point(int index) const
+{
+    return m_points.at(index);
+}
+
+int MissionGeometry::indexOf(int sequence) const
+{
+    return m_indexes.value(sequence, -1);
+}
+
+double MissionGeometry::distance(int index) const
+{
+    return this->legsSum(index);
+}
+
+double MissionGeometry::totalDistance() const
+{
+    return m_points.isEmpty() ? 0 : this->legsSum(m_points.count() - 1);
+}
+
+float MissionGeometry::homeAltitude() const
+{
+    int index = this->indexOf(::homeSequence);
+    return index > -1 ? m_points.at(index).altitude : 0;
+}
+
+float MissionGeometry::absoluteAltitude(int index) const
+{
+    const Point& point = m_points.at(index);
+    return point.relative ? this->homeAltitude() + point.altitude : point.altitude;
+}
+
+float MissionGeometry::minAltitude() const
+{
+    bool hasAbsolute = !m_absoluteAltitudes.isEmpty();
+    bool hasRelative = !m_relativeAltitudes.isEmpty();
+
+    if (!hasRelative) return hasAbsolute ? m_absoluteAltitudes.firstKey() : 0;
+
+    float relative = this->homeAltitude() + m_relativeAltitudes.firstKey();
+    return hasAbsolute ? qMin(relative, m_absoluteAltitudes.firstKey()) : relative;
+}
+
+float MissionGeometry::maxAltitude() const
+{
+    bool hasAbsolute = !m_absoluteAltitudes.isEmpty();
+    bool hasRelative = !m_relativeAltitudes.isEmpty();
+
+    if (!hasRelative) return hasAbsolute ? m_absoluteAltitudes.lastKey() : 0;
+
+    float relative = this->homeAltitude() + m_relativeAltitudes.lastKey();
+    return hasAbsolute ? qMax(relative, m_absoluteAltitudes.lastKey()) : relative;
+}
+
+QGeoRectangle MissionGeometry::boundingBox() const
+{
+    if (m_latitudes.isEmpty()) return QGeoRectangle();
+
+    return QGeoRectangle(QGeoCoordinate(m_latitudes.lastKey(), m_longitudes.firstKey()),
+                         QGeoCoordinate(m_latitudes.firstKey(), m_longitudes.lastKey()));
+}
+
+QVariantList MissionGeometry::path() const
+{
+    return m_path;
+}
+
+void MissionGeometry::recalcLeg(int index)
+{
+    Point& point = m_points[index];
+    int previous = this->previousPositioned(index);
+
+    double leg = 0;
+    point.heading = qQNaN();
+    if (previous > -1 && point.coordinate.isValid())
+    {
+        const QGeoCoordinate& from = m_points.at(previous).coordinate;
+        leg = from.distanceTo(point.coordinate);
+        point.heading = from.azimuthTo(point.coordinate);
+    }
+
+    this->addLeg(index, leg - point.leg);
+    point.leg = leg;
+}
+
+int MissionGeometry::nextPositioned(int index) const
+{
+    for (int next = index + 1; next < m_points.count(); ++next)
+    {
+        if (m_points.at(next).coordinate.isValid()) return next;
+    }
+    return -1;
+}
+
+int MissionGeometry::previousPositioned(int index) const
+{
+    for (int previous = index - 1; previous >= 0; --previous)
+    {
+        if (m_points.at(previous).coordinate.isValid()) return previous;
+    }
+    return -1;
+}
+
+void MissionGeometry::addLeg(int index, double delta)
+{
+    for (int i = index + 1; i < m_legTree.count(); i += i & -i) m_legTree[i] += delta;
+}
+
+double MissionGeometry::legsSum(int index) const
+{
+    double sum = 0;
+    for (int i = index + 1; i > 0; i -= i & -i) sum += m_legTree.at(i);
+    return sum;
+}
+
+void MissionGeometry::insertAltitude(const Point& point)
+{
+    if (!point.altituded) return;
+
+    ::insertCounted(point.relative ? m_relativeAltitudes : m_absoluteAltitudes, point.altitude);
+}
+
+void MissionGeometry::removeAltitude(const Point& point)
+{
+    if (!point.altituded) return;
+
+    ::removeCounted(point.relative ? m_relativeAltitudes : m_absoluteAltitudes, point.altitude);
+}
+
+void MissionGeometry::insertCoordinate(const QGeoCoordinate& coordinate)
+{
+    ::insertCounted(m_latitudes, coordinate.latitude());
+    ::insertCounted(m_longitudes, coordinate.longitude());
+}
+
+void MissionGeometry::removeCoordinate(const QGeoCoordinate& coordinate)
+{
+    ::removeCounted(m_latitudes, coordinate.latitude());
+    ::removeCounted(m_longitudes, coordinate.longitude());
+}
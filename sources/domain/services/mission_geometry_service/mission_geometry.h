@@ -0,0 +1,83 @@
+#ifndef MISSION_GEOMETRY_H
+#define MISSION_GEOMETRY_H
+
+// Qt
+#include <QVector>
+#include <QHash>
+#include <QMap>
+#include <QVariantList>
+#include <QGeoCoordinate>
+#include <QGeoRectangle>
+
+// Internal
+#include "dto_traits.h"
+
+namespace domain
+{
+    // Cached path of one mission: legs, cumulative distances, altitudes and bounds.
+    // Moving an item recalculates only legs adjacent to it, cumulative distances live
+    // in a Fenwick tree and extremes in counted sets, so every query is O(log n)
+    class MissionGeometry
+    {
+    public:
+        struct Point
+        {
+            int sequence = -1;
+            QGeoCoordinate coordinate; // Invalid for items without position
+            float altitude = 0;
+            bool altituded = false;
+            bool relative = false;
+            bool returnHome = false;
+            double leg = 0; // Distance from previous positioned point
+            double heading = qQNaN(); // Azimuth of that leg
+        };
+
+        void rebuild(const dto::MissionItemPtrList& items);
+        // Returns index of first point affected, count() if geometry is the same
+        // or -1 if item can't be updated in place and rebuild is required
+        int update(const dto::MissionItemPtr& item);
+
+        int count() const;
+        const Point& point(int index) const;
+        int indexOf(int sequence) const;
+
+        double distance(int index) const;
+        double totalDistance() const;
+
+        float homeAltitude() const;
+        float absoluteAltitude(int index) const;
+        float minAltitude() const;
+        float maxAltitude() const;
+
+        QGeoRectangle boundingBox() const;
+        QVariantList path() const;
+
+    private:
+        void recalcLeg(int index);
+        int nextPositioned(int index) const;
+        int previousPositioned(int index) const;
+
+        void addLeg(int index, double delta);
+        double legsSum(int index) const;
+
+        void insertAltitude(const Point& point);
+        void removeAltitude(const Point& point);
+        void insertCoordinate(const QGeoCoordinate& coordinate);
+        void removeCoordinate(const QGeoCoordinate& coordinate);
+
+        QVector<Point> m_points;
+        QHash<int, int> m_indexes; // sequence -> point index
+        QVector<double> m_legTree; // Fenwick tree over leg lengths
+
+        QMap<float, int> m_absoluteAltitudes; // Counted sets
+        QMap<float, int> m_relativeAltitudes;
+        QMap<double, int> m_latitudes;
+        QMap<double, int> m_longitudes;
+
+        QVariantList m_path;
+        QHash<int, int> m_pathIndexes; // point index -> path index
+        QList<int> m_homeReturns; // path indexes repeating home coordinate
+    };
+}
+
+#endif // MISSION_GEOMETRY_H
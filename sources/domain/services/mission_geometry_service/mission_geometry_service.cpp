@@ -0,0 +1,125 @@
+#include "mission_geometry_service.h"
+
+// Qt
+#include <QHash>
+#include <QSet>
+
+// Internal
+#include "mission.h"
+#include "mission_item.h"
+
+#include "mission_service.h"
+#include "mission_geometry.h"
+
+using namespace domain;
+
+class MissionGeometryService::Impl
+{
+public:
+    MissionService* service;
+
+    QHash<int, MissionGeometry> geometries;
+    // Items added, removed or reordered, one queued rebuild serves a whole batch of them
+    QSet<int> staleMissions;
+    QHash<int, int> changedFrom; // Not notified yet, first changed point or -1
+
+    void rebuildIfStale(int missionId)
+    {
+        if (!staleMissions.remove(missionId)) return;
+
+        geometries[missionId].rebuild(service->missionItems(missionId));
+    }
+};
+
+MissionGeometryService::MissionGeometryService(MissionService* service, QObject* parent):
+    QObject(parent),
+    d(new Impl())
+{
+    d->service = service;
+
+    connect(service, &MissionService::missionRemoved,
+            this, &MissionGeometryService::onMissionRemoved);
+    connect(service, &MissionService::missionItemAdded,
+            this, [this](const dto::MissionItemPtr& item) {
+        this->onMissionItemsChanged(item->missionId());
+    });
+    connect(service, &MissionService::missionItemRemoved,
+            this, [this](const dto::MissionItemPtr& item) {
+        this->onMissionItemsChanged(item->missionId());
+    });
+    connect(service, &MissionService::missionItemsChanged,
+            this, &MissionGeometryService::onMissionItemsChanged);
+    connect(service, &MissionService::missionItemChanged,
+            this, &MissionGeometryService::onMissionItemChanged);
+}
+
+MissionGeometryService::~MissionGeometryService()
+{}
+
+const MissionGeometry* MissionGeometryService::geometry(int missionId)
+{
+    auto it = d->geometries.find(missionId);
+    if (it == d->geometries.end())
+    {
+        it = d->geometries.insert(missionId, MissionGeometry());
+        it->rebuild(d->service->missionItems(missionId));
+    }
+    else d->rebuildIfStale(missionId);
+
+    return &it.value();
+}
+
+void MissionGeometryService::onMissionRemoved(const dto::MissionPtr& mission)
+{
+    d->geometries.remove(mission->id());
+    d->staleMissions.remove(mission->id());
+    d->changedFrom.remove(mission->id());
+}
+
+void MissionGeometryService::onMissionItemsChanged(int missionId)
+{
+    if (!d->geometries.contains(missionId)) return;
+
+    d->staleMissions.insert(missionId);
+    this->scheduleNotify(missionId, -1);
+}
+
+void MissionGeometryService::onMissionItemChanged(const dto::MissionItemPtr& item)
+{
+    auto it = d->geometries.find(item->missionId());
+    if (it == d->geometries.end()) return;
+    if (d->staleMissions.contains(item->missionId())) return; // Pending rebuild covers it
+
+    int fromIndex = it->update(item);
+    if (fromIndex == it->count()) return;
+
+    // E.g. sequence shift, inserting in the middle shifts every following item one by one
+    if (fromIndex == -1) d->staleMissions.insert(item->missionId());
+    this->scheduleNotify(item->missionId(), fromIndex);
+}
+
+void MissionGeometryService::onRebuildStale()
+{
+    QHash<int, int> changedFrom;
+    changedFrom.swap(d->changedFrom);
+
+    for (auto it = changedFrom.cbegin(); it != changedFrom.cend(); ++it)
+    {
+        if (!d->geometries.contains(it.key())) continue;
+
+        d->rebuildIfStale(it.key());
+        emit geometryChanged(it.key(), it.value());
+    }
+}
+
+void MissionGeometryService::scheduleNotify(int missionId, int fromIndex)
+{
+    if (d->changedFrom.isEmpty())
+    {
+        QMetaObject::invokeMethod(this, "onRebuildStale", Qt::QueuedConnection);
+    }
+
+    auto it = d->changedFrom.find(missionId);
+    if (it == d->changedFrom.end()) d->changedFrom.insert(missionId, fromIndex);
+    else if (it.value() != -1) it.value() = fromIndex == -1 ? -1 : qMin(it.value(), fromIndex);
+}
@@ -0,0 +1,45 @@
+#ifndef MISSION_GEOMETRY_SERVICE_H
+#define MISSION_GEOMETRY_SERVICE_H
+
+// Qt
+#include <QObject>
+
+// Internal
+#include "dto_traits.h"
+
+namespace domain
+{
+    class MissionService;
+    class MissionGeometry;
+
+    class MissionGeometryService: public QObject
+    {
+        Q_OBJECT
+
+    public:
+        explicit MissionGeometryService(MissionService* service, QObject* parent = nullptr);
+        ~MissionGeometryService() override;
+
+        // Built on first request and kept in sync with mission items afterwards
+        const MissionGeometry* geometry(int missionId);
+
+    signals:
+        // fromIndex is first point changed, -1 if whole geometry was rebuilt
+        void geometryChanged(int missionId, int fromIndex);
+
+    private slots:
+        void onMissionRemoved(const dto::MissionPtr& mission);
+        void onMissionItemsChanged(int missionId);
+        void onMissionItemChanged(const dto::MissionItemPtr& item);
+        void onRebuildStale();
+
+    private:
+        // Changes are reported once per event loop pass, whatever their count
+        void scheduleNotify(int missionId, int fromIndex);
+
+        class Impl;
+        QScopedPointer<Impl> const d;
+    };
+}
+
+#endif // MISSION_GEOMETRY_SERVICE_H
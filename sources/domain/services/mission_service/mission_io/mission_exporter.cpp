@@ -0,0 +1,169 @@
+#include "mission_exporter.h"
+
+// Qt
+#include <QSaveFile>
+#include <QTextStream>
+#include <QDataStream>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+
+// Internal
+#include "mission.h"
+#include "mission_item.h"
+#include "mission_service.h"
+#include "mission_item_convertor.h"
+
+using namespace domain;
+
+namespace
+{
+    const int coordinatePrecision = 8;
+    const int planFormatVersion = 1;
+    const int planMissionVersion = 2;
+
+    MavMissionItem toMavItem(const dto::MissionItemPtr& item, int seq,
+                                   const MissionItemConvertor& convertor)
+    {
+        MavMissionItem mavItem;
+        mavItem.seq = seq;
+        convertor.fromItem(item, mavItem);
+        return mavItem;
+    }
+}
+
+MissionExporter::MissionExporter(MissionService* service):
+    m_service(service)
+{}
+
+bool MissionExporter::exportMission(const dto::MissionPtr& mission, const QString& fileName,
+                                    MissionFileFormat format)
+{
+    m_errorString.clear();
+    if (format == MissionFileFormat::Unknown) format = missionFileFormat(fileName);
+    if (format == MissionFileFormat::Unknown)
+    {
+        m_errorString = tr("Unknown mission file format");
+        return false;
+    }
+
+    // Whole file or nothing, partially written plan is worse than none
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        m_errorString = file.errorString();
+        return false;
+    }
+
+    dto::MissionItemPtrList items = m_service->missionItems(mission->id());
+
+    switch (format)
+    {
+    case MissionFileFormat::Waypoints:
+        this->writeWaypoints(&file, items);
+        break;
+    case MissionFileFormat::Plan:
+        this->writePlan(&file, items);
+        break;
+    case MissionFileFormat::Binary:
+        this->writeBinary(&file, mission, items);
+        break;
+    default:
+        break;
+    }
+
+    if (!file.commit())
+    {
+        m_errorString = file.errorString();
+        return false;
+    }
+
+    return true;
+}
+
+QString MissionExporter::errorString() const
+{
+    return m_errorString;
+}
+
+void MissionExporter::writeWaypoints(QIODevice* device, const dto::MissionItemPtrList& items)
+{
+    QTextStream stream(device);
+    stream.setRealNumberNotation(QTextStream::FixedNotation);
+    stream.setRealNumberPrecision(::coordinatePrecision);
+    MissionItemConvertor convertor;
+
+    stream << waypointsHeader << endl;
+
+    for (const dto::MissionItemPtr& item: items)
+    {
+        MavMissionItem mavItem = ::toMavItem(item, item->sequence(), convertor);
+
+        stream << mavItem.seq << '\t' << int(mavItem.seq == 0) << '\t' <<
+                  int(mavItem.frame) << '\t' << mavItem.command << '\t' <<
+                  mavItem.param1 << '\t' << mavItem.param2 << '\t' <<
+                  mavItem.param3 << '\t' << mavItem.param4 << '\t' <<
+                  mavItem.x << '\t' << mavItem.y << '\t' << mavItem.z << '\t' <<
+                  int(mavItem.autocontinue) << '\n';
+    }
+
+    stream.flush();
+}
+
+void MissionExporter::writePlan(QIODevice* device, const dto::MissionItemPtrList& items)
+{
+    MissionItemConvertor convertor;
+    QJsonArray home;
+    QJsonArray planItems;
+
+    for (const dto::MissionItemPtr& item: items)
+    {
+        if (item->command() == dto::MissionItem::Home)
+        {
+            home = { item->latitude(), item->longitude(), item->altitude() };
+            continue;
+        }
+
+        MavMissionItem mavItem = ::toMavItem(item, item->sequence(), convertor);
+
+        QJsonObject object;
+        object["type"] = "SimpleItem";
+        object["autoContinue"] = mavItem.autocontinue;
+        object["command"] = mavItem.command;
+        object["doJumpId"] = mavItem.seq;
+        object["frame"] = mavItem.frame;
+        object["params"] = QJsonArray({ mavItem.param1, mavItem.param2,
+                                        mavItem.param3, mavItem.param4,
+                                        mavItem.x, mavItem.y, mavItem.z });
+        planItems.append(object);
+    }
+
+    QJsonObject mission;
+    mission["version"] = ::planMissionVersion;
+    mission["items"] = planItems;
+    mission["plannedHomePosition"] = home;
+
+    QJsonObject plan;
+    plan["fileType"] = "Plan";
+    plan["groundStation"] = qApp->applicationName();
+    plan["version"] = ::planFormatVersion;
+    plan["mission"] = mission;
+
+    device->write(QJsonDocument(plan).toJson());
+}
+
+void MissionExporter::writeBinary(QIODevice* device, const dto::MissionPtr& mission,
+                                  const dto::MissionItemPtrList& items)
+{
+    QDataStream stream(device);
+    stream.setVersion(missionBinaryVersion);
+
+    stream << missionBinaryMagic << missionBinaryFormatVersion <<
+              mission->name() << quint32(items.count());
+
+    for (const dto::MissionItemPtr& item: items)
+    {
+        stream << quint8(item->command()) << item->isAltitudeRelative() << item->altitude() <<
+                  item->latitude() << item->longitude() << item->parameters();
+    }
+}
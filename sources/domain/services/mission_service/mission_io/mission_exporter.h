@@ -0,0 +1,41 @@
+#ifndef MISSION_EXPORTER_H
+#define MISSION_EXPORTER_H
+
+// Qt
+#include <QCoreApplication>
+
+// Internal
+#include "dto_traits.h"
+#include "mission_file_format.h"
+
+class QIODevice;
+
+namespace domain
+{
+    class MissionService;
+
+    class MissionExporter
+    {
+        Q_DECLARE_TR_FUNCTIONS(MissionExporter)
+
+    public:
+        explicit MissionExporter(MissionService* service);
+
+        // Writes mission with all its items, format is taken from file suffix if unknown
+        bool exportMission(const dto::MissionPtr& mission, const QString& fileName,
+                           MissionFileFormat format = MissionFileFormat::Unknown);
+
+        QString errorString() const;
+
+    private:
+        void writeWaypoints(QIODevice* device, const dto::MissionItemPtrList& items);
+        void writePlan(QIODevice* device, const dto::MissionItemPtrList& items);
+        void writeBinary(QIODevice* device, const dto::MissionPtr& mission,
+                         const dto::MissionItemPtrList& items);
+
+        MissionService* const m_service;
+        QString m_errorString;
+    };
+}
+
+#endif // MISSION_EXPORTER_H
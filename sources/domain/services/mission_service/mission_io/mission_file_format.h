@@ -0,0 +1,38 @@
+#ifndef MISSION_FILE_FORMAT_H
+#define MISSION_FILE_FORMAT_H
+
+// Qt
+#include <QFileInfo>
+#include <QDataStream>
+
+namespace domain
+{
+    enum class MissionFileFormat
+    {
+        Unknown,
+        Plan,       // QGroundControl JSON plan
+        Waypoints,  // QGC WPL 110 text
+        Binary      // Compact JAGCS binary
+    };
+
+    // Binary layout: magic, version, name, item count, then per item command, altitude relative,
+    // altitude, latitude, longitude and parameters blob, all written with binaryVersion
+    const quint32 missionBinaryMagic = 0x4A474D53; // "JGMS"
+    const quint16 missionBinaryFormatVersion = 1;
+    const QDataStream::Version missionBinaryVersion = QDataStream::Qt_5_9;
+
+    const QString waypointsHeader = "QGC WPL 110";
+
+    inline MissionFileFormat missionFileFormat(const QString& fileName)
+    {
+        QString suffix = QFileInfo(fileName).suffix().toLower();
+
+        if (suffix == "plan") return MissionFileFormat::Plan;
+        if (suffix == "waypoints" || suffix == "txt") return MissionFileFormat::Waypoints;
+        if (suffix == "mission") return MissionFileFormat::Binary;
+
+        return MissionFileFormat::Unknown;
+    }
+}
+
+#endif // MISSION_FILE_FORMAT_H
@@ -0,0 +1,252 @@
+#include "mission_importer.h"
+
+// Qt
+#include <QFile>
+#include <QTextStream>
+#include <QDataStream>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+
+// Internal
+#include "mission.h"
+#include "mission_item.h"
+#include "mission_service.h"
+#include "mission_item_convertor.h"
+
+using namespace domain;
+
+namespace
+{
+    const int planHomeSequence = 0;
+    const quint32 maxReservedItems = 65535; // MAVLink sequence limit
+
+    void appendPlanItems(const QJsonArray& array, dto::MissionItemPtrList& items,
+                         const MissionItemConvertor& convertor)
+    {
+        for (const QJsonValue& value: array)
+        {
+            QJsonObject object = value.toObject();
+
+            // Complex items (surveys, corridors) carry their generated simple items inside
+            if (object.value("type").toString() == "ComplexItem")
+            {
+                QJsonObject transect = object.value("TransectStyleComplexItem").toObject();
+                ::appendPlanItems(transect.value("Items").toArray(), items, convertor);
+                continue;
+            }
+
+            QJsonArray params = object.value("params").toArray();
+
+            MavMissionItem mavItem;
+            mavItem.seq = items.count();
+            mavItem.command = object.value("command").toInt();
+            mavItem.frame = object.value("frame").toInt();
+            mavItem.autocontinue = object.value("autoContinue").toBool(true);
+            mavItem.param1 = params.at(0).toDouble();
+            mavItem.param2 = params.at(1).toDouble();
+            mavItem.param3 = params.at(2).toDouble();
+            mavItem.param4 = params.at(3).toDouble();
+            mavItem.x = params.at(4).toDouble();
+            mavItem.y = params.at(5).toDouble();
+            mavItem.z = params.at(6).toDouble();
+
+            dto::MissionItemPtr item = dto::MissionItemPtr::create();
+            item->setSequence(mavItem.seq);
+            convertor.toItem(mavItem, item);
+            items.append(item);
+        }
+    }
+}
+
+MissionImporter::MissionImporter(MissionService* service):
+    m_service(service)
+{}
+
+dto::MissionPtr MissionImporter::import(const QString& fileName, MissionFileFormat format)
+{
+    m_errorString.clear();
+    if (format == MissionFileFormat::Unknown) format = missionFileFormat(fileName);
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        m_errorString = file.errorString();
+        return dto::MissionPtr();
+    }
+
+    QString name = QFileInfo(fileName).baseName();
+    dto::MissionItemPtrList items;
+    bool ok = false;
+
+    switch (format)
+    {
+    case MissionFileFormat::Waypoints:
+        ok = this->readWaypoints(&file, items);
+        break;
+    case MissionFileFormat::Plan:
+        ok = this->readPlan(&file, items);
+        break;
+    case MissionFileFormat::Binary:
+        ok = this->readBinary(&file, name, items);
+        break;
+    case MissionFileFormat::Unknown:
+    default:
+        m_errorString = tr("Unknown mission file format");
+        break;
+    }
+
+    if (!ok) return dto::MissionPtr();
+
+    dto::MissionPtr mission = dto::MissionPtr::create();
+    mission->setName(name);
+    if (!m_service->save(mission))
+    {
+        m_errorString = tr("Can't save mission");
+        return dto::MissionPtr();
+    }
+
+    for (const dto::MissionItemPtr& item: items) item->setMissionId(mission->id());
+
+    if (!m_service->save(items))
+    {
+        m_service->remove(mission);
+        m_errorString = tr("Can't save mission items");
+        return dto::MissionPtr();
+    }
+
+    return mission;
+}
+
+QString MissionImporter::errorString() const
+{
+    return m_errorString;
+}
+
+bool MissionImporter::readWaypoints(QIODevice* device, dto::MissionItemPtrList& items)
+{
+    QTextStream stream(device);
+    MissionItemConvertor convertor;
+
+    QString line = stream.readLine();
+    if (!line.startsWith(waypointsHeader))
+    {
+        m_errorString = tr("Waypoints file has no \"%1\" header").arg(waypointsHeader);
+        return false;
+    }
+
+    // Line by line, so file is never held in memory as a whole
+    while (stream.readLineInto(&line))
+    {
+        if (line.trimmed().isEmpty()) continue;
+
+        QTextStream lineStream(&line, QIODevice::ReadOnly);
+        int index, current, frame, command, autocontinue;
+        MavMissionItem mavItem;
+
+        lineStream >> index >> current >> frame >> command >>
+                      mavItem.param1 >> mavItem.param2 >> mavItem.param3 >> mavItem.param4 >>
+                      mavItem.x >> mavItem.y >> mavItem.z >> autocontinue;
+
+        if (lineStream.status() != QTextStream::Ok)
+        {
+            m_errorString = tr("Malformed waypoint line %1").arg(items.count() + 1);
+            return false;
+        }
+
+        mavItem.seq = items.count(); // Keep sequence dense whatever file says
+        mavItem.current = current;
+        mavItem.frame = frame;
+        mavItem.command = command;
+        mavItem.autocontinue = autocontinue;
+
+        dto::MissionItemPtr item = dto::MissionItemPtr::create();
+        item->setSequence(mavItem.seq);
+        convertor.toItem(mavItem, item);
+        items.append(item);
+    }
+
+    return true;
+}
+
+bool MissionImporter::readPlan(QIODevice* device, dto::MissionItemPtrList& items)
+{
+    QJsonParseError error;
+    QJsonDocument document = QJsonDocument::fromJson(device->readAll(), &error);
+    if (document.isNull())
+    {
+        m_errorString = error.errorString();
+        return false;
+    }
+
+    QJsonObject mission = document.object().value("mission").toObject();
+    QJsonArray home = mission.value("plannedHomePosition").toArray();
+
+    dto::MissionItemPtr homeItem = dto::MissionItemPtr::create();
+    homeItem->setSequence(::planHomeSequence);
+    homeItem->setCommand(dto::MissionItem::Home);
+    homeItem->setLatitude(home.at(0).toDouble());
+    homeItem->setLongitude(home.at(1).toDouble());
+    homeItem->setAltitude(home.at(2).toDouble());
+    items.append(homeItem);
+
+    ::appendPlanItems(mission.value("items").toArray(), items, MissionItemConvertor());
+
+    return true;
+}
+
+bool MissionImporter::readBinary(QIODevice* device, QString& name, dto::MissionItemPtrList& items)
+{
+    QDataStream stream(device);
+    stream.setVersion(missionBinaryVersion);
+
+    quint32 magic = 0;
+    quint16 version = 0;
+    quint32 count = 0;
+    stream >> magic >> version;
+
+    if (magic != missionBinaryMagic || version > missionBinaryFormatVersion)
+    {
+        m_errorString = tr("Not a mission file or unsupported version");
+        return false;
+    }
+
+    stream >> name >> count;
+    items.reserve(qMin(count, ::maxReservedItems)); // Don't trust header blindly
+
+    for (quint32 seq = 0; seq < count && stream.status() == QDataStream::Ok; ++seq)
+    {
+        quint8 command;
+        bool altitudeRelative;
+        float altitude;
+        double latitude, longitude;
+        QByteArray parameters;
+
+        stream >> command >> altitudeRelative >> altitude >> latitude >> longitude >> parameters;
+        if (stream.status() != QDataStream::Ok) break;
+
+        if (command > dto::MissionItem::TargetPoint)
+        {
+            m_errorString = tr("Unknown command %1 in item %2").arg(command).arg(seq);
+            return false;
+        }
+
+        dto::MissionItemPtr item = dto::MissionItemPtr::create();
+        item->setSequence(seq);
+        item->setCommand(dto::MissionItem::Command(command));
+        item->setAltitudeRelative(altitudeRelative);
+        item->setAltitude(altitude);
+        item->setLatitude(latitude);
+        item->setLongitude(longitude);
+        item->setParameters(parameters);
+        items.append(item);
+    }
+
+    if (stream.status() != QDataStream::Ok)
+    {
+        m_errorString = tr("Mission file is truncated");
+        return false;
+    }
+
+    return true;
+}
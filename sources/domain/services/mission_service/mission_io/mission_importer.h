@@ -0,0 +1,41 @@
+#ifndef MISSION_IMPORTER_H
+#define MISSION_IMPORTER_H
+
+// Qt
+#include <QCoreApplication>
+
+// Internal
+#include "dto_traits.h"
+#include "mission_file_format.h"
+
+class QIODevice;
+
+namespace domain
+{
+    class MissionService;
+
+    class MissionImporter
+    {
+        Q_DECLARE_TR_FUNCTIONS(MissionImporter)
+
+    public:
+        explicit MissionImporter(MissionService* service);
+
+        // Reads file into a new mission, all items are inserted in one transaction.
+        // Returns null mission on failure, see errorString()
+        dto::MissionPtr import(const QString& fileName,
+                               MissionFileFormat format = MissionFileFormat::Unknown);
+
+        QString errorString() const;
+
+    private:
+        bool readWaypoints(QIODevice* device, dto::MissionItemPtrList& items);
+        bool readPlan(QIODevice* device, dto::MissionItemPtrList& items);
+        bool readBinary(QIODevice* device, QString& name, dto::MissionItemPtrList& items);
+
+        MissionService* const m_service;
+        QString m_errorString;
+    };
+}
+
+#endif // MISSION_IMPORTER_H
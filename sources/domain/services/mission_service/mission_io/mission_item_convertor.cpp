@@ -0,0 +1,190 @@
+#include "mission_item_convertor.h"
+
+// MAVLink
+#include <mavlink.h>
+
+// Qt
+#include <QMap>
+
+// Internal
+#include "mission_item.h"
+
+namespace
+{
+    const QMap<quint16, dto::MissionItem::Command> mavCommandLongMap =
+    {
+        { MAV_CMD_NAV_TAKEOFF, dto::MissionItem::Takeoff },
+        { MAV_CMD_NAV_LAND, dto::MissionItem::Landing },
+        { MAV_CMD_NAV_WAYPOINT, dto::MissionItem::Waypoint },
+        { MAV_CMD_NAV_LOITER_UNLIM, dto::MissionItem::LoiterUnlim },
+        { MAV_CMD_NAV_LOITER_TO_ALT, dto::MissionItem::LoiterAltitude },
+        { MAV_CMD_NAV_LOITER_TURNS, dto::MissionItem::LoiterTurns },
+        { MAV_CMD_NAV_LOITER_TIME, dto::MissionItem::LoiterTime },
+        { MAV_CMD_NAV_CONTINUE_AND_CHANGE_ALT, dto::MissionItem::Continue },
+        { MAV_CMD_NAV_RETURN_TO_LAUNCH, dto::MissionItem::Return },
+
+        { MAV_CMD_DO_CHANGE_SPEED, dto::MissionItem::SetSpeed },
+        { MAV_CMD_DO_JUMP, dto::MissionItem::JumpTo },
+
+        { MAV_CMD_DO_SET_SERVO, dto::MissionItem::SetServo },
+        { MAV_CMD_DO_SET_RELAY, dto::MissionItem::SetRelay },
+        { MAV_CMD_DO_REPEAT_SERVO, dto::MissionItem::RepeatServo },
+        { MAV_CMD_DO_REPEAT_RELAY, dto::MissionItem::RepeatRelay },
+
+        { MAV_CMD_DO_SET_ROI, dto::MissionItem::SetRoi },
+        { MAV_CMD_DO_MOUNT_CONTROL, dto::MissionItem::MountControl },
+        { MAV_CMD_DO_SET_CAM_TRIGG_DIST, dto::MissionItem::SetCameraTriggerDistance },
+        { MAV_CMD_DO_DIGICAM_CONTROL, dto::MissionItem::CameraControl }
+    };
+}
+
+using namespace domain;
+
+void MissionItemConvertor::toItem(const MavMissionItem& mavItem, const dto::MissionItemPtr& item) const
+{
+    item->setCommand(mavItem.seq > 0 ?
+                         ::mavCommandLongMap.value(mavItem.command, dto::MissionItem::UnknownCommand) :
+                         dto::MissionItem::Home);
+
+    if (item->isAltitudedItem())
+    {
+        item->setAltitudeRelative(mavItem.frame == MAV_FRAME_GLOBAL_RELATIVE_ALT ||
+                                  mavItem.frame == MAV_FRAME_GLOBAL_RELATIVE_ALT_INT);
+        item->setAltitude(mavItem.z);
+    }
+
+    if (item->isPositionatedItem())
+    {
+        item->setLatitude(mavItem.x);
+        item->setLongitude(mavItem.y);
+    }
+
+    if (mavItem.command == MAV_CMD_NAV_TAKEOFF)
+    {
+        item->setParameter(dto::MissionItem::Pitch, mavItem.param1);
+    }
+    else if (mavItem.command == MAV_CMD_NAV_LAND)
+    {
+        item->setParameter(dto::MissionItem::AbortAltitude, mavItem.param1);
+        item->setParameter(dto::MissionItem::Yaw, mavItem.param4);
+    }
+    else if (mavItem.command == MAV_CMD_NAV_WAYPOINT)
+    {
+        item->setParameter(dto::MissionItem::Radius, mavItem.param2);
+    }
+    else if (mavItem.command == MAV_CMD_NAV_LOITER_UNLIM ||
+             mavItem.command == MAV_CMD_NAV_LOITER_TURNS ||
+             mavItem.command == MAV_CMD_NAV_LOITER_TIME)
+    {
+        item->setParameter(dto::MissionItem::Radius, qAbs(mavItem.param3));
+        item->setParameter(dto::MissionItem::Clockwise, bool(mavItem.param3 > 0));
+        item->setParameter(dto::MissionItem::Yaw, mavItem.param4);
+    }
+    else if (mavItem.command == MAV_CMD_NAV_LOITER_TO_ALT)
+    {
+        item->setParameter(dto::MissionItem::HeadingRequired, bool(mavItem.param1));
+        item->setParameter(dto::MissionItem::Radius, qAbs(mavItem.param2));
+        item->setParameter(dto::MissionItem::Clockwise, bool(mavItem.param2 > 0));
+    }
+    else if (mavItem.command == MAV_CMD_DO_CHANGE_SPEED)
+    {
+        item->setParameter(dto::MissionItem::IsGroundSpeed, bool(mavItem.param1));
+        if (mavItem.param2 != -1) item->setParameter(dto::MissionItem::Speed, mavItem.param2);
+        if (mavItem.param3 != -1) item->setParameter(dto::MissionItem::Throttle, int(mavItem.param3));
+    }
+    else if (mavItem.command == MAV_CMD_DO_JUMP)
+    {
+        item->setParameter(dto::MissionItem::TargetSequence, int(mavItem.param1));
+        item->setParameter(dto::MissionItem::Repeats, int(mavItem.param2));
+    }
+
+    if (mavItem.command == MAV_CMD_NAV_LOITER_TURNS)
+    {
+        item->setParameter(dto::MissionItem::Repeats, int(mavItem.param1));
+    }
+    else if (mavItem.command == MAV_CMD_NAV_LOITER_TIME)
+    {
+        item->setParameter(dto::MissionItem::Time, mavItem.param1);
+    }
+
+//    if (mavItem.command == MAV_CMD_NAV_CONTINUE_AND_CHANGE_ALT)
+//    {
+//  TODO: In APM Plane 3.4 (and later) the param1 value sets how close the vehicle
+//        altitude must be to target altitude for command completion.
+//    }
+}
+
+void MissionItemConvertor::fromItem(const dto::MissionItemPtr& item, MavMissionItem& mavItem) const
+{
+    if (mavItem.seq) mavItem.command = ::mavCommandLongMap.key(item->command(), 0);
+    else mavItem.command = MAV_CMD_NAV_WAYPOINT; // Home is waypoint
+
+    if (item->isAltitudedItem())
+    {
+        mavItem.frame = item->isAltitudeRelative() ? MAV_FRAME_GLOBAL_RELATIVE_ALT :
+                                                      MAV_FRAME_GLOBAL;
+        mavItem.z = item->altitude();
+    }
+
+    if (item->isPositionatedItem())
+    {
+        mavItem.x = item->latitude();
+        mavItem.y = item->longitude();
+    }
+
+    if (mavItem.command == MAV_CMD_NAV_TAKEOFF)
+    {
+        mavItem.param1 = item->parameter(dto::MissionItem::Pitch).toFloat();
+    }
+    else if (mavItem.command == MAV_CMD_NAV_LAND)
+    {
+        mavItem.param1 = item->parameter(dto::MissionItem::AbortAltitude).toFloat();
+        mavItem.param4 = item->parameter(dto::MissionItem::Yaw).toFloat();
+    }
+    else if (mavItem.command == MAV_CMD_NAV_WAYPOINT)
+    {
+        mavItem.param2 = item->parameter(dto::MissionItem::Radius).toFloat();
+    }
+    else if (mavItem.command == MAV_CMD_NAV_LOITER_UNLIM ||
+             mavItem.command == MAV_CMD_NAV_LOITER_TURNS ||
+             mavItem.command == MAV_CMD_NAV_LOITER_TIME)
+    {
+        mavItem.param3 = item->parameter(dto::MissionItem::Clockwise).toBool() ?
+                             item->parameter(dto::MissionItem::Radius).toFloat() :
+                             -1 * item->parameter(dto::MissionItem::Radius).toFloat();
+        mavItem.param4 = item->parameter(dto::MissionItem::Yaw).toFloat();
+    }
+    else if (mavItem.command == MAV_CMD_NAV_LOITER_TO_ALT)
+    {
+        mavItem.param1 = item->parameter(dto::MissionItem::HeadingRequired).toBool();
+        mavItem.param2 = item->parameter(dto::MissionItem::Clockwise).toBool() ?
+                             item->parameter(dto::MissionItem::Radius).toFloat() :
+                             -1 * item->parameter(dto::MissionItem::Radius).toFloat();
+    }
+    else if (mavItem.command == MAV_CMD_DO_CHANGE_SPEED)
+    {
+        mavItem.param1 = item->parameter(dto::MissionItem::IsGroundSpeed).toBool();
+        mavItem.param2 = item->parameter(dto::MissionItem::Speed, -1).toFloat();
+        mavItem.param3 = item->parameter(dto::MissionItem::Throttle, -1).toInt();
+    }
+    else if (mavItem.command == MAV_CMD_DO_JUMP)
+    {
+        mavItem.param1 = item->parameter(dto::MissionItem::TargetSequence).toInt();
+        mavItem.param2 = item->parameter(dto::MissionItem::Repeats).toInt();
+    }
+
+    if (mavItem.command == MAV_CMD_NAV_LOITER_TURNS)
+    {
+        mavItem.param1 = item->parameter(dto::MissionItem::Repeats).toInt();
+    }
+    else if (mavItem.command == MAV_CMD_NAV_LOITER_TIME)
+    {
+        mavItem.param1 = item->parameter(dto::MissionItem::Time).toFloat();
+    }
+
+//    if (mavItem.command == MAV_CMD_NAV_CONTINUE_AND_CHANGE_ALT)
+//    {
+//  TODO: In Plane 3.4 (and later) the param1 value sets how close the vehicle
+//        altitude must be to target altitude for command completion.
+//    }
+}
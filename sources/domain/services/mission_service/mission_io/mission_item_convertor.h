@@ -0,0 +1,53 @@
+#ifndef MISSION_ITEM_CONVERTOR_H
+#define MISSION_ITEM_CONVERTOR_H
+
+// Qt
+#include <QtGlobal>
+
+// Internal
+#include "dto_traits.h"
+
+namespace domain
+{
+    // Raw MAVLink mission item, independent of MISSION_ITEM/MISSION_ITEM_INT and file encodings
+    struct MavMissionItem
+    {
+        quint16 seq = 0;
+        quint16 command = 0;
+        quint8 frame = 0;
+        bool current = false;
+        bool autocontinue = true;
+        float param1 = 0;
+        float param2 = 0;
+        float param3 = 0;
+        float param4 = 0;
+        double x = 0;
+        double y = 0;
+        float z = 0;
+    };
+
+    inline bool operator==(const MavMissionItem& left, const MavMissionItem& right)
+    {
+        return left.seq == right.seq && left.command == right.command &&
+                left.frame == right.frame && left.autocontinue == right.autocontinue &&
+                left.param1 == right.param1 && left.param2 == right.param2 &&
+                left.param3 == right.param3 && left.param4 == right.param4 &&
+                left.x == right.x && left.y == right.y && left.z == right.z;
+    }
+
+    inline bool operator!=(const MavMissionItem& left, const MavMissionItem& right)
+    {
+        return !(left == right);
+    }
+
+    class MissionItemConvertor
+    {
+    public:
+        // Fills mission item with command, coordinate and parameters from mav item
+        void toItem(const MavMissionItem& mavItem, const dto::MissionItemPtr& item) const;
+        // Fills mav item from mission item, seq must be set and autocontinue is left to the caller
+        void fromItem(const dto::MissionItemPtr& item, MavMissionItem& mavItem) const;
+    };
+}
+
+#endif // MISSION_ITEM_CONVERTOR_H
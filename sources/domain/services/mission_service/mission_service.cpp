@@ -2,7 +2,10 @@
 
 // Qt
 #include <QMap>
+#include <QHash>
+#include <QSet>
 #include <QMutexLocker>
+#include <QReadWriteLock>
 #include <QGeoCoordinate>
 
 // Internal
@@ -20,7 +23,10 @@ using namespace domain;
 class MissionService::Impl
 {
 public:
+    // Serializes writers and repository access, readers never take it
     QMutex mutex;
+    // Guards caches and indexes below, held only for the duration of a lookup or an update
+    QReadWriteLock cacheLock;
 
     GenericRepository<Mission> missionRepository;
     GenericRepository<MissionItem> itemRepository;
@@ -28,6 +34,17 @@ public:
 
     QMap <int, MissionItemPtr> currentItems;
 
+    QHash<int, MissionPtr> missions;
+    QHash<int, MissionItemPtr> items;
+    QHash<int, MissionAssignmentPtr> assignments;
+
+    // Secondary indexes, kept in sync with repositories on every save/remove/unload
+    QHash<int, QMap<int, MissionItemPtr> > missionItems; // missionId -> sequence -> item
+    QHash<int, QPair<int, int> > itemKeys; // itemId -> (missionId, sequence)
+    QHash<int, MissionAssignmentPtr> missionAssignments; // missionId -> assignment
+    QHash<int, MissionAssignmentPtr> vehicleAssignments; // vehicleId -> assignment
+    QHash<int, QPair<int, int> > assignmentKeys; // assignmentId -> (missionId, vehicleId)
+
     Impl():
         mutex(QMutex::Recursive),
         missionRepository("missions"),
@@ -37,17 +54,112 @@ public:
 
     void loadMissions(const QString& condition = QString())
     {
-        for (int id: missionRepository.selectId(condition)) missionRepository.read(id);
+        for (int id: missionRepository.selectId(condition))
+        {
+            this->indexMission(missionRepository.read(id));
+        }
     }
 
     void loadMissionItems(const QString& condition = QString())
     {
-        for (int id: itemRepository.selectId(condition)) itemRepository.read(id);
+        for (int id: itemRepository.selectId(condition)) this->indexItem(itemRepository.read(id));
     }
 
     void loadMissionAssignments(const QString& condition = QString())
     {
-        for (int id: assignmentRepository.selectId(condition)) assignmentRepository.read(id);
+        for (int id: assignmentRepository.selectId(condition))
+        {
+            this->indexAssignment(assignmentRepository.read(id));
+        }
+    }
+
+    void indexMission(const MissionPtr& mission)
+    {
+        if (mission.isNull()) return;
+
+        QWriteLocker locker(&cacheLock);
+        missions[mission->id()] = mission;
+    }
+
+    void unindexMission(int missionId)
+    {
+        QWriteLocker locker(&cacheLock);
+        missions.remove(missionId);
+    }
+
+    void indexItem(const MissionItemPtr& item)
+    {
+        if (item.isNull()) return;
+
+        QWriteLocker locker(&cacheLock);
+        this->dropItem(item->id());
+
+        items[item->id()] = item;
+        itemKeys[item->id()] = qMakePair(item->missionId(), item->sequence());
+        missionItems[item->missionId()][item->sequence()] = item;
+    }
+
+    void unindexItem(int itemId)
+    {
+        QWriteLocker locker(&cacheLock);
+        this->dropItem(itemId);
+    }
+
+    void indexAssignment(const MissionAssignmentPtr& assignment)
+    {
+        if (assignment.isNull()) return;
+
+        QWriteLocker locker(&cacheLock);
+        this->dropAssignment(assignment->id());
+
+        assignments[assignment->id()] = assignment;
+        assignmentKeys[assignment->id()] = qMakePair(assignment->missionId(),
+                                                     assignment->vehicleId());
+        missionAssignments[assignment->missionId()] = assignment;
+        if (assignment->vehicleId() > 0) vehicleAssignments[assignment->vehicleId()] = assignment;
+    }
+
+    void unindexAssignment(int assignmentId)
+    {
+        QWriteLocker locker(&cacheLock);
+        this->dropAssignment(assignmentId);
+    }
+
+private:
+    // Expects cacheLock to be locked for write
+    void dropItem(int itemId)
+    {
+        items.remove(itemId);
+        if (!itemKeys.contains(itemId)) return;
+
+        QPair<int, int> key = itemKeys.take(itemId);
+        QMap<int, MissionItemPtr>& sequenced = missionItems[key.first];
+
+        // Slot may be already taken by another item with the same sequence
+        MissionItemPtr indexed = sequenced.value(key.second);
+        if (indexed && indexed->id() == itemId) sequenced.remove(key.second);
+        if (sequenced.isEmpty()) missionItems.remove(key.first);
+    }
+
+    // Expects cacheLock to be locked for write
+    void dropAssignment(int assignmentId)
+    {
+        assignments.remove(assignmentId);
+        if (!assignmentKeys.contains(assignmentId)) return;
+
+        QPair<int, int> key = assignmentKeys.take(assignmentId);
+
+        if (missionAssignments.value(key.first) &&
+            missionAssignments.value(key.first)->id() == assignmentId)
+        {
+            missionAssignments.remove(key.first);
+        }
+
+        if (vehicleAssignments.value(key.second) &&
+            vehicleAssignments.value(key.second)->id() == assignmentId)
+        {
+            vehicleAssignments.remove(key.second);
+        }
     }
 };
 
@@ -69,55 +181,94 @@ MissionService::~MissionService()
 
 MissionPtr MissionService::mission(int id) const
 {
+    if (id < 1) return MissionPtr();
+
+    {
+        QReadLocker locker(&d->cacheLock);
+
+        MissionPtr mission = d->missions.value(id);
+        if (mission) return mission;
+    }
+
+    // Not loaded yet, fall back to the repository
     QMutexLocker locker(&d->mutex);
 
-    return d->missionRepository.read(id);
+    MissionPtr mission = d->missionRepository.read(id);
+    d->indexMission(mission);
+
+    return mission;
 }
 
 MissionItemPtr MissionService::missionItem(int id) const
 {
+    if (id < 1) return MissionItemPtr();
+
+    {
+        QReadLocker locker(&d->cacheLock);
+
+        MissionItemPtr item = d->items.value(id);
+        if (item) return item;
+    }
+
     QMutexLocker locker(&d->mutex);
 
-    return d->itemRepository.read(id);
+    MissionItemPtr item = d->itemRepository.read(id);
+    d->indexItem(item);
+
+    return item;
 }
 
 MissionAssignmentPtr MissionService::assignment(int id) const
 {
+    if (id < 1) return MissionAssignmentPtr();
+
+    {
+        QReadLocker locker(&d->cacheLock);
+
+        MissionAssignmentPtr assignment = d->assignments.value(id);
+        if (assignment) return assignment;
+    }
+
     QMutexLocker locker(&d->mutex);
 
-    return d->assignmentRepository.read(id);
+    MissionAssignmentPtr assignment = d->assignmentRepository.read(id);
+    d->indexAssignment(assignment);
+
+    return assignment;
 }
 
 MissionPtrList MissionService::missions() const
 {
-    QMutexLocker locker(&d->mutex);
+    QReadLocker locker(&d->cacheLock);
 
-    return d->missionRepository.loadedEntities();
+    return d->missions.values();
 }
 
 MissionItemPtrList MissionService::missionItems() const
 {
-    QMutexLocker locker(&d->mutex);
+    QReadLocker locker(&d->cacheLock);
 
-    return d->itemRepository.loadedEntities();
+    return d->items.values();
 }
 
 MissionAssignmentPtrList MissionService::missionAssignments() const
 {
-    QMutexLocker locker(&d->mutex);
+    QReadLocker locker(&d->cacheLock);
 
-    return d->assignmentRepository.loadedEntities();
+    return d->assignments.values();
 }
 
 MissionItemPtr MissionService::currentWaypoint(int vehicleId) const
 {
-    QMutexLocker locker(&d->mutex);
+    QReadLocker locker(&d->cacheLock);
 
     return d->currentItems.value(vehicleId);
 }
 
 int MissionService::isCurrentForVehicle(const MissionItemPtr& item) const
 {
+    QReadLocker locker(&d->cacheLock);
+
     return d->currentItems.key(item, 0);
 }
 
@@ -174,10 +325,12 @@ dto::MissionItemPtr MissionService::addNewMissionItem(int missionId,
         item->setLongitude(coordinate.longitude());
     }
 
-    // TODO: querry by sequence
-    for (const dto::MissionItemPtr& other: this->missionItems(missionId))
+    // Shift following items from the tail, so sequence slots never collide in index
+    dto::MissionItemPtrList following = this->missionItems(missionId);
+    for (int i = following.count() - 1; i >= 0; --i)
     {
-        if (other->sequence() < sequence) continue;
+        const dto::MissionItemPtr& other = following.at(i);
+        if (other->sequence() < sequence) break;
 
         other->setSequence(other->sequence() + 1);
         other->setStatus(dto::MissionItem::NotActual);
@@ -209,49 +362,30 @@ void MissionService::addNewMission(const QString& name)
 
 MissionAssignmentPtr MissionService::missionAssignment(int missionId) const
 {
-    QMutexLocker locker(&d->mutex);
+    QReadLocker locker(&d->cacheLock);
 
-    for (const MissionAssignmentPtr& assignment: d->assignmentRepository.loadedEntities())
-    {
-        if (assignment->missionId() == missionId) return assignment;
-    }
-
-    return MissionAssignmentPtr();
+    return d->missionAssignments.value(missionId);
 }
 
 MissionAssignmentPtr MissionService::vehicleAssignment(int vehicleId) const
 {
-    QMutexLocker locker(&d->mutex);
+    QReadLocker locker(&d->cacheLock);
 
-    for (const MissionAssignmentPtr& assignment: d->assignmentRepository.loadedEntities())
-    {
-        if (assignment->vehicleId() == vehicleId) return assignment;
-    }
-
-    return MissionAssignmentPtr();
+    return d->vehicleAssignments.value(vehicleId);
 }
 
 MissionItemPtrList MissionService::missionItems(int missionId) const
 {
-    QMutexLocker locker(&d->mutex);
+    QReadLocker locker(&d->cacheLock);
 
-    QMap<int, MissionItemPtr> items;
-    for (const MissionItemPtr& item: d->itemRepository.loadedEntities())
-    {
-        if (item->missionId() == missionId) items[item->sequence()] = item;
-    }
-    return items.values();
+    return d->missionItems.value(missionId).values();
 }
 
 MissionItemPtr MissionService::missionItem(int missionId, int sequence) const
 {
-    QMutexLocker locker(&d->mutex);
+    QReadLocker locker(&d->cacheLock);
 
-    for (const MissionItemPtr& item: d->itemRepository.loadedEntities())
-    {
-        if (item->missionId() == missionId && item->sequence() == sequence) return item;
-    }
-    return MissionItemPtr();
+    return d->missionItems.value(missionId).value(sequence);
 }
 
 bool MissionService::save(const MissionPtr& mission)
@@ -261,6 +395,8 @@ bool MissionService::save(const MissionPtr& mission)
     bool isNew = mission->id() == 0;
     if (!d->missionRepository.save(mission)) return false;
 
+    if (isNew) d->indexMission(mission);
+
     if (isNew)
     {
         settings::Provider::setValue(settings::mission::mission + QString::number(mission->id()) +
@@ -283,12 +419,39 @@ bool MissionService::save(const MissionItemPtr& item)
     item->clearSuperfluousParameters();
     if (!d->itemRepository.save(item)) return false;
 
+    d->indexItem(item);
+
     emit (isNew ? missionItemAdded(item) : missionItemChanged(item));
     if (isNew) this->fixMissionItemCount(item->missionId());
 
     return true;
 }
 
+bool MissionService::save(const MissionItemPtrList& items)
+{
+    QSet<int> missionIds;
+    {
+        QMutexLocker locker(&d->mutex);
+
+        for (const MissionItemPtr& item: items) item->clearSuperfluousParameters();
+
+        // Single transaction for whole list, it is way faster than one per item
+        if (!d->itemRepository.save(items)) return false;
+
+        for (const MissionItemPtr& item: items)
+        {
+            d->indexItem(item);
+            missionIds.insert(item->missionId());
+        }
+    }
+
+    // One notification per mission instead of one per item, listeners may call back into service
+    for (int missionId: missionIds) emit missionItemsChanged(missionId);
+    for (int missionId: missionIds) this->fixMissionItemCount(missionId);
+
+    return true;
+}
+
 bool MissionService::save(const MissionAssignmentPtr& assignment)
 {
     QMutexLocker locker(&d->mutex);
@@ -296,6 +459,8 @@ bool MissionService::save(const MissionAssignmentPtr& assignment)
     bool isNew = assignment->id() == 0;
     if (!d->assignmentRepository.save(assignment)) return false;
 
+    d->indexAssignment(assignment);
+
     emit (isNew ? assignmentAdded(assignment) : assignmentChanged(assignment));
     return true;
 }
@@ -314,6 +479,8 @@ bool MissionService::remove(const MissionPtr& mission)
 
     if (!d->missionRepository.remove(mission)) return false;
 
+    d->unindexMission(mission->id());
+
     settings::Provider::remove(settings::mission::mission + QString::number(mission->id()));
 
     emit missionRemoved(mission);
@@ -327,11 +494,53 @@ bool MissionService::remove(const MissionItemPtr& item)
     // TODO: remove from current
     if (!d->itemRepository.remove(item)) return false;
 
+    d->unindexItem(item->id());
+
     this->fixMissionItemOrder(item->missionId());
     emit missionItemRemoved(item);
     return true;
 }
 
+bool MissionService::remove(const MissionItemPtrList& items)
+{
+    QSet<int> missionIds;
+    {
+        QMutexLocker locker(&d->mutex);
+
+        if (!d->itemRepository.remove(items)) return false;
+
+        for (const MissionItemPtr& item: items)
+        {
+            d->unindexItem(item->id());
+            missionIds.insert(item->missionId());
+        }
+    }
+
+    for (const MissionItemPtr& item: items) emit missionItemRemoved(item);
+
+    // Close gaps with one batch, instead of saving every shifted item on its own
+    for (int missionId: missionIds)
+    {
+        MissionItemPtrList shifted;
+        int counter = 0;
+        for (const MissionItemPtr& item : this->missionItems(missionId))
+        {
+            if (item->sequence() != counter)
+            {
+                item->setSequence(counter);
+                item->setStatus(MissionItem::NotActual);
+                shifted.append(item);
+            }
+            counter++;
+        }
+
+        if (!shifted.isEmpty()) this->save(shifted);
+        this->fixMissionItemCount(missionId);
+    }
+
+    return true;
+}
+
 bool MissionService::remove(const MissionAssignmentPtr& assignment)
 {
     QMutexLocker locker(&d->mutex);
@@ -342,16 +551,28 @@ bool MissionService::remove(const MissionAssignmentPtr& assignment)
         emit missionItemChanged(item);
     }
 
-    for (const dto::MissionItemPtr& item: d->currentItems.values())
+    dto::MissionItemPtrList resetItems;
     {
-        if (item->missionId() != assignment->missionId()) continue;
+        QWriteLocker cacheLocker(&d->cacheLock);
+
+        for (const dto::MissionItemPtr& item: d->currentItems.values())
+        {
+            if (item->missionId() != assignment->missionId()) continue;
+
+            d->currentItems.remove(d->currentItems.key(item));
+            resetItems.append(item);
+        }
+    }
 
-        d->currentItems.remove(d->currentItems.key(item));
+    for (const dto::MissionItemPtr& item: resetItems)
+    {
         emit missionItemChanged(item);
     }
 
     if (!d->assignmentRepository.remove(assignment)) return false;
 
+    d->unindexAssignment(assignment->id());
+
     emit assignmentRemoved(assignment);
     return true;
 }
@@ -361,6 +582,7 @@ void MissionService::unload(const MissionPtr& mission)
     QMutexLocker locker(&d->mutex);
 
     d->missionRepository.unload(mission->id());
+    d->unindexMission(mission->id());
 }
 
 void MissionService::unload(const MissionItemPtr& item)
@@ -368,6 +590,7 @@ void MissionService::unload(const MissionItemPtr& item)
     QMutexLocker locker(&d->mutex);
 
     d->itemRepository.unload(item->id());
+    d->unindexItem(item->id());
 }
 
 void MissionService::unload(const MissionAssignmentPtr& assignment)
@@ -375,6 +598,7 @@ void MissionService::unload(const MissionAssignmentPtr& assignment)
     QMutexLocker locker(&d->mutex);
 
     d->assignmentRepository.unload(assignment->id());
+    d->unindexAssignment(assignment->id());
 }
 
 void MissionService::fixMissionItemOrder(int missionId)
@@ -448,7 +672,11 @@ void MissionService::unassign(int missionId)
     MissionAssignmentPtr assignment = this->missionAssignment(missionId);
     if (assignment.isNull()) return;
 
-    MissionItemPtr oldOne =d->currentItems.take(assignment->vehicleId());
+    MissionItemPtr oldOne;
+    {
+        QWriteLocker cacheLocker(&d->cacheLock);
+        oldOne = d->currentItems.take(assignment->vehicleId());
+    }
     emit currentItemChanged(assignment->vehicleId(), oldOne, MissionItemPtr());
     this->remove(assignment);
 }
@@ -457,15 +685,17 @@ void MissionService::setCurrentItem(int vehicleId, const MissionItemPtr& current
 {
     QMutexLocker locker(&d->mutex);
 
-    MissionItemPtr oldCurrent = d->currentItems.value(vehicleId);
+    MissionItemPtr oldCurrent = this->currentWaypoint(vehicleId);
     if (oldCurrent == current) return;
 
-    if (current)
     {
-        d->currentItems[vehicleId] = current;
-        emit missionItemChanged(current);
+        QWriteLocker cacheLocker(&d->cacheLock);
+
+        if (current) d->currentItems[vehicleId] = current;
+        else if (oldCurrent) d->currentItems.remove(vehicleId);
     }
-    else if (oldCurrent) d->currentItems.remove(vehicleId);
+
+    if (current) emit missionItemChanged(current);
 
     emit currentItemChanged(vehicleId, oldCurrent, current);
 }
@@ -481,6 +711,9 @@ void MissionService::swapItems(const MissionItemPtr& first, const MissionItemPtr
     if (!d->itemRepository.save(first)) return;
     if (!d->itemRepository.save(second)) return;
 
+    d->indexItem(first);
+    d->indexItem(second);
+
     emit missionItemChanged(first);
     emit missionItemChanged(second);
 }
@@ -43,10 +43,12 @@ namespace domain
 
         bool save(const dto::MissionPtr& mission);
         bool save(const dto::MissionItemPtr& item);
+        bool save(const dto::MissionItemPtrList& items);
         bool save(const dto::MissionAssignmentPtr& assignment);
 
         bool remove(const dto::MissionPtr& mission);
         bool remove(const dto::MissionItemPtr& item);
+        bool remove(const dto::MissionItemPtrList& items);
         bool remove(const dto::MissionAssignmentPtr& assignment);
 
 public slots:
@@ -73,6 +75,8 @@ public slots:
         void missionItemAdded(dto::MissionItemPtr item);
         void missionItemRemoved(dto::MissionItemPtr item);
         void missionItemChanged(dto::MissionItemPtr item);
+        // Items added or changed by batch save, once per mission after the lock is released
+        void missionItemsChanged(int missionId);
         void currentItemChanged(int vehicleId,
                                 dto::MissionItemPtr oldOne,
                                 dto::MissionItemPtr newOne);
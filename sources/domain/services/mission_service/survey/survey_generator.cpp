@@ -0,0 +1,194 @@
+#include "survey_generator.h"
+
+// Qt
+#include <QVector>
+#include <QPointF>
+#include <QtMath>
+
+// Std
+#include <algorithm>
+
+using namespace domain;
+
+namespace
+{
+    const double earthRadius = 6371000.0;
+    const double minTransectDistance = 0.5;
+    const double maxOverlap = 0.95;
+    const int maxTransects = 100000;
+
+    // Local plane around origin, x runs along transects and y across them
+    class Projection
+    {
+    public:
+        Projection(const QGeoCoordinate& origin, double heading):
+            m_origin(origin),
+            m_cosLatitude(qCos(qDegreesToRadians(origin.latitude()))),
+            m_sinHeading(qSin(qDegreesToRadians(heading))),
+            m_cosHeading(qCos(qDegreesToRadians(heading)))
+        {}
+
+        QPointF toPlane(const QGeoCoordinate& coordinate) const
+        {
+            double east = qDegreesToRadians(coordinate.longitude() - m_origin.longitude()) *
+                          m_cosLatitude * ::earthRadius;
+            double north = qDegreesToRadians(coordinate.latitude() - m_origin.latitude()) *
+                           ::earthRadius;
+
+            return QPointF(east * m_sinHeading + north * m_cosHeading,
+                           east * m_cosHeading - north * m_sinHeading);
+        }
+
+        QGeoCoordinate fromPlane(const QPointF& point) const
+        {
+            // Rotation is its own inverse
+            double east = point.x() * m_sinHeading + point.y() * m_cosHeading;
+            double north = point.x() * m_cosHeading - point.y() * m_sinHeading;
+
+            return QGeoCoordinate(m_origin.latitude() + qRadiansToDegrees(north / ::earthRadius),
+                                  m_origin.longitude() + qRadiansToDegrees(
+                                      east / (::earthRadius * m_cosLatitude)));
+        }
+
+    private:
+        QGeoCoordinate m_origin;
+        double m_cosLatitude;
+        double m_sinHeading;
+        double m_cosHeading;
+    };
+
+    struct Edge
+    {
+        QPointF from;
+        QPointF to;
+        double yMin;
+        double yMax;
+        bool hole;
+    };
+
+    struct Crossing
+    {
+        double x;
+        bool hole;
+
+        bool operator <(const Crossing& other) const { return x < other.x; }
+    };
+
+    void appendEdges(QVector<Edge>& edges, const Projection& projection,
+                     const QList<QGeoCoordinate>& ring, bool hole)
+    {
+        if (ring.count() < 3) return;
+
+        QPointF previous = projection.toPlane(ring.last());
+        for (const QGeoCoordinate& coordinate: ring)
+        {
+            QPointF point = projection.toPlane(coordinate);
+            if (previous.y() != point.y()) // Edges along transects never cross them
+            {
+                edges.append({ previous, point, qMin(previous.y(), point.y()),
+                               qMax(previous.y(), point.y()), hole });
+            }
+            previous = point;
+        }
+    }
+
+    QList<QGeoCoordinate> sweep(const SurveyArea& area, const SurveyParameters& parameters,
+                                double heading)
+    {
+        QList<QGeoCoordinate> points;
+        Projection projection(area.boundary.first(), heading);
+
+        QVector<Edge> edges;
+        ::appendEdges(edges, projection, area.boundary, false);
+        for (const QList<QGeoCoordinate>& hole: area.holes)
+        {
+            ::appendEdges(edges, projection, hole, true);
+        }
+        if (edges.isEmpty()) return points;
+
+        std::sort(edges.begin(), edges.end(), [](const Edge& first, const Edge& second) {
+            return first.yMin < second.yMin;
+        });
+
+        double yMin = edges.first().yMin;
+        double yMax = yMin;
+        for (const Edge& edge: edges) yMax = qMax(yMax, edge.yMax);
+
+        // Transects are centered over the area, narrow area still gets one
+        double distance = parameters.transectDistance();
+        int count = qMax(1, int(qCeil((yMax - yMin) / distance)));
+        if (count > ::maxTransects) return points;
+        double offset = (yMax - yMin - (count - 1) * distance) / 2;
+
+        QVector<Edge> active;
+        QVector<Crossing> crossings;
+        int next = 0;
+        bool forward = true;
+
+        for (int transect = 0; transect < count; ++transect)
+        {
+            double y = yMin + offset + transect * distance;
+
+            while (next < edges.count() && edges.at(next).yMin <= y) active.append(edges.at(next++));
+            active.erase(std::remove_if(active.begin(), active.end(), [y](const Edge& edge) {
+                return edge.yMax <= y; // Half-open edges, so shared vertex is crossed once
+            }), active.end());
+
+            crossings.clear();
+            for (const Edge& edge: active)
+            {
+                double x = edge.from.x() + (y - edge.from.y()) *
+                           (edge.to.x() - edge.from.x()) / (edge.to.y() - edge.from.y());
+                crossings.append({ x, edge.hole });
+            }
+            std::sort(crossings.begin(), crossings.end());
+
+            // Even-odd rule: every pair of crossings bounds one segment inside the area
+            QVector<QPointF> transectPoints;
+            for (int i = 0; i + 1 < crossings.count(); i += 2)
+            {
+                const Crossing& start = crossings.at(i);
+                const Crossing& end = crossings.at(i + 1);
+
+                transectPoints.append(QPointF(start.hole ? start.x :
+                                                           start.x - parameters.turnaround, y));
+                transectPoints.append(QPointF(end.hole ? end.x : end.x + parameters.turnaround, y));
+            }
+            if (transectPoints.isEmpty()) continue;
+
+            if (!forward) std::reverse(transectPoints.begin(), transectPoints.end());
+            forward = !forward;
+
+            for (const QPointF& point: transectPoints) points.append(projection.fromPlane(point));
+        }
+
+        return points;
+    }
+}
+
+double SurveyParameters::transectDistance() const
+{
+    return qMax(::minTransectDistance, spacing * (1 - qBound(0.0, overlap, ::maxOverlap)));
+}
+
+QList<QGeoCoordinate> SurveyGenerator::generate(const SurveyArea& area,
+                                                const SurveyParameters& parameters)
+{
+    QList<QGeoCoordinate> points;
+    if (area.boundary.count() < 3) return points;
+
+    points = ::sweep(area, parameters, parameters.heading);
+    if (parameters.pattern != SurveyParameters::Crosshatch) return points;
+
+    QList<QGeoCoordinate> crossPoints = ::sweep(area, parameters, parameters.heading + 90);
+    if (crossPoints.isEmpty()) return points;
+
+    // Cross pass starts from its end nearest to where the first pass has finished
+    if (!points.isEmpty() && points.last().distanceTo(crossPoints.last()) <
+        points.last().distanceTo(crossPoints.first()))
+    {
+        std::reverse(crossPoints.begin(), crossPoints.end());
+    }
+
+    return points + crossPoints;
+}
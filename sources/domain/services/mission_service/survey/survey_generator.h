@@ -0,0 +1,46 @@
+#ifndef SURVEY_GENERATOR_H
+#define SURVEY_GENERATOR_H
+
+// Qt
+#include <QList>
+#include <QGeoCoordinate>
+
+namespace domain
+{
+    struct SurveyArea
+    {
+        QList<QGeoCoordinate> boundary;
+        QList< QList<QGeoCoordinate> > holes; // Areas to skip, transects are cut by them
+    };
+
+    struct SurveyParameters
+    {
+        enum Pattern
+        {
+            Lawnmower,
+            Crosshatch // Lawnmower followed by the same pattern turned by 90 degrees
+        };
+
+        Pattern pattern = Lawnmower;
+        double spacing = 30;    // Sensor footprint width across transect, meters
+        double overlap = 0.0;   // Side overlap of neighbour footprints, 0..1
+        double heading = 0;     // Azimuth of transects, degrees
+        double turnaround = 0;  // Transect extension beyond the boundary, meters
+        float altitude = 50;
+        bool altitudeRelative = true;
+
+        double transectDistance() const;
+    };
+
+    // Plain geometry, without any mission state, so it is cheap to rerun on every edit.
+    // Transects are clipped by scanline sweep over polygon edges: O((E + T) log E + I)
+    // for E edges, T transects and I intersections
+    class SurveyGenerator
+    {
+    public:
+        static QList<QGeoCoordinate> generate(const SurveyArea& area,
+                                              const SurveyParameters& parameters);
+    };
+}
+
+#endif // SURVEY_GENERATOR_H
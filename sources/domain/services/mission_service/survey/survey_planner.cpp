@@ -0,0 +1,112 @@
+#include "survey_planner.h"
+
+// Std
+#include <algorithm>
+
+// Internal
+#include "mission.h"
+#include "mission_item.h"
+
+#include "mission_service.h"
+
+using namespace domain;
+
+SurveyPlanner::SurveyPlanner(MissionService* service, int missionId):
+    m_service(service),
+    m_missionId(missionId)
+{}
+
+const SurveyArea& SurveyPlanner::area() const
+{
+    return m_area;
+}
+
+void SurveyPlanner::setArea(const SurveyArea& area)
+{
+    m_area = area;
+}
+
+const SurveyParameters& SurveyPlanner::parameters() const
+{
+    return m_parameters;
+}
+
+void SurveyPlanner::setParameters(const SurveyParameters& parameters)
+{
+    m_parameters = parameters;
+}
+
+bool SurveyPlanner::apply()
+{
+    dto::MissionPtr mission = m_service->mission(m_missionId);
+    if (mission.isNull()) return false;
+
+    QList<QGeoCoordinate> points = SurveyGenerator::generate(m_area, m_parameters);
+
+    // Generated items could have been removed or moved meanwhile, so survey block
+    // is taken as it is now in mission, not as it was generated
+    m_items.erase(std::remove_if(m_items.begin(), m_items.end(),
+                                 [this](const dto::MissionItemPtr& item) {
+        return m_service->missionItem(item->id()).isNull();
+    }), m_items.end());
+    std::sort(m_items.begin(), m_items.end(),
+              [](const dto::MissionItemPtr& first, const dto::MissionItemPtr& second) {
+        return first->sequence() < second->sequence();
+    });
+
+    if (m_items.count() > points.count())
+    {
+        if (!m_service->remove(m_items.mid(points.count()))) return false;
+        m_items = m_items.mid(0, points.count());
+    }
+
+    // New items go right after the last survey item, sequences there are free
+    // once following items are shifted
+    dto::MissionItemPtrList following = m_service->missionItems(m_missionId);
+    int next = m_items.isEmpty() ? following.count() : m_items.last()->sequence() + 1;
+    int added = points.count() - m_items.count();
+
+    dto::MissionItemPtrList changed;
+    if (added > 0)
+    {
+        // Highest sequence goes first, so none of them takes a sequence which is still occupied
+        for (auto it = following.crbegin(); it != following.crend(); ++it)
+        {
+            const dto::MissionItemPtr& item = *it;
+            if (item->sequence() < next) break;
+
+            item->setSequence(item->sequence() + added);
+            item->setStatus(dto::MissionItem::NotActual);
+            changed.append(item);
+        }
+    }
+
+    for (int i = 0; i < points.count(); ++i)
+    {
+        dto::MissionItemPtr item = m_items.value(i);
+        if (item.isNull())
+        {
+            item = dto::MissionItemPtr::create();
+            item->setMissionId(m_missionId);
+            item->setCommand(dto::MissionItem::Waypoint);
+            item->setSequence(next++);
+            m_items.append(item);
+        }
+        else if (item->coordinate() == points.at(i) &&
+                 qFuzzyCompare(item->altitude(), m_parameters.altitude) &&
+                 item->isAltitudeRelative() == m_parameters.altitudeRelative) continue;
+
+        item->setCoordinate(points.at(i));
+        item->setAltitude(m_parameters.altitude);
+        item->setAltitudeRelative(m_parameters.altitudeRelative);
+        item->setStatus(dto::MissionItem::NotActual);
+        changed.append(item);
+    }
+
+    return changed.isEmpty() || m_service->save(changed);
+}
+
+dto::MissionItemPtrList SurveyPlanner::items() const
+{
+    return m_items;
+}
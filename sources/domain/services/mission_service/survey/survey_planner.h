@@ -0,0 +1,41 @@
+#ifndef SURVEY_PLANNER_H
+#define SURVEY_PLANNER_H
+
+// Internal
+#include "dto_traits.h"
+#include "survey_generator.h"
+
+namespace domain
+{
+    class MissionService;
+
+    // Keeps survey waypoints of one mission in line with area and parameters.
+    // Reapplying reuses generated items, so editing polygon writes only changed
+    // rows and sizes difference, all in one batch
+    class SurveyPlanner
+    {
+    public:
+        SurveyPlanner(MissionService* service, int missionId);
+
+        const SurveyArea& area() const;
+        void setArea(const SurveyArea& area);
+
+        const SurveyParameters& parameters() const;
+        void setParameters(const SurveyParameters& parameters);
+
+        // Survey block is appended to mission on first apply
+        bool apply();
+
+        dto::MissionItemPtrList items() const;
+
+    private:
+        MissionService* const m_service;
+        const int m_missionId;
+
+        SurveyArea m_area;
+        SurveyParameters m_parameters;
+        dto::MissionItemPtrList m_items;
+    };
+}
+
+#endif // SURVEY_PLANNER_H
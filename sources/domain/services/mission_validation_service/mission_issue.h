@@ -0,0 +1,26 @@
+#ifndef MISSION_ISSUE_H
+#define MISSION_ISSUE_H
+
+// Qt
+#include <QString>
+#include <QList>
+
+namespace domain
+{
+    struct MissionIssue
+    {
+        enum Severity
+        {
+            Warning,
+            Error
+        };
+
+        Severity severity = Warning;
+        int sequence = -1; // -1 for issues of mission as a whole
+        QString message;
+    };
+
+    using MissionIssueList = QList<MissionIssue>;
+}
+
+#endif // MISSION_ISSUE_H
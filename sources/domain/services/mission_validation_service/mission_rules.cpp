@@ -0,0 +1,199 @@
+#include "mission_rules.h"
+
+using namespace domain;
+
+namespace
+{
+    MissionIssue issue(MissionIssue::Severity severity, int sequence, const QString& message)
+    {
+        MissionIssue issue;
+        issue.severity = severity;
+        issue.sequence = sequence;
+        issue.message = message;
+        return issue;
+    }
+}
+
+MissionSnapshot MissionSnapshot::create(const dto::MissionItemPtrList& items)
+{
+    MissionSnapshot snapshot;
+    snapshot.items.reserve(items.count());
+
+    for (const dto::MissionItemPtr& item: items)
+    {
+        Item value;
+        value.sequence = item->sequence();
+        value.command = item->command();
+        value.altitude = item->altitude();
+        value.altituded = item->isAltitudedItem();
+        value.positionated = item->isPositionatedItem();
+        value.coordinate = item->coordinate();
+        value.targetSequence = item->parameter(dto::MissionItem::TargetSequence, -1).toInt();
+        value.repeats = item->parameter(dto::MissionItem::Repeats, 0).toInt();
+
+        snapshot.items.append(value);
+    }
+
+    return snapshot;
+}
+
+int MissionSnapshot::previousPositionated(int index) const
+{
+    for (int previous = index - 1; previous >= 0; --previous)
+    {
+        if (items.at(previous).positionated) return previous;
+    }
+    return -1;
+}
+
+bool AltitudeLimitsRule::isItemRule() const
+{
+    return true;
+}
+
+void AltitudeLimitsRule::check(const MissionSnapshot& snapshot, int index,
+                               MissionIssueList& issues) const
+{
+    const MissionSnapshot::Item& item = snapshot.items.at(index);
+    if (!item.altituded || item.command == dto::MissionItem::Home) return;
+
+    if (item.altitude < snapshot.minAltitude || item.altitude > snapshot.maxAltitude)
+    {
+        issues.append(::issue(MissionIssue::Error, item.sequence,
+                              tr("Altitude %1 m is out of limits %2..%3 m").arg(
+                                  item.altitude).arg(snapshot.minAltitude).arg(
+                                  snapshot.maxAltitude)));
+    }
+}
+
+bool LegLengthRule::isItemRule() const
+{
+    return true;
+}
+
+void LegLengthRule::check(const MissionSnapshot& snapshot, int index,
+                          MissionIssueList& issues) const
+{
+    const MissionSnapshot::Item& item = snapshot.items.at(index);
+    if (!item.positionated || !item.coordinate.isValid()) return;
+
+    int previous = snapshot.previousPositionated(index);
+    if (previous == -1 || !snapshot.items.at(previous).coordinate.isValid()) return;
+
+    double distance = snapshot.items.at(previous).coordinate.distanceTo(item.coordinate);
+    if (distance > snapshot.maxDistance)
+    {
+        issues.append(::issue(MissionIssue::Warning, item.sequence,
+                              tr("Leg of %1 m is longer than %2 m").arg(
+                                  qRound(distance)).arg(snapshot.maxDistance)));
+    }
+}
+
+bool UploadableCommandRule::isItemRule() const
+{
+    return true;
+}
+
+void UploadableCommandRule::check(const MissionSnapshot& snapshot, int index,
+                                  MissionIssueList& issues) const
+{
+    const MissionSnapshot::Item& item = snapshot.items.at(index);
+
+    switch (item.command)
+    {
+    case dto::MissionItem::UnknownCommand:
+    case dto::MissionItem::TargetPoint:
+        issues.append(::issue(MissionIssue::Error, item.sequence,
+                              tr("Command can't be uploaded to vehicle")));
+        break;
+    case dto::MissionItem::Home:
+        if (index > 0) issues.append(::issue(MissionIssue::Error, item.sequence,
+                                             tr("Home must be the first item")));
+        break;
+    default:
+        break;
+    }
+}
+
+bool HomeRule::isItemRule() const
+{
+    return false;
+}
+
+void HomeRule::check(const MissionSnapshot& snapshot, int index, MissionIssueList& issues) const
+{
+    Q_UNUSED(index)
+
+    if (snapshot.items.isEmpty()) return;
+
+    const MissionSnapshot::Item& home = snapshot.items.first();
+    if (home.command != dto::MissionItem::Home)
+    {
+        issues.append(::issue(MissionIssue::Error, -1, tr("Mission has no home item")));
+    }
+    else if (!home.coordinate.isValid())
+    {
+        issues.append(::issue(MissionIssue::Warning, -1, tr("Home position is not set")));
+    }
+}
+
+bool JumpRule::isItemRule() const
+{
+    return false;
+}
+
+void JumpRule::check(const MissionSnapshot& snapshot, int index, MissionIssueList& issues) const
+{
+    Q_UNUSED(index)
+
+    QVector<int> loops; // Indexes of backward jumps
+    for (int i = 0; i < snapshot.items.count(); ++i)
+    {
+        const MissionSnapshot::Item& item = snapshot.items.at(i);
+        if (item.command != dto::MissionItem::JumpTo) continue;
+
+        int target = item.targetSequence;
+        if (target < 0 || target >= snapshot.items.count())
+        {
+            issues.append(::issue(MissionIssue::Error, item.sequence,
+                                  tr("Jump target %1 doesn't exist").arg(target + 1)));
+            continue;
+        }
+
+        if (target == i)
+        {
+            issues.append(::issue(MissionIssue::Error, item.sequence, tr("Jump to itself")));
+        }
+        else if (snapshot.items.at(target).command == dto::MissionItem::JumpTo)
+        {
+            issues.append(::issue(MissionIssue::Warning, item.sequence,
+                                  tr("Jump to another jump")));
+        }
+        else if (target < i)
+        {
+            if (item.repeats < 0)
+            {
+                issues.append(::issue(MissionIssue::Warning, item.sequence,
+                                      tr("Endless loop back to item %1").arg(target + 1)));
+            }
+            loops.append(i);
+        }
+    }
+
+    // Loops must nest or be apart, crossing ones leave repeat counters in odd state
+    for (int i = 0; i < loops.count(); ++i)
+    {
+        const MissionSnapshot::Item& first = snapshot.items.at(loops.at(i));
+        for (int j = i + 1; j < loops.count(); ++j)
+        {
+            const MissionSnapshot::Item& second = snapshot.items.at(loops.at(j));
+            if (second.targetSequence > first.targetSequence &&
+                second.targetSequence <= loops.at(i))
+            {
+                issues.append(::issue(MissionIssue::Warning, second.sequence,
+                                      tr("Loop crosses loop of item %1").arg(
+                                          first.sequence + 1)));
+            }
+        }
+    }
+}
@@ -0,0 +1,102 @@
+#ifndef MISSION_RULES_H
+#define MISSION_RULES_H
+
+// Qt
+#include <QCoreApplication>
+#include <QVector>
+#include <QGeoCoordinate>
+
+// Internal
+#include "mission_item.h"
+#include "mission_issue.h"
+
+namespace domain
+{
+    // Value copy of a mission, rules run in worker threads and never touch shared dto
+    struct MissionSnapshot
+    {
+        struct Item
+        {
+            int sequence = -1;
+            dto::MissionItem::Command command = dto::MissionItem::UnknownCommand;
+            float altitude = 0;
+            bool altituded = false;
+            bool positionated = false;
+            QGeoCoordinate coordinate;
+            int targetSequence = -1;
+            int repeats = 0;
+        };
+
+        QVector<Item> items; // Index matches sequence
+        float minAltitude = 0;
+        float maxAltitude = 0;
+        double maxDistance = 0;
+
+        static MissionSnapshot create(const dto::MissionItemPtrList& items);
+        int previousPositionated(int index) const;
+    };
+
+    class MissionRule
+    {
+    public:
+        virtual ~MissionRule() {}
+
+        // Item rules check single item, so only changed items are rechecked,
+        // mission rules look at the whole mission every time
+        virtual bool isItemRule() const = 0;
+        virtual void check(const MissionSnapshot& snapshot, int index,
+                           MissionIssueList& issues) const = 0;
+    };
+
+    class AltitudeLimitsRule: public MissionRule
+    {
+        Q_DECLARE_TR_FUNCTIONS(AltitudeLimitsRule)
+
+    public:
+        bool isItemRule() const override;
+        void check(const MissionSnapshot& snapshot, int index,
+                   MissionIssueList& issues) const override;
+    };
+
+    class LegLengthRule: public MissionRule
+    {
+        Q_DECLARE_TR_FUNCTIONS(LegLengthRule)
+
+    public:
+        bool isItemRule() const override;
+        void check(const MissionSnapshot& snapshot, int index,
+                   MissionIssueList& issues) const override;
+    };
+
+    class UploadableCommandRule: public MissionRule
+    {
+        Q_DECLARE_TR_FUNCTIONS(UploadableCommandRule)
+
+    public:
+        bool isItemRule() const override;
+        void check(const MissionSnapshot& snapshot, int index,
+                   MissionIssueList& issues) const override;
+    };
+
+    class HomeRule: public MissionRule
+    {
+        Q_DECLARE_TR_FUNCTIONS(HomeRule)
+
+    public:
+        bool isItemRule() const override;
+        void check(const MissionSnapshot& snapshot, int index,
+                   MissionIssueList& issues) const override;
+    };
+
+    class JumpRule: public MissionRule
+    {
+        Q_DECLARE_TR_FUNCTIONS(JumpRule)
+
+    public:
+        bool isItemRule() const override;
+        void check(const MissionSnapshot& snapshot, int index,
+                   MissionIssueList& issues) const override;
+    };
+}
+
+#endif // MISSION_RULES_H
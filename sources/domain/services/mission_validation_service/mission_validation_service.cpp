@@ -0,0 +1,328 @@
+#include "mission_validation_service.h"
+
+// Qt
+#include <QCoreApplication>
+#include <QThreadPool>
+#include <QRunnable>
+#include <QBasicTimer>
+#include <QTimerEvent>
+#include <QSharedPointer>
+#include <QHash>
+#include <QMap>
+#include <QSet>
+#include <QDebug>
+
+// Internal
+#include "settings_provider.h"
+
+#include "mission.h"
+#include "mission_item.h"
+
+#include "mission_service.h"
+#include "mission_rules.h"
+
+using namespace domain;
+
+namespace
+{
+    const int coalesceInterval = 50; // Edits in one burst are checked together
+    const int chunkSize = 256;
+
+    const QEvent::Type validatedEventType = QEvent::Type(QEvent::registerEventType());
+
+    using RulePtr = QSharedPointer<const MissionRule>;
+    using SnapshotPtr = QSharedPointer<const MissionSnapshot>;
+
+    struct ValidationResult
+    {
+        int missionId = 0;
+        int generation = 0;
+        bool missionRules = false;
+        QVector<int> indexes; // Items to check with item rules
+        QVector<int> sequences; // Sequences of checked items
+        MissionIssueList issues;
+    };
+
+    class ValidatedEvent: public QEvent
+    {
+    public:
+        explicit ValidatedEvent(const ValidationResult& result):
+            QEvent(::validatedEventType),
+            result(result)
+        {}
+
+        const ValidationResult result;
+    };
+
+    class ValidationTask: public QRunnable
+    {
+    public:
+        ValidationTask(QObject* receiver, const SnapshotPtr& snapshot,
+                       const QList<RulePtr>& rules, const ValidationResult& result):
+            m_receiver(receiver),
+            m_snapshot(snapshot),
+            m_rules(rules),
+            m_result(result)
+        {}
+
+        void run() override
+        {
+            if (m_result.missionRules)
+            {
+                for (const RulePtr& rule: m_rules)
+                {
+                    if (!rule->isItemRule()) rule->check(*m_snapshot, -1, m_result.issues);
+                }
+            }
+            else
+            {
+                for (int index: m_result.indexes)
+                {
+                    for (const RulePtr& rule: m_rules)
+                    {
+                        if (rule->isItemRule()) rule->check(*m_snapshot, index, m_result.issues);
+                    }
+                    m_result.sequences.append(m_snapshot->items.at(index).sequence);
+                }
+            }
+
+            QCoreApplication::postEvent(m_receiver, new ValidatedEvent(m_result));
+        }
+
+    private:
+        QObject* const m_receiver;
+        const SnapshotPtr m_snapshot;
+        const QList<RulePtr> m_rules;
+        ValidationResult m_result;
+    };
+}
+
+class MissionValidationService::Impl
+{
+public:
+    struct MissionState
+    {
+        int generation = 0;
+        QMap<int, MissionIssueList> itemIssues; // By sequence
+        QHash<int, int> itemGenerations;
+        MissionIssueList missionIssues;
+        int missionGeneration = 0;
+    };
+
+    MissionService* service;
+    QList<RulePtr> rules;
+
+    QHash<int, MissionState> states;
+    QSet<int> fullChecks;
+    QHash<int, QSet<int> > dirtyItems;
+
+    QBasicTimer timer;
+    QThreadPool pool; // Declared last, so it waits for running tasks first
+};
+
+MissionValidationService::MissionValidationService(MissionService* service, QObject* parent):
+    QObject(parent),
+    d(new Impl())
+{
+    d->service = service;
+    d->rules.append(RulePtr(new AltitudeLimitsRule()));
+    d->rules.append(RulePtr(new LegLengthRule()));
+    d->rules.append(RulePtr(new UploadableCommandRule()));
+    d->rules.append(RulePtr(new HomeRule()));
+    d->rules.append(RulePtr(new JumpRule()));
+
+    connect(service, &MissionService::missionRemoved,
+            this, &MissionValidationService::onMissionRemoved);
+    connect(service, &MissionService::missionItemAdded,
+            this, &MissionValidationService::onMissionItemsChanged);
+    connect(service, &MissionService::missionItemRemoved,
+            this, &MissionValidationService::onMissionItemsChanged);
+    connect(service, &MissionService::missionItemChanged,
+            this, &MissionValidationService::onMissionItemChanged);
+    connect(service, &MissionService::missionItemsChanged,
+            this, &MissionValidationService::validate);
+
+    this->validateAll();
+}
+
+MissionValidationService::~MissionValidationService()
+{
+    d->pool.clear();
+    d->pool.waitForDone();
+}
+
+MissionIssueList MissionValidationService::issues(int missionId) const
+{
+    auto it = d->states.constFind(missionId);
+    if (it == d->states.constEnd()) return MissionIssueList();
+
+    MissionIssueList issues = it->missionIssues;
+    for (const MissionIssueList& itemIssues: it->itemIssues) issues.append(itemIssues);
+    return issues;
+}
+
+MissionIssueList MissionValidationService::itemIssues(int missionId, int sequence) const
+{
+    auto it = d->states.constFind(missionId);
+    if (it == d->states.constEnd()) return MissionIssueList();
+
+    MissionIssueList issues = it->itemIssues.value(sequence);
+    for (const MissionIssue& issue: it->missionIssues)
+    {
+        if (issue.sequence == sequence) issues.append(issue);
+    }
+    return issues;
+}
+
+bool MissionValidationService::hasErrors(int missionId) const
+{
+    for (const MissionIssue& issue: this->issues(missionId))
+    {
+        if (issue.severity == MissionIssue::Error) return true;
+    }
+    return false;
+}
+
+void MissionValidationService::validate(int missionId)
+{
+    d->fullChecks.insert(missionId);
+    this->schedule();
+}
+
+void MissionValidationService::validateAll()
+{
+    for (const dto::MissionPtr& mission: d->service->missions())
+    {
+        d->fullChecks.insert(mission->id());
+    }
+    this->schedule();
+}
+
+void MissionValidationService::timerEvent(QTimerEvent* event)
+{
+    if (event->timerId() != d->timer.timerId()) return QObject::timerEvent(event);
+
+    d->timer.stop();
+
+    QSet<int> missionIds = d->fullChecks;
+    for (auto it = d->dirtyItems.cbegin(); it != d->dirtyItems.cend(); ++it)
+    {
+        missionIds.insert(it.key());
+    }
+
+    for (int missionId: missionIds) this->dispatch(missionId);
+}
+
+void MissionValidationService::customEvent(QEvent* event)
+{
+    if (event->type() != ::validatedEventType) return QObject::customEvent(event);
+
+    const ValidationResult& result = static_cast<ValidatedEvent*>(event)->result;
+    auto it = d->states.find(result.missionId);
+    if (it == d->states.end()) return; // Mission was removed meanwhile
+
+    if (result.missionRules)
+    {
+        if (result.generation < it->missionGeneration) return;
+
+        it->missionGeneration = result.generation;
+        it->missionIssues = result.issues;
+    }
+    else
+    {
+        QMap<int, MissionIssueList> found;
+        for (const MissionIssue& issue: result.issues) found[issue.sequence].append(issue);
+
+        // Newer check of the same item could have finished first, or item is gone
+        for (int sequence: result.sequences)
+        {
+            if (it->itemGenerations.value(sequence) > result.generation ||
+                d->service->missionItem(result.missionId, sequence).isNull()) continue;
+
+            it->itemGenerations[sequence] = result.generation;
+            if (found.contains(sequence)) it->itemIssues[sequence] = found.value(sequence);
+            else it->itemIssues.remove(sequence);
+        }
+    }
+
+    emit issuesChanged(result.missionId);
+}
+
+void MissionValidationService::onMissionRemoved(const dto::MissionPtr& mission)
+{
+    d->states.remove(mission->id());
+    d->fullChecks.remove(mission->id());
+    d->dirtyItems.remove(mission->id());
+}
+
+void MissionValidationService::onMissionItemsChanged(const dto::MissionItemPtr& item)
+{
+    // Sequences are shifted, so every item is rechecked
+    this->validate(item->missionId());
+}
+
+void MissionValidationService::onMissionItemChanged(const dto::MissionItemPtr& item)
+{
+    QSet<int>& dirty = d->dirtyItems[item->missionId()];
+    dirty.insert(item->sequence());
+
+    // Leg of next positioned item depends on this one
+    for (int sequence = item->sequence() + 1; ; ++sequence)
+    {
+        dto::MissionItemPtr next = d->service->missionItem(item->missionId(), sequence);
+        if (next.isNull()) break;
+        if (!next->isPositionatedItem()) continue;
+
+        dirty.insert(sequence);
+        break;
+    }
+
+    this->schedule();
+}
+
+void MissionValidationService::schedule()
+{
+    if (!d->timer.isActive()) d->timer.start(::coalesceInterval, this);
+}
+
+void MissionValidationService::dispatch(int missionId)
+{
+    bool full = d->fullChecks.remove(missionId);
+    QSet<int> dirty = d->dirtyItems.take(missionId);
+
+    QSharedPointer<MissionSnapshot> snapshot = QSharedPointer<MissionSnapshot>::create(
+                MissionSnapshot::create(d->service->missionItems(missionId)));
+    snapshot->minAltitude = settings::Provider::value(settings::parameters::minAltitude).toFloat();
+    snapshot->maxAltitude = settings::Provider::value(settings::parameters::maxAltitude).toFloat();
+    snapshot->maxDistance = settings::Provider::value(settings::parameters::maxDistance).toDouble();
+
+    Impl::MissionState& state = d->states[missionId];
+    ValidationResult result;
+    result.missionId = missionId;
+    result.generation = ++state.generation;
+
+    QVector<int> indexes;
+    for (int index = 0; index < snapshot->items.count(); ++index)
+    {
+        if (full || dirty.contains(snapshot->items.at(index).sequence)) indexes.append(index);
+    }
+
+    if (full) // Forget items which are gone
+    {
+        int count = snapshot->items.count();
+        while (!state.itemIssues.isEmpty() && state.itemIssues.lastKey() >= count)
+        {
+            state.itemIssues.remove(state.itemIssues.lastKey());
+        }
+    }
+
+    for (int from = 0; from < indexes.count(); from += ::chunkSize)
+    {
+        ValidationResult chunk = result;
+        chunk.indexes = indexes.mid(from, ::chunkSize);
+        d->pool.start(new ValidationTask(this, snapshot, d->rules, chunk));
+    }
+
+    result.missionRules = true;
+    d->pool.start(new ValidationTask(this, snapshot, d->rules, result));
+}
@@ -0,0 +1,54 @@
+#ifndef MISSION_VALIDATION_SERVICE_H
+#define MISSION_VALIDATION_SERVICE_H
+
+// Qt
+#include <QObject>
+
+// Internal
+#include "dto_traits.h"
+#include "mission_issue.h"
+
+namespace domain
+{
+    class MissionService;
+
+    // Checks missions against rules in a thread pool. Changed items are rechecked
+    // alone, items added or removed recheck whole mission split in chunks
+    class MissionValidationService: public QObject
+    {
+        Q_OBJECT
+
+    public:
+        explicit MissionValidationService(MissionService* service, QObject* parent = nullptr);
+        ~MissionValidationService() override;
+
+        MissionIssueList issues(int missionId) const;
+        MissionIssueList itemIssues(int missionId, int sequence) const;
+        bool hasErrors(int missionId) const;
+
+    public slots:
+        void validate(int missionId);
+        void validateAll();
+
+    signals:
+        void issuesChanged(int missionId);
+
+    protected:
+        void timerEvent(QTimerEvent* event) override;
+        void customEvent(QEvent* event) override;
+
+    private slots:
+        void onMissionRemoved(const dto::MissionPtr& mission);
+        void onMissionItemsChanged(const dto::MissionItemPtr& item);
+        void onMissionItemChanged(const dto::MissionItemPtr& item);
+
+    private:
+        void schedule();
+        void dispatch(int missionId);
+
+        class Impl;
+        QScopedPointer<Impl> const d;
+    };
+}
+
+#endif // MISSION_VALIDATION_SERVICE_H
@@ -0,0 +1,21 @@
+#ifndef ONBOARD_LOG_H
+#define ONBOARD_LOG_H
+
+// Qt
+#include <QDateTime>
+#include <QList>
+
+namespace domain
+{
+    // Log stored on vehicle, as listed by autopilot
+    struct OnboardLog
+    {
+        int id = 0;
+        quint32 size = 0;
+        QDateTime time; // Invalid if autopilot has no UTC time for it
+    };
+
+    using OnboardLogList = QList<OnboardLog>;
+}
+
+#endif // ONBOARD_LOG_H
@@ -0,0 +1,64 @@
+#include "onboard_log_service.h"
+
+// Qt
+#include <QHash>
+#include <QMutexLocker>
+
+using namespace domain;
+
+class OnboardLogService::Impl
+{
+public:
+    mutable QMutex mutex;
+    QHash<int, OnboardLogList> logs;
+};
+
+OnboardLogService::OnboardLogService(QObject* parent):
+    QObject(parent),
+    d(new Impl())
+{}
+
+OnboardLogService::~OnboardLogService()
+{}
+
+OnboardLogList OnboardLogService::logs(int vehicleId) const
+{
+    QMutexLocker locker(&d->mutex);
+
+    return d->logs.value(vehicleId);
+}
+
+void OnboardLogService::setLogs(int vehicleId, const OnboardLogList& logs)
+{
+    {
+        QMutexLocker locker(&d->mutex);
+        d->logs[vehicleId] = logs;
+    }
+
+    emit logsChanged(vehicleId);
+}
+
+void OnboardLogService::setDownloadProgress(int vehicleId, int logId, quint32 received, quint32 size)
+{
+    emit downloadProgress(vehicleId, logId, received, size);
+}
+
+void OnboardLogService::setDownloadFinished(int vehicleId, int logId, bool success)
+{
+    emit downloadFinished(vehicleId, logId, success);
+}
+
+void OnboardLogService::requestList(int vehicleId)
+{
+    emit listRequested(vehicleId);
+}
+
+void OnboardLogService::download(int vehicleId, int logId, const QString& fileName)
+{
+    emit downloadRequested(vehicleId, logId, fileName);
+}
+
+void OnboardLogService::cancelDownload(int vehicleId)
+{
+    emit downloadCanceled(vehicleId);
+}
@@ -0,0 +1,48 @@
+#ifndef ONBOARD_LOG_SERVICE_H
+#define ONBOARD_LOG_SERVICE_H
+
+// Qt
+#include <QObject>
+
+// Internal
+#include "onboard_log.h"
+
+namespace domain
+{
+    class OnboardLogService: public QObject
+    {
+        Q_OBJECT
+
+    public:
+        explicit OnboardLogService(QObject* parent = nullptr);
+        ~OnboardLogService() override;
+
+        OnboardLogList logs(int vehicleId) const;
+
+        // For protocol handlers, thread safe
+        void setLogs(int vehicleId, const OnboardLogList& logs);
+        void setDownloadProgress(int vehicleId, int logId, quint32 received, quint32 size);
+        void setDownloadFinished(int vehicleId, int logId, bool success);
+
+    public slots:
+        void requestList(int vehicleId);
+        // Log is written straight to fileName while chunks arrive
+        void download(int vehicleId, int logId, const QString& fileName);
+        void cancelDownload(int vehicleId);
+
+    signals:
+        void listRequested(int vehicleId);
+        void downloadRequested(int vehicleId, int logId, const QString& fileName);
+        void downloadCanceled(int vehicleId);
+
+        void logsChanged(int vehicleId);
+        void downloadProgress(int vehicleId, int logId, quint32 received, quint32 size);
+        void downloadFinished(int vehicleId, int logId, bool success);
+
+    private:
+        class Impl;
+        QScopedPointer<Impl> const d;
+    };
+}
+
+#endif // ONBOARD_LOG_SERVICE_H
@@ -0,0 +1,240 @@
+#include "parameter_service.h"
+
+// Qt
+#include <QHash>
+#include <QSet>
+#include <QMutexLocker>
+#include <QReadWriteLock>
+#include <QDebug>
+
+// Internal
+#include "vehicle.h"
+#include "parameter_cache.h"
+#include "parameters_blob.h"
+
+#include "generic_repository.h"
+
+#include "vehicle_service.h"
+
+using namespace dto;
+using namespace domain;
+
+class ParameterService::Impl
+{
+public:
+    // Serializes repository access, readers of cached values never take it
+    QMutex mutex;
+    QReadWriteLock cacheLock;
+
+    GenericRepository<ParameterCache> cacheRepository;
+
+    QHash<int, VehicleParameterMap> parameters;
+    QHash<int, QString> firmwares;
+    QSet<int> completeVehicles;
+    QSet<int> dirtyVehicles; // Waiting for save, guarded by cacheLock
+
+    Impl():
+        cacheRepository("parameter_caches")
+    {}
+
+    ParameterCachePtr readCache(int vehicleId, const QString& firmware)
+    {
+        QString escaped = firmware;
+        escaped.replace("'", "''");
+
+        for (int id: cacheRepository.selectId(QString("WHERE vehicleId = %1 AND firmware = '%2'").arg(
+                                                  vehicleId).arg(escaped)))
+        {
+            return cacheRepository.read(id);
+        }
+        return ParameterCachePtr();
+    }
+
+    void saveCache(int vehicleId)
+    {
+        QByteArray data;
+        {
+            QReadLocker locker(&cacheLock);
+            if (!completeVehicles.contains(vehicleId)) return;
+
+            QDataStream stream(&data, QIODevice::WriteOnly);
+            stream.setVersion(dto::parametersBlobVersion);
+            stream << parameters.value(vehicleId);
+        }
+
+        QMutexLocker locker(&mutex);
+
+        QString firmware = firmwares.value(vehicleId);
+        ParameterCachePtr cache = this->readCache(vehicleId, firmware);
+        if (cache.isNull())
+        {
+            cache = ParameterCachePtr::create();
+            cache->setVehicleId(vehicleId);
+            cache->setFirmware(firmware);
+        }
+
+        cache->setParameters(data);
+        cacheRepository.save(cache);
+    }
+};
+
+ParameterService::ParameterService(VehicleService* vehicleService, QObject* parent):
+    QObject(parent),
+    d(new Impl())
+{
+    connect(vehicleService, &VehicleService::vehicleRemoved,
+            this, &ParameterService::onVehicleRemoved);
+}
+
+ParameterService::~ParameterService()
+{}
+
+VehicleParameterMap ParameterService::parameters(int vehicleId) const
+{
+    QReadLocker locker(&d->cacheLock);
+
+    return d->parameters.value(vehicleId);
+}
+
+QVariant ParameterService::value(int vehicleId, const QString& name) const
+{
+    QReadLocker locker(&d->cacheLock);
+
+    return d->parameters.value(vehicleId).value(name).value;
+}
+
+bool ParameterService::isComplete(int vehicleId) const
+{
+    QReadLocker locker(&d->cacheLock);
+
+    return d->completeVehicles.contains(vehicleId);
+}
+
+VehicleParameterMap ParameterService::loadCache(int vehicleId, const QString& firmware)
+{
+    VehicleParameterMap parameters;
+    {
+        QMutexLocker locker(&d->mutex);
+
+        ParameterCachePtr cache = d->readCache(vehicleId, firmware);
+        if (cache)
+        {
+            QDataStream stream(cache->parameters());
+            stream.setVersion(dto::parametersBlobVersion);
+            stream >> parameters;
+
+            if (stream.status() != QDataStream::Ok) parameters.clear();
+        }
+    }
+
+    {
+        QWriteLocker locker(&d->cacheLock);
+
+        d->firmwares[vehicleId] = firmware;
+        if (parameters.isEmpty()) return parameters;
+
+        d->parameters[vehicleId] = parameters;
+        d->completeVehicles.insert(vehicleId);
+    }
+
+    emit parametersChanged(vehicleId);
+    return parameters;
+}
+
+void ParameterService::setParameters(int vehicleId, const VehicleParameterMap& parameters)
+{
+    {
+        QWriteLocker locker(&d->cacheLock);
+
+        d->parameters[vehicleId] = parameters;
+        d->completeVehicles.insert(vehicleId);
+    }
+
+    this->scheduleSave(vehicleId);
+    emit parametersChanged(vehicleId);
+}
+
+void ParameterService::setParameter(int vehicleId, const QString& name,
+                                    const VehicleParameter& parameter, bool persist)
+{
+    {
+        QWriteLocker locker(&d->cacheLock);
+
+        VehicleParameter& stored = d->parameters[vehicleId][name];
+        if (stored.index == parameter.index && stored.type == parameter.type &&
+            stored.value == parameter.value) return;
+
+        stored = parameter;
+    }
+
+    if (persist) this->scheduleSave(vehicleId);
+    emit parameterChanged(vehicleId, name, parameter.value);
+}
+
+void ParameterService::setProgress(int vehicleId, int received, int total)
+{
+    emit progressChanged(vehicleId, received, total);
+}
+
+void ParameterService::setWriteFinished(int vehicleId, const QStringList& failed)
+{
+    this->scheduleSave(vehicleId);
+    emit writeFinished(vehicleId, failed);
+}
+
+void ParameterService::download(int vehicleId)
+{
+    emit downloadRequested(vehicleId);
+}
+
+void ParameterService::write(int vehicleId, const QVariantMap& values)
+{
+    emit writeRequested(vehicleId, values);
+}
+
+void ParameterService::onVehicleRemoved(const dto::VehiclePtr& vehicle)
+{
+    {
+        QWriteLocker locker(&d->cacheLock);
+
+        d->parameters.remove(vehicle->id());
+        d->firmwares.remove(vehicle->id());
+        d->completeVehicles.remove(vehicle->id());
+        d->dirtyVehicles.remove(vehicle->id());
+    }
+
+    QMutexLocker locker(&d->mutex);
+
+    ParameterCachePtrList caches;
+    for (int id: d->cacheRepository.selectId(QString("WHERE vehicleId = %1").arg(vehicle->id())))
+    {
+        ParameterCachePtr cache = d->cacheRepository.read(id);
+        if (cache) caches.append(cache);
+    }
+    d->cacheRepository.remove(caches);
+}
+
+void ParameterService::onCachesDirty()
+{
+    QSet<int> vehicleIds;
+    {
+        QWriteLocker locker(&d->cacheLock);
+        vehicleIds.swap(d->dirtyVehicles);
+    }
+
+    for (int vehicleId: vehicleIds) d->saveCache(vehicleId);
+}
+
+void ParameterService::scheduleSave(int vehicleId)
+{
+    bool schedule;
+    {
+        QWriteLocker locker(&d->cacheLock);
+
+        schedule = d->dirtyVehicles.isEmpty();
+        d->dirtyVehicles.insert(vehicleId);
+    }
+
+    // One queued call saves every vehicle changed meanwhile
+    if (schedule) QMetaObject::invokeMethod(this, "onCachesDirty", Qt::QueuedConnection);
+}
@@ -0,0 +1,65 @@
+#ifndef PARAMETER_SERVICE_H
+#define PARAMETER_SERVICE_H
+
+// Qt
+#include <QObject>
+#include <QVariantMap>
+
+// Internal
+#include "dto_traits.h"
+#include "vehicle_parameter.h"
+
+namespace domain
+{
+    class VehicleService;
+
+    // Vehicle parameters as last reported by protocol handlers, complete sets are
+    // cached per vehicle and firmware, so known vehicle gets them before any download
+    class ParameterService: public QObject
+    {
+        Q_OBJECT
+
+    public:
+        explicit ParameterService(VehicleService* vehicleService, QObject* parent = nullptr);
+        ~ParameterService() override;
+
+        VehicleParameterMap parameters(int vehicleId) const;
+        QVariant value(int vehicleId, const QString& name) const;
+        bool isComplete(int vehicleId) const;
+
+        // For protocol handlers, thread safe
+        VehicleParameterMap loadCache(int vehicleId, const QString& firmware);
+        void setParameters(int vehicleId, const VehicleParameterMap& parameters);
+        // Single changes may skip persisting, next complete set or finished write saves them.
+        // Persisting is deferred to service's thread and coalesced, callers never wait on db
+        void setParameter(int vehicleId, const QString& name, const VehicleParameter& parameter,
+                          bool persist = true);
+        void setProgress(int vehicleId, int received, int total);
+        void setWriteFinished(int vehicleId, const QStringList& failed);
+
+    public slots:
+        void download(int vehicleId);
+        void write(int vehicleId, const QVariantMap& values);
+
+    signals:
+        void downloadRequested(int vehicleId);
+        void writeRequested(int vehicleId, const QVariantMap& values);
+
+        void parametersChanged(int vehicleId);
+        void parameterChanged(int vehicleId, const QString& name, const QVariant& value);
+        void progressChanged(int vehicleId, int received, int total);
+        void writeFinished(int vehicleId, const QStringList& failed);
+
+    private slots:
+        void onVehicleRemoved(const dto::VehiclePtr& vehicle);
+        void onCachesDirty();
+
+    private:
+        void scheduleSave(int vehicleId);
+
+        class Impl;
+        QScopedPointer<Impl> const d;
+    };
+}
+
+#endif // PARAMETER_SERVICE_H
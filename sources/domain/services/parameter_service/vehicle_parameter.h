@@ -0,0 +1,37 @@
+#ifndef VEHICLE_PARAMETER_H
+#define VEHICLE_PARAMETER_H
+
+// Qt
+#include <QMap>
+#include <QVariant>
+#include <QDataStream>
+
+namespace domain
+{
+    struct VehicleParameter
+    {
+        int index = -1; // Position in vehicle's parameter table
+        int type = 0; // Storage type, protocol specific
+        QVariant value;
+    };
+
+    using VehicleParameterMap = QMap<QString, VehicleParameter>; // By parameter name
+
+    inline QDataStream& operator <<(QDataStream& stream, const VehicleParameter& parameter)
+    {
+        return stream << qint32(parameter.index) << quint8(parameter.type) << parameter.value;
+    }
+
+    inline QDataStream& operator >>(QDataStream& stream, VehicleParameter& parameter)
+    {
+        qint32 index = -1;
+        quint8 type = 0;
+        stream >> index >> type >> parameter.value;
+
+        parameter.index = index;
+        parameter.type = type;
+        return stream;
+    }
+}
+
+#endif // VEHICLE_PARAMETER_H
@@ -5,7 +5,12 @@
 
 // Internal
 #include "mission_service.h"
+#include "mission_geometry_service.h"
+#include "mission_validation_service.h"
 #include "vehicle_service.h"
+#include "parameter_service.h"
+#include "onboard_log_service.h"
+#include "file_transfer_service.h"
 #include "telemetry_service.h"
 #include "video_service.h"
 #include "command_service.h"
@@ -20,7 +25,12 @@ class ServiceRegistry::Impl
 {
 public:
     MissionService missionService;
+    MissionGeometryService missionGeometryService;
+    MissionValidationService missionValidationService;
     VehicleService vehicleService;
+    ParameterService parameterService;
+    OnboardLogService onboardLogService;
+    FileTransferService fileTransferService;
     TelemetryService telemetryService;
     VideoService videoService;
     CommandService commandService;
@@ -28,7 +38,10 @@ public:
     CommunicationService communicationService;
 
     Impl():
+        missionGeometryService(&missionService),
+        missionValidationService(&missionService),
         vehicleService(&missionService),
+        parameterService(&vehicleService),
         telemetryService(&vehicleService),
         communicationService(&serialPortService)
     {}
@@ -55,11 +68,36 @@ MissionService* ServiceRegistry::missionService()
     return &d->missionService;
 }
 
+MissionGeometryService* ServiceRegistry::missionGeometryService()
+{
+    return &d->missionGeometryService;
+}
+
+MissionValidationService* ServiceRegistry::missionValidationService()
+{
+    return &d->missionValidationService;
+}
+
 VehicleService* ServiceRegistry::vehicleService()
 {
     return &d->vehicleService;
 }
 
+ParameterService* ServiceRegistry::parameterService()
+{
+    return &d->parameterService;
+}
+
+OnboardLogService* ServiceRegistry::onboardLogService()
+{
+    return &d->onboardLogService;
+}
+
+FileTransferService* ServiceRegistry::fileTransferService()
+{
+    return &d->fileTransferService;
+}
+
 TelemetryService* ServiceRegistry::telemetryService()
 {
     return &d->telemetryService;
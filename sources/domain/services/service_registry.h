@@ -7,7 +7,12 @@
 namespace domain
 {
     class MissionService;
+    class MissionGeometryService;
+    class MissionValidationService;
     class VehicleService;
+    class ParameterService;
+    class OnboardLogService;
+    class FileTransferService;
     class TelemetryService;
     class VideoService;
     class CommandService;
@@ -23,7 +28,12 @@ namespace domain
         static ServiceRegistry* instance();
 
         MissionService* missionService();
+        MissionGeometryService* missionGeometryService();
+        MissionValidationService* missionValidationService();
         VehicleService* vehicleService();
+        ParameterService* parameterService();
+        OnboardLogService* onboardLogService();
+        FileTransferService* fileTransferService();
         TelemetryService* telemetryService();
         VideoService* videoService();
         CommandService* commandService();
@@ -1,6 +1,7 @@
 #include "telemetry.h"
 
 // Qt
+#include <QMetaMethod>
 #include <QDebug>
 
 using namespace domain;
@@ -84,6 +85,20 @@ QList<Telemetry*> Telemetry::childNodes() const
     return m_childNodes.values();
 }
 
+bool Telemetry::isObserved() const
+{
+    static const QMetaMethod changed = QMetaMethod::fromSignal(&Telemetry::parametersChanged);
+    static const QMetaMethod updated = QMetaMethod::fromSignal(&Telemetry::parametersUpdated);
+
+    if (this->isSignalConnected(changed) || this->isSignalConnected(updated)) return true;
+
+    for (Telemetry* child: m_childNodes)
+    {
+        if (child->isObserved()) return true;
+    }
+    return false;
+}
+
 void Telemetry::setParameter(TelemetryId key, const QVariant& value)
 {
     if (m_parameters.contains(key) && m_parameters[key] == value) return;
@@ -128,6 +128,15 @@
 //  |  |-SizeX                          real
 //  |  |-SizeY                          real
 //  |  |-Coordinate                     coordinate
+//  |-Heartbeat
+//  |  |-Interval                       int
+//  |  |-Jitter                         int
+//  |  |-Quality                        int
+//  |-Timesync
+//  |  |-RoundTrip                      int
+//  |  |-RoundTripP95                   int
+//  |  |-ClockOffset                    real
+//  |  |-ClockDrift                     real
 // Radio
 //  |-Rssi                              real
 //  |-Noise                             int
@@ -256,6 +265,17 @@ namespace domain
             DeviationY = 12002,
             SizeX = 12003,
             SizeY = 12004,
+
+            Heartbeat = 13000,
+            Interval = 13001,
+            Jitter = 13002,
+            Quality = 13003,
+
+            Timesync = 14000,
+            RoundTrip = 14001,
+            RoundTripP95 = 14002,
+            ClockOffset = 14003,
+            ClockDrift = 14004,
         };
 
         using TelemetryList = QList<TelemetryId>;
@@ -277,6 +297,9 @@ namespace domain
         Telemetry* childNode(const TelemetryList& path);
         QList<Telemetry*> childNodes() const;
 
+        // True if anybody listens to this node or one of its children
+        bool isObserved() const;
+
     public slots:
         void setParameter(TelemetryId id, const QVariant& value);
         void setParameter(const TelemetryList& path, const QVariant& value);
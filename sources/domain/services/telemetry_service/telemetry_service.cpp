@@ -2,6 +2,7 @@
 
 // Qt
 #include <QMap>
+#include <QMutex>
 #include <QDebug>
 
 // Internal
@@ -23,7 +24,10 @@ class TelemetryService::Impl
 public:
     domain::VehicleService* service;
 
+    // Guards node maps, nodes are looked up from communication thread
+    mutable QMutex mutex;
     QMap<int, Telemetry*> vehicleNodes;
+    QMap<int, Telemetry*> provisionalNodes; // mavId -> node of discovered vehicle
     Telemetry radioNode;
 
     Impl():
@@ -41,6 +45,8 @@ TelemetryService::TelemetryService(VehicleService* service, QObject* parent):
     d->service = service;
     connect(d->service, &VehicleService::vehicleAdded, this, &TelemetryService::onVehicleAdded);
     connect(d->service, &VehicleService::vehicleRemoved, this, &TelemetryService::onVehicleRemoved);
+    connect(d->service, &VehicleService::vehicleDiscovered,
+            this, &TelemetryService::onVehicleDiscovered, Qt::DirectConnection);
 
     VehicleTelemetryFactory factory;
     for (const dto::VehiclePtr& vehicle: d->service->vehicles())
@@ -54,6 +60,7 @@ TelemetryService::~TelemetryService()
 
 QList<Telemetry*> TelemetryService::rootNodes() const
 {
+    QMutexLocker locker(&d->mutex);
     QList<Telemetry*> list;
 
     list.append(d->vehicleNodes.values());
@@ -64,12 +71,17 @@ QList<Telemetry*> TelemetryService::rootNodes() const
 
 Telemetry* TelemetryService::vehicleNode(int vehicleId) const
 {
+    QMutexLocker locker(&d->mutex);
     return d->vehicleNodes.value(vehicleId, nullptr);
 }
 
 Telemetry* TelemetryService::mavNode(int mavId) const
 {
-    return this->vehicleNode(d->service->vehicleIdByMavId(mavId));
+    int vehicleId = d->service->vehicleIdByMavId(mavId);
+
+    QMutexLocker locker(&d->mutex);
+    Telemetry* node = d->vehicleNodes.value(vehicleId, nullptr);
+    return node ? node : d->provisionalNodes.value(mavId, nullptr);
 }
 
 Telemetry* TelemetryService::radioNode() const
@@ -79,18 +91,36 @@ Telemetry* TelemetryService::radioNode() const
 
 void TelemetryService::onVehicleAdded(const dto::VehiclePtr& vehicle)
 {
+    QMutexLocker locker(&d->mutex);
     if (d->vehicleNodes.contains(vehicle->id())) return;
 
-    VehicleTelemetryFactory factory;
-    d->vehicleNodes[vehicle->id()] = factory.create();
+    // Discovered vehicle keeps telemetry collected before it was saved
+    Telemetry* node = d->provisionalNodes.take(vehicle->mavId());
+    if (!node)
+    {
+        VehicleTelemetryFactory factory;
+        node = factory.create();
+    }
+    d->vehicleNodes[vehicle->id()] = node;
 }
 
 void TelemetryService::onVehicleRemoved(const dto::VehiclePtr& vehicle)
 {
+    QMutexLocker locker(&d->mutex);
     if (!d->vehicleNodes.contains(vehicle->id())) return;
 
     // FIXME: crash on removing nodes
     //delete d->vehicleNodes[vehicle->id()];
 }
 
+void TelemetryService::onVehicleDiscovered(const dto::VehiclePtr& vehicle)
+{
+    QMutexLocker locker(&d->mutex);
+    if (d->provisionalNodes.contains(vehicle->mavId())) return;
 
+    // Created in discoverer's thread, handed over to service's one
+    VehicleTelemetryFactory factory;
+    Telemetry* node = factory.create();
+    node->moveToThread(this->thread());
+    d->provisionalNodes[vehicle->mavId()] = node;
+}
@@ -19,6 +19,7 @@ namespace domain
 
         QList<Telemetry*> rootNodes() const;
         Telemetry* vehicleNode(int vehicleId) const;
+        // Falls back to provisional node of a discovered vehicle, not saved yet
         Telemetry* mavNode(int mavId) const;
         // TODO: multiply radio telemetry
         Telemetry* radioNode() const;
@@ -26,6 +27,7 @@ namespace domain
     private slots:
         void onVehicleAdded(const dto::VehiclePtr& vehicle);
         void onVehicleRemoved(const dto::VehiclePtr& vehicle);
+        void onVehicleDiscovered(const dto::VehiclePtr& vehicle);
 
     private:
         class Impl;
@@ -1,7 +1,10 @@
 #include "vehicle_service.h"
 
 // Qt
+#include <QHash>
+#include <QSet>
 #include <QMutexLocker>
+#include <QReadWriteLock>
 #include <QDebug>
 
 // Internal
@@ -13,16 +16,29 @@
 
 #include "mission_service.h"
 
+#include "log_bus.h"
+
 using namespace dto;
 using namespace domain;
 
 class VehicleService::Impl
 {
 public:
+    // Serializes writers and repository access, readers never take it
     QMutex mutex;
+    // Guards caches and indexes below, held only for the duration of a lookup or an update
+    QReadWriteLock cacheLock;
+
     GenericRepository<Vehicle> vehicleRepository;
     MissionService* missionService;
 
+    QHash<int, VehiclePtr> vehicles; // vehicleId -> vehicle
+    QHash<int, VehiclePtr> mavVehicles; // mavId -> vehicle
+    QHash<int, int> vehicleMavIds; // vehicleId -> indexed mavId
+
+    QSet<int> discoveredMavIds; // Discovered, but not saved yet
+    VehiclePtrList discoveredVehicles; // Waiting for save
+
     Impl():
         mutex(QMutex::Recursive),
         vehicleRepository("vehicles")
@@ -30,7 +46,56 @@ public:
 
     void loadVehicles(const QString& condition = QString())
     {
-        for (int id: vehicleRepository.selectId(condition)) vehicleRepository.read(id);
+        for (int id: vehicleRepository.selectId(condition))
+        {
+            this->indexVehicle(vehicleRepository.read(id));
+        }
+    }
+
+    void indexVehicle(const VehiclePtr& vehicle)
+    {
+        if (vehicle.isNull()) return;
+
+        QWriteLocker locker(&cacheLock);
+        this->dropVehicle(vehicle->id());
+
+        vehicles[vehicle->id()] = vehicle;
+        vehicleMavIds[vehicle->id()] = vehicle->mavId();
+        // Duplicates stored before they were rejected keep the first owner of mavId
+        if (!mavVehicles.contains(vehicle->mavId())) mavVehicles[vehicle->mavId()] = vehicle;
+    }
+
+    // Other vehicle already indexed by mavId, null if it is free or owned by this one
+    VehiclePtr mavIdOwner(const VehiclePtr& vehicle)
+    {
+        QReadLocker locker(&cacheLock);
+
+        VehiclePtr owner = mavVehicles.value(vehicle->mavId());
+        if (owner.isNull() || owner == vehicle || owner->id() == vehicle->id()) return VehiclePtr();
+        return owner;
+    }
+
+    void unindexVehicle(int vehicleId)
+    {
+        QWriteLocker locker(&cacheLock);
+        this->dropVehicle(vehicleId);
+    }
+
+private:
+    // Expects cacheLock to be locked for write
+    void dropVehicle(int vehicleId)
+    {
+        vehicles.remove(vehicleId);
+        if (!vehicleMavIds.contains(vehicleId)) return;
+
+        int mavId = vehicleMavIds.take(vehicleId);
+        VehiclePtr indexed = mavVehicles.value(mavId);
+        if (indexed.isNull() || indexed->id() != vehicleId) return;
+
+        // Handed over to a duplicate, if any, instead of leaving it unreachable
+        int other = vehicleMavIds.key(mavId, 0);
+        if (other) mavVehicles[mavId] = vehicles.value(other);
+        else mavVehicles.remove(mavId);
     }
 };
 
@@ -52,55 +117,91 @@ VehicleService::~VehicleService()
 
 VehiclePtr VehicleService::vehicle(int vehicleId) const
 {
+    if (vehicleId < 1) return VehiclePtr();
+
+    {
+        QReadLocker locker(&d->cacheLock);
+
+        VehiclePtr vehicle = d->vehicles.value(vehicleId);
+        if (vehicle) return vehicle;
+    }
+
+    // Not loaded yet, fall back to the repository
     QMutexLocker locker(&d->mutex);
 
-    return d->vehicleRepository.read(vehicleId);
+    VehiclePtr vehicle = d->vehicleRepository.read(vehicleId);
+    d->indexVehicle(vehicle);
+
+    return vehicle;
 }
 
 VehiclePtrList VehicleService::vehicles() const
 {
-    QMutexLocker locker(&d->mutex);
+    QReadLocker locker(&d->cacheLock);
 
-    return d->vehicleRepository.loadedEntities();
+    return d->vehicles.values();
 }
 
 int VehicleService::vehicleIdByMavId(int mavId) const
 {
-    QMutexLocker locker(&d->mutex);
+    QReadLocker locker(&d->cacheLock);
 
-    for (const VehiclePtr& vehicle: d->vehicleRepository.loadedEntities())
-    {
-        if (vehicle->mavId() == mavId) return vehicle->id();
-    }
+    VehiclePtr vehicle = d->mavVehicles.value(mavId);
+    if (vehicle) return vehicle->id();
     return 0;
 }
 
 int VehicleService::mavIdByVehicleId(int vehicleId) const
 {
-    QMutexLocker locker(&d->mutex);
+    QReadLocker locker(&d->cacheLock);
 
-    VehiclePtr vehicle = this->vehicle(vehicleId);
-    if (vehicle) return vehicle->mavId();
-    return -1;
+    return d->vehicleMavIds.value(vehicleId, -1);
 }
 
 QList<int> VehicleService::employedMavIds() const
 {
-    QList<int> mavIds;
-    for (const VehiclePtr& vehicle: this->vehicles())
+    QReadLocker locker(&d->cacheLock);
+
+    return d->mavVehicles.keys();
+}
+
+void VehicleService::discoverVehicle(const VehiclePtr& vehicle)
+{
+    bool schedule;
     {
-        mavIds.append(vehicle->mavId());
+        QWriteLocker locker(&d->cacheLock);
+
+        if (d->mavVehicles.contains(vehicle->mavId()) ||
+            d->discoveredMavIds.contains(vehicle->mavId())) return;
+
+        d->discoveredMavIds.insert(vehicle->mavId());
+        schedule = d->discoveredVehicles.isEmpty();
+        d->discoveredVehicles.append(vehicle);
     }
-    return mavIds;
+
+    emit vehicleDiscovered(vehicle);
+
+    // One queued call saves the whole burst of discoveries
+    if (schedule) QMetaObject::invokeMethod(this, "onVehiclesDiscovered", Qt::QueuedConnection);
 }
 
 bool VehicleService::save(const VehiclePtr& vehicle)
 {
     QMutexLocker locker(&d->mutex);
 
+    VehiclePtr owner = d->mavIdOwner(vehicle);
+    if (owner)
+    {
+        LogBus::log(tr("MAV ID %1 is already used by %2").arg(vehicle->mavId()).arg(owner->name()),
+                    dto::LogMessage::Warning);
+        return false;
+    }
+
     bool isNew = vehicle->id() == 0;
     if (!d->vehicleRepository.save(vehicle)) return false;
 
+    d->indexVehicle(vehicle);
+
     if (isNew)
     {
         settings::Provider::setValue(settings::vehicle::vehicle + QString::number(vehicle->id()) +
@@ -134,6 +235,8 @@ bool VehicleService::remove(const VehiclePtr& vehicle)
 
     if (!d->vehicleRepository.remove(vehicle)) return false;
 
+    d->unindexVehicle(vehicle->id());
+
     settings::Provider::remove(settings::vehicle::vehicle + QString::number(vehicle->id()));
 
     emit vehicleRemoved(vehicle);
@@ -154,3 +257,20 @@ bool VehicleService::addNewVehicle()
 
     return this->save(vehicle);
 }
+
+void VehicleService::onVehiclesDiscovered()
+{
+    VehiclePtrList vehicles;
+    {
+        QWriteLocker locker(&d->cacheLock);
+        vehicles.swap(d->discoveredVehicles);
+    }
+
+    for (const VehiclePtr& vehicle: vehicles)
+    {
+        this->save(vehicle);
+
+        QWriteLocker locker(&d->cacheLock);
+        d->discoveredMavIds.remove(vehicle->mavId());
+    }
+}
@@ -27,6 +27,10 @@ namespace domain
 
         QList<int> employedMavIds() const;
 
+        // Thread safe and cheap, vehicle is saved later in service's thread.
+        // Repeated discoveries of the same mavId are ignored until it is saved
+        void discoverVehicle(const dto::VehiclePtr& vehicle);
+
     public slots:
         bool save(const dto::VehiclePtr& vehicle);
         bool remove(const dto::VehiclePtr& vehicle);
@@ -36,6 +40,10 @@ namespace domain
         void vehicleAdded(dto::VehiclePtr vehicle);
         void vehicleRemoved(dto::VehiclePtr vehicle);
         void vehicleChanged(dto::VehiclePtr vehicle);
+        void vehicleDiscovered(dto::VehiclePtr vehicle); // Emitted in discoverer's thread
+
+    private slots:
+        void onVehiclesDiscovered();
 
     private:
         class Impl;
@@ -15,6 +15,7 @@ namespace dto
     class LinkDescription;
     class LinkStatistics;
     class VideoSource;
+    class ParameterCache;
 
     using MissionPtr = QSharedPointer<Mission>;
     using MissionItemPtr = QSharedPointer<MissionItem>;
@@ -24,6 +25,7 @@ namespace dto
     using LinkDescriptionPtr = QSharedPointer<LinkDescription>;
     using LinkStatisticsPtr = QSharedPointer<LinkStatistics>;
     using VideoSourcePtr = QSharedPointer<VideoSource>;
+    using ParameterCachePtr = QSharedPointer<ParameterCache>;
 
     using MissionPtrList = QList<MissionPtr>;
     using MissionItemPtrList = QList<MissionItemPtr>;
@@ -33,6 +35,7 @@ namespace dto
     using LinkDescriptionPtrList = QList<LinkDescriptionPtr>;
     using LinkStatisticsPtrList = QList<LinkStatisticsPtr>;
     using VideoSourcePtrList = QList<VideoSourcePtr>;
+    using ParameterCachePtrList = QList<ParameterCachePtr>;
 }
 
 #endif // DTO_TRAITS_H
@@ -1,18 +1,26 @@
 #include "link_description.h"
 
 // Qt
-#include <QMetaEnum>
 #include <QDebug>
 
+// Internal
+#include "parameters_blob.h"
+
 using namespace dto;
 
 namespace
 {
     static QMap <LinkDescription::Type, QList<LinkDescription::Parameter> > typeParameters =
     {
-        { LinkDescription::Serial, { LinkDescription::Device, LinkDescription::BaudRate } },
+        { LinkDescription::Serial, { LinkDescription::Device, LinkDescription::BaudRate,
+                                     LinkDescription::RouteAllowed,
+                                     LinkDescription::RouteBlocked,
+                                     LinkDescription::RouteRate } },
         { LinkDescription::Udp, { LinkDescription::Port, LinkDescription::Endpoints,
-                                  LinkDescription::UdpAutoResponse } }
+                                  LinkDescription::UdpAutoResponse,
+                                  LinkDescription::RouteAllowed,
+                                  LinkDescription::RouteBlocked,
+                                  LinkDescription::RouteRate } }
     };
 }
 
@@ -36,35 +44,14 @@ void LinkDescription::setType(LinkDescription::Type type)
     m_type = type;
 }
 
-QString LinkDescription::parameters() const
+QByteArray LinkDescription::parameters() const
 {
-    QStringList list;
-    int enumIndex = LinkDescription::staticMetaObject.indexOfEnumerator("Parameter");
-    QMetaEnum enumerator = LinkDescription::staticMetaObject.enumerator(enumIndex);
-
-    for (Parameter parameter: m_parameters.keys())
-    {
-        list.append(QString(enumerator.valueToKey(parameter)) + ":" +
-                    m_parameters.value(parameter).toString());
-    }
-
-    return list.join(";");
+    return packParameters(m_parameters);
 }
 
-void LinkDescription::setParameters(const QString& arguments)
+void LinkDescription::setParameters(const QByteArray& parameters)
 {
-    int enumIndex = LinkDescription::staticMetaObject.indexOfEnumerator("Parameter");
-    QMetaEnum enumerator = LinkDescription::staticMetaObject.enumerator(enumIndex);
-
-    m_parameters.clear();
-    for (const QString& pairs: arguments.split(";"))
-    {
-        QStringList pairList = pairs.split(":");
-        if (pairList.count() < 2) continue;
-
-        Parameter param = static_cast<Parameter>(enumerator.keyToValue(qPrintable(pairList.at(0))));
-        if (param != UnknownParameter) m_parameters[param] = pairList.at(1);
-    }
+    m_parameters = unpackParameters<Parameter>(parameters);
 }
 
 QVariant LinkDescription::parameter(Parameter key, const QVariant& parameter)
@@ -16,7 +16,7 @@ namespace dto
 
         Q_PROPERTY(QString name READ name WRITE setName)
         Q_PROPERTY(Type type READ type WRITE setType)
-        Q_PROPERTY(QString parameters READ parameters WRITE setParameters)
+        Q_PROPERTY(QByteArray parameters READ parameters WRITE setParameters)
         Q_PROPERTY(bool autoConnect READ isAutoConnect WRITE setAutoConnect)
 
     public:
@@ -42,7 +42,10 @@ namespace dto
             BaudRate,
             Port,
             Endpoints,
-            UdpAutoResponse
+            UdpAutoResponse,
+            RouteAllowed, // Comma separated message ids, forwarded by router
+            RouteBlocked,
+            RouteRate // Bytes per second
         };
 
         QString name() const;
@@ -51,8 +54,8 @@ namespace dto
         Type type() const;
         void setType(Type type);
 
-        QString parameters() const;
-        void setParameters(const QString& parameters);
+        QByteArray parameters() const;
+        void setParameters(const QByteArray& parameters);
         QVariant parameter(Parameter key, const QVariant& parameter = QVariant());
         void setParameter(Parameter key, const QVariant& parameter);
         void clearParameters();
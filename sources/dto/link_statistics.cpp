@@ -61,3 +61,33 @@ void LinkStatistics::setPacketDrops(int packetDrops)
 {
     m_packetDrops = packetDrops;
 }
+
+int LinkStatistics::roundTrip() const
+{
+    return m_roundTrip;
+}
+
+void LinkStatistics::setRoundTrip(int roundTrip)
+{
+    m_roundTrip = roundTrip;
+}
+
+int LinkStatistics::roundTripP95() const
+{
+    return m_roundTripP95;
+}
+
+void LinkStatistics::setRoundTripP95(int roundTripP95)
+{
+    m_roundTripP95 = roundTripP95;
+}
+
+const LinkTraffic& LinkStatistics::traffic() const
+{
+    return m_traffic;
+}
+
+void LinkStatistics::setTraffic(const LinkTraffic& traffic)
+{
+    m_traffic = traffic;
+}
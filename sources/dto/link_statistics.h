@@ -3,6 +3,7 @@
 
 // Internal
 #include "base_dto.h"
+#include "link_traffic.h"
 
 namespace dto
 {
@@ -16,6 +17,8 @@ namespace dto
         Q_PROPERTY(int bytesRecv READ bytesRecv WRITE setBytesRecv)
         Q_PROPERTY(int packetsRecv READ packetsRecv WRITE setPacketsRecv)
         Q_PROPERTY(int packetDrops READ packetDrops WRITE setPacketDrops)
+        Q_PROPERTY(int roundTrip READ roundTrip WRITE setRoundTrip)
+        Q_PROPERTY(int roundTripP95 READ roundTripP95 WRITE setRoundTripP95)
 
     public:
         int linkId() const;
@@ -36,6 +39,15 @@ namespace dto
         int packetDrops() const;
         void setPacketDrops(int packetDrops);
 
+        int roundTrip() const; // Median, ms
+        void setRoundTrip(int roundTrip);
+
+        int roundTripP95() const;
+        void setRoundTripP95(int roundTripP95);
+
+        const LinkTraffic& traffic() const;
+        void setTraffic(const LinkTraffic& traffic);
+
     private:
         int m_linkId = 0;
         int m_timestamp = 0;
@@ -43,6 +55,9 @@ namespace dto
         int m_bytesRecv = 0;
         int m_packetsRecv = 0;
         int m_packetDrops = 0;
+        int m_roundTrip = 0;
+        int m_roundTripP95 = 0;
+        LinkTraffic m_traffic;
     };
 }
 
@@ -0,0 +1,28 @@
+#ifndef LINK_TRAFFIC_H
+#define LINK_TRAFFIC_H
+
+// Qt
+#include <QMap>
+#include <QMetaType>
+
+namespace dto
+{
+    struct TrafficCounters
+    {
+        int packets = 0;
+        int bytes = 0;
+        int gaps = 0; // Lost packets by sequence numbers, known only per sender
+    };
+
+    // One second of link traffic, broken down by sender and message id
+    struct LinkTraffic
+    {
+        QMap<int, TrafficCounters> systems; // sysid -> counters
+        QMap<int, TrafficCounters> messages; // msgid -> counters
+        int drops = 0; // Packets failed to parse, their sender is unknown
+    };
+}
+
+Q_DECLARE_METATYPE(dto::LinkTraffic)
+
+#endif // LINK_TRAFFIC_H
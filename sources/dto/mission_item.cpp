@@ -1,11 +1,11 @@
 #include "mission_item.h"
 
 // Qt
-#include <QMetaEnum>
 #include <QDebug>
 
 // Internal
 #include "mission.h"
+#include "parameters_blob.h"
 
 using namespace dto;
 
@@ -26,6 +26,7 @@ namespace
                                          MissionItem::HeadingRequired } },
         { MissionItem::SetSpeed, { MissionItem::Speed, MissionItem::IsGroundSpeed,
                                    MissionItem::Throttle } },
+        { MissionItem::JumpTo, { MissionItem::TargetSequence, MissionItem::Repeats } },
         { MissionItem::TargetPoint, { MissionItem::Radius } },
     };
 }
@@ -110,35 +111,14 @@ void MissionItem::setCoordinate(const QGeoCoordinate& coordinate)
     m_coordinate = coordinate;
 }
 
-QString MissionItem::parameters() const
+QByteArray MissionItem::parameters() const
 {
-    QStringList list;
-    int enumIndex = MissionItem::staticMetaObject.indexOfEnumerator("Parameter");
-    QMetaEnum enumerator = MissionItem::staticMetaObject.enumerator(enumIndex);
-
-    for (Parameter parameter: m_parameters.keys())
-    {
-        list.append(QString(enumerator.valueToKey(parameter)) + ":" +
-                    m_parameters.value(parameter).toString());
-    }
-
-    return list.join(";");
+    return packParameters(m_parameters);
 }
 
-void MissionItem::setParameters(const QString& arguments)
+void MissionItem::setParameters(const QByteArray& parameters)
 {
-    int enumIndex = MissionItem::staticMetaObject.indexOfEnumerator("Parameter");
-    QMetaEnum enumerator = MissionItem::staticMetaObject.enumerator(enumIndex);
-
-    m_parameters.clear();
-    for (const QString& pairs: arguments.split(";"))
-    {
-        QStringList pairList = pairs.split(":");
-        if (pairList.count() < 2) continue;
-
-        Parameter param = static_cast<Parameter>(enumerator.keyToValue(qPrintable(pairList.at(0))));
-        if (param != UnknownParameter) m_parameters[param] = pairList.at(1);
-    }
+    m_parameters = unpackParameters<Parameter>(parameters);
 }
 
 QVariant MissionItem::parameter(Parameter key, const QVariant& parameter)
@@ -23,7 +23,7 @@ namespace dto
         Q_PROPERTY(double latitude READ latitude WRITE setLatitude)
         Q_PROPERTY(double longitude READ longitude WRITE setLongitude)
         // TODO: replace parameters with command arguments
-        Q_PROPERTY(QString parameters READ parameters WRITE setParameters)
+        Q_PROPERTY(QByteArray parameters READ parameters WRITE setParameters)
         Q_PROPERTY(Status status READ status WRITE setStatus)
         Q_PROPERTY(bool reached READ isReached WRITE setReached)
 
@@ -79,7 +79,8 @@ namespace dto
             Clockwise,
             Repeats,
             Time,
-            Enabled
+            Enabled,
+            TargetSequence
         };
 
         enum Status
@@ -112,8 +113,8 @@ namespace dto
         QGeoCoordinate coordinate() const;
         void setCoordinate(const QGeoCoordinate& coordinate);
 
-        QString parameters() const;
-        void setParameters(const QString& parameters);
+        QByteArray parameters() const;
+        void setParameters(const QByteArray& parameters);
         QVariant parameter(Parameter key, const QVariant& parameter = QVariant());
         void setParameter(Parameter key, const QVariant& parameter);
         void clearParameters();
@@ -0,0 +1,33 @@
+#include "parameter_cache.h"
+
+using namespace dto;
+
+int ParameterCache::vehicleId() const
+{
+    return m_vehicleId;
+}
+
+void ParameterCache::setVehicleId(int vehicleId)
+{
+    m_vehicleId = vehicleId;
+}
+
+QString ParameterCache::firmware() const
+{
+    return m_firmware;
+}
+
+void ParameterCache::setFirmware(const QString& firmware)
+{
+    m_firmware = firmware;
+}
+
+QByteArray ParameterCache::parameters() const
+{
+    return m_parameters;
+}
+
+void ParameterCache::setParameters(const QByteArray& parameters)
+{
+    m_parameters = parameters;
+}
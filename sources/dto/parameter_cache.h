@@ -0,0 +1,35 @@
+#ifndef PARAMETER_CACHE_H
+#define PARAMETER_CACHE_H
+
+// Internal
+#include "base_dto.h"
+
+namespace dto
+{
+    // Last complete parameter set of a vehicle for one firmware build
+    class ParameterCache: public BaseDto
+    {
+        Q_GADGET
+
+        Q_PROPERTY(int vehicleId READ vehicleId WRITE setVehicleId)
+        Q_PROPERTY(QString firmware READ firmware WRITE setFirmware)
+        Q_PROPERTY(QByteArray parameters READ parameters WRITE setParameters)
+
+    public:
+        int vehicleId() const;
+        void setVehicleId(int vehicleId);
+
+        QString firmware() const;
+        void setFirmware(const QString& firmware);
+
+        QByteArray parameters() const;
+        void setParameters(const QByteArray& parameters);
+
+    private:
+        int m_vehicleId = 0;
+        QString m_firmware;
+        QByteArray m_parameters;
+    };
+}
+
+#endif // PARAMETER_CACHE_H
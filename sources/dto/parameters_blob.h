@@ -0,0 +1,58 @@
+#ifndef PARAMETERS_BLOB_H
+#define PARAMETERS_BLOB_H
+
+// Qt
+#include <QMap>
+#include <QVariant>
+#include <QDataStream>
+
+namespace dto
+{
+    // Compact typed storage for DTO parameter maps: entry count followed by
+    // (key, QVariant) pairs, so hydration needs neither string splitting nor enum lookups
+    const QDataStream::Version parametersBlobVersion = QDataStream::Qt_5_9;
+
+    template <typename Key>
+    QByteArray packParameters(const QMap<Key, QVariant>& parameters)
+    {
+        QByteArray data;
+        if (parameters.isEmpty()) return data;
+
+        QDataStream stream(&data, QIODevice::WriteOnly);
+        stream.setVersion(parametersBlobVersion);
+
+        stream << quint8(parameters.count());
+        for (auto it = parameters.constBegin(); it != parameters.constEnd(); ++it)
+        {
+            stream << quint8(it.key()) << it.value();
+        }
+
+        return data;
+    }
+
+    template <typename Key>
+    QMap<Key, QVariant> unpackParameters(const QByteArray& data)
+    {
+        QMap<Key, QVariant> parameters;
+        if (data.isEmpty()) return parameters;
+
+        QDataStream stream(data);
+        stream.setVersion(parametersBlobVersion);
+
+        quint8 count = 0;
+        stream >> count;
+
+        for (quint8 i = 0; i < count && stream.status() == QDataStream::Ok; ++i)
+        {
+            quint8 key = 0;
+            QVariant value;
+            stream >> key >> value;
+
+            if (stream.status() == QDataStream::Ok && key) parameters[static_cast<Key>(key)] = value;
+        }
+
+        return parameters;
+    }
+}
+
+#endif // PARAMETERS_BLOB_H
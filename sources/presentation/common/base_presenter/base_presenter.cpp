@@ -68,3 +68,10 @@ void BasePresenter::invokeViewMethod(const char* name, const QVariant& arg1, con
     QMetaObject::invokeMethod(m_view, name, Q_ARG(QVariant, arg1), Q_ARG(QVariant, arg2));
 }
 
+void BasePresenter::invokeViewMethod(const char* name, const QVariant& arg1, const QVariant& arg2,
+                                     const QVariant& arg3)
+{
+    QMetaObject::invokeMethod(m_view, name, Q_ARG(QVariant, arg1), Q_ARG(QVariant, arg2),
+                              Q_ARG(QVariant, arg3));
+}
+
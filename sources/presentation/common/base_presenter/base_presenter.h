@@ -28,6 +28,8 @@ namespace presentation
         void invokeViewMethod(const char* name);
         void invokeViewMethod(const char* name, const QVariant& arg);
         void invokeViewMethod(const char* name, const QVariant& arg1, const QVariant& arg2);
+        void invokeViewMethod(const char* name, const QVariant& arg1, const QVariant& arg2,
+                              const QVariant& arg3);
 
     signals:
         void viewChanged(QObject* view);
@@ -29,6 +29,8 @@
 #include "link_edit_presenter.h"
 #include "vehicle_list_presenter.h"
 #include "vehicle_presenter.h"
+#include "onboard_logs_presenter.h"
+#include "remote_files_presenter.h"
 #include "log_list_presenter.h"
 #include "planning_presenter.h"
 #include "mission_list_presenter.h"
@@ -93,6 +95,8 @@ static void registerTypes()
     QML_TYPE(LinkEditPresenter);
     QML_TYPE(VehicleListPresenter);
     QML_TYPE(VehiclePresenter);
+    QML_TYPE(OnboardLogsPresenter);
+    QML_TYPE(RemoteFilesPresenter);
     QML_TYPE(LogListPresenter);
 
     QML_TYPE(PlanningPresenter);
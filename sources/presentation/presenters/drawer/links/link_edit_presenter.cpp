@@ -14,6 +14,7 @@
 #include "communication_service.h"
 
 #include "link_statistics_model.h"
+#include "link_traffic_model.h"
 
 namespace
 {
@@ -25,7 +26,8 @@ using namespace presentation;
 LinkEditPresenter::LinkEditPresenter(QObject* parent):
     LinkPresenter(parent),
     m_serialService(serviceRegistry->serialPortService()),
-    m_statisticsModel(new LinkStatisticsModel(this))
+    m_statisticsModel(new LinkStatisticsModel(this)),
+    m_trafficModel(new LinkTrafficModel(this))
 {
     connect(m_serialService, &domain::SerialPortService::availableDevicesChanged,
             this, &LinkEditPresenter::updateDevices);
@@ -112,11 +114,13 @@ void LinkEditPresenter::save()
 void LinkEditPresenter::connectView(QObject* view)
 {
     view->setProperty(PROPERTY(statistics), QVariant::fromValue(m_statisticsModel));
+    view->setProperty(PROPERTY(traffic), QVariant::fromValue(m_trafficModel));
 }
 
 void LinkEditPresenter::updateStatistics(const dto::LinkStatisticsPtr& statistics)
 {
     m_statisticsModel->addData(statistics);
+    m_trafficModel->setTraffic(statistics->traffic());
 
     // don't call LinkPresenter's impl
 }
@@ -12,6 +12,7 @@ namespace domain
 namespace presentation
 {
     class LinkStatisticsModel;
+    class LinkTrafficModel;
 
     class LinkEditPresenter: public LinkPresenter
     {
@@ -36,6 +37,7 @@ namespace presentation
     private:
         domain::SerialPortService* const m_serialService;
         LinkStatisticsModel* const m_statisticsModel;
+        LinkTrafficModel* const m_trafficModel;
     };
 }
 
@@ -0,0 +1,77 @@
+#include "link_traffic_model.h"
+
+// Qt
+#include <QDebug>
+
+// Std
+#include <algorithm>
+
+using namespace presentation;
+
+LinkTrafficModel::LinkTrafficModel(QObject* parent):
+    QAbstractListModel(parent)
+{}
+
+int LinkTrafficModel::rowCount(const QModelIndex& parent) const
+{
+    Q_UNUSED(parent)
+
+    return m_rows.count();
+}
+
+QVariant LinkTrafficModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_rows.count()) return QVariant();
+
+    const Row& row = m_rows.at(index.row());
+
+    switch (role)
+    {
+    case IsSystemRole: return row.system;
+    case IdentifierRole: return row.id;
+    case PacketsRole: return row.counters.packets;
+    case BytesRole: return row.counters.bytes;
+    case ShareRole: return m_totalBytes > 0 ? row.counters.bytes * 100 / m_totalBytes : 0;
+    case GapsRole: return row.counters.gaps;
+    default: return QVariant();
+    }
+}
+
+void LinkTrafficModel::setTraffic(const dto::LinkTraffic& traffic)
+{
+    QList<Row> messages;
+    for (auto it = traffic.messages.begin(); it != traffic.messages.end(); ++it)
+    {
+        messages.append({ false, it.key(), it.value() });
+    }
+    std::sort(messages.begin(), messages.end(), [](const Row& left, const Row& right) {
+        return left.counters.bytes > right.counters.bytes;
+    });
+
+    this->beginResetModel();
+
+    m_rows.clear();
+    m_totalBytes = 0;
+    for (auto it = traffic.systems.begin(); it != traffic.systems.end(); ++it)
+    {
+        m_rows.append({ true, it.key(), it.value() });
+        m_totalBytes += it.value().bytes;
+    }
+    m_rows.append(messages);
+
+    this->endResetModel();
+}
+
+QHash<int, QByteArray> LinkTrafficModel::roleNames() const
+{
+    QHash<int, QByteArray> roles;
+
+    roles[IsSystemRole] = "isSystem";
+    roles[IdentifierRole] = "identifier";
+    roles[PacketsRole] = "packets";
+    roles[BytesRole] = "bytes";
+    roles[ShareRole] = "share";
+    roles[GapsRole] = "gaps";
+
+    return roles;
+}
@@ -0,0 +1,52 @@
+#ifndef LINK_TRAFFIC_MODEL_H
+#define LINK_TRAFFIC_MODEL_H
+
+// Qt
+#include <QAbstractListModel>
+
+// Internal
+#include "link_traffic.h"
+
+namespace presentation
+{
+    // Last second of link traffic: senders first, then messages by bytes taken
+    class LinkTrafficModel: public QAbstractListModel
+    {
+        Q_OBJECT
+
+    public:
+        enum LinkTrafficRoles
+        {
+            IsSystemRole = Qt::UserRole + 1,
+            IdentifierRole,
+            PacketsRole,
+            BytesRole,
+            ShareRole,
+            GapsRole
+        };
+
+        explicit LinkTrafficModel(QObject* parent = nullptr);
+
+        int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+        QVariant data(const QModelIndex& index, int role) const override;
+
+    public slots:
+        void setTraffic(const dto::LinkTraffic& traffic);
+
+    protected:
+        QHash<int, QByteArray> roleNames() const override;
+
+    private:
+        struct Row
+        {
+            bool system;
+            int id;
+            dto::TrafficCounters counters;
+        };
+
+        QList<Row> m_rows;
+        int m_totalBytes = 0;
+    };
+}
+
+#endif // LINK_TRAFFIC_MODEL_H
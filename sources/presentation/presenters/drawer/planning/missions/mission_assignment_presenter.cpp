@@ -9,6 +9,8 @@
 
 #include "service_registry.h"
 #include "mission_service.h"
+#include "mission_validation_service.h"
+#include "log_bus.h"
 
 using namespace presentation;
 
@@ -67,6 +69,13 @@ void MissionAssignmentPresenter::uploadMission()
     dto::MissionAssignmentPtr assignment = m_service->missionAssignment(m_missionId);
     if (assignment.isNull()) return;
 
+    if (serviceRegistry->missionValidationService()->hasErrors(m_missionId))
+    {
+        domain::LogBus::log(tr("Mission has errors, fix them before upload"),
+                            dto::LogMessage::Warning);
+        return;
+    }
+
     m_service->upload(assignment);
 }
 
@@ -3,24 +3,39 @@
 // Qt
 #include <QMap>
 #include <QVariant>
+#include <QSharedPointer>
+#include <QtMath>
 #include <QDebug>
 
 // Internal
 #include "service_registry.h"
 #include "mission_service.h"
+#include "mission_validation_service.h"
+#include "survey_planner.h"
 
 #include "mission.h"
 #include "mission_item.h"
 
 using namespace presentation;
 
+namespace
+{
+    const double surveySize = 200; // Side of default survey area, meters
+    const int minSurveyVertices = 3;
+}
+
 class MissionEditPresenter::Impl
 {
 public:
     domain::MissionService* const service = serviceRegistry->missionService();
+    domain::MissionValidationService* const validationService =
+            serviceRegistry->missionValidationService();
 
     dto::MissionPtr mission;
     dto::MissionItemPtr item;
+
+    // Planners are kept, so reapplying moves existing survey items instead of adding new
+    QMap<int, QSharedPointer<domain::SurveyPlanner> > surveys;
 };
 
 MissionEditPresenter::MissionEditPresenter(QObject* object):
@@ -31,6 +46,16 @@ MissionEditPresenter::MissionEditPresenter(QObject* object):
             [this](const dto::MissionPtr& mission) {
         if (mission == d->mission) this->updateMission();
     });
+
+    connect(d->service, &domain::MissionService::missionRemoved, this,
+            [this](const dto::MissionPtr& mission) {
+        d->surveys.remove(mission->id());
+    });
+
+    connect(d->validationService, &domain::MissionValidationService::issuesChanged, this,
+            [this](int missionId) {
+        if (d->mission && d->mission->id() == missionId) this->updateIssues();
+    });
 }
 
 MissionEditPresenter::~MissionEditPresenter()
@@ -41,6 +66,7 @@ void MissionEditPresenter::setMission(int id)
     d->mission = d->service->mission(id);
 
     this->updateMission();
+    this->updateSurvey();
 }
 
 void MissionEditPresenter::setItem(int id)
@@ -63,12 +89,65 @@ void MissionEditPresenter::updateMission()
 {
     this->setViewProperty(PROPERTY(count), d->mission ? d->mission->count() : 0);
     this->setViewProperty(PROPERTY(name), d->mission ? d->mission->name() : tr("None"));
+
+    this->updateIssues();
 }
 
 void MissionEditPresenter::updateItem()
 {
     this->setViewProperty(PROPERTY(selectedItemId), d->item ? d->item->id() : 0);
     this->setViewProperty(PROPERTY(sequence), d->item ? d->item->sequence() : -1);
+
+    this->updateIssues();
+}
+
+void MissionEditPresenter::updateIssues()
+{
+    QStringList issues;
+    bool errors = false;
+
+    // Whole mission issues and ones of selected item
+    if (d->mission)
+    {
+        for (const domain::MissionIssue& issue: d->validationService->issues(d->mission->id()))
+        {
+            if (issue.sequence != -1 && (d->item.isNull() ||
+                                         issue.sequence != d->item->sequence())) continue;
+
+            issues.append(issue.message);
+            if (issue.severity == domain::MissionIssue::Error) errors = true;
+        }
+    }
+
+    this->setViewProperty(PROPERTY(issues), issues.join("\n"));
+    this->setViewProperty(PROPERTY(issuesCritical), errors);
+}
+
+void MissionEditPresenter::updateSurvey()
+{
+    QSharedPointer<domain::SurveyPlanner> planner;
+    if (d->mission) planner = d->surveys.value(d->mission->id());
+
+    this->setViewProperty(PROPERTY(surveyActive), !planner.isNull());
+    if (planner.isNull()) return;
+
+    const domain::SurveyParameters& parameters = planner->parameters();
+    QVariantMap values;
+    values[PROPERTY(pattern)] = parameters.pattern;
+    values[PROPERTY(spacing)] = parameters.spacing;
+    values[PROPERTY(overlap)] = parameters.overlap * 100;
+    values[PROPERTY(heading)] = parameters.heading;
+    values[PROPERTY(turnaround)] = parameters.turnaround;
+    values[PROPERTY(altitude)] = parameters.altitude;
+    values[PROPERTY(altitudeRelative)] = parameters.altitudeRelative;
+
+    QVariantList area;
+    for (const QGeoCoordinate& coordinate: planner->area().boundary)
+    {
+        area.append(QVariant::fromValue(coordinate));
+    }
+
+    this->invokeViewMethod(PROPERTY(setSurvey), values, area);
 }
 
 void MissionEditPresenter::removeItem()
@@ -105,6 +184,61 @@ void MissionEditPresenter::addItem(dto::MissionItem::Command command,
     this->updateItem();
 }
 
+void MissionEditPresenter::addSurvey(const QGeoCoordinate& center)
+{
+    if (d->mission.isNull() || !center.isValid()) return;
+
+    QSharedPointer<domain::SurveyPlanner>& planner = d->surveys[d->mission->id()];
+    if (planner.isNull()) planner.reset(new domain::SurveyPlanner(d->service, d->mission->id()));
+
+    domain::SurveyArea area;
+    double halfDiagonal = ::surveySize / M_SQRT2;
+    for (double azimuth: { 45.0, 135.0, 225.0, 315.0 })
+    {
+        area.boundary.append(center.atDistanceAndAzimuth(halfDiagonal, azimuth));
+    }
+    planner->setArea(area);
+
+    bool applied = planner->apply();
+    this->updateSurvey();
+    if (!applied || planner->items().isEmpty()) return;
+
+    d->item = planner->items().first();
+    this->updateItem();
+}
+
+void MissionEditPresenter::applySurvey(const QVariantMap& values, const QVariantList& area)
+{
+    if (d->mission.isNull()) return;
+
+    QSharedPointer<domain::SurveyPlanner> planner = d->surveys.value(d->mission->id());
+    if (planner.isNull()) return;
+
+    domain::SurveyArea surveyArea = planner->area();
+    surveyArea.boundary.clear();
+    for (const QVariant& vertex: area)
+    {
+        QGeoCoordinate coordinate = vertex.value<QGeoCoordinate>();
+        if (coordinate.isValid()) surveyArea.boundary.append(coordinate);
+    }
+    if (surveyArea.boundary.count() < ::minSurveyVertices) return;
+
+    domain::SurveyParameters parameters = planner->parameters();
+    parameters.pattern = static_cast<domain::SurveyParameters::Pattern>(
+                             values.value(PROPERTY(pattern), parameters.pattern).toInt());
+    parameters.spacing = values.value(PROPERTY(spacing), parameters.spacing).toDouble();
+    parameters.overlap = values.value(PROPERTY(overlap), parameters.overlap * 100).toDouble() / 100;
+    parameters.heading = values.value(PROPERTY(heading), parameters.heading).toDouble();
+    parameters.turnaround = values.value(PROPERTY(turnaround), parameters.turnaround).toDouble();
+    parameters.altitude = values.value(PROPERTY(altitude), parameters.altitude).toFloat();
+    parameters.altitudeRelative = values.value(PROPERTY(altitudeRelative),
+                                               parameters.altitudeRelative).toBool();
+
+    planner->setArea(surveyArea);
+    planner->setParameters(parameters);
+    planner->apply();
+}
+
 void MissionEditPresenter::changeSequence(int sequence)
 {
     if (d->item.isNull()) return;
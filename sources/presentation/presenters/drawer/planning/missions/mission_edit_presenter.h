@@ -1,6 +1,9 @@
 #ifndef MISSION_EDIT_PRESENTER_H
 #define MISSION_EDIT_PRESENTER_H
 
+// Qt
+#include <QVariant>
+
 // Internal
 #include "base_presenter.h"
 #include "dto_traits.h"
@@ -23,9 +26,15 @@ namespace presentation
 
         void updateMission();
         void updateItem();
+        void updateIssues();
+        void updateSurvey();
 
         void removeItem();
         void addItem(dto::MissionItem::Command command, const QGeoCoordinate& coordinate);
+        // Lays survey over square area around center, or moves survey of mission there
+        void addSurvey(const QGeoCoordinate& center);
+        // Regenerates survey of mission with parameters and boundary edited in view
+        void applySurvey(const QVariantMap& parameters, const QVariantList& area);
         void changeSequence(int sequence);
 
     private:
@@ -54,6 +54,9 @@ MissionItemEditPresenter::MissionItemEditPresenter(QObject* object):
 {
     connect(d->service, &domain::MissionService::missionItemChanged, this,
             [this](dto::MissionItemPtr item) { if (item == d->item) this->updateItem(); });
+    connect(d->service, &domain::MissionService::missionItemsChanged, this, [this](int missionId) {
+        if (d->item && d->item->missionId() == missionId) this->updateItem();
+    });
 }
 
 MissionItemEditPresenter::~MissionItemEditPresenter()
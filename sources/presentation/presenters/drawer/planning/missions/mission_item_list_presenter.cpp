@@ -30,6 +30,10 @@ MissionItemListPresenter::MissionItemListPresenter(QObject* parent):
             [this](dto::MissionItemPtr item) {
         if (item->missionId() == m_missionId) this->updateMissionItems();
     });
+    connect(m_service, &domain::MissionService::missionItemsChanged, this,
+            [this](int missionId) {
+        if (missionId == m_missionId) this->updateMissionItems();
+    });
 }
 
 void MissionItemListPresenter::setMission(int id)
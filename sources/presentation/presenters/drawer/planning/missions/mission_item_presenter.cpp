@@ -9,23 +9,34 @@
 
 #include "service_registry.h"
 #include "mission_service.h"
+#include "mission_validation_service.h"
 
 using namespace presentation;
 
 MissionItemPresenter::MissionItemPresenter(QObject* parent):
     BasePresenter(parent),
-    m_service(serviceRegistry->missionService())
+    m_service(serviceRegistry->missionService()),
+    m_validationService(serviceRegistry->missionValidationService())
 {
     connect(m_service, &domain::MissionService::missionItemChanged, this,
             [this](const dto::MissionItemPtr& item) {
         if (m_item && m_item == item) this->updateItem();
     });
+    connect(m_service, &domain::MissionService::missionItemsChanged, this,
+            [this](int missionId) {
+        if (m_item && m_item->missionId() == missionId) this->updateItem();
+    });
 
     connect(m_service, &domain::MissionService::currentItemChanged, this,
             [this](int vehicleId, const dto::MissionItemPtr& old, const dto::MissionItemPtr& item) {
         Q_UNUSED(vehicleId)
         if (m_item && (m_item == old || m_item == item)) this->updateItem();
     });
+
+    connect(m_validationService, &domain::MissionValidationService::issuesChanged, this,
+            [this](int missionId) {
+        if (m_item && m_item->missionId() == missionId) this->updateItem();
+    });
 }
 
 void MissionItemPresenter::setItem(int id)
@@ -43,4 +54,15 @@ void MissionItemPresenter::updateItem()
     this->setViewProperty(PROPERTY(sequence), m_item ? m_item->sequence() : -1);
     this->setViewProperty(PROPERTY(status), m_item ? m_item->status() : false);
     this->setViewProperty(PROPERTY(command), m_item ? m_item->command() : false);
+
+    int issueSeverity = -1;
+    if (m_item)
+    {
+        for (const domain::MissionIssue& issue: m_validationService->itemIssues(
+                 m_item->missionId(), m_item->sequence()))
+        {
+            issueSeverity = qMax(issueSeverity, int(issue.severity));
+        }
+    }
+    this->setViewProperty(PROPERTY(issueSeverity), issueSeverity);
 }
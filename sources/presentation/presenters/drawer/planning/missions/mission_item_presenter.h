@@ -8,6 +8,7 @@
 namespace domain
 {
     class MissionService;
+    class MissionValidationService;
 }
 
 namespace presentation
@@ -25,6 +26,7 @@ namespace presentation
 
     private:
         domain::MissionService* const m_service;
+        domain::MissionValidationService* const m_validationService;
         dto::MissionItemPtr m_item;
     };
 }
@@ -2,6 +2,7 @@
 
 // Qt
 #include <QVariant>
+#include <QUrl>
 #include <QDebug>
 
 // Internal
@@ -9,6 +10,8 @@
 
 #include "service_registry.h"
 #include "mission_service.h"
+#include "mission_importer.h"
+#include "log_bus.h"
 
 #include "mission_list_model.h"
 #include "mission_list_filter_model.h"
@@ -47,6 +50,23 @@ void MissionListPresenter::addMission()
     d->service->addNewMission(tr("New Mission"));
 }
 
+void MissionListPresenter::importMission(const QUrl& fileUrl)
+{
+    domain::MissionImporter importer(d->service);
+    dto::MissionPtr mission = importer.import(fileUrl.toLocalFile());
+
+    if (mission)
+    {
+        domain::LogBus::log(tr("Mission \"%1\" imported").arg(mission->name()),
+                            dto::LogMessage::Positive);
+    }
+    else
+    {
+        domain::LogBus::log(tr("Mission import failed: %1").arg(importer.errorString()),
+                            dto::LogMessage::Warning);
+    }
+}
+
 void MissionListPresenter::connectView(QObject* view)
 {
     Q_UNUSED(view)
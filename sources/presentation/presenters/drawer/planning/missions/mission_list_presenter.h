@@ -21,6 +21,7 @@ namespace presentation
 
     public slots:
         void addMission();
+        void importMission(const QUrl& fileUrl);
 
     protected:
         void connectView(QObject* view);
@@ -2,6 +2,7 @@
 
 // Qt
 #include <QVariant>
+#include <QUrl>
 #include <QDebug>
 
 // Internal
@@ -11,6 +12,8 @@
 
 #include "service_registry.h"
 #include "mission_service.h"
+#include "mission_exporter.h"
+#include "log_bus.h"
 
 using namespace presentation;
 
@@ -56,6 +59,24 @@ void MissionPresenter::remove()
     m_service->remove(m_service->mission(m_missionId));
 }
 
+void MissionPresenter::exportMission(const QUrl& fileUrl)
+{
+    dto::MissionPtr mission = m_service->mission(m_missionId);
+    if (mission.isNull()) return;
+
+    domain::MissionExporter exporter(m_service);
+    if (exporter.exportMission(mission, fileUrl.toLocalFile()))
+    {
+        domain::LogBus::log(tr("Mission \"%1\" exported").arg(mission->name()),
+                            dto::LogMessage::Positive);
+    }
+    else
+    {
+        domain::LogBus::log(tr("Mission export failed: %1").arg(exporter.errorString()),
+                            dto::LogMessage::Warning);
+    }
+}
+
 void MissionPresenter::connectView(QObject* view)
 {
     Q_UNUSED(view)
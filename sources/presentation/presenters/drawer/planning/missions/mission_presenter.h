@@ -25,6 +25,7 @@ namespace presentation
         void rename(const QString& name);
         void setMissionVisible(bool visible);
         void remove();
+        void exportMission(const QUrl& fileUrl);
 
     protected:
         void connectView(QObject* view);
@@ -0,0 +1,103 @@
+#include "onboard_logs_presenter.h"
+
+// Qt
+#include <QVariant>
+#include <QDir>
+#include <QStandardPaths>
+#include <QDebug>
+
+// Internal
+#include "service_registry.h"
+#include "onboard_log_service.h"
+
+using namespace presentation;
+
+namespace
+{
+    QString logFileName(int vehicleId, int logId)
+    {
+        QDir dir(QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation));
+        dir.mkpath("JAGCS/logs");
+        return dir.filePath(QString("JAGCS/logs/vehicle%1_log%2.bin").arg(vehicleId).arg(logId));
+    }
+}
+
+OnboardLogsPresenter::OnboardLogsPresenter(QObject* parent):
+    BasePresenter(parent),
+    m_service(serviceRegistry->onboardLogService())
+{
+    connect(m_service, &domain::OnboardLogService::logsChanged, this, [this](int vehicleId) {
+        if (vehicleId == m_vehicleId) this->updateLogs();
+    });
+    connect(m_service, &domain::OnboardLogService::downloadProgress, this,
+            [this](int vehicleId, int logId, quint32 received, quint32 size) {
+        if (vehicleId != m_vehicleId || logId != m_downloadingLogId) return;
+
+        this->setViewProperty(PROPERTY(progress), size ? qreal(received) / size : 0);
+    });
+    connect(m_service, &domain::OnboardLogService::downloadFinished, this,
+            [this](int vehicleId, int logId, bool success) {
+        if (vehicleId != m_vehicleId || logId != m_downloadingLogId) return;
+
+        m_downloadingLogId = 0;
+        this->setViewProperty(PROPERTY(downloadingLogId), 0);
+        this->setViewProperty(PROPERTY(status), success ?
+                                  tr("Saved to %1").arg(::logFileName(vehicleId, logId)) :
+                                  tr("Download failed"));
+    });
+}
+
+void OnboardLogsPresenter::setVehicle(int vehicleId)
+{
+    m_vehicleId = vehicleId;
+    m_downloadingLogId = 0;
+
+    this->setViewProperty(PROPERTY(downloadingLogId), 0);
+    this->setViewProperty(PROPERTY(status), QString());
+    this->updateLogs();
+}
+
+void OnboardLogsPresenter::updateLogs()
+{
+    QVariantList logs;
+    for (const domain::OnboardLog& log: m_service->logs(m_vehicleId))
+    {
+        QVariantMap entry;
+        entry[PROPERTY(id)] = log.id;
+        entry[PROPERTY(size)] = log.size;
+        entry[PROPERTY(time)] = log.time.isValid() ? log.time.toString(Qt::SystemLocaleShortDate) :
+                                                     QString();
+        logs.append(entry);
+    }
+
+    this->setViewProperty(PROPERTY(logs), logs);
+}
+
+void OnboardLogsPresenter::requestList()
+{
+    if (m_vehicleId < 1) return;
+
+    m_service->requestList(m_vehicleId);
+}
+
+void OnboardLogsPresenter::download(int logId)
+{
+    if (m_vehicleId < 1) return;
+
+    m_downloadingLogId = logId;
+    this->setViewProperty(PROPERTY(downloadingLogId), logId);
+    this->setViewProperty(PROPERTY(progress), 0);
+    this->setViewProperty(PROPERTY(status), QString());
+
+    m_service->download(m_vehicleId, logId, ::logFileName(m_vehicleId, logId));
+}
+
+void OnboardLogsPresenter::cancelDownload()
+{
+    if (m_vehicleId < 1 || !m_downloadingLogId) return;
+
+    m_service->cancelDownload(m_vehicleId);
+
+    m_downloadingLogId = 0;
+    this->setViewProperty(PROPERTY(downloadingLogId), 0);
+}
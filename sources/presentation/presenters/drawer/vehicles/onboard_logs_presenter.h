@@ -0,0 +1,37 @@
+#ifndef ONBOARD_LOGS_PRESENTER_H
+#define ONBOARD_LOGS_PRESENTER_H
+
+// Internal
+#include "base_presenter.h"
+
+namespace domain
+{
+    class OnboardLogService;
+}
+
+namespace presentation
+{
+    // Logs stored on vehicle, downloaded into documents folder
+    class OnboardLogsPresenter: public BasePresenter
+    {
+        Q_OBJECT
+
+    public:
+        explicit OnboardLogsPresenter(QObject* parent = nullptr);
+
+    public slots:
+        void setVehicle(int vehicleId);
+        void updateLogs();
+
+        void requestList();
+        void download(int logId);
+        void cancelDownload();
+
+    private:
+        domain::OnboardLogService* const m_service;
+        int m_vehicleId = 0;
+        int m_downloadingLogId = 0;
+    };
+}
+
+#endif // ONBOARD_LOGS_PRESENTER_H
@@ -0,0 +1,132 @@
+#include "remote_files_presenter.h"
+
+// Qt
+#include <QVariant>
+#include <QDir>
+#include <QStandardPaths>
+#include <QDebug>
+
+// Internal
+#include "service_registry.h"
+#include "file_transfer_service.h"
+
+using namespace presentation;
+
+namespace
+{
+    const QString rootPath = "/";
+
+    QString joinPath(const QString& path, const QString& name)
+    {
+        return path.endsWith('/') ? path + name : path + '/' + name;
+    }
+
+    QString localFileName(int vehicleId, const QString& name)
+    {
+        QDir dir(QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation));
+        QString subdir = QString("JAGCS/files/vehicle%1").arg(vehicleId);
+        dir.mkpath(subdir);
+        return dir.filePath(subdir + "/" + name);
+    }
+}
+
+RemoteFilesPresenter::RemoteFilesPresenter(QObject* parent):
+    BasePresenter(parent),
+    m_service(serviceRegistry->fileTransferService()),
+    m_path(::rootPath)
+{
+    connect(m_service, &domain::FileTransferService::directoryListed, this,
+            [this](int vehicleId, const QString& path, const domain::RemoteFileList& files,
+                   bool success) {
+        if (vehicleId != m_vehicleId || path != m_path) return;
+
+        QVariantList entries;
+        for (const domain::RemoteFile& file: files)
+        {
+            QVariantMap entry;
+            entry[PROPERTY(name)] = file.name;
+            entry[PROPERTY(directory)] = file.directory;
+            entry[PROPERTY(size)] = file.size;
+            entries.append(entry);
+        }
+
+        this->setViewProperty(PROPERTY(files), entries);
+        this->setViewProperty(PROPERTY(listing), false);
+        this->setViewProperty(PROPERTY(status), success ? QString() : tr("Listing failed"));
+    });
+    connect(m_service, &domain::FileTransferService::transferProgress, this,
+            [this](int vehicleId, const QString& path, quint32 received, quint32 size,
+                   int bytesPerSecond) {
+        if (vehicleId != m_vehicleId || path != m_transferPath) return;
+
+        this->setViewProperty(PROPERTY(progress), size ? qreal(received) / size : 0);
+        this->setViewProperty(PROPERTY(status), tr("%1 KiB/s").arg(bytesPerSecond / 1024));
+    });
+    connect(m_service, &domain::FileTransferService::transferFinished, this,
+            [this](int vehicleId, const QString& path, bool success, const QString& error) {
+        if (vehicleId != m_vehicleId || path != m_transferPath) return;
+
+        m_transferPath.clear();
+        this->setViewProperty(PROPERTY(transferring), false);
+        this->setViewProperty(PROPERTY(status), success ? tr("Downloaded %1").arg(path) :
+                                                          tr("Download failed: %1").arg(error));
+    });
+}
+
+void RemoteFilesPresenter::setVehicle(int vehicleId)
+{
+    m_vehicleId = vehicleId;
+    m_transferPath.clear();
+
+    this->setViewProperty(PROPERTY(transferring), false);
+    this->setViewProperty(PROPERTY(status), QString());
+    this->setViewProperty(PROPERTY(files), QVariantList());
+    this->setViewProperty(PROPERTY(path), ::rootPath);
+    m_path = ::rootPath;
+}
+
+void RemoteFilesPresenter::listDirectory(const QString& path)
+{
+    if (m_vehicleId < 1) return;
+
+    m_path = path.isEmpty() ? ::rootPath : path;
+    this->setViewProperty(PROPERTY(path), m_path);
+    this->setViewProperty(PROPERTY(files), QVariantList());
+    this->setViewProperty(PROPERTY(listing), true);
+
+    m_service->listDirectory(m_vehicleId, m_path);
+}
+
+void RemoteFilesPresenter::enter(const QString& name)
+{
+    this->listDirectory(::joinPath(m_path, name));
+}
+
+void RemoteFilesPresenter::up()
+{
+    int slash = m_path.lastIndexOf('/', m_path.endsWith('/') ? -2 : -1);
+    this->listDirectory(slash > 0 ? m_path.left(slash) : ::rootPath);
+}
+
+void RemoteFilesPresenter::download(const QString& name)
+{
+    if (m_vehicleId < 1 || !m_transferPath.isEmpty()) return;
+
+    m_transferPath = ::joinPath(m_path, name);
+    this->setViewProperty(PROPERTY(transferring), true);
+    this->setViewProperty(PROPERTY(progress), 0);
+    this->setViewProperty(PROPERTY(status), QString());
+
+    m_service->download(m_vehicleId, m_transferPath, ::localFileName(m_vehicleId, name));
+}
+
+void RemoteFilesPresenter::cancel()
+{
+    if (m_vehicleId < 1) return;
+
+    m_service->cancel(m_vehicleId);
+
+    m_transferPath.clear();
+    this->setViewProperty(PROPERTY(transferring), false);
+    this->setViewProperty(PROPERTY(listing), false);
+}
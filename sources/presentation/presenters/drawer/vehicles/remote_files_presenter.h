@@ -0,0 +1,40 @@
+#ifndef REMOTE_FILES_PRESENTER_H
+#define REMOTE_FILES_PRESENTER_H
+
+// Internal
+#include "base_presenter.h"
+
+namespace domain
+{
+    class FileTransferService;
+}
+
+namespace presentation
+{
+    // Browses vehicle file system over MAVLink FTP, files go into documents folder
+    class RemoteFilesPresenter: public BasePresenter
+    {
+        Q_OBJECT
+
+    public:
+        explicit RemoteFilesPresenter(QObject* parent = nullptr);
+
+    public slots:
+        void setVehicle(int vehicleId);
+
+        void listDirectory(const QString& path);
+        void enter(const QString& name);
+        void up();
+
+        void download(const QString& name);
+        void cancel();
+
+    private:
+        domain::FileTransferService* const m_service;
+        int m_vehicleId = 0;
+        QString m_path;
+        QString m_transferPath;
+    };
+}
+
+#endif // REMOTE_FILES_PRESENTER_H
@@ -2,6 +2,7 @@
 
 // Qt
 #include <QVariant>
+#include <QGeoRectangle>
 #include <QDebug>
 
 // Internal
@@ -9,6 +10,7 @@
 #include "mission_item.h"
 
 #include "mission_point_map_item_model.h"
+#include "mission_point_map_filter_model.h"
 #include "mission_line_map_item_model.h"
 #include "vehicle_map_item_model.h"
 
@@ -18,12 +20,15 @@ class LocationMapPresenter::Impl
 {
 public:
     MissionPointMapItemModel pointModel;
+    MissionPointMapFilterModel pointFilterModel;
     MissionLineMapItemModel lineModel;
     VehicleMapItemModel vehicleModel;
 
     Impl():
         pointModel(serviceRegistry->missionService()),
-        lineModel(serviceRegistry->missionService()),
+        pointFilterModel(&pointModel),
+        lineModel(serviceRegistry->missionService(),
+                  serviceRegistry->missionGeometryService()),
         vehicleModel(serviceRegistry->vehicleService(),
                      serviceRegistry->telemetryService())
     {}
@@ -65,11 +70,33 @@ void LocationMapPresenter::setZoomLevel(float zoomLevel)
     this->setViewProperty(PROPERTY(zoomLevel), zoomLevel);
 }
 
+void LocationMapPresenter::setViewport(const QVariantList& corners)
+{
+    QList<QGeoCoordinate> coordinates;
+    for (const QVariant& corner: corners)
+    {
+        QGeoCoordinate coordinate = corner.value<QGeoCoordinate>();
+        if (!coordinate.isValid()) // Horizon is visible on tilted map, viewport is unbounded
+        {
+            d->pointFilterModel.setViewport(QGeoRectangle());
+            return;
+        }
+        coordinates.append(coordinate);
+    }
+
+    d->pointFilterModel.setViewport(QGeoRectangle(coordinates));
+}
+
+void LocationMapPresenter::setSelectedItem(int itemId)
+{
+    d->pointFilterModel.setPinnedItem(itemId);
+}
+
 void LocationMapPresenter::connectView(QObject* view)
 {
     Q_UNUSED(view)
 
-    this->setViewProperty(PROPERTY(pointModel), QVariant::fromValue(&d->pointModel));
+    this->setViewProperty(PROPERTY(pointModel), QVariant::fromValue(&d->pointFilterModel));
     this->setViewProperty(PROPERTY(lineModel), QVariant::fromValue(&d->lineModel));
     this->setViewProperty(PROPERTY(vehicleModel), QVariant::fromValue(&d->vehicleModel));
 }
@@ -22,6 +22,9 @@ namespace presentation
         void setMapCenter(double latitude, double longitude) override;
         void setZoomLevel(float zoomLevel) override;
 
+        void setViewport(const QVariantList& corners);
+        void setSelectedItem(int itemId);
+
     protected:
         void connectView(QObject* view) override;
 
@@ -11,14 +11,18 @@
 #include "mission_item.h"
 
 #include "mission_service.h"
+#include "mission_geometry_service.h"
+#include "mission_geometry.h"
 #include "mission_assignment.h"
 
 using namespace presentation;
 
 MissionLineMapItemModel::MissionLineMapItemModel(domain::MissionService* service,
+                                                 domain::MissionGeometryService* geometryService,
                                                  QObject* parent):
     QAbstractListModel(parent),
-    m_service(service)
+    m_service(service),
+    m_geometryService(geometryService)
 {
     connect(service, &domain::MissionService::missionAdded,
             this, &MissionLineMapItemModel::onMissionAdded);
@@ -34,12 +38,8 @@ MissionLineMapItemModel::MissionLineMapItemModel(domain::MissionService* service
     connect(service, &domain::MissionService::assignmentChanged,
             this, &MissionLineMapItemModel::onAssignmentChanged);
 
-    connect(service, &domain::MissionService::missionItemChanged,
-            this, &MissionLineMapItemModel::onMissionItemChanged);
-    connect(service, &domain::MissionService::missionItemAdded,
-            this, &MissionLineMapItemModel::onMissionItemChanged);
-    connect(service, &domain::MissionService::missionItemRemoved,
-            this, &MissionLineMapItemModel::onMissionItemChanged);
+    connect(geometryService, &domain::MissionGeometryService::geometryChanged,
+            this, &MissionLineMapItemModel::onGeometryChanged);
 
     for (const dto::MissionPtr& item: service->missions())
     {
@@ -70,21 +70,7 @@ QVariant MissionLineMapItemModel::data(const QModelIndex& index, int role) const
             return line;
         }
 
-        for (const dto::MissionItemPtr& item: m_service->missionItems(mission->id()))
-        {
-            if (item->isPositionatedItem())
-            {
-                if (item->coordinate().isValid())
-                {
-                    line.append(QVariant::fromValue(item->coordinate()));
-                }
-            }
-            else if (item->command() == dto::MissionItem::Return && !line.isEmpty())
-            {
-                line.append(line[0]); // Return to home line
-            }
-        }
-        return line;
+        return m_geometryService->geometry(mission->id())->path();
     }
     case MissionStatusRole:
     {
@@ -100,6 +86,8 @@ QVariant MissionLineMapItemModel::data(const QModelIndex& index, int role) const
 
 void MissionLineMapItemModel::onMissionAdded(const dto::MissionPtr& mission)
 {
+    m_geometryService->geometry(mission->id()); // Start tracking mission path
+
     this->beginInsertRows(QModelIndex(), this->rowCount(), this->rowCount());
     m_missions.append(mission);
     this->endInsertRows();
@@ -132,10 +120,9 @@ void MissionLineMapItemModel::onAssignmentChanged(const dto::MissionAssignmentPt
     }
 }
 
-void MissionLineMapItemModel::onMissionItemChanged(const dto::MissionItemPtr& item)
+void MissionLineMapItemModel::onGeometryChanged(int missionId)
 {
-    dto::MissionPtr mission = m_service->mission(item->missionId());
-    QModelIndex index = this->index(m_missions.indexOf(mission));
+    QModelIndex index = this->index(m_missions.indexOf(m_service->mission(missionId)));
     if (index.isValid()) emit dataChanged(index, index, { MissionPathRole });
 }
 
@@ -10,6 +10,7 @@
 namespace domain
 {
     class MissionService;
+    class MissionGeometryService;
 }
 
 namespace presentation
@@ -25,8 +26,9 @@ namespace presentation
             MissionStatusRole
         };
 
-        explicit MissionLineMapItemModel(domain::MissionService* service,
-                                         QObject* parent = nullptr);
+        MissionLineMapItemModel(domain::MissionService* service,
+                                domain::MissionGeometryService* geometryService,
+                                QObject* parent = nullptr);
 
         int rowCount(const QModelIndex& parent = QModelIndex()) const override;
         QVariant data(const QModelIndex& index, int role) const override;
@@ -36,7 +38,7 @@ namespace presentation
         void onMissionRemoved(const dto::MissionPtr& mission);
         void onMissionChanged(const dto::MissionPtr& mission);
         void onAssignmentChanged(const dto::MissionAssignmentPtr& assignment);
-        void onMissionItemChanged(const dto::MissionItemPtr& item);
+        void onGeometryChanged(int missionId);
 
     protected:
         QHash<int, QByteArray> roleNames() const override;
@@ -45,6 +47,7 @@ namespace presentation
 
     private:
         domain::MissionService* m_service;
+        domain::MissionGeometryService* m_geometryService;
         dto::MissionPtrList m_missions;
     };
 }
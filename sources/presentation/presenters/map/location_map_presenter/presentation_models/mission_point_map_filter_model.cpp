@@ -0,0 +1,115 @@
+#include "mission_point_map_filter_model.h"
+
+// Qt
+#include <QDebug>
+
+// Internal
+#include "mission_item.h"
+
+#include "mission_point_map_item_model.h"
+
+using namespace presentation;
+
+namespace
+{
+    const double viewportMargin = 0.25; // Of viewport size on each side, to avoid pop-in on panning
+    const int maxVisiblePoints = 512;
+    const int thinningGrid = 24;
+}
+
+MissionPointMapFilterModel::MissionPointMapFilterModel(MissionPointMapItemModel* source,
+                                                       QObject* parent):
+    QSortFilterProxyModel(parent),
+    m_source(source)
+{
+    // Connected before the proxy's own handlers, so sets are marked stale before refiltering
+    connect(source, &QAbstractItemModel::rowsInserted,
+            this, &MissionPointMapFilterModel::onSourceChanged);
+    connect(source, &QAbstractItemModel::rowsRemoved,
+            this, &MissionPointMapFilterModel::onSourceChanged);
+    connect(source, &QAbstractItemModel::dataChanged,
+            this, &MissionPointMapFilterModel::onSourceChanged);
+    connect(source, &QAbstractItemModel::modelReset,
+            this, &MissionPointMapFilterModel::onSourceChanged);
+
+    this->setSourceModel(source);
+    this->setDynamicSortFilter(true);
+}
+
+void MissionPointMapFilterModel::setViewport(const QGeoRectangle& viewport)
+{
+    m_viewport = viewport;
+
+    if (m_viewport.isValid())
+    {
+        m_viewport.setWidth(qMin(360.0, viewport.width() * (1 + 2 * ::viewportMargin)));
+        m_viewport.setHeight(qMin(180.0, viewport.height() * (1 + 2 * ::viewportMargin)));
+    }
+
+    this->updateAccepted();
+    this->invalidateFilter();
+}
+
+void MissionPointMapFilterModel::setPinnedItem(int itemId)
+{
+    if (m_pinnedItemId == itemId) return;
+
+    m_pinnedItemId = itemId;
+    this->invalidateFilter();
+}
+
+bool MissionPointMapFilterModel::filterAcceptsRow(int sourceRow,
+                                                  const QModelIndex& sourceParent) const
+{
+    Q_UNUSED(sourceParent)
+
+    if (!m_source->isItemVisible(sourceRow)) return false;
+
+    dto::MissionItemPtr item = m_source->item(sourceRow);
+    if (item->id() == m_pinnedItemId || !m_viewport.isValid()) return true;
+
+    if (m_stale) this->updateAccepted();
+    if (!m_inViewport.contains(item->id())) return false;
+
+    return !m_thinnedOut.contains(item->id()) ||
+            m_source->data(m_source->index(sourceRow),
+                           MissionPointMapItemModel::ItemCurrent).toBool();
+}
+
+void MissionPointMapFilterModel::updateAccepted() const
+{
+    m_stale = false;
+    m_inViewport.clear();
+    m_thinnedOut.clear();
+    if (!m_viewport.isValid()) return;
+
+    // Index holds only points of visible missions
+    const utils::GeoQuadTree& index = m_source->spatialIndex();
+    QList<int> ids = index.query(m_viewport);
+    m_inViewport = ids.toSet();
+    if (ids.count() <= ::maxVisiblePoints) return;
+
+    double left = m_viewport.topLeft().longitude();
+    double bottom = m_viewport.bottomLeft().latitude();
+    double cellWidth = m_viewport.width() / ::thinningGrid;
+    double cellHeight = m_viewport.height() / ::thinningGrid;
+
+    QSet<int> cells;
+    for (int id: ids)
+    {
+        QGeoCoordinate coordinate = index.coordinate(id);
+        double longitude = coordinate.longitude() - left;
+        if (longitude < 0) longitude += 360;
+
+        int cell = int(longitude / cellWidth) * (::thinningGrid + 1) +
+                   int((coordinate.latitude() - bottom) / cellHeight);
+        if (cells.contains(cell)) m_thinnedOut.insert(id);
+        else cells.insert(cell);
+    }
+}
+
+void MissionPointMapFilterModel::onSourceChanged()
+{
+    // Recounted lazily on next filtering, once per batch of source changes
+    m_stale = true;
+}
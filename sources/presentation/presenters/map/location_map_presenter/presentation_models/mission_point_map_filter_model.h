@@ -0,0 +1,44 @@
+#ifndef MISSION_POINT_MAP_FILTER_MODEL_H
+#define MISSION_POINT_MAP_FILTER_MODEL_H
+
+// Qt
+#include <QSortFilterProxyModel>
+#include <QGeoRectangle>
+#include <QSet>
+
+namespace presentation
+{
+    class MissionPointMapItemModel;
+
+    // Passes only visible points inside map viewport, dense point clouds are
+    // thinned out to one point per viewport grid cell on low zoom levels
+    class MissionPointMapFilterModel: public QSortFilterProxyModel
+    {
+        Q_OBJECT
+
+    public:
+        explicit MissionPointMapFilterModel(MissionPointMapItemModel* source,
+                                            QObject* parent = nullptr);
+
+    public slots:
+        void setViewport(const QGeoRectangle& viewport);
+        void setPinnedItem(int itemId);
+
+    protected:
+        bool filterAcceptsRow(int sourceRow, const QModelIndex& sourceParent) const override;
+        void updateAccepted() const;
+
+    private slots:
+        void onSourceChanged();
+
+    private:
+        MissionPointMapItemModel* m_source;
+        QGeoRectangle m_viewport;
+        mutable QSet<int> m_inViewport;
+        mutable QSet<int> m_thinnedOut;
+        mutable bool m_stale = false;
+        int m_pinnedItemId = 0;
+    };
+}
+
+#endif // MISSION_POINT_MAP_FILTER_MODEL_H
@@ -13,6 +13,14 @@
 
 using namespace presentation;
 
+namespace
+{
+    QGeoCoordinate itemCoordinate(const dto::MissionItemPtr& item)
+    {
+        return item->isPositionatedItem() ? item->coordinate() : QGeoCoordinate();
+    }
+}
+
 MissionPointMapItemModel::MissionPointMapItemModel(domain::MissionService* service, QObject* parent):
     QAbstractListModel(parent),
     m_service(service)
@@ -23,6 +31,8 @@ MissionPointMapItemModel::MissionPointMapItemModel(domain::MissionService* servi
             this, &MissionPointMapItemModel::onMissionItemRemoved);
     connect(service, &domain::MissionService::missionItemChanged,
             this, &MissionPointMapItemModel::onMissionItemChanged);
+    connect(service, &domain::MissionService::missionItemsChanged,
+            this, &MissionPointMapItemModel::onMissionItemsChanged);
     connect(service, &domain::MissionService::currentItemChanged,
             this, &MissionPointMapItemModel::onCurrentItemChanged);
     connect(service, &domain::MissionService::missionChanged,
@@ -52,20 +62,9 @@ QVariant MissionPointMapItemModel::data(const QModelIndex& index, int role) cons
     case ItemRole:
         return QVariant::fromValue(*item.data());
     case ItemCoordinateRole:
-    {
-        if (item->isPositionatedItem())
-        {
-            if (item->coordinate().isValid()) return QVariant::fromValue(item->coordinate());
-        }
-        return QVariant::fromValue(QGeoCoordinate());
-    }
+        return QVariant::fromValue(::itemCoordinate(item));
     case ItemVisibleRole:
-    {
-        return settings::Provider::value(settings::mission::mission +
-                                         QString::number(item->missionId()) + "/" +
-                                         settings::visibility).toBool()
-                && (item->isPositionatedItem());
-    }
+        return this->isItemVisible(index.row());
     case ItemAcceptanceRadius:
     {
         if (item->command() == dto::MissionItem::Waypoint)
@@ -90,8 +89,30 @@ QVariant MissionPointMapItemModel::data(const QModelIndex& index, int role) cons
     }
 }
 
+dto::MissionItemPtr MissionPointMapItemModel::item(int row) const
+{
+    return m_items.value(row);
+}
+
+bool MissionPointMapItemModel::isItemVisible(int row) const
+{
+    const dto::MissionItemPtr& item = m_items.at(row);
+    return item->isPositionatedItem() && m_missionVisibility.value(item->missionId());
+}
+
+const utils::GeoQuadTree& MissionPointMapItemModel::spatialIndex() const
+{
+    return m_spatialIndex;
+}
+
 void MissionPointMapItemModel::onMissionItemAdded(const dto::MissionItemPtr& item)
 {
+    if (!m_missionVisibility.contains(item->missionId()))
+    {
+        this->updateMissionVisibility(item->missionId());
+    }
+    this->updateSpatialIndex(item);
+
     this->beginInsertRows(QModelIndex(), this->rowCount(), this->rowCount());
     m_items.append(item);
     this->endInsertRows();
@@ -100,6 +121,7 @@ void MissionPointMapItemModel::onMissionItemAdded(const dto::MissionItemPtr& ite
 void MissionPointMapItemModel::onMissionItemRemoved(const dto::MissionItemPtr& item)
 {
     int row = m_items.indexOf(item);
+    m_spatialIndex.remove(item->id());
 
     this->beginRemoveRows(QModelIndex(), row, row);
     m_items.removeOne(item);
@@ -112,9 +134,42 @@ void MissionPointMapItemModel::onMissionItemChanged(const dto::MissionItemPtr& i
 {
     QModelIndex index = this->itemIndex(item);
     if (!index.isValid()) return;
+
+    this->updateSpatialIndex(item);
     emit dataChanged(index, index);
 }
 
+void MissionPointMapItemModel::onMissionItemsChanged(int missionId)
+{
+    if (!m_missionVisibility.contains(missionId)) this->updateMissionVisibility(missionId);
+
+    // Rows of changed items are updated at once, new ones are appended in one insertion
+    int first = m_items.count();
+    int last = -1;
+    dto::MissionItemPtrList added;
+    for (const dto::MissionItemPtr& item: m_service->missionItems(missionId))
+    {
+        this->updateSpatialIndex(item);
+
+        int row = m_items.indexOf(item);
+        if (row == -1)
+        {
+            added.append(item);
+            continue;
+        }
+
+        first = qMin(first, row);
+        last = qMax(last, row);
+    }
+
+    if (last > -1) emit dataChanged(this->index(first), this->index(last));
+    if (added.isEmpty()) return;
+
+    this->beginInsertRows(QModelIndex(), m_items.count(), m_items.count() + added.count() - 1);
+    m_items.append(added);
+    this->endInsertRows();
+}
+
 void MissionPointMapItemModel::onCurrentItemChanged(int vehicleId,
                                                     const dto::MissionItemPtr& old,
                                                     const dto::MissionItemPtr& item)
@@ -130,10 +185,13 @@ void MissionPointMapItemModel::onCurrentItemChanged(int vehicleId,
 
 void MissionPointMapItemModel::onMissionChanged(const dto::MissionPtr& mission)
 {
+    this->updateMissionVisibility(mission->id());
+
     for (const dto::MissionItemPtr& item: m_items)
     {
         if (item->missionId() != mission->id()) continue;
 
+        this->updateSpatialIndex(item);
         QModelIndex index = this->itemIndex(item);
         if (index.isValid()) emit dataChanged(index, index);
     }
@@ -158,3 +216,17 @@ QModelIndex MissionPointMapItemModel::itemIndex(const dto::MissionItemPtr& item)
 {
     return this->index(m_items.indexOf(item));
 }
+
+void MissionPointMapItemModel::updateMissionVisibility(int missionId)
+{
+    m_missionVisibility[missionId] = settings::Provider::value(
+                                         settings::mission::mission + QString::number(missionId) +
+                                         "/" + settings::visibility).toBool();
+}
+
+void MissionPointMapItemModel::updateSpatialIndex(const dto::MissionItemPtr& item)
+{
+    // Hidden missions are kept out of index, so they don't take thinning cells
+    m_spatialIndex.move(item->id(), m_missionVisibility.value(item->missionId()) ?
+                            ::itemCoordinate(item) : QGeoCoordinate());
+}
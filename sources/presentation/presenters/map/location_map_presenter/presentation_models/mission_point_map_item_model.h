@@ -6,6 +6,7 @@
 
 // Internal
 #include "dto_traits.h"
+#include "geo_quad_tree.h"
 
 namespace domain
 {
@@ -36,10 +37,15 @@ namespace presentation
         int rowCount(const QModelIndex& parent = QModelIndex()) const override;
         QVariant data(const QModelIndex& index, int role) const override;
 
+        dto::MissionItemPtr item(int row) const;
+        bool isItemVisible(int row) const;
+        const utils::GeoQuadTree& spatialIndex() const;
+
     public slots:
         void onMissionItemAdded(const dto::MissionItemPtr& item);
         void onMissionItemRemoved(const dto::MissionItemPtr& item);
         void onMissionItemChanged(const dto::MissionItemPtr& item);
+        void onMissionItemsChanged(int missionId);
         void onCurrentItemChanged(int vehicleId,
                                   const dto::MissionItemPtr& old,
                                   const dto::MissionItemPtr& item);
@@ -48,10 +54,14 @@ namespace presentation
     protected:
         QHash<int, QByteArray> roleNames() const override;
         QModelIndex itemIndex(const dto::MissionItemPtr& item) const;
+        void updateMissionVisibility(int missionId);
+        void updateSpatialIndex(const dto::MissionItemPtr& item);
 
     private:
         domain::MissionService* m_service;
         dto::MissionItemPtrList m_items;
+        utils::GeoQuadTree m_spatialIndex;
+        QHash<int, bool> m_missionVisibility; // Cached settings lookup
     };
 }
 
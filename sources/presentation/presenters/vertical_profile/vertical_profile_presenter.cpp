@@ -2,11 +2,14 @@
 
 // Qt
 #include <QVariant>
+#include <QPointF>
 #include <QDebug>
 
 // Internal
 #include "service_registry.h"
 #include "mission_service.h"
+#include "mission_geometry_service.h"
+#include "mission_geometry.h"
 #include "mission.h"
 #include "mission_item.h"
 
@@ -14,21 +17,15 @@ using namespace presentation;
 
 VerticalProfilePresenter::VerticalProfilePresenter(QObject* parent):
     BasePresenter(parent),
-    m_service(serviceRegistry->missionService())
+    m_service(serviceRegistry->missionService()),
+    m_geometryService(serviceRegistry->missionGeometryService())
 {
-    connect(m_service, &domain::MissionService::missionItemAdded, this, [this]
-            (const dto::MissionItemPtr& missionItem){
-        if (m_mission && m_mission->id() == missionItem->missionId()) this->updateMission();
-    });
-
-    connect(m_service, &domain::MissionService::missionItemRemoved, this, [this]
-            (const dto::MissionItemPtr& missionItem){
-        if (m_mission && m_mission->id() == missionItem->missionId()) this->updateMission();
-    });
+    connect(m_geometryService, &domain::MissionGeometryService::geometryChanged, this,
+            [this](int missionId, int fromIndex) {
+        if (m_mission.isNull() || m_mission->id() != missionId) return;
 
-    connect(m_service, &domain::MissionService::missionItemChanged, this, [this]
-            (const dto::MissionItemPtr& missionItem){
-        if (m_mission && m_mission->id() == missionItem->missionId()) this->updateMission();
+        if (fromIndex == -1) this->updateMission();
+        else this->updateWaypoints(fromIndex);
     });
 }
 
@@ -44,41 +41,44 @@ void VerticalProfilePresenter::updateMission()
 {
     this->invokeViewMethod(PROPERTY(clearWaypoints));
 
-    if (m_mission.isNull() || m_mission->count() < 1) return;
+    if (m_mission.isNull()) return;
 
-    QGeoCoordinate lastPosition;
-    int distance = 0;
-    int homeAltitude = 0;
-    int minAltitude = INT_MAX;
-    int maxAltitude = INT_MIN;
+    // Requesting geometry keeps it tracked, even while mission is empty
+    const domain::MissionGeometry* geometry = m_geometryService->geometry(m_mission->id());
+    if (geometry->count() < 1) return;
 
-    for (const dto::MissionItemPtr& item: m_service->missionItems(m_mission->id()))
+    for (int index = 0; index < geometry->count(); ++index)
     {
-        if (!item->isAltitudedItem()) continue;
+        if (!geometry->point(index).altituded) continue;
 
-        if (item->sequence() == 0) homeAltitude = item->altitude();
+        this->invokeViewMethod(PROPERTY(appendWaypoint), geometry->distance(index),
+                               geometry->absoluteAltitude(index));
+    }
 
-        if (item->isPositionatedItem())
-        {
-            if (item->coordinate().isValid() && lastPosition.isValid())
-            {
-                distance += lastPosition.distanceTo(item->coordinate());
-            }
-            lastPosition = item->coordinate();
-        }
+    this->updateBounds(geometry);
+}
 
-        int altitude = item->isAltitudeRelative() ? homeAltitude + item->altitude() : item->altitude();
+void VerticalProfilePresenter::updateWaypoints(int fromIndex)
+{
+    if (m_mission.isNull()) return;
 
-        if (altitude < minAltitude) minAltitude = altitude;
-        if (altitude > maxAltitude) maxAltitude = altitude;
+    // Only waypoints after changed one have moved on the profile, they go in one batch
+    const domain::MissionGeometry* geometry = m_geometryService->geometry(m_mission->id());
+    int firstWaypoint = 0;
+    QVariantList points;
+    for (int index = 0; index < geometry->count(); ++index)
+    {
+        if (!geometry->point(index).altituded) continue;
 
-        this->invokeViewMethod(PROPERTY(appendWaypoint), distance, altitude);
+        if (index >= fromIndex)
+        {
+            points.append(QPointF(geometry->distance(index), geometry->absoluteAltitude(index)));
+        }
+        else ++firstWaypoint;
     }
+    this->invokeViewMethod(PROPERTY(replaceWaypoints), firstWaypoint, points);
 
-    this->setViewProperty(PROPERTY(minDistance), 0);
-    this->setViewProperty(PROPERTY(maxDistance), distance);
-    this->setViewProperty(PROPERTY(minAltitude), minAltitude);
-    this->setViewProperty(PROPERTY(maxAltitude), maxAltitude);
+    this->updateBounds(geometry);
 }
 
 void VerticalProfilePresenter::clearMission()
@@ -86,6 +86,14 @@ void VerticalProfilePresenter::clearMission()
     this->invokeViewMethod(METHOD(clearWaypoints));
 }
 
+void VerticalProfilePresenter::updateBounds(const domain::MissionGeometry* geometry)
+{
+    this->setViewProperty(PROPERTY(minDistance), 0);
+    this->setViewProperty(PROPERTY(maxDistance), geometry->totalDistance());
+    this->setViewProperty(PROPERTY(minAltitude), geometry->minAltitude());
+    this->setViewProperty(PROPERTY(maxAltitude), geometry->maxAltitude());
+}
+
 void VerticalProfilePresenter::connectView(QObject* view)
 {
     Q_UNUSED(view)
@@ -8,6 +8,8 @@
 namespace domain
 {
     class MissionService;
+    class MissionGeometryService;
+    class MissionGeometry;
 }
 
 namespace presentation
@@ -22,13 +24,16 @@ namespace presentation
     public slots:
         void selectMission(const dto::MissionPtr& mission);
         void updateMission();
+        void updateWaypoints(int fromIndex);
         void clearMission();
 
     protected:
         void connectView(QObject* view) override;
+        void updateBounds(const domain::MissionGeometry* geometry);
 
     private:
         domain::MissionService* m_service;
+        domain::MissionGeometryService* m_geometryService;
         dto::MissionPtr m_mission;
     };
 }
@@ -12,6 +12,7 @@ Rectangle {
     property int sequence: -1
     property int status: MissionItem.NotActual
     property int command: MissionItem.UnknownCommand
+    property int issueSeverity: -1 // Worst issue found by mission validation
 
     property bool dragEnabled: false
     property alias mouseEnabled: area.visible
@@ -68,6 +69,16 @@ Rectangle {
         font.bold: true
     }
 
+    Rectangle {
+        visible: issueSeverity > -1
+        anchors.top: parent.top
+        anchors.right: parent.right
+        width: parent.width / 4
+        height: width
+        radius: width / 2
+        color: issueSeverity > 0 ? customPalette.dangerColor : customPalette.cautionColor
+    }
+
     Controls.ColoredIcon {
         id: picker
         width: parent.width
@@ -19,6 +19,7 @@ GridLayout {
     property string device
     property int baudRate
     property var statistics
+    property var traffic
 
     property alias name: nameField.text
     property alias devices: deviceBox.model
@@ -234,6 +235,49 @@ GridLayout {
         }
     }
 
+    ListView {
+        id: trafficList
+        model: traffic
+        visible: count > 0
+        clip: true
+        implicitHeight: Math.min(contentHeight, sizings.controlBaseSize * 6)
+        Layout.fillWidth: true
+        Layout.columnSpan: 2
+
+        Controls.ScrollBar.vertical: Controls.ScrollBar {}
+
+        delegate: RowLayout {
+            width: parent.width
+
+            Controls.Label {
+                text: isSystem ? qsTr("MAV %1").arg(identifier) : qsTr("Msg %1").arg(identifier)
+                font.bold: isSystem
+                Layout.fillWidth: true
+            }
+
+            Controls.Label {
+                text: qsTr("%1 pkt/s").arg(packets)
+                Layout.preferredWidth: sizings.controlBaseSize * 2
+            }
+
+            Controls.Label {
+                text: qsTr("%1 B/s").arg(bytes)
+                Layout.preferredWidth: sizings.controlBaseSize * 2
+            }
+
+            Controls.Label {
+                text: share + "%"
+                Layout.preferredWidth: sizings.controlBaseSize
+            }
+
+            Controls.Label {
+                text: isSystem ? qsTr("%1 lost").arg(gaps) : ""
+                color: gaps > 0 ? customPalette.dangerColor : customPalette.textColor
+                Layout.preferredWidth: sizings.controlBaseSize * 1.5
+            }
+        }
+    }
+
     Controls.Button {
         enabled: !changed
         text: connected ? qsTr("Disconnect") : qsTr("Connect")
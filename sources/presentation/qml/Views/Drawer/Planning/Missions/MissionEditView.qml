@@ -11,6 +11,9 @@ ColumnLayout {
 
     property int sequence: -1
     property int count: 0
+    property string issues
+    property bool issuesCritical: false
+    property bool surveyActive: false
 
     property alias name: nameLabel.text
     property alias selectedItemId: itemList.selectedItemId
@@ -29,6 +32,10 @@ ColumnLayout {
 
     Component.onDestruction: if (map) map.selectedItemId = 0
 
+    function setSurvey(parameters, area) {
+        survey.set(parameters, area);
+    }
+
     MissionEditPresenter {
         id: presenter
         view: missionEdit
@@ -99,6 +106,14 @@ ColumnLayout {
         }
     }
 
+    Controls.Label {
+        text: issues
+        visible: issues.length > 0
+        color: issuesCritical ? customPalette.dangerColor : customPalette.cautionColor
+        wrapMode: Text.WordWrap
+        Layout.fillWidth: true
+    }
+
     RowLayout {
         spacing: sizings.spacing
 
@@ -188,13 +203,51 @@ ColumnLayout {
                     enabled: sequence >= 0
                     onTriggered: presenter.addItem(MissionItem.Landing)
                 }
+
+                Controls.MenuItem {
+                    text: qsTr("Survey")
+                    iconSource: "qrc:/icons/map.svg"
+                    enabled: sequence >= 0
+                    onTriggered: {
+                        presenter.addSurvey(map.center);
+                        surveyButton.checked = true;
+                    }
+                }
             }
         }
     }
 
+    Controls.Button {
+        id: surveyButton
+        text: qsTr("Survey")
+        iconSource: "qrc:/icons/map.svg"
+        checkable: true
+        visible: surveyActive
+        Layout.fillWidth: true
+    }
+
+    Flickable {
+        id: surveyFlickable
+        visible: surveyActive && surveyButton.checked
+        contentHeight: survey.height
+        clip: true
+        boundsBehavior: Flickable.StopAtBounds
+        Layout.fillWidth: true
+        Layout.fillHeight: true
+
+        Controls.ScrollBar.vertical: Controls.ScrollBar {}
+
+        SurveyEditView {
+            id: survey
+            width: parent.width
+            onApply: presenter.applySurvey(parameters, area)
+        }
+    }
+
     MissionItemEditView {
         id: itemEdit
         itemId: missionEdit.selectedItemId
+        visible: !surveyFlickable.visible
         Layout.fillWidth: true
         Layout.fillHeight: true
     }
@@ -1,5 +1,6 @@
 import QtQuick 2.6
 import QtQuick.Layouts 1.3
+import QtQuick.Dialogs 1.2
 import JAGCS 1.0
 
 import "qrc:/Controls" as Controls
@@ -17,6 +18,13 @@ Item {
         view: missionList
     }
 
+    FileDialog {
+        id: importDialog
+        title: qsTr("Import mission")
+        nameFilters: [ qsTr("Mission files (*.plan *.waypoints *.txt *.mission)") ]
+        onAccepted: presenter.importMission(fileUrl)
+    }
+
     RowLayout {
         id: headerRow
         width: parent.width
@@ -35,6 +43,13 @@ Item {
             onClicked: presenter.addMission()
             Layout.alignment: Qt.AlignRight
         }
+
+        Controls.Button {
+            iconSource: "qrc:/icons/download.svg"
+            tipText: qsTr("Import Mission")
+            onClicked: importDialog.open()
+            Layout.alignment: Qt.AlignRight
+        }
     }
 
     Item {
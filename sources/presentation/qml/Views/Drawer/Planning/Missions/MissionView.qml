@@ -1,5 +1,6 @@
 import QtQuick 2.6
 import QtQuick.Layouts 1.3
+import QtQuick.Dialogs 1.2
 import JAGCS 1.0
 
 import "qrc:/Controls" as Controls
@@ -56,8 +57,8 @@ Controls.Card {
                    assignment.status === MissionAssignment.Uploading) });
         cancelItem.triggered.connect(assignment.cancelSync);
 
-        // TODO: export mission to file
-        menu.addEntry(qsTr("Export mission"), "qrc:/icons/save.svg").enabled = false;
+        menu.addEntry(qsTr("Export mission"), "qrc:/icons/save.svg").triggered.connect(
+                    exportDialog.open);
 
         var removeItem = menu.addEntry(qsTr("Remove"), "qrc:/icons/remove.svg");
         removeItem.iconColor = customPalette.dangerColor;
@@ -70,6 +71,15 @@ Controls.Card {
         view: missionView
     }
 
+    FileDialog {
+        id: exportDialog
+        title: qsTr("Export mission")
+        selectExisting: false
+        nameFilters: [ qsTr("QGC plan (*.plan)"), qsTr("QGC waypoints (*.waypoints)"),
+            qsTr("JAGCS mission (*.mission)") ]
+        onAccepted: presenter.exportMission(fileUrl)
+    }
+
     GridLayout {
         id: grid
         anchors.fill: parent
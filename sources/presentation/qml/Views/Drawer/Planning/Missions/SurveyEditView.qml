@@ -0,0 +1,225 @@
+import QtQuick 2.6
+import QtQuick.Layouts 1.3
+import QtPositioning 5.6
+
+import "qrc:/Controls" as Controls
+
+GridLayout {
+    id: surveyEdit
+
+    property var area: []
+
+    property alias pattern: patternBox.currentIndex
+    property alias spacing: spacingBox.realValue
+    property alias overlap: overlapBox.realValue
+    property alias heading: headingBox.realValue
+    property alias turnaround: turnaroundBox.realValue
+    property alias altitude: altitudeBox.realValue
+    property alias altitudeRelative: altitudeRelativeBox.checked
+
+    // Values set by presenter are not edits, they must not regenerate survey
+    property bool lock: false
+
+    signal apply(var parameters, var area)
+
+    function set(parameters, newArea) {
+        lock = true;
+        pattern = parameters.pattern;
+        spacing = parameters.spacing;
+        overlap = parameters.overlap;
+        heading = parameters.heading;
+        turnaround = parameters.turnaround;
+        altitude = parameters.altitude;
+        altitudeRelative = parameters.altitudeRelative;
+        area = newArea;
+        lock = false;
+    }
+
+    function edited() {
+        if (!lock) applyTimer.restart();
+    }
+
+    function setVertex(index, latitude, longitude) {
+        var vertex = QtPositioning.coordinate(latitude, longitude);
+        if (area[index].latitude === vertex.latitude &&
+            area[index].longitude === vertex.longitude) return;
+
+        area[index] = vertex; // In place, so vertex boxes are not recreated while editing
+        edited();
+    }
+
+    function addVertex() {
+        // Between last and first vertices, so polygon keeps its shape
+        var first = area[0];
+        var last = area[area.length - 1];
+        var newArea = area.slice();
+        newArea.push(last.atDistanceAndAzimuth(last.distanceTo(first) / 2, last.azimuthTo(first)));
+        area = newArea;
+        edited();
+    }
+
+    function removeVertex() {
+        var newArea = area.slice();
+        newArea.pop();
+        area = newArea;
+        edited();
+    }
+
+    columns: 2
+    rowSpacing: sizings.spacing
+    columnSpacing: sizings.spacing
+
+    // Spin boxes change on every step, survey is regenerated once they settle
+    Timer {
+        id: applyTimer
+        interval: 300
+        onTriggered: surveyEdit.apply({ pattern: pattern, spacing: spacing, overlap: overlap,
+                                         heading: heading, turnaround: turnaround,
+                                         altitude: altitude, altitudeRelative: altitudeRelative },
+                                       area)
+    }
+
+    Controls.Label {
+        text: qsTr("Pattern")
+        Layout.fillWidth: true
+    }
+
+    Controls.ComboBox {
+        id: patternBox
+        model: [ qsTr("Lawnmower"), qsTr("Crosshatch") ]
+        onCurrentIndexChanged: edited()
+        Layout.fillWidth: true
+    }
+
+    Controls.Label {
+        text: qsTr("Spacing, m")
+        Layout.fillWidth: true
+    }
+
+    Controls.RealSpinBox {
+        id: spacingBox
+        realFrom: 1
+        realTo: 1000
+        precision: 0.1
+        onRealValueChanged: edited()
+        Layout.fillWidth: true
+    }
+
+    Controls.Label {
+        text: qsTr("Overlap, %")
+        Layout.fillWidth: true
+    }
+
+    Controls.RealSpinBox {
+        id: overlapBox
+        realFrom: 0
+        realTo: 90
+        precision: 1
+        onRealValueChanged: edited()
+        Layout.fillWidth: true
+    }
+
+    Controls.Label {
+        text: qsTr("Heading")
+        Layout.fillWidth: true
+    }
+
+    Controls.RealSpinBox {
+        id: headingBox
+        realFrom: 0
+        realTo: 360
+        precision: 1
+        onRealValueChanged: edited()
+        Layout.fillWidth: true
+    }
+
+    Controls.Label {
+        text: qsTr("Turnaround, m")
+        Layout.fillWidth: true
+    }
+
+    Controls.RealSpinBox {
+        id: turnaroundBox
+        realFrom: 0
+        realTo: 500
+        precision: 1
+        onRealValueChanged: edited()
+        Layout.fillWidth: true
+    }
+
+    Controls.Label {
+        text: qsTr("Altitude")
+        Layout.fillWidth: true
+    }
+
+    Controls.RealSpinBox {
+        id: altitudeBox
+        realFrom: settings.value("Parameters/minAltitude")
+        realTo: settings.value("Parameters/maxAltitude")
+        precision: settings.value("Parameters/precisionAltitude")
+        onRealValueChanged: edited()
+        Layout.fillWidth: true
+    }
+
+    Controls.Label {
+        text: qsTr("Relative altitude")
+        Layout.fillWidth: true
+    }
+
+    Controls.CheckBox {
+        id: altitudeRelativeBox
+        onCheckedChanged: edited()
+        Layout.fillWidth: true
+    }
+
+    Repeater {
+        model: area.length
+
+        GridLayout {
+            columns: 2
+            rowSpacing: sizings.spacing
+            columnSpacing: sizings.spacing
+            Layout.columnSpan: 2
+            Layout.fillWidth: true
+
+            Controls.Label {
+                text: qsTr("Vertex") + " " + (index + 1)
+                Layout.columnSpan: 2
+                Layout.fillWidth: true
+            }
+
+            Controls.Label { text: qsTr("Lat.") }
+
+            Controls.CoordSpinBox {
+                value: area[index].latitude
+                onValueChanged: setVertex(index, value, area[index].longitude)
+                Layout.fillWidth: true
+            }
+
+            Controls.Label { text: qsTr("Lon.") }
+
+            Controls.CoordSpinBox {
+                isLongitude: true
+                value: area[index].longitude
+                onValueChanged: setVertex(index, area[index].latitude, value)
+                Layout.fillWidth: true
+            }
+        }
+    }
+
+    Controls.Button {
+        text: qsTr("Remove vertex")
+        iconSource: "qrc:/icons/remove.svg"
+        enabled: area.length > 3
+        onClicked: removeVertex()
+        Layout.fillWidth: true
+    }
+
+    Controls.Button {
+        text: qsTr("Add vertex")
+        iconSource: "qrc:/icons/add.svg"
+        enabled: area.length > 2
+        onClicked: addVertex()
+        Layout.fillWidth: true
+    }
+}
@@ -0,0 +1,79 @@
+import QtQuick 2.6
+import QtQuick.Layouts 1.3
+import JAGCS 1.0
+
+import "qrc:/Controls" as Controls
+
+ColumnLayout {
+    id: onboardLogs
+
+    property int vehicleId: 0
+    property bool online: false
+
+    property var logs: []
+    property int downloadingLogId: 0
+    property real progress: 0
+    property string status
+
+    spacing: sizings.spacing
+
+    onVehicleIdChanged: presenter.setVehicle(vehicleId)
+
+    OnboardLogsPresenter {
+        id: presenter
+        view: onboardLogs
+        Component.onCompleted: setVehicle(vehicleId)
+    }
+
+    RowLayout {
+        spacing: sizings.spacing
+
+        Controls.Label {
+            text: logs.length > 0 ? qsTr("Onboard logs") : qsTr("No onboard logs listed")
+            Layout.fillWidth: true
+        }
+
+        Controls.Button {
+            tipText: qsTr("Request log list")
+            iconSource: "qrc:/icons/restore.svg"
+            enabled: online
+            onClicked: presenter.requestList()
+        }
+    }
+
+    Repeater {
+        model: logs
+
+        RowLayout {
+            spacing: sizings.spacing
+
+            Controls.Label {
+                text: "#" + modelData.id + " " + (modelData.size / 1024).toFixed(0) + " " +
+                      qsTr("KiB") + " " + modelData.time
+                Layout.fillWidth: true
+            }
+
+            Controls.Button {
+                tipText: highlighted ? qsTr("Cancel download") : qsTr("Download log")
+                iconSource: highlighted ? "qrc:/icons/cancel.svg" : "qrc:/icons/download.svg"
+                highlighted: downloadingLogId === modelData.id
+                enabled: online && (downloadingLogId === 0 || highlighted)
+                onClicked: highlighted ? presenter.cancelDownload() : presenter.download(modelData.id)
+            }
+        }
+    }
+
+    Controls.ProgressBar {
+        visible: downloadingLogId > 0
+        value: progress
+        text: (progress * 100).toFixed(0) + "%"
+        Layout.fillWidth: true
+    }
+
+    Controls.Label {
+        text: status
+        visible: status.length > 0
+        wrapMode: Text.WrapAnywhere
+        Layout.fillWidth: true
+    }
+}
@@ -0,0 +1,102 @@
+import QtQuick 2.6
+import QtQuick.Layouts 1.3
+import JAGCS 1.0
+
+import "qrc:/Controls" as Controls
+
+ColumnLayout {
+    id: remoteFiles
+
+    property int vehicleId: 0
+    property bool online: false
+
+    property string path: "/"
+    property var files: []
+    property bool listing: false
+    property bool transferring: false
+    property real progress: 0
+    property string status
+
+    spacing: sizings.spacing
+
+    onVehicleIdChanged: presenter.setVehicle(vehicleId)
+
+    RemoteFilesPresenter {
+        id: presenter
+        view: remoteFiles
+        Component.onCompleted: setVehicle(vehicleId)
+    }
+
+    RowLayout {
+        spacing: sizings.spacing
+
+        Controls.Button {
+            tipText: qsTr("Parent directory")
+            iconSource: "qrc:/icons/up.svg"
+            enabled: online && !transferring && path !== "/"
+            onClicked: presenter.up()
+        }
+
+        Controls.Label {
+            text: path
+            elide: Text.ElideLeft
+            Layout.fillWidth: true
+        }
+
+        Controls.Button {
+            tipText: qsTr("List directory")
+            iconSource: "qrc:/icons/restore.svg"
+            enabled: online && !transferring
+            highlighted: listing
+            onClicked: presenter.listDirectory(path)
+        }
+    }
+
+    Repeater {
+        model: files
+
+        RowLayout {
+            spacing: sizings.spacing
+
+            Controls.Label {
+                text: modelData.directory ? modelData.name + "/" :
+                                            modelData.name + " " +
+                                            (modelData.size / 1024).toFixed(0) + " " + qsTr("KiB")
+                elide: Text.ElideRight
+                Layout.fillWidth: true
+            }
+
+            Controls.Button {
+                tipText: modelData.directory ? qsTr("Open directory") : qsTr("Download file")
+                iconSource: modelData.directory ? "qrc:/icons/right.svg" : "qrc:/icons/download.svg"
+                enabled: online && !transferring
+                onClicked: modelData.directory ? presenter.enter(modelData.name) :
+                                                 presenter.download(modelData.name)
+            }
+        }
+    }
+
+    RowLayout {
+        visible: transferring
+        spacing: sizings.spacing
+
+        Controls.ProgressBar {
+            value: progress
+            text: (progress * 100).toFixed(0) + "%"
+            Layout.fillWidth: true
+        }
+
+        Controls.Button {
+            tipText: qsTr("Cancel download")
+            iconSource: "qrc:/icons/cancel.svg"
+            onClicked: presenter.cancel()
+        }
+    }
+
+    Controls.Label {
+        text: status
+        visible: status.length > 0
+        wrapMode: Text.WrapAnywhere
+        Layout.fillWidth: true
+    }
+}
@@ -107,6 +107,20 @@ Controls.Frame {
                 enabled: changed
             }
 
+            Controls.Button {
+                id: logsButton
+                tipText: qsTr("Onboard logs")
+                iconSource: "qrc:/icons/logbook.svg"
+                checkable: true
+            }
+
+            Controls.Button {
+                id: filesButton
+                tipText: qsTr("Vehicle files")
+                iconSource: "qrc:/icons/db.svg"
+                checkable: true
+            }
+
             Controls.DelayButton {
                 tipText: qsTr("Remove")
                 iconSource: "qrc:/icons/remove.svg"
@@ -115,5 +129,31 @@ Controls.Frame {
                 iconColor: customPalette.dangerColor
             }
         }
+
+        Loader {
+            active: logsButton.checked
+            visible: active
+            sourceComponent: Component {
+                OnboardLogsView {
+                    vehicleId: vehicleView.vehicleId
+                    online: vehicleView.online
+                }
+            }
+            Layout.columnSpan: 2
+            Layout.fillWidth: true
+        }
+
+        Loader {
+            active: filesButton.checked
+            visible: active
+            sourceComponent: Component {
+                RemoteFilesView {
+                    vehicleId: vehicleView.vehicleId
+                    online: vehicleView.online
+                }
+            }
+            Layout.columnSpan: 2
+            Layout.fillWidth: true
+        }
     }
 }
@@ -43,6 +43,15 @@ Map {
         view: map
     }
 
+    Timer {
+        id: viewportTimer
+        interval: 100
+        onTriggered: presenter.setViewport([ map.toCoordinate(Qt.point(0, 0)),
+                                             map.toCoordinate(Qt.point(width, 0)),
+                                             map.toCoordinate(Qt.point(0, height)),
+                                             map.toCoordinate(Qt.point(width, height)) ])
+    }
+
     Behavior on center {
         enabled: trackingVehicleId == 0
         CoordinateAnimation { duration: 200 }
@@ -75,6 +84,14 @@ Map {
     Component.onDestruction: if (visible) saveViewport()
     onVisibleChanged: if (!visible) saveViewport()
 
+    onCenterChanged: viewportTimer.restart()
+    onZoomLevelChanged: viewportTimer.restart()
+    onBearingChanged: viewportTimer.restart()
+    onTiltChanged: viewportTimer.restart()
+    onWidthChanged: viewportTimer.restart()
+    onHeightChanged: viewportTimer.restart()
+    onSelectedItemIdChanged: presenter.setSelectedItem(selectedItemId)
+
     onTrackingVehicleIdChanged: updateGestures()
     onTrackYawChanged: updateGestures()
 
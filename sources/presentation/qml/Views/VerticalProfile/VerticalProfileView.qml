@@ -17,8 +17,22 @@ Item {
     }
 
     function insertWaypoint(index, distance, altitude) {
-        waypoints.append(index, distance, altitude);
-        paths.append(index, distance, altitude);
+        waypoints.insert(index, distance, altitude);
+        paths.insert(index, distance, altitude);
+    }
+
+    function replaceWaypoints(from, points) {
+        // Whole tail at once, replacing point by point shifts the series every time
+        var count = waypoints.count - from;
+        if (count > 0) {
+            waypoints.removePoints(from, count);
+            paths.removePoints(from, count);
+        }
+
+        for (var i = 0; i < points.length; ++i) {
+            waypoints.append(points[i].x, points[i].y);
+            paths.append(points[i].x, points[i].y);
+        }
     }
 
     function removeWaypoint(index) {
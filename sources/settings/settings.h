@@ -20,6 +20,7 @@ namespace settings
         const QString baudRate = "Communication/baudRate";
         const QString port = "Communication/port";
         const QString statisticsCount = "Communication/statisticsCount";
+        const QString routing = "Communication/routing";
     }
 
     namespace parameters
@@ -31,6 +31,7 @@ namespace
         { communication::baudRate, 57600 },
         { communication::port, 14550 },
         { communication::statisticsCount, 50 },
+        { communication::routing, false },
 
         { parameters::defaultAcceptanceRadius, 3 },
         { parameters::defaultTakeoffPitch, 15 },
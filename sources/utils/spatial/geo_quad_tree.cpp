@@ -0,0 +1,193 @@
+#include "geo_quad_tree.h"
+
+using namespace utils;
+
+namespace
+{
+    const QRectF world(-180, -90, 360, 180);
+
+    QPointF toPoint(const QGeoCoordinate& coordinate)
+    {
+        return QPointF(coordinate.longitude(), coordinate.latitude());
+    }
+
+    bool inside(const QRectF& rect, const QPointF& point)
+    {
+        return point.x() >= rect.left() && point.x() <= rect.right() &&
+                point.y() >= rect.top() && point.y() <= rect.bottom();
+    }
+
+    bool overlaps(const QRectF& first, const QRectF& second)
+    {
+        return first.left() <= second.right() && second.left() <= first.right() &&
+                first.top() <= second.bottom() && second.top() <= first.bottom();
+    }
+}
+
+GeoQuadTree::GeoQuadTree(int capacity, int maxDepth):
+    m_capacity(capacity),
+    m_maxDepth(maxDepth)
+{
+    this->clear();
+}
+
+void GeoQuadTree::insert(int id, const QGeoCoordinate& coordinate)
+{
+    if (m_points.contains(id)) this->remove(id);
+    if (!coordinate.isValid()) return;
+
+    QPointF point = ::toPoint(coordinate);
+    m_points[id] = point;
+
+    int depth = 0;
+    int leaf = this->leafFor(point, &depth);
+    m_nodes[leaf].points.append(qMakePair(id, point));
+
+    if (m_nodes[leaf].points.count() > m_capacity && depth < m_maxDepth) this->split(leaf);
+}
+
+void GeoQuadTree::remove(int id)
+{
+    auto it = m_points.find(id);
+    if (it == m_points.end()) return;
+
+    // Emptied leafs are kept, they are reused by following inserts
+    Node& leaf = m_nodes[this->leafFor(it.value())];
+    for (int i = 0; i < leaf.points.count(); ++i)
+    {
+        if (leaf.points.at(i).first != id) continue;
+
+        leaf.points.remove(i);
+        break;
+    }
+
+    m_points.erase(it);
+}
+
+void GeoQuadTree::move(int id, const QGeoCoordinate& coordinate)
+{
+    auto it = m_points.find(id);
+    if (it != m_points.end() && coordinate.isValid() && it.value() == ::toPoint(coordinate)) return;
+
+    this->insert(id, coordinate);
+}
+
+void GeoQuadTree::clear()
+{
+    m_points.clear();
+    m_nodes.clear();
+
+    Node root;
+    root.bounds = ::world;
+    m_nodes.append(root);
+}
+
+bool GeoQuadTree::contains(int id) const
+{
+    return m_points.contains(id);
+}
+
+QGeoCoordinate GeoQuadTree::coordinate(int id) const
+{
+    auto it = m_points.find(id);
+    if (it == m_points.end()) return QGeoCoordinate();
+
+    return QGeoCoordinate(it.value().y(), it.value().x());
+}
+
+int GeoQuadTree::count() const
+{
+    return m_points.count();
+}
+
+QList<int> GeoQuadTree::query(const QGeoRectangle& rectangle) const
+{
+    QList<int> result;
+    if (!rectangle.isValid()) return result;
+
+    double top = rectangle.bottomLeft().latitude();
+    double height = rectangle.height();
+    double left = rectangle.topLeft().longitude();
+    double right = rectangle.bottomRight().longitude();
+
+    if (left <= right)
+    {
+        this->query(QRectF(left, top, right - left, height), result);
+    }
+    else
+    {
+        this->query(QRectF(left, top, 180 - left, height), result);
+        this->query(QRectF(-180, top, right + 180, height), result);
+    }
+
+    return result;
+}
+
+int GeoQuadTree::leafFor(const QPointF& point, int* depth) const
+{
+    int index = 0;
+    int level = 0;
+    while (m_nodes.at(index).children > -1)
+    {
+        index = this->childFor(m_nodes.at(index), point);
+        ++level;
+    }
+
+    if (depth) *depth = level;
+    return index;
+}
+
+int GeoQuadTree::childFor(const Node& node, const QPointF& point) const
+{
+    QPointF center = node.bounds.center();
+    return node.children + (point.x() < center.x() ? 0 : 1) + (point.y() < center.y() ? 0 : 2);
+}
+
+void GeoQuadTree::split(int nodeIndex)
+{
+    QRectF bounds = m_nodes.at(nodeIndex).bounds;
+    QSizeF size = bounds.size() / 2;
+    int first = m_nodes.count();
+
+    for (int quadrant = 0; quadrant < 4; ++quadrant)
+    {
+        Node child;
+        child.bounds = QRectF(QPointF(bounds.left() + (quadrant & 1 ? size.width() : 0),
+                                      bounds.top() + (quadrant & 2 ? size.height() : 0)), size);
+        m_nodes.append(child);
+    }
+
+    // m_nodes may have been reallocated, so node is taken after appending children
+    Node& node = m_nodes[nodeIndex];
+    node.children = first;
+
+    QVector<QPair<int, QPointF>> points;
+    points.swap(node.points);
+    for (const QPair<int, QPointF>& entry: points)
+    {
+        m_nodes[this->childFor(m_nodes.at(nodeIndex), entry.second)].points.append(entry);
+    }
+}
+
+void GeoQuadTree::query(const QRectF& rect, QList<int>& result) const
+{
+    QVector<int> stack;
+    stack.append(0);
+
+    while (!stack.isEmpty())
+    {
+        const Node& node = m_nodes.at(stack.takeLast());
+        if (!::overlaps(node.bounds, rect)) continue;
+
+        if (node.children > -1)
+        {
+            for (int child = node.children; child < node.children + 4; ++child) stack.append(child);
+            continue;
+        }
+
+        for (const QPair<int, QPointF>& entry: node.points)
+        {
+            if (::inside(rect, entry.second)) result.append(entry.first);
+        }
+    }
+}
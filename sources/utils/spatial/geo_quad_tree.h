@@ -0,0 +1,54 @@
+#ifndef GEO_QUAD_TREE_H
+#define GEO_QUAD_TREE_H
+
+// Qt
+#include <QVector>
+#include <QHash>
+#include <QPointF>
+#include <QRectF>
+#include <QGeoCoordinate>
+#include <QGeoRectangle>
+
+namespace utils
+{
+    // Point region quadtree over geographic coordinates, keyed by integer ids.
+    // Longitude is x and latitude is y, nodes split when they overflow capacity
+    class GeoQuadTree
+    {
+    public:
+        explicit GeoQuadTree(int capacity = 16, int maxDepth = 18);
+
+        void insert(int id, const QGeoCoordinate& coordinate);
+        void remove(int id);
+        void move(int id, const QGeoCoordinate& coordinate);
+        void clear();
+
+        bool contains(int id) const;
+        QGeoCoordinate coordinate(int id) const;
+        int count() const;
+
+        // Ids inside rectangle, rectangle crossing antimeridian is handled
+        QList<int> query(const QGeoRectangle& rectangle) const;
+
+    private:
+        struct Node
+        {
+            QRectF bounds;
+            int children = -1; // Index of first of four children, -1 for leaf
+            QVector<QPair<int, QPointF>> points;
+        };
+
+        int leafFor(const QPointF& point, int* depth = nullptr) const;
+        int childFor(const Node& node, const QPointF& point) const;
+        void split(int nodeIndex);
+        void query(const QRectF& rect, QList<int>& result) const;
+
+        const int m_capacity;
+        const int m_maxDepth;
+
+        QVector<Node> m_nodes;
+        QHash<int, QPointF> m_points;
+    };
+}
+
+#endif // GEO_QUAD_TREE_H
@@ -0,0 +1,157 @@
+#include "timing_wheel.h"
+
+// Qt
+#include <QTimerEvent>
+
+using namespace utils;
+
+namespace
+{
+    const int levelBits[] = { 8, 6, 6 };
+    const int levelCount = 3;
+
+    int slotBits(int level)
+    {
+        int bits = 0;
+        for (int i = 0; i < level; ++i) bits += ::levelBits[i];
+        return bits;
+    }
+
+    qint64 levelSpan(int level) // Ticks covered by levels up to this one
+    {
+        return qint64(1) << (::slotBits(level) + ::levelBits[level]);
+    }
+
+    int slotIndex(int level, qint64 tick)
+    {
+        return (tick >> ::slotBits(level)) & ((1 << ::levelBits[level]) - 1);
+    }
+}
+
+TimingWheel::TimingWheel(int tick, QObject* parent):
+    QObject(parent),
+    m_tick(tick)
+{
+    for (int level = 0; level < ::levelCount; ++level)
+    {
+        m_levels.append(QVector<QVector<int> >(1 << ::levelBits[level]));
+    }
+}
+
+int TimingWheel::start(int timeout, QObject* context, const Callback& callback)
+{
+    if (!m_timer.isActive()) // Idle wheel jumps straight to the clock
+    {
+        if (!m_clock.isValid()) m_clock.start();
+        m_current = m_clock.elapsed() / m_tick;
+
+        for (QVector<QVector<int> >& level: m_levels)
+        {
+            for (QVector<int>& slot: level) slot.clear();
+        }
+        m_timer.start(m_tick, this);
+    }
+
+    do
+    {
+        if (++m_lastId < 1) m_lastId = 1;
+    }
+    while (m_entries.contains(m_lastId));
+
+    qint64 ticks = qBound(qint64(1), qint64((timeout + m_tick - 1) / m_tick),
+                          ::levelSpan(::levelCount - 1) - 1);
+
+    Entry& entry = m_entries[m_lastId];
+    entry.expiry = m_current + ticks;
+    entry.context = context;
+    entry.callback = callback;
+
+    this->place(m_lastId, entry.expiry);
+    return m_lastId;
+}
+
+void TimingWheel::stop(int timerId)
+{
+    // Slot keeps the id until it comes up, removal from slot list would be linear
+    m_entries.remove(timerId);
+    if (m_entries.isEmpty()) m_timer.stop();
+}
+
+bool TimingWheel::isActive(int timerId) const
+{
+    return m_entries.contains(timerId);
+}
+
+int TimingWheel::count() const
+{
+    return m_entries.count();
+}
+
+int TimingWheel::backoff(int timeout, int attempt, int maxTimeout)
+{
+    return attempt < 16 ? qMin(maxTimeout, timeout << attempt) : maxTimeout;
+}
+
+void TimingWheel::timerEvent(QTimerEvent* event)
+{
+    if (event->timerId() != m_timer.timerId()) return QObject::timerEvent(event);
+
+    // Timer events can be late, so wheel catches up with the clock
+    qint64 target = m_clock.elapsed() / m_tick;
+    while (m_current < target && !m_entries.isEmpty()) this->advance();
+
+    if (m_entries.isEmpty()) m_timer.stop();
+}
+
+void TimingWheel::place(int timerId, qint64 expiry)
+{
+    qint64 delta = expiry - m_current;
+
+    int level = 0;
+    while (level < ::levelCount - 1 && delta >= ::levelSpan(level)) ++level;
+
+    m_levels[level][::slotIndex(level, qMax(expiry, m_current))].append(timerId);
+}
+
+void TimingWheel::cascade(int level)
+{
+    QVector<int> ids;
+    ids.swap(m_levels[level][::slotIndex(level, m_current)]);
+
+    for (int timerId: ids)
+    {
+        auto it = m_entries.constFind(timerId);
+        if (it != m_entries.constEnd()) this->place(timerId, it->expiry);
+    }
+}
+
+void TimingWheel::advance()
+{
+    ++m_current;
+
+    // Upper level slot is spread over lower levels, when lower level turns over.
+    // Top level goes first, so its timers land in lower slots not cascaded yet
+    int top = 0;
+    while (top + 1 < ::levelCount && ::slotIndex(top, m_current) == 0) ++top;
+    for (int level = top; level > 0; --level) this->cascade(level);
+
+    QVector<int> ids;
+    ids.swap(m_levels[0][::slotIndex(0, m_current)]);
+
+    for (int timerId: ids)
+    {
+        auto it = m_entries.find(timerId);
+        if (it == m_entries.end()) continue; // Stopped
+
+        if (it->expiry > m_current) // Lapped the wheel, keep it for the next turn
+        {
+            this->place(timerId, it->expiry);
+            continue;
+        }
+
+        Entry entry = it.value();
+        m_entries.erase(it);
+
+        if (entry.context) entry.callback();
+    }
+}
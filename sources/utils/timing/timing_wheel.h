@@ -0,0 +1,66 @@
+#ifndef TIMING_WHEEL_H
+#define TIMING_WHEEL_H
+
+// Qt
+#include <QObject>
+#include <QPointer>
+#include <QVector>
+#include <QHash>
+#include <QBasicTimer>
+#include <QElapsedTimer>
+
+// Std
+#include <functional>
+
+namespace utils
+{
+    // Hierarchical timing wheel: any number of one-shot timers driven by a single
+    // OS timer. Start and stop are O(1), expired timers are found without scanning.
+    // Levels cover 2.56 s, 2.7 min and 2.9 h with 10 ms tick, longer timeouts are clamped
+    class TimingWheel: public QObject
+    {
+        Q_OBJECT
+
+    public:
+        using Callback = std::function<void()>;
+
+        explicit TimingWheel(int tick = 10, QObject* parent = nullptr);
+
+        // Callback is called once in wheel's thread, skipped if context is destroyed.
+        // Returns timer id, which is never 0
+        int start(int timeout, QObject* context, const Callback& callback);
+        void stop(int timerId);
+        bool isActive(int timerId) const;
+
+        int count() const;
+
+        static int backoff(int timeout, int attempt, int maxTimeout);
+
+    protected:
+        void timerEvent(QTimerEvent* event) override;
+
+    private:
+        struct Entry
+        {
+            qint64 expiry;
+            QPointer<QObject> context;
+            Callback callback;
+        };
+
+        void place(int timerId, qint64 expiry);
+        void cascade(int level);
+        void advance();
+
+        const int m_tick;
+        qint64 m_current = 0; // Ticks of m_clock already processed
+
+        QVector< QVector<QVector<int> > > m_levels; // Slots hold ids, stopped ones are skipped
+        QHash<int, Entry> m_entries;
+        int m_lastId = 0;
+
+        QBasicTimer m_timer;
+        QElapsedTimer m_clock;
+    };
+}
+
+#endif // TIMING_WHEEL_H
@@ -0,0 +1,63 @@
+#include "liveness_tracker_test.h"
+
+// Qt
+#include <QDebug>
+
+// Internal
+#include "liveness_tracker.h"
+
+// Std
+#include <algorithm>
+
+using namespace comm;
+
+void LivenessTrackerTest::testBeat()
+{
+    LivenessTracker tracker;
+
+    QVERIFY(!tracker.isOnline(1));
+    QVERIFY2(tracker.beat(1), "First heartbeat must bring system online");
+    QVERIFY2(!tracker.beat(1), "Repeated heartbeat must not");
+    QVERIFY(tracker.isOnline(1));
+    QVERIFY(!tracker.isOnline(2));
+
+    QCOMPARE(tracker.interval(255), 0);
+    QVERIFY(tracker.beat(255)); // Whole sysid range is tracked
+    QCOMPARE(tracker.quality(255), 100);
+}
+
+void LivenessTrackerTest::testSweep()
+{
+    LivenessTracker tracker;
+
+    tracker.beat(1);
+    tracker.beat(2);
+    tracker.beat(3);
+    tracker.beat(4);
+
+    QTest::qWait(50);
+    tracker.beat(2);
+    tracker.beat(4);
+
+    // Removed entries are refilled from the list end, sweep must still see every one
+    QVector<quint8> timedOut = tracker.sweep(25);
+    std::sort(timedOut.begin(), timedOut.end());
+    QCOMPARE(timedOut, QVector<quint8>({ 1, 3 }));
+
+    QVERIFY(!tracker.isOnline(1));
+    QVERIFY(tracker.isOnline(2));
+    QVERIFY(!tracker.isOnline(3));
+    QVERIFY(tracker.isOnline(4));
+    QCOMPARE(tracker.quality(1), 0);
+
+    QVERIFY(tracker.sweep(1000).isEmpty());
+
+    QVERIFY2(tracker.beat(3), "Swept system must come back online");
+    QTest::qWait(50);
+    tracker.beat(3);
+
+    timedOut = tracker.sweep(25);
+    std::sort(timedOut.begin(), timedOut.end());
+    QCOMPARE(timedOut, QVector<quint8>({ 2, 4 }));
+    QVERIFY(tracker.isOnline(3));
+}
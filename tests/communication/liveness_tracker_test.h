@@ -0,0 +1,15 @@
+#ifndef LIVENESS_TRACKER_TEST_H
+#define LIVENESS_TRACKER_TEST_H
+
+#include <QTest>
+
+class LivenessTrackerTest: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testBeat();
+    void testSweep();
+};
+
+#endif // LIVENESS_TRACKER_TEST_H
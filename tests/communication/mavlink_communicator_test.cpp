@@ -0,0 +1,140 @@
+#include "mavlink_communicator_test.h"
+
+// MAVLink
+#include <mavlink.h>
+
+// Qt
+#include <QDebug>
+
+// Internal
+#include "mavlink_communicator.h"
+#include "abstract_mavlink_handler.h"
+#include "abstract_link.h"
+
+using namespace comm;
+
+namespace
+{
+    const quint8 packChannel = MAVLINK_COMM_NUM_BUFFERS - 1; // Left to tests by communicator
+    const int pathSettle = 700; // Longer than path reselection interval
+
+    class TestLink: public AbstractLink
+    {
+    public:
+        bool isConnected() const override { return true; }
+
+        void connectLink() override {}
+        void disconnectLink() override {}
+
+        void inject(const QByteArray& data) { this->receiveData(data); }
+
+    protected:
+        void sendDataImpl(const QByteArray& data) override { Q_UNUSED(data) }
+    };
+
+    class CountingHandler: public AbstractMavLinkHandler
+    {
+    public:
+        CountingHandler(MavLinkCommunicator* communicator, int* counter):
+            AbstractMavLinkHandler(communicator),
+            m_counter(counter)
+        {}
+
+        void processMessage(const mavlink_message_t& message) override
+        {
+            if (message.msgid == MAVLINK_MSG_ID_HEARTBEAT) ++(*m_counter);
+        }
+
+    private:
+        int* const m_counter;
+    };
+
+    QByteArray heartbeat(quint8 sysId, quint8 seq)
+    {
+        mavlink_get_channel_status(::packChannel)->current_tx_seq = seq;
+
+        mavlink_message_t message;
+        mavlink_msg_heartbeat_pack_chan(sysId, 1, ::packChannel, &message, MAV_TYPE_QUADROTOR,
+                                        MAV_AUTOPILOT_PX4, 0, 0, MAV_STATE_ACTIVE);
+
+        quint8 buffer[MAVLINK_MAX_PACKET_LEN];
+        int length = mavlink_msg_to_send_buffer(buffer, &message);
+        return QByteArray(reinterpret_cast<const char*>(buffer), length);
+    }
+}
+
+void MavLinkCommunicatorTest::testDuplicates()
+{
+    TestLink first;
+    TestLink second;
+    MavLinkCommunicator communicator(255, 190);
+    communicator.addLink(&first);
+    communicator.addLink(&second);
+
+    int received = 0;
+    communicator.addHandler(new CountingHandler(&communicator, &received));
+
+    first.inject(::heartbeat(1, 0));
+    second.inject(::heartbeat(1, 0));
+    QCOMPARE(received, 1); // Same packet by redundant link
+
+    second.inject(::heartbeat(1, 1));
+    first.inject(::heartbeat(1, 1));
+    QCOMPARE(received, 2);
+
+    first.inject(::heartbeat(2, 1)); // Same sequence of another system is no copy
+    QCOMPARE(received, 3);
+
+    first.inject(::heartbeat(1, 3));
+    second.inject(::heartbeat(1, 2)); // Late, but not seen before
+    second.inject(::heartbeat(1, 3));
+    QCOMPARE(received, 5);
+
+    // Both links are paths to the system, though only one delivered its packets
+    QVERIFY(communicator.linkMavSystems(&first).contains(1));
+    QVERIFY(communicator.linkMavSystems(&second).contains(1));
+}
+
+void MavLinkCommunicatorTest::testPathHysteresis()
+{
+    TestLink slow;
+    TestLink fast;
+    TestLink unmeasured;
+    MavLinkCommunicator communicator(255, 190);
+    communicator.addLink(&slow);
+    communicator.addLink(&fast);
+
+    quint8 seq = 0;
+    auto beat = [&](const QList<TestLink*>& links) {
+        QByteArray frame = ::heartbeat(1, seq++);
+        for (TestLink* link: links) link->inject(frame);
+    };
+
+    communicator.setLinkLatency(&slow, 100, 100);
+    communicator.setLinkLatency(&fast, 90, 90);
+
+    beat({ &slow, &fast });
+    QVERIFY(communicator.mavSystemLink(1) == &slow); // Heard first
+
+    QTest::qWait(::pathSettle);
+    beat({ &slow, &fast });
+    QTest::qWait(::pathSettle);
+    QVERIFY(communicator.mavSystemLink(1) == &slow); // Not better enough to switch
+
+    communicator.setLinkLatency(&fast, 50, 50);
+    beat({ &slow, &fast });
+    QTest::qWait(::pathSettle);
+    QVERIFY(communicator.mavSystemLink(1) == &fast);
+
+    // Link without round trip yet is taken as the slowest one, not as the fastest
+    communicator.addLink(&unmeasured);
+    beat({ &slow, &fast, &unmeasured });
+    QTest::qWait(::pathSettle);
+    QVERIFY(communicator.mavSystemLink(1) == &fast);
+
+    // Silent path fails over at once
+    beat({ &slow, &unmeasured });
+    QTest::qWait(2500);
+    beat({ &slow, &unmeasured });
+    QVERIFY(communicator.mavSystemLink(1) != &fast);
+}
@@ -0,0 +1,15 @@
+#ifndef MAVLINK_COMMUNICATOR_TEST_H
+#define MAVLINK_COMMUNICATOR_TEST_H
+
+#include <QTest>
+
+class MavLinkCommunicatorTest: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testDuplicates();
+    void testPathHysteresis();
+};
+
+#endif // MAVLINK_COMMUNICATOR_TEST_H
@@ -0,0 +1,169 @@
+#include "mavlink_router_test.h"
+
+// MAVLink
+#include <mavlink.h>
+
+// Qt
+#include <QDebug>
+
+// Internal
+#include "mavlink_router.h"
+#include "abstract_link.h"
+
+using namespace comm;
+
+namespace
+{
+    const quint8 gcsId = 255;
+
+    class TestLink: public AbstractLink
+    {
+    public:
+        bool isConnected() const override { return connected; }
+
+        void connectLink() override {}
+        void disconnectLink() override {}
+
+        bool connected = true;
+
+    protected:
+        void sendDataImpl(const QByteArray& data) override { Q_UNUSED(data) }
+    };
+
+    mavlink_message_t heartbeat(quint8 sysId, quint8 compId)
+    {
+        mavlink_message_t message;
+        mavlink_msg_heartbeat_pack(sysId, compId, &message, MAV_TYPE_QUADROTOR,
+                                   MAV_AUTOPILOT_PX4, 0, 0, MAV_STATE_ACTIVE);
+        return message;
+    }
+
+    mavlink_message_t command(quint8 targetSystem, quint8 targetComponent)
+    {
+        mavlink_message_t message;
+        mavlink_msg_command_long_pack(::gcsId, 0, &message, targetSystem, targetComponent,
+                                      MAV_CMD_COMPONENT_ARM_DISARM, 0, 1, 0, 0, 0, 0, 0, 0);
+        return message;
+    }
+
+    QList<AbstractLink*> route(MavLinkRouter& router, const mavlink_message_t& message,
+                               AbstractLink* source, const QList<AbstractLink*>& links)
+    {
+        return router.route(message, MAVLINK_NUM_NON_PAYLOAD_BYTES + message.len, source, links);
+    }
+}
+
+void MavLinkRouterTest::testBroadcast()
+{
+    TestLink first;
+    TestLink second;
+    TestLink third;
+    QList<AbstractLink*> links({ &first, &second, &third });
+    MavLinkRouter router;
+
+    QCOMPARE(::route(router, ::heartbeat(1, 1), &first, links),
+             QList<AbstractLink*>({ &second, &third }));
+
+    // Command to everyone goes to every link but the source one
+    QCOMPARE(::route(router, ::command(0, 0), &third, links),
+             QList<AbstractLink*>({ &first, &second }));
+}
+
+void MavLinkRouterTest::testTargets()
+{
+    TestLink vehicleLink;
+    TestLink otherLink;
+    TestLink gcsLink;
+    QList<AbstractLink*> links({ &vehicleLink, &otherLink, &gcsLink });
+    MavLinkRouter router;
+
+    ::route(router, ::heartbeat(1, 1), &vehicleLink, links);
+    ::route(router, ::heartbeat(2, 1), &otherLink, links);
+    ::route(router, ::heartbeat(::gcsId, 0), &gcsLink, links);
+
+    QList<AbstractLink*> vehicleOnly({ &vehicleLink });
+    QCOMPARE(::route(router, ::command(1, 1), &gcsLink, links), vehicleOnly);
+    QCOMPARE(::route(router, ::command(1, 0), &gcsLink, links), vehicleOnly);
+    // Component not heard yet is looked for where its system is
+    QCOMPARE(::route(router, ::command(1, 154), &gcsLink, links), vehicleOnly);
+
+    // System not heard yet is flooded, except to where the sender is
+    QCOMPARE(::route(router, ::command(3, 1), &gcsLink, links),
+             QList<AbstractLink*>({ &vehicleLink, &otherLink }));
+
+    // Target lives on the source link, nothing to forward
+    QVERIFY(::route(router, ::command(::gcsId, 0), &gcsLink, links).isEmpty());
+}
+
+void MavLinkRouterTest::testFilters()
+{
+    TestLink source;
+    TestLink blocking;
+    TestLink allowing;
+    TestLink disconnected;
+    disconnected.connected = false;
+    QList<AbstractLink*> links({ &source, &blocking, &allowing, &disconnected });
+
+    RouteFilter filter;
+    filter.blockedMessages.insert(MAVLINK_MSG_ID_HEARTBEAT);
+    blocking.setRouteFilter(filter);
+
+    filter = RouteFilter();
+    filter.allowedMessages.insert(MAVLINK_MSG_ID_COMMAND_LONG);
+    allowing.setRouteFilter(filter);
+
+    MavLinkRouter router;
+    QVERIFY(::route(router, ::heartbeat(1, 1), &source, links).isEmpty());
+    QCOMPARE(::route(router, ::command(0, 0), &source, links),
+             QList<AbstractLink*>({ &blocking, &allowing }));
+}
+
+void MavLinkRouterTest::testRate()
+{
+    TestLink source;
+    TestLink limited;
+    TestLink unlimited;
+    QList<AbstractLink*> links({ &source, &limited, &unlimited });
+
+    RouteFilter filter;
+    filter.maxRate = 1000; // Bursts of 250 bytes
+    limited.setRouteFilter(filter);
+
+    MavLinkRouter router;
+    mavlink_message_t message = ::heartbeat(1, 1);
+
+    int forwarded = 0;
+    for (int i = 0; i < 10; ++i)
+    {
+        QList<AbstractLink*> result = router.route(message, 50, &source, links);
+        QVERIFY(result.contains(&unlimited));
+        if (result.contains(&limited)) ++forwarded;
+    }
+    QCOMPARE(forwarded, 5);
+
+    // Refilled for idle time, but never over the burst
+    QTest::qWait(110);
+    forwarded = 0;
+    for (int i = 0; i < 10; ++i)
+    {
+        if (router.route(message, 50, &source, links).contains(&limited)) ++forwarded;
+    }
+    QVERIFY(forwarded >= 2 && forwarded <= 5);
+}
+
+void MavLinkRouterTest::testRemoveLink()
+{
+    TestLink vehicleLink;
+    TestLink otherLink;
+    TestLink gcsLink;
+    MavLinkRouter router;
+
+    ::route(router, ::heartbeat(1, 1), &vehicleLink,
+            QList<AbstractLink*>({ &vehicleLink, &otherLink, &gcsLink }));
+
+    // Vehicle is unknown again once its only link is gone
+    router.removeLink(&vehicleLink);
+    QCOMPARE(::route(router, ::command(1, 1), &gcsLink,
+                     QList<AbstractLink*>({ &otherLink, &gcsLink })),
+             QList<AbstractLink*>({ &otherLink }));
+}
@@ -0,0 +1,18 @@
+#ifndef MAVLINK_ROUTER_TEST_H
+#define MAVLINK_ROUTER_TEST_H
+
+#include <QTest>
+
+class MavLinkRouterTest: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testBroadcast();
+    void testTargets();
+    void testFilters();
+    void testRate();
+    void testRemoveLink();
+};
+
+#endif // MAVLINK_ROUTER_TEST_H
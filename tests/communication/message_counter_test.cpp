@@ -0,0 +1,65 @@
+#include "message_counter_test.h"
+
+// MAVLink
+#include <mavlink.h>
+
+// Qt
+#include <QDebug>
+
+// Internal
+#include "message_counter.h"
+
+using namespace comm;
+
+namespace
+{
+    mavlink_message_t heartbeat(quint8 sysId, quint8 compId, quint8 seq)
+    {
+        mavlink_message_t message;
+        mavlink_msg_heartbeat_pack(sysId, compId, &message, MAV_TYPE_QUADROTOR,
+                                   MAV_AUTOPILOT_PX4, 0, 0, MAV_STATE_ACTIVE);
+        message.seq = seq;
+        return message;
+    }
+}
+
+void MessageCounterTest::testGaps()
+{
+    MessageCounter counter;
+
+    QCOMPARE(counter.count(::heartbeat(1, 1, 10)), 0); // First one sets reference
+    QCOMPARE(counter.count(::heartbeat(1, 1, 11)), 0);
+    QCOMPARE(counter.count(::heartbeat(1, 1, 14)), 2);
+    QCOMPARE(counter.count(::heartbeat(1, 1, 13)), 0); // Reordered, not lost
+    QCOMPARE(counter.count(::heartbeat(1, 1, 255)), 0); // Long jump is reordering too
+    QCOMPARE(counter.count(::heartbeat(1, 1, 1)), 1); // Over the wrap
+
+    // Other component of the same system has its own sequence
+    QCOMPARE(counter.count(::heartbeat(1, 2, 100)), 0);
+    QCOMPARE(counter.count(::heartbeat(1, 2, 103)), 2);
+
+    dto::LinkTraffic traffic = counter.take();
+    QCOMPARE(traffic.systems.count(), 1);
+    QCOMPARE(traffic.systems[1].packets, 8);
+    QCOMPARE(traffic.systems[1].gaps, 5);
+    QCOMPARE(traffic.systems[1].bytes,
+             8 * MessageCounter::packetSize(::heartbeat(1, 1, 0)));
+    QCOMPARE(traffic.messages[MAVLINK_MSG_ID_HEARTBEAT].packets, 8);
+
+    traffic = counter.take();
+    QVERIFY2(traffic.systems.isEmpty(), "Take must reset counters");
+    QCOMPARE(counter.count(::heartbeat(1, 1, 3)), 1); // But keeps sequences
+}
+
+void MessageCounterTest::testDrops()
+{
+    MessageCounter counter;
+
+    counter.setDropsTotal(7); // Parser drops before counting are not ours
+    QCOMPARE(counter.take().drops, 0);
+
+    counter.setDropsTotal(9);
+    counter.setDropsTotal(12);
+    QCOMPARE(counter.take().drops, 5);
+    QCOMPARE(counter.take().drops, 0);
+}
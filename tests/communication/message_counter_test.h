@@ -0,0 +1,15 @@
+#ifndef MESSAGE_COUNTER_TEST_H
+#define MESSAGE_COUNTER_TEST_H
+
+#include <QTest>
+
+class MessageCounterTest: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testGaps();
+    void testDrops();
+};
+
+#endif // MESSAGE_COUNTER_TEST_H
@@ -0,0 +1,201 @@
+#include "mission_transfer_session_test.h"
+
+// Qt
+#include <QDebug>
+
+// Internal
+#include "mission_transfer_session.h"
+#include "mission_item.h"
+
+using namespace comm;
+
+namespace
+{
+    const quint8 mavId = 1;
+
+    class TestTransport: public MissionTransferSession::Transport
+    {
+    public:
+        void requestMissionCount(quint8 mavId) override
+        {
+            Q_UNUSED(mavId)
+            countRequests++;
+        }
+
+        void requestMissionItem(quint8 mavId, quint16 seq) override
+        {
+            Q_UNUSED(mavId)
+            itemRequests.append(seq);
+        }
+
+        void sendMissionCount(quint8 mavId) override
+        {
+            Q_UNUSED(mavId)
+            countsSent++;
+        }
+
+        void fallbackToFullUpload(quint8 mavId) override
+        {
+            Q_UNUSED(mavId)
+            fallbacks++;
+        }
+
+        int countRequests = 0;
+        QList<int> itemRequests;
+        int countsSent = 0;
+        int fallbacks = 0;
+    };
+
+    QList<domain::MavMissionItem> mission(int count)
+    {
+        QList<domain::MavMissionItem> items;
+        for (int seq = 0; seq < count; ++seq)
+        {
+            domain::MavMissionItem item;
+            item.seq = seq;
+            item.x = seq;
+            items.append(item);
+        }
+        return items;
+    }
+}
+
+void MissionTransferSessionTest::testDownloadWindow()
+{
+    TestTransport transport;
+    utils::TimingWheel wheel;
+    MissionTransferSession session(::mavId, &transport, &wheel, this);
+
+    session.startDownload();
+    QCOMPARE(session.stage(), MissionTransferSession::Stage::WaitingCount);
+    QCOMPARE(transport.countRequests, 1);
+
+    QVERIFY(session.countReceived(8));
+    QCOMPARE(session.stage(), MissionTransferSession::Stage::WaitingItem);
+    QCOMPARE(transport.itemRequests, QList<int>({ 0, 1, 2, 3, 4 })); // Pipelined
+
+    // Every answer frees one place in window
+    session.itemReceived(0, dto::MissionItemPtr::create());
+    QCOMPARE(transport.itemRequests.last(), 5);
+
+    for (quint16 seq = 1; seq < 8; ++seq)
+    {
+        QVERIFY(session.isRequested(seq));
+        session.itemReceived(seq, dto::MissionItemPtr::create());
+    }
+    QCOMPARE(transport.itemRequests.count(), 8);
+    QVERIFY(session.isDownloadComplete());
+
+    QCOMPARE(session.finishDownload().count(), 8);
+    QCOMPARE(session.stage(), MissionTransferSession::Stage::Idle);
+    QCOMPARE(session.statistics().requests, 8);
+    QCOMPARE(session.statistics().retransmissions, 0);
+
+    session.startDownload();
+    QVERIFY2(!session.countReceived(0), "Empty mission has nothing to wait for");
+}
+
+void MissionTransferSessionTest::testDownloadTimeout()
+{
+    TestTransport transport;
+    utils::TimingWheel wheel;
+    MissionTransferSession session(::mavId, &transport, &wheel, this);
+
+    session.startDownload();
+    session.countReceived(4);
+    session.itemReceived(0, dto::MissionItemPtr::create()); // Fast answer, timeout goes down
+
+    // Missing items are asked again one at a time, in order
+    QTRY_COMPARE(transport.itemRequests.count(), 5);
+    QCOMPARE(transport.itemRequests.last(), 1);
+    QCOMPARE(session.statistics().retransmissions, 3);
+    QVERIFY(!session.isLegacyItems()); // Vehicle has answered MISSION_REQUEST_INT before
+
+    session.itemReceived(1, dto::MissionItemPtr::create());
+    QCOMPARE(transport.itemRequests.last(), 2);
+    session.itemReceived(2, dto::MissionItemPtr::create());
+    session.itemReceived(3, dto::MissionItemPtr::create());
+
+    QCOMPARE(transport.itemRequests, QList<int>({ 0, 1, 2, 3, 1, 2, 3 }));
+    QVERIFY(session.isDownloadComplete());
+    QCOMPARE(session.finishDownload().count(), 4);
+}
+
+void MissionTransferSessionTest::testUpload()
+{
+    TestTransport transport;
+    utils::TimingWheel wheel;
+    MissionTransferSession session(::mavId, &transport, &wheel, this);
+
+    QList<domain::MavMissionItem> pending = ::mission(3);
+    session.startUpload(pending, 0, 2, false);
+    QCOMPARE(session.stage(), MissionTransferSession::Stage::SendingCount);
+    QCOMPARE(transport.countsSent, 1);
+    QVERIFY(!session.acknowledged());
+
+    QCOMPARE(session.itemRequested(0), -1);
+    QCOMPARE(session.stage(), MissionTransferSession::Stage::SendingItem);
+    QVERIFY(session.itemSent(0));
+
+    // Repeated request is a retransmission, next one confirms previous item
+    QCOMPARE(session.itemRequested(0), -1);
+    QVERIFY(session.itemSent(0));
+    QCOMPARE(session.itemRequested(1), 0);
+    QVERIFY(session.itemSent(1));
+    QCOMPARE(session.itemRequested(2), 1);
+    QVERIFY(session.itemSent(2));
+
+    QCOMPARE(session.stage(), MissionTransferSession::Stage::WaitongAck);
+    QCOMPARE(session.statistics().items, 3);
+    QCOMPARE(session.statistics().retransmissions, 1);
+
+    QVERIFY(session.acknowledged());
+    QVERIFY(session.onboard() == pending);
+    QCOMPARE(session.stage(), MissionTransferSession::Stage::Idle);
+    QVERIFY(!session.acknowledged());
+
+    // Empty mission is done with acknowledged count
+    session.startUpload(QList<domain::MavMissionItem>(), 0, -1, false);
+    QVERIFY(session.acknowledged());
+    QVERIFY(session.onboard().isEmpty());
+}
+
+void MissionTransferSessionTest::testPartialUpload()
+{
+    TestTransport transport;
+    utils::TimingWheel wheel;
+    MissionTransferSession session(::mavId, &transport, &wheel, this);
+
+    QList<domain::MavMissionItem> onboard = ::mission(4);
+    session.setOnboard(onboard);
+
+    // Refusal of full upload doesn't mean partial lists are unsupported
+    session.startUpload(onboard, 0, 3, false);
+    session.partialRefused();
+    QVERIFY(!session.isPartialUnsupported());
+    QVERIFY(session.onboard() == onboard);
+    session.stop();
+
+    QList<domain::MavMissionItem> pending = onboard;
+    pending[2].x = 42;
+    session.startUpload(pending, 2, 2, true);
+    QVERIFY(session.isPartial());
+    QCOMPARE(session.partialStart(), 2);
+    QCOMPARE(session.partialEnd(), 2);
+
+    QCOMPARE(session.itemRequested(2), -1);
+    QVERIFY(session.itemSent(2));
+    QVERIFY(session.acknowledged());
+    QVERIFY(session.onboard() == pending);
+
+    session.startUpload(onboard, 2, 2, true);
+    session.partialRefused();
+    QVERIFY(session.isPartialUnsupported());
+    QVERIFY2(session.onboard().isEmpty(), "Onboard mission is unknown after refusal");
+
+    session.fail();
+    QCOMPARE(session.stage(), MissionTransferSession::Stage::Idle);
+
+    session.resetVehicle();
+    QVERIFY(!session.isPartialUnsupported());
+}
@@ -0,0 +1,17 @@
+#ifndef MISSION_TRANSFER_SESSION_TEST_H
+#define MISSION_TRANSFER_SESSION_TEST_H
+
+#include <QTest>
+
+class MissionTransferSessionTest: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testDownloadWindow();
+    void testDownloadTimeout();
+    void testUpload();
+    void testPartialUpload();
+};
+
+#endif // MISSION_TRANSFER_SESSION_TEST_H
@@ -0,0 +1,47 @@
+#include "rtt_estimator_test.h"
+
+// Qt
+#include <QDebug>
+
+// Internal
+#include "rtt_estimator.h"
+
+using namespace comm;
+
+void RttEstimatorTest::testSamples()
+{
+    RttEstimator estimator;
+    QCOMPARE(estimator.timeout(), 2000);
+
+    estimator.addSample(100); // First one sets variance to half of it
+    QCOMPARE(estimator.smoothedRtt(), 100);
+    QCOMPARE(estimator.timeout(), 300);
+
+    estimator.addSample(100); // Steady round trip narrows timeout
+    QCOMPARE(estimator.timeout(), 250);
+
+    estimator.addSample(500);
+    QVERIFY(estimator.smoothedRtt() > 100);
+    QVERIFY(estimator.timeout() > 500);
+
+    estimator.reset();
+    QCOMPARE(estimator.timeout(), 2000);
+    QCOMPARE(estimator.smoothedRtt(), 0);
+}
+
+void RttEstimatorTest::testBounds()
+{
+    RttEstimator estimator(1000, 100, 5000);
+
+    for (int i = 0; i < 20; ++i) estimator.addSample(5);
+    QCOMPARE(estimator.timeout(), 100);
+
+    estimator.backoff();
+    QCOMPARE(estimator.timeout(), 200);
+
+    for (int i = 0; i < 10; ++i) estimator.backoff();
+    QCOMPARE(estimator.timeout(), 5000);
+
+    estimator.addSample(10000);
+    QCOMPARE(estimator.timeout(), 5000);
+}
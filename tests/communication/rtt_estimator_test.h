@@ -0,0 +1,15 @@
+#ifndef RTT_ESTIMATOR_TEST_H
+#define RTT_ESTIMATOR_TEST_H
+
+#include <QTest>
+
+class RttEstimatorTest: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testSamples();
+    void testBounds();
+};
+
+#endif // RTT_ESTIMATOR_TEST_H
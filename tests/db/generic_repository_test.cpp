@@ -0,0 +1,86 @@
+#include "generic_repository_test.h"
+
+// Qt
+#include <QSqlQuery>
+#include <QVariant>
+#include <QDebug>
+
+// Internal
+#include "generic_repository.h"
+
+#include "mission.h"
+
+using namespace db;
+
+namespace
+{
+    // Changes row behind repository, to see which columns it writes back
+    bool setColumn(int id, const QString& column, const QVariant& value)
+    {
+        QSqlQuery query;
+        query.prepare("UPDATE missions SET " + column + " = :value WHERE id = :id");
+        query.bindValue(":value", value);
+        query.bindValue(":id", id);
+        return query.exec();
+    }
+
+    QVariant column(int id, const QString& column)
+    {
+        QSqlQuery query;
+        query.prepare("SELECT " + column + " FROM missions WHERE id = :id");
+        query.bindValue(":id", id);
+        if (!query.exec() || !query.next()) return QVariant();
+
+        return query.value(0);
+    }
+}
+
+void GenericRepositoryTest::testChangedColumns()
+{
+    GenericRepository<dto::Mission> repository("missions");
+
+    dto::MissionPtr mission = dto::MissionPtr::create();
+    mission->setName("Partially updated mission");
+    QVERIFY2(repository.insert(mission), "Can't insert mission");
+
+    QVERIFY(::setColumn(mission->id(), "count", 42));
+
+    mission->setName("Renamed mission");
+    QVERIFY2(repository.update(mission), "Can't update mission");
+
+    QCOMPARE(::column(mission->id(), "name").toString(), QString("Renamed mission"));
+    QCOMPARE(::column(mission->id(), "count").toInt(), 42); // Untouched column isn't written
+
+    // Entity without snapshot is written in full
+    repository.unload(mission->id());
+    mission->setCount(0);
+    QVERIFY2(repository.update(mission), "Can't update mission");
+    QCOMPARE(::column(mission->id(), "count").toInt(), 0);
+
+    QVERIFY2(repository.remove(mission), "Can't remove mission");
+}
+
+void GenericRepositoryTest::testUnchangedEntity()
+{
+    GenericRepository<dto::Mission> repository("missions");
+
+    dto::MissionPtr mission = dto::MissionPtr::create();
+    mission->setName("Unchanged mission");
+    QVERIFY2(repository.insert(mission), "Can't insert mission");
+
+    QVERIFY(::setColumn(mission->id(), "name", "Changed behind"));
+
+    QVERIFY2(repository.update(mission), "Update without changes must succeed");
+    QCOMPARE(::column(mission->id(), "name").toString(), QString("Changed behind"));
+
+    // Read resets snapshot to the row values
+    dto::MissionPtr reloaded = repository.read(mission->id(), true);
+    QCOMPARE(reloaded, mission);
+    QCOMPARE(mission->name(), QString("Changed behind"));
+
+    mission->setName("Changed again");
+    QVERIFY2(repository.update(mission), "Can't update mission");
+    QCOMPARE(::column(mission->id(), "name").toString(), QString("Changed again"));
+
+    QVERIFY2(repository.remove(mission), "Can't remove mission");
+}
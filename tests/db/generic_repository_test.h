@@ -0,0 +1,15 @@
+#ifndef GENERIC_REPOSITORY_TEST_H
+#define GENERIC_REPOSITORY_TEST_H
+
+#include <QTest>
+
+class GenericRepositoryTest: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testChangedColumns();
+    void testUnchangedEntity();
+};
+
+#endif // GENERIC_REPOSITORY_TEST_H
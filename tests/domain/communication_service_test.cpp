@@ -13,7 +13,7 @@
 #include "communication_service.h"
 #include "link_description.h"
 
-using namespace dao; // TODO: dao tests
+using namespace dto;
 using namespace comm;
 using namespace domain;
 
@@ -48,7 +48,7 @@ void CommunicationServiceTest::testUdpLink()
     link1.sendData("TEST 2");
 
     spy2.wait();
-    QCOMPARE(spy2.count(), 3);
+    QCOMPARE(spy2.count(), 2);
     arguments = spy2.last();
     QCOMPARE(arguments.count(), 1);
     QCOMPARE(arguments.first(), QVariant("TEST 2"));
@@ -56,19 +56,19 @@ void CommunicationServiceTest::testUdpLink()
 
 void CommunicationServiceTest::testLinkDescription()
 {
-     CommunicationService* service = ServiceRegistry::communicationService();
+     CommunicationService* service = serviceRegistry->communicationService();
 
      LinkDescriptionPtr description = LinkDescriptionPtr::create();
      description->setName("UDP link");
      description->setType(LinkDescription::Udp);
-     description->setPort(8080);
+     description->setParameter(LinkDescription::Port, 8080);
 
      QVERIFY2(service->save(description), "Can't insert link");
-     service->description(description->id(), true);
+     QCOMPARE(service->description(description->id()), description);
 
      QVERIFY2(description->name() == "UDP link", "Link name are different");
      QCOMPARE(description->type(), LinkDescription::Udp);
-     QCOMPARE(description->port(), 8080);
+     QCOMPARE(description->parameter(LinkDescription::Port).toInt(), 8080);
 
      QVERIFY2(service->remove(description), "Can't remove link");
 }
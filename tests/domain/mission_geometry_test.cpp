@@ -0,0 +1,163 @@
+#include "mission_geometry_test.h"
+
+// Qt
+#include <QSignalSpy>
+#include <QDebug>
+
+// Internal
+#include "service_registry.h"
+#include "mission_service.h"
+#include "mission_geometry_service.h"
+#include "mission_geometry.h"
+
+#include "mission.h"
+#include "mission_item.h"
+
+using namespace domain;
+
+namespace
+{
+    dto::MissionItemPtr item(int sequence, dto::MissionItem::Command command,
+                             double latitude = 0, double longitude = 0,
+                             float altitude = 0, bool relative = false)
+    {
+        dto::MissionItemPtr item = dto::MissionItemPtr::create();
+        item->setSequence(sequence);
+        item->setCommand(command);
+        item->setLatitude(latitude);
+        item->setLongitude(longitude);
+        item->setAltitude(altitude);
+        item->setAltitudeRelative(relative);
+        return item;
+    }
+
+    dto::MissionItemPtrList route()
+    {
+        return {
+            ::item(0, dto::MissionItem::Home, 55.0, 37.0, 100),
+            ::item(1, dto::MissionItem::Waypoint, 55.01, 37.0, 50, true),
+            ::item(2, dto::MissionItem::SetSpeed), // Not a point of geometry
+            ::item(3, dto::MissionItem::Continue, 0, 0, 80, true),
+            ::item(4, dto::MissionItem::Waypoint, 55.01, 37.02, 120),
+            ::item(5, dto::MissionItem::Return)
+        };
+    }
+
+    bool fuzzyEqual(double first, double second)
+    {
+        return qAbs(first - second) < 0.001;
+    }
+}
+
+void MissionGeometryTest::testRebuild()
+{
+    dto::MissionItemPtrList items = ::route();
+    MissionGeometry geometry;
+    geometry.rebuild(items);
+
+    QCOMPARE(geometry.count(), 5);
+    QCOMPARE(geometry.indexOf(2), -1);
+    QCOMPARE(geometry.indexOf(4), 3);
+    QVERIFY(!geometry.point(2).coordinate.isValid());
+
+    QGeoCoordinate home(55.0, 37.0);
+    QGeoCoordinate first(55.01, 37.0);
+    QGeoCoordinate second(55.01, 37.02);
+
+    QCOMPARE(geometry.distance(0), 0.0);
+    QVERIFY(::fuzzyEqual(geometry.distance(1), home.distanceTo(first)));
+    QVERIFY(::fuzzyEqual(geometry.distance(2), geometry.distance(1))); // No leg for altitude only
+    QVERIFY(::fuzzyEqual(geometry.totalDistance(),
+                         home.distanceTo(first) + first.distanceTo(second)));
+    QVERIFY(::fuzzyEqual(geometry.point(3).heading, first.azimuthTo(second)));
+
+    QCOMPARE(geometry.homeAltitude(), 100.0f);
+    QCOMPARE(geometry.absoluteAltitude(1), 150.0f);
+    QCOMPARE(geometry.minAltitude(), 100.0f);
+    QCOMPARE(geometry.maxAltitude(), 180.0f);
+
+    QCOMPARE(geometry.boundingBox().topLeft(), QGeoCoordinate(55.01, 37.0));
+    QCOMPARE(geometry.boundingBox().bottomRight(), QGeoCoordinate(55.0, 37.02));
+
+    // Return closes the path at home
+    QVariantList path = geometry.path();
+    QCOMPARE(path.count(), 4);
+    QCOMPARE(path.last().value<QGeoCoordinate>(), home);
+}
+
+void MissionGeometryTest::testUpdate()
+{
+    dto::MissionItemPtrList items = ::route();
+    MissionGeometry geometry;
+    geometry.rebuild(items);
+
+    QCOMPARE(geometry.update(items.at(1)), geometry.count()); // Nothing changed
+    QCOMPARE(geometry.update(items.at(2)), geometry.count()); // Not in geometry
+
+    items.at(1)->setLatitude(55.02);
+    QCOMPARE(geometry.update(items.at(1)), 1);
+
+    // Moved legs must match a full rebuild
+    MissionGeometry rebuilt;
+    rebuilt.rebuild(items);
+    for (int index = 0; index < rebuilt.count(); ++index)
+    {
+        QVERIFY(::fuzzyEqual(geometry.distance(index), rebuilt.distance(index)));
+    }
+    QCOMPARE(geometry.boundingBox(), rebuilt.boundingBox());
+    QCOMPARE(geometry.path(), rebuilt.path());
+
+    items.at(0)->setLongitude(36.99);
+    items.at(0)->setAltitude(110);
+    QCOMPARE(geometry.update(items.at(0)), 0);
+    QCOMPARE(geometry.path().last().value<QGeoCoordinate>(), QGeoCoordinate(55.0, 36.99));
+    QCOMPARE(geometry.maxAltitude(), 190.0f);
+
+    // Point kind changes, in place update is impossible
+    items.at(4)->setCommand(dto::MissionItem::Continue);
+    QCOMPARE(geometry.update(items.at(4)), -1);
+}
+
+void MissionGeometryTest::testNotify()
+{
+    MissionService* service = serviceRegistry->missionService();
+    MissionGeometryService* geometryService = serviceRegistry->missionGeometryService();
+
+    dto::MissionPtr mission = dto::MissionPtr::create();
+    mission->setName("Geometry mission");
+    QVERIFY2(service->save(mission), "Can't insert mission");
+
+    service->addNewMissionItem(mission->id(), dto::MissionItem::Home, 0,
+                               QGeoCoordinate(55.0, 37.0));
+    dto::MissionItemPtr first = service->addNewMissionItem(mission->id(),
+                                                           dto::MissionItem::Waypoint, 1,
+                                                           QGeoCoordinate(55.01, 37.0));
+    dto::MissionItemPtr second = service->addNewMissionItem(mission->id(),
+                                                            dto::MissionItem::Waypoint, 2,
+                                                            QGeoCoordinate(55.02, 37.0));
+    QVERIFY(first && second);
+    QCOMPARE(geometryService->geometry(mission->id())->count(), 3);
+
+    QSignalSpy spy(geometryService, &MissionGeometryService::geometryChanged);
+
+    // Several edits in one pass are reported once, from the first changed point
+    second->setLatitude(55.03);
+    QVERIFY2(service->save(second), "Can't update item");
+    first->setLatitude(55.015);
+    QVERIFY2(service->save(first), "Can't update item");
+    QCOMPARE(spy.count(), 0);
+
+    QVERIFY(spy.wait(100));
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(spy.first().at(0).toInt(), mission->id());
+    QCOMPARE(spy.first().at(1).toInt(), 1);
+
+    // Added item rebuilds geometry
+    service->addNewMissionItem(mission->id(), dto::MissionItem::Waypoint, 3,
+                               QGeoCoordinate(55.04, 37.0));
+    QVERIFY(spy.wait(100));
+    QCOMPARE(spy.last().at(1).toInt(), -1);
+    QCOMPARE(geometryService->geometry(mission->id())->count(), 4);
+
+    QVERIFY2(service->remove(mission), "Can't remove mission");
+}
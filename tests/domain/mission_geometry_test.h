@@ -0,0 +1,16 @@
+#ifndef MISSION_GEOMETRY_TEST_H
+#define MISSION_GEOMETRY_TEST_H
+
+#include <QTest>
+
+class MissionGeometryTest: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testRebuild();
+    void testUpdate();
+    void testNotify();
+};
+
+#endif // MISSION_GEOMETRY_TEST_H
@@ -0,0 +1,177 @@
+#include "mission_rules_test.h"
+
+// Qt
+#include <QDebug>
+
+// Internal
+#include "mission_rules.h"
+
+using namespace domain;
+
+namespace
+{
+    dto::MissionItemPtr item(dto::MissionItem::Command command,
+                             const QGeoCoordinate& coordinate = QGeoCoordinate(),
+                             float altitude = 0)
+    {
+        dto::MissionItemPtr item = dto::MissionItemPtr::create();
+        item->setCommand(command);
+        item->setCoordinate(coordinate);
+        item->setAltitude(altitude);
+        return item;
+    }
+
+    dto::MissionItemPtr jump(int targetSequence, int repeats)
+    {
+        dto::MissionItemPtr item = ::item(dto::MissionItem::JumpTo);
+        item->setParameter(dto::MissionItem::TargetSequence, targetSequence);
+        item->setParameter(dto::MissionItem::Repeats, repeats);
+        return item;
+    }
+
+    MissionSnapshot snapshot(const dto::MissionItemPtrList& items)
+    {
+        for (int sequence = 0; sequence < items.count(); ++sequence)
+        {
+            items.at(sequence)->setSequence(sequence);
+        }
+
+        MissionSnapshot snapshot = MissionSnapshot::create(items);
+        snapshot.minAltitude = 10;
+        snapshot.maxAltitude = 500;
+        snapshot.maxDistance = 5000;
+        return snapshot;
+    }
+
+    MissionIssueList check(const MissionRule& rule, const MissionSnapshot& snapshot)
+    {
+        MissionIssueList issues;
+        if (rule.isItemRule())
+        {
+            for (int index = 0; index < snapshot.items.count(); ++index)
+            {
+                rule.check(snapshot, index, issues);
+            }
+        }
+        else rule.check(snapshot, -1, issues);
+
+        return issues;
+    }
+
+    QList<int> sequences(const MissionIssueList& issues)
+    {
+        QList<int> sequences;
+        for (const MissionIssue& issue: issues) sequences.append(issue.sequence);
+        return sequences;
+    }
+}
+
+void MissionRulesTest::testAltitudeLimits()
+{
+    QGeoCoordinate coordinate(55, 37);
+    MissionSnapshot snapshot = ::snapshot({
+        ::item(dto::MissionItem::Home, coordinate, 0), // Home is below limits, but ignored
+        ::item(dto::MissionItem::Waypoint, coordinate, 5),
+        ::item(dto::MissionItem::Waypoint, coordinate, 100),
+        ::item(dto::MissionItem::Continue, QGeoCoordinate(), 600),
+        ::item(dto::MissionItem::SetSpeed)
+    });
+
+    MissionIssueList issues = ::check(AltitudeLimitsRule(), snapshot);
+    QCOMPARE(::sequences(issues), QList<int>({ 1, 3 }));
+    QCOMPARE(issues.first().severity, MissionIssue::Error);
+}
+
+void MissionRulesTest::testLegLength()
+{
+    QGeoCoordinate home(55, 37);
+    MissionSnapshot snapshot = ::snapshot({
+        ::item(dto::MissionItem::Home, home),
+        ::item(dto::MissionItem::Waypoint, home.atDistanceAndAzimuth(4000, 0), 100),
+        ::item(dto::MissionItem::SetSpeed), // Legs skip items without position
+        ::item(dto::MissionItem::Waypoint, home.atDistanceAndAzimuth(10000, 0), 100),
+        ::item(dto::MissionItem::Waypoint, QGeoCoordinate(), 100) // Not set yet
+    });
+
+    MissionIssueList issues = ::check(LegLengthRule(), snapshot);
+    QCOMPARE(::sequences(issues), QList<int>({ 3 }));
+    QCOMPARE(issues.first().severity, MissionIssue::Warning);
+}
+
+void MissionRulesTest::testUploadableCommand()
+{
+    QGeoCoordinate coordinate(55, 37);
+    MissionSnapshot snapshot = ::snapshot({
+        ::item(dto::MissionItem::Home, coordinate),
+        ::item(dto::MissionItem::TargetPoint, coordinate, 100),
+        ::item(dto::MissionItem::UnknownCommand),
+        ::item(dto::MissionItem::Home, coordinate)
+    });
+
+    QCOMPARE(::sequences(::check(UploadableCommandRule(), snapshot)), QList<int>({ 1, 2, 3 }));
+}
+
+void MissionRulesTest::testHome()
+{
+    HomeRule rule;
+    QVERIFY(!rule.isItemRule());
+
+    QVERIFY(::check(rule, ::snapshot({})).isEmpty());
+    QVERIFY(::check(rule, ::snapshot({ ::item(dto::MissionItem::Home,
+                                              QGeoCoordinate(55, 37)) })).isEmpty());
+
+    MissionIssueList issues = ::check(rule, ::snapshot({ ::item(dto::MissionItem::Home) }));
+    QCOMPARE(issues.count(), 1);
+    QCOMPARE(issues.first().severity, MissionIssue::Warning);
+    QCOMPARE(issues.first().sequence, -1);
+
+    issues = ::check(rule, ::snapshot({ ::item(dto::MissionItem::Waypoint,
+                                               QGeoCoordinate(55, 37)) }));
+    QCOMPARE(issues.count(), 1);
+    QCOMPARE(issues.first().severity, MissionIssue::Error);
+}
+
+void MissionRulesTest::testJumps()
+{
+    QGeoCoordinate coordinate(55, 37);
+
+    // Nested and separate loops are fine
+    MissionSnapshot snapshot = ::snapshot({
+        ::item(dto::MissionItem::Home, coordinate),
+        ::item(dto::MissionItem::Waypoint, coordinate, 100),
+        ::item(dto::MissionItem::Waypoint, coordinate, 100),
+        ::jump(2, 3),
+        ::jump(1, 2),
+        ::item(dto::MissionItem::Waypoint, coordinate, 100),
+        ::jump(5, 1),
+        ::jump(8, 0), // Forward jump
+        ::item(dto::MissionItem::Waypoint, coordinate, 100)
+    });
+    QVERIFY(::check(JumpRule(), snapshot).isEmpty());
+
+    // Loop from 4 back to 2 crosses loop from 3 back to 1
+    snapshot = ::snapshot({
+        ::item(dto::MissionItem::Home, coordinate),
+        ::item(dto::MissionItem::Waypoint, coordinate, 100),
+        ::item(dto::MissionItem::Waypoint, coordinate, 100),
+        ::jump(1, 2),
+        ::jump(2, 2)
+    });
+    MissionIssueList issues = ::check(JumpRule(), snapshot);
+    QCOMPARE(::sequences(issues), QList<int>({ 4 }));
+    QCOMPARE(issues.first().severity, MissionIssue::Warning);
+
+    snapshot = ::snapshot({
+        ::item(dto::MissionItem::Home, coordinate),
+        ::jump(7, 1), // Missing target
+        ::jump(2, 1), // Itself
+        ::jump(1, 1), // Another jump
+        ::jump(0, -1) // Endless
+    });
+    issues = ::check(JumpRule(), snapshot);
+    QCOMPARE(::sequences(issues), QList<int>({ 1, 2, 3, 4 }));
+    QCOMPARE(issues.at(0).severity, MissionIssue::Error);
+    QCOMPARE(issues.at(1).severity, MissionIssue::Error);
+    QCOMPARE(issues.at(2).severity, MissionIssue::Warning);
+    QCOMPARE(issues.at(3).severity, MissionIssue::Warning);
+}
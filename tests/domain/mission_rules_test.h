@@ -0,0 +1,18 @@
+#ifndef MISSION_RULES_TEST_H
+#define MISSION_RULES_TEST_H
+
+#include <QTest>
+
+class MissionRulesTest: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testAltitudeLimits();
+    void testLegLength();
+    void testUploadableCommand();
+    void testHome();
+    void testJumps();
+};
+
+#endif // MISSION_RULES_TEST_H
@@ -14,12 +14,12 @@
 #include "vehicle_service.h"
 #include "vehicle.h"
 
-using namespace dao;
+using namespace dto;
 using namespace domain;
 
 void MissionServiceTest::testMission()
 {
-    domain::MissionService* missionService = domain::ServiceRegistry::missionService();
+    domain::MissionService* missionService = serviceRegistry->missionService();
 
     MissionPtr mission = MissionPtr::create();
     mission->setName("Some ridiculous name");
@@ -34,19 +34,19 @@ void MissionServiceTest::testMission()
 
     QCOMPARE(mission, missionService->mission(id));
 
-    mission->setName("Reload will erase this ridiculous name");
+    // Unloaded mission is read from database again
+    missionService->unload(mission);
+    MissionPtr reloaded = missionService->mission(id);
+    QVERIFY2(reloaded, "Can't read mission after unload");
+    QCOMPARE(reloaded->name(), QString("Another ridiculous name"));
 
-    QCOMPARE(mission, missionService->mission(id, true)); // But pointer will be the same
-
-    QCOMPARE(mission->name(), QString("Another ridiculous name"));
-
-    QVERIFY2(missionService->remove(mission), "Can't remove mission");
-    QCOMPARE(mission->id(), 0); // Mission id must be zero after remove
+    QVERIFY2(missionService->remove(reloaded), "Can't remove mission");
+    QVERIFY2(missionService->mission(id).isNull(), "Removed mission must be null");
 }
 
 void MissionServiceTest::testMissionItems()
 {
-    domain::MissionService* missionService = domain::ServiceRegistry::missionService();
+    domain::MissionService* missionService = serviceRegistry->missionService();
 
     MissionPtr mission = MissionPtr::create();
     mission->setName("Items Mission");
@@ -72,7 +72,8 @@ void MissionServiceTest::testMissionItems()
 
         missionService->unload(item);
     }
-    MissionItemPtr item = missionService->missionItem(id, true);
+    MissionItemPtr item = missionService->missionItem(id);
+    QVERIFY2(item, "Can't read mission item after unload");
 
     QCOMPARE(item->command(), MissionItem::Landing);
     QCOMPARE(item->parameter(MissionItem::AbortAltitude).toInt(), 25);
@@ -82,10 +83,9 @@ void MissionServiceTest::testMissionItems()
     QVERIFY2(missionService->remove(mission), "Can't remove mission");
 }
 
-// TODO: dao tests
 void MissionServiceTest::testVehicleDescription()
 {
-    domain::VehicleService* vehicleService = domain::ServiceRegistry::vehicleService();
+    domain::VehicleService* vehicleService = serviceRegistry->vehicleService();
 
     VehiclePtr vehicle = VehiclePtr::create();
 
@@ -98,7 +98,7 @@ void MissionServiceTest::testVehicleDescription()
     QVERIFY2(id > 0, "Vehicle id after insert mus be > 0");
 
     QVERIFY2(vehicle->name() == "Ridiculous vehicle", "Vehicles names are different");
-    QCOMPARE(vehicle->mavId(), quint8(13));
+    QCOMPARE(vehicle->mavId(), 13);
     QCOMPARE(vehicle->type(), Vehicle::FixedWing);
 
     QVERIFY2(vehicleService->remove(vehicle), "Can't remove vehicle");
@@ -106,8 +106,8 @@ void MissionServiceTest::testVehicleDescription()
 
 void MissionServiceTest::testMissionAssignment()
 {
-    domain::MissionService* missionService = domain::ServiceRegistry::missionService();
-    domain::VehicleService* vehicleService = domain::ServiceRegistry::vehicleService();
+    domain::MissionService* missionService = serviceRegistry->missionService();
+    domain::VehicleService* vehicleService = serviceRegistry->vehicleService();
 
     MissionPtr mission = MissionPtr::create();
     mission->setName("Assigned mission");
@@ -115,6 +115,7 @@ void MissionServiceTest::testMissionAssignment()
 
     VehiclePtr vehicle = VehiclePtr::create();
     vehicle->setName("Assigned vehicle");
+    vehicle->setMavId(14);
     QVERIFY2(vehicleService->save(vehicle), "Can't insert vehicle");
 
     MissionAssignmentPtr assignment = MissionAssignmentPtr::create();
@@ -1,5 +1,5 @@
-#ifndef TELEMETRY_SERVICE_TEST_H
-#define TELEMETRY_SERVICE_TEST_H
+#ifndef MISSION_SERVICE_TEST_H
+#define MISSION_SERVICE_TEST_H
 
 #include <QTest>
 
@@ -14,4 +14,4 @@ private slots:
     void testMissionAssignment();
 };
 
-#endif // TELEMETRY_SERVICE_TEST_H
+#endif // MISSION_SERVICE_TEST_H
@@ -0,0 +1,138 @@
+#include "service_index_test.h"
+
+// Qt
+#include <QDebug>
+
+// Internal
+#include "service_registry.h"
+#include "mission_service.h"
+#include "vehicle_service.h"
+
+#include "mission.h"
+#include "mission_item.h"
+#include "mission_assignment.h"
+#include "vehicle.h"
+
+using namespace domain;
+
+void ServiceIndexTest::testMissionItemIndex()
+{
+    MissionService* service = serviceRegistry->missionService();
+
+    dto::MissionPtr mission = dto::MissionPtr::create();
+    mission->setName("Indexed mission");
+    QVERIFY2(service->save(mission), "Can't insert mission");
+
+    dto::MissionItemPtr home = service->addNewMissionItem(mission->id(), dto::MissionItem::Home, 0);
+    dto::MissionItemPtr first = service->addNewMissionItem(mission->id(),
+                                                           dto::MissionItem::Waypoint, 1);
+    dto::MissionItemPtr second = service->addNewMissionItem(mission->id(),
+                                                            dto::MissionItem::Waypoint, 2);
+    QVERIFY(home && first && second);
+
+    QCOMPARE(service->missionItem(mission->id(), 1), first);
+    QCOMPARE(service->missionItems(mission->id()),
+             dto::MissionItemPtrList({ home, first, second }));
+
+    service->swapItems(first, second);
+    QCOMPARE(service->missionItem(mission->id(), 1), second);
+    QCOMPARE(service->missionItem(mission->id(), 2), first);
+
+    // Removal closes the gap, index follows shifted sequences
+    QVERIFY2(service->remove(second), "Can't remove item");
+    QCOMPARE(service->missionItem(mission->id(), 1), first);
+    QVERIFY(service->missionItem(mission->id(), 2).isNull());
+    QCOMPARE(service->missionItems(mission->id()), dto::MissionItemPtrList({ home, first }));
+
+    int missionId = mission->id();
+    int homeId = home->id();
+    QVERIFY2(service->remove(mission), "Can't remove mission");
+    QVERIFY(service->missionItems(missionId).isEmpty());
+    QVERIFY(service->missionItem(homeId).isNull());
+}
+
+void ServiceIndexTest::testAssignmentIndex()
+{
+    MissionService* missionService = serviceRegistry->missionService();
+    VehicleService* vehicleService = serviceRegistry->vehicleService();
+
+    dto::MissionPtr mission = dto::MissionPtr::create();
+    mission->setName("Assigned mission");
+    QVERIFY2(missionService->save(mission), "Can't insert mission");
+
+    dto::MissionPtr other = dto::MissionPtr::create();
+    other->setName("Reassigned mission");
+    QVERIFY2(missionService->save(other), "Can't insert mission");
+
+    dto::VehiclePtr vehicle = dto::VehiclePtr::create();
+    vehicle->setName("Assigned vehicle");
+    vehicle->setMavId(21);
+    QVERIFY2(vehicleService->save(vehicle), "Can't insert vehicle");
+
+    missionService->assign(mission->id(), vehicle->id());
+    dto::MissionAssignmentPtr assignment = missionService->missionAssignment(mission->id());
+    QVERIFY(assignment);
+    QCOMPARE(missionService->vehicleAssignment(vehicle->id()), assignment);
+
+    // Vehicle has one mission at a time, old assignment must leave both indexes
+    missionService->assign(other->id(), vehicle->id());
+    QVERIFY(missionService->missionAssignment(mission->id()).isNull());
+    QCOMPARE(missionService->vehicleAssignment(vehicle->id()),
+             missionService->missionAssignment(other->id()));
+
+    missionService->unassign(other->id());
+    QVERIFY(missionService->vehicleAssignment(vehicle->id()).isNull());
+
+    QVERIFY2(missionService->remove(mission), "Can't remove mission");
+    QVERIFY2(missionService->remove(other), "Can't remove mission");
+    QVERIFY2(vehicleService->remove(vehicle), "Can't remove vehicle");
+}
+
+void ServiceIndexTest::testVehicleIndex()
+{
+    VehicleService* service = serviceRegistry->vehicleService();
+
+    dto::VehiclePtr vehicle = dto::VehiclePtr::create();
+    vehicle->setName("Indexed vehicle");
+    vehicle->setMavId(13);
+    QVERIFY2(service->save(vehicle), "Can't insert vehicle");
+
+    QCOMPARE(service->vehicleIdByMavId(13), vehicle->id());
+    QCOMPARE(service->mavIdByVehicleId(vehicle->id()), 13);
+
+    vehicle->setMavId(14);
+    QVERIFY2(service->save(vehicle), "Can't update vehicle");
+    QCOMPARE(service->vehicleIdByMavId(13), 0); // Old mav id must leave the index
+    QCOMPARE(service->vehicleIdByMavId(14), vehicle->id());
+    QCOMPARE(service->mavIdByVehicleId(vehicle->id()), 14);
+
+    int id = vehicle->id();
+    QVERIFY2(service->remove(vehicle), "Can't remove vehicle");
+    QCOMPARE(service->vehicleIdByMavId(14), 0);
+    QCOMPARE(service->mavIdByVehicleId(id), -1);
+}
+
+void ServiceIndexTest::testDuplicateMavId()
+{
+    VehicleService* service = serviceRegistry->vehicleService();
+
+    dto::VehiclePtr owner = dto::VehiclePtr::create();
+    owner->setName("Owner vehicle");
+    owner->setMavId(31);
+    QVERIFY2(service->save(owner), "Can't insert vehicle");
+
+    dto::VehiclePtr duplicate = dto::VehiclePtr::create();
+    duplicate->setName("Duplicate vehicle");
+    duplicate->setMavId(31);
+    QVERIFY2(!service->save(duplicate), "Duplicate mav id must be rejected");
+    QCOMPARE(duplicate->id(), 0);
+    QCOMPARE(service->vehicleIdByMavId(31), owner->id());
+
+    // Mav id is free again once its owner is gone
+    QVERIFY2(service->remove(owner), "Can't remove vehicle");
+    QVERIFY2(service->save(duplicate), "Can't insert vehicle");
+    QCOMPARE(service->vehicleIdByMavId(31), duplicate->id());
+
+    QVERIFY2(service->remove(duplicate), "Can't remove vehicle");
+    QCOMPARE(service->vehicleIdByMavId(31), 0);
+}
@@ -0,0 +1,17 @@
+#ifndef SERVICE_INDEX_TEST_H
+#define SERVICE_INDEX_TEST_H
+
+#include <QTest>
+
+class ServiceIndexTest: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testMissionItemIndex();
+    void testAssignmentIndex();
+    void testVehicleIndex();
+    void testDuplicateMavId();
+};
+
+#endif // SERVICE_INDEX_TEST_H
@@ -0,0 +1,143 @@
+#include "survey_generator_test.h"
+
+// Qt
+#include <QtMath>
+#include <QDebug>
+
+// Internal
+#include "survey_generator.h"
+
+using namespace domain;
+
+namespace
+{
+    const double tolerance = 1.0; // meters
+    const double side = 940; // Not a multiple of spacing, so transects are centered
+
+    QGeoCoordinate southWest()
+    {
+        return QGeoCoordinate(55.0, 37.0);
+    }
+
+    QList<QGeoCoordinate> square(const QGeoCoordinate& southWest, double side)
+    {
+        QGeoCoordinate northWest = southWest.atDistanceAndAzimuth(side, 0);
+        return { southWest, northWest, northWest.atDistanceAndAzimuth(side, 90),
+                 southWest.atDistanceAndAzimuth(side, 90) };
+    }
+
+    bool near(double value, double expected)
+    {
+        return qAbs(value - expected) < ::tolerance;
+    }
+
+    bool inside(const QGeoCoordinate& point, const QList<QGeoCoordinate>& rectangle, double margin)
+    {
+        QGeoCoordinate southWest = rectangle.first().atDistanceAndAzimuth(margin, 45);
+        QGeoCoordinate northEast = rectangle.at(2).atDistanceAndAzimuth(margin, 225);
+
+        return point.latitude() > southWest.latitude() && point.latitude() < northEast.latitude() &&
+                point.longitude() > southWest.longitude() &&
+                point.longitude() < northEast.longitude();
+    }
+}
+
+void SurveyGeneratorTest::testLawnmower()
+{
+    SurveyArea area;
+    area.boundary = ::square(::southWest(), ::side);
+
+    SurveyParameters parameters;
+    parameters.spacing = 100;
+
+    QList<QGeoCoordinate> points = SurveyGenerator::generate(area, parameters);
+    QCOMPARE(points.count(), 20); // Ten transects, two points each
+
+    for (int i = 0; i < points.count(); i += 2)
+    {
+        QVERIFY(::near(points.at(i).distanceTo(points.at(i + 1)), ::side));
+        QVERIFY(::inside(points.at(i), area.boundary, -::tolerance));
+    }
+
+    // Serpentine: next transect starts where previous one has ended
+    QVERIFY(::near(points.at(1).distanceTo(points.at(2)), parameters.spacing));
+    QVERIFY(::near(points.at(0).distanceTo(points.at(3)), parameters.spacing));
+
+    // Centered across the area
+    QVERIFY(::near(points.first().distanceTo(area.boundary.first()), 20));
+}
+
+void SurveyGeneratorTest::testOverlapTurnaround()
+{
+    SurveyArea area;
+    area.boundary = ::square(::southWest(), ::side);
+
+    SurveyParameters parameters;
+    parameters.spacing = 100;
+    parameters.overlap = 0.5;
+    parameters.turnaround = 20;
+
+    QCOMPARE(parameters.transectDistance(), 50.0);
+
+    QList<QGeoCoordinate> points = SurveyGenerator::generate(area, parameters);
+    QCOMPARE(points.count(), 38);
+    QVERIFY(::near(points.at(0).distanceTo(points.at(1)), ::side + 2 * parameters.turnaround));
+
+    parameters.overlap = 1.5; // Bounded, footprints can't overlap completely
+    QVERIFY(parameters.transectDistance() > 0);
+}
+
+void SurveyGeneratorTest::testCrosshatch()
+{
+    SurveyArea area;
+    area.boundary = ::square(::southWest(), ::side);
+
+    SurveyParameters parameters;
+    parameters.spacing = 100;
+    parameters.pattern = SurveyParameters::Crosshatch;
+
+    QList<QGeoCoordinate> points = SurveyGenerator::generate(area, parameters);
+    QCOMPARE(points.count(), 40);
+
+    // First pass runs north-south, cross pass east-west
+    QVERIFY(qAbs(qSin(qDegreesToRadians(points.at(0).azimuthTo(points.at(1))))) < 0.01);
+    QVERIFY(qAbs(qCos(qDegreesToRadians(points.at(20).azimuthTo(points.at(21))))) < 0.01);
+
+    // Cross pass starts from its end nearest to the first pass end
+    QVERIFY(points.at(19).distanceTo(points.at(20)) < points.at(19).distanceTo(points.last()));
+}
+
+void SurveyGeneratorTest::testHole()
+{
+    SurveyArea area;
+    area.boundary = ::square(::southWest(), ::side);
+
+    // Covers east offsets 380..570, so transects at 420 and 520 are cut in two
+    QList<QGeoCoordinate> hole = ::square(::southWest().atDistanceAndAzimuth(400, 0)
+                                          .atDistanceAndAzimuth(380, 90), 190);
+    area.holes.append(hole);
+
+    SurveyParameters parameters;
+    parameters.spacing = 100;
+    parameters.turnaround = 20; // Not applied at hole edges
+
+    QList<QGeoCoordinate> points = SurveyGenerator::generate(area, parameters);
+    QCOMPARE(points.count(), 24);
+
+    for (const QGeoCoordinate& point: points)
+    {
+        QVERIFY2(!::inside(point, hole, ::tolerance), "Point inside hole");
+    }
+}
+
+void SurveyGeneratorTest::testDegenerate()
+{
+    SurveyArea area;
+    area.boundary = { ::southWest(), ::southWest().atDistanceAndAzimuth(100, 0) };
+
+    QVERIFY(SurveyGenerator::generate(area, SurveyParameters()).isEmpty());
+
+    // Narrow area still gets one transect
+    area.boundary = ::square(::southWest(), 10);
+    QCOMPARE(SurveyGenerator::generate(area, SurveyParameters()).count(), 2);
+}
@@ -0,0 +1,18 @@
+#ifndef SURVEY_GENERATOR_TEST_H
+#define SURVEY_GENERATOR_TEST_H
+
+#include <QTest>
+
+class SurveyGeneratorTest: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testLawnmower();
+    void testOverlapTurnaround();
+    void testCrosshatch();
+    void testHole();
+    void testDegenerate();
+};
+
+#endif // SURVEY_GENERATOR_TEST_H
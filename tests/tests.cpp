@@ -3,12 +3,26 @@
 #include <QFile>
 
 // Internal
+#include "db_manager.h"
 #include "service_registry.h"
 
 // Tests
 #include "communication_service_test.h"
 #include "telemetry_service_test.h"
 #include "mission_service_test.h"
+#include "service_index_test.h"
+#include "generic_repository_test.h"
+#include "mission_geometry_test.h"
+#include "survey_generator_test.h"
+#include "mission_rules_test.h"
+#include "timing_wheel_test.h"
+#include "geo_quad_tree_test.h"
+#include "liveness_tracker_test.h"
+#include "message_counter_test.h"
+#include "mavlink_communicator_test.h"
+#include "rtt_estimator_test.h"
+#include "mission_transfer_session_test.h"
+#include "mavlink_router_test.h"
 
 int main(int argc, char* argv[])
 {
@@ -19,16 +33,61 @@ int main(int argc, char* argv[])
         if (file.exists()) file.remove();
     }
 
-    domain::ServiceRegistry::instance()->init(QString("test_db"));
+    db::DbManager dbManager;
+    if (!dbManager.open("test_db")) qFatal("Unable to open test DB");
+
+    domain::ServiceRegistry registry;
+    Q_UNUSED(registry)
+
+    int result = 0;
 
     CommunicationServiceTest commTest;
-    QTest::qExec(&commTest);
+    result |= QTest::qExec(&commTest);
 
     TelemetryServiceTest telemetryTest;
-    QTest::qExec(&telemetryTest);
+    result |= QTest::qExec(&telemetryTest);
 
     MissionServiceTest missionTest;
-    QTest::qExec(&missionTest);
+    result |= QTest::qExec(&missionTest);
+
+    ServiceIndexTest indexTest;
+    result |= QTest::qExec(&indexTest);
+
+    GenericRepositoryTest repositoryTest;
+    result |= QTest::qExec(&repositoryTest);
+
+    MissionGeometryTest geometryTest;
+    result |= QTest::qExec(&geometryTest);
+
+    SurveyGeneratorTest surveyTest;
+    result |= QTest::qExec(&surveyTest);
+
+    MissionRulesTest rulesTest;
+    result |= QTest::qExec(&rulesTest);
+
+    GeoQuadTreeTest quadTreeTest;
+    result |= QTest::qExec(&quadTreeTest);
+
+    TimingWheelTest wheelTest;
+    result |= QTest::qExec(&wheelTest);
+
+    LivenessTrackerTest livenessTest;
+    result |= QTest::qExec(&livenessTest);
+
+    MessageCounterTest counterTest;
+    result |= QTest::qExec(&counterTest);
+
+    MavLinkCommunicatorTest communicatorTest;
+    result |= QTest::qExec(&communicatorTest);
+
+    RttEstimatorTest rttTest;
+    result |= QTest::qExec(&rttTest);
+
+    MissionTransferSessionTest transferTest;
+    result |= QTest::qExec(&transferTest);
+
+    MavLinkRouterTest routerTest;
+    result |= QTest::qExec(&routerTest);
 
-    return 0;
+    return result;
 }
@@ -0,0 +1,131 @@
+#include "geo_quad_tree_test.h"
+
+// Qt
+#include <QDebug>
+
+// Internal
+#include "geo_quad_tree.h"
+
+// Std
+#include <algorithm>
+
+using namespace utils;
+
+namespace
+{
+    double random(double from, double to)
+    {
+        return from + (to - from) * qrand() / RAND_MAX;
+    }
+
+    QList<int> sorted(QList<int> ids)
+    {
+        std::sort(ids.begin(), ids.end());
+        return ids;
+    }
+
+    // Brute force reference for tree queries
+    QList<int> scan(const QHash<int, QGeoCoordinate>& points, const QGeoRectangle& rectangle)
+    {
+        QList<int> ids;
+        for (auto it = points.cbegin(); it != points.cend(); ++it)
+        {
+            if (rectangle.contains(it.value())) ids.append(it.key());
+        }
+        return ::sorted(ids);
+    }
+}
+
+void GeoQuadTreeTest::testQuery()
+{
+    qsrand(42);
+
+    GeoQuadTree tree(4); // Small capacity, so tree splits deep
+    QHash<int, QGeoCoordinate> points;
+    for (int id = 0; id < 1000; ++id)
+    {
+        // Clustered, like mission items are
+        QGeoCoordinate coordinate(::random(54.9, 55.1), ::random(36.9, 37.1));
+        tree.insert(id, coordinate);
+        points[id] = coordinate;
+    }
+    QCOMPARE(tree.count(), 1000);
+
+    tree.insert(1000, QGeoCoordinate()); // Invalid one isn't stored
+    QVERIFY(!tree.contains(1000));
+
+    for (int i = 0; i < 50; ++i)
+    {
+        double latitude = ::random(54.85, 55.1);
+        double longitude = ::random(36.85, 37.1);
+        QGeoRectangle rectangle(QGeoCoordinate(latitude + ::random(0, 0.1), longitude),
+                                QGeoCoordinate(latitude, longitude + ::random(0, 0.1)));
+
+        QCOMPARE(::sorted(tree.query(rectangle)), ::scan(points, rectangle));
+    }
+
+    QVERIFY(tree.query(QGeoRectangle(QGeoCoordinate(10, 10), QGeoCoordinate(0, 20))).isEmpty());
+}
+
+void GeoQuadTreeTest::testMoveRemove()
+{
+    qsrand(13);
+
+    GeoQuadTree tree(4);
+    QHash<int, QGeoCoordinate> points;
+    for (int id = 0; id < 200; ++id)
+    {
+        points[id] = QGeoCoordinate(::random(-60, 60), ::random(-170, 170));
+        tree.insert(id, points[id]);
+    }
+
+    // Moved points leave their old leafs, removed ones leave the tree
+    for (int id = 0; id < 200; id += 3)
+    {
+        points[id] = QGeoCoordinate(::random(-60, 60), ::random(-170, 170));
+        tree.move(id, points[id]);
+    }
+    for (int id = 1; id < 200; id += 5)
+    {
+        points.remove(id);
+        tree.remove(id);
+        QVERIFY(!tree.contains(id));
+    }
+
+    QCOMPARE(tree.count(), points.count());
+    QCOMPARE(tree.coordinate(3), points[3]);
+    QVERIFY(!tree.coordinate(1).isValid());
+
+    QGeoRectangle world(QGeoCoordinate(90, -180), QGeoCoordinate(-90, 180));
+    QCOMPARE(::sorted(tree.query(world)), ::sorted(points.keys()));
+
+    QGeoRectangle part(QGeoCoordinate(30, -45), QGeoCoordinate(-20, 90));
+    QCOMPARE(::sorted(tree.query(part)), ::scan(points, part));
+
+    tree.clear();
+    QCOMPARE(tree.count(), 0);
+    QVERIFY(tree.query(world).isEmpty());
+}
+
+void GeoQuadTreeTest::testAntimeridian()
+{
+    GeoQuadTree tree;
+    tree.insert(1, QGeoCoordinate(10, 179.5));
+    tree.insert(2, QGeoCoordinate(10, -179.5));
+    tree.insert(3, QGeoCoordinate(10, 0));
+
+    // Rectangle from 179 east to 179 west crosses antimeridian
+    QGeoRectangle rectangle(QGeoCoordinate(11, 179), QGeoCoordinate(9, -179));
+    QCOMPARE(::sorted(tree.query(rectangle)), QList<int>({ 1, 2 }));
+}
+
+void GeoQuadTreeTest::testSamePoint()
+{
+    GeoQuadTree tree(2, 4); // Equal points never separate, depth limits splitting
+
+    for (int id = 0; id < 20; ++id) tree.insert(id, QGeoCoordinate(55, 37));
+
+    QCOMPARE(tree.count(), 20);
+    QCOMPARE(tree.query(QGeoRectangle(QGeoCoordinate(55.1, 36.9),
+                                      QGeoCoordinate(54.9, 37.1))).count(), 20);
+}
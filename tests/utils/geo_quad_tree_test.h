@@ -0,0 +1,17 @@
+#ifndef GEO_QUAD_TREE_TEST_H
+#define GEO_QUAD_TREE_TEST_H
+
+#include <QTest>
+
+class GeoQuadTreeTest: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testQuery();
+    void testMoveRemove();
+    void testAntimeridian();
+    void testSamePoint();
+};
+
+#endif // GEO_QUAD_TREE_TEST_H
@@ -0,0 +1,81 @@
+#include "timing_wheel_test.h"
+
+// Qt
+#include <QElapsedTimer>
+#include <QDebug>
+
+// Internal
+#include "timing_wheel.h"
+
+using namespace utils;
+
+void TimingWheelTest::testCascading()
+{
+    TimingWheel wheel(1); // First level spans 256 ms, so longer timers cascade down
+    QElapsedTimer clock;
+    clock.start();
+
+    QList<int> fired;
+    QList<qint64> elapsed;
+    for (int timeout: { 600, 5, 300 })
+    {
+        wheel.start(timeout, &wheel, [&fired, &elapsed, &clock, timeout]() {
+            fired.append(timeout);
+            elapsed.append(clock.elapsed());
+        });
+    }
+    QCOMPARE(wheel.count(), 3);
+
+    QTRY_COMPARE_WITH_TIMEOUT(fired.count(), 3, 2000);
+    QCOMPARE(fired, QList<int>({ 5, 300, 600 }));
+    for (int i = 0; i < fired.count(); ++i)
+    {
+        QVERIFY2(elapsed.at(i) >= fired.at(i), "Timer fired before its timeout");
+    }
+    QCOMPARE(wheel.count(), 0);
+}
+
+void TimingWheelTest::testStop()
+{
+    TimingWheel wheel(1);
+
+    int fired = 0;
+    int stopped = wheel.start(20, &wheel, [&fired]() { fired |= 1; });
+    int kept = wheel.start(20, &wheel, [&fired]() { fired |= 2; }); // Shares slot with stopped
+    int distant = wheel.start(400, &wheel, [&fired]() { fired |= 4; });
+
+    QVERIFY(stopped != kept);
+    QVERIFY(wheel.isActive(stopped));
+
+    wheel.stop(stopped);
+    wheel.stop(distant);
+    QVERIFY(!wheel.isActive(stopped));
+    QCOMPARE(wheel.count(), 1);
+
+    QTRY_COMPARE_WITH_TIMEOUT(fired, 2, 1000);
+    QTest::qWait(500);
+    QCOMPARE(fired, 2);
+    QVERIFY(!wheel.isActive(kept));
+}
+
+void TimingWheelTest::testContext()
+{
+    TimingWheel wheel(1);
+
+    int fired = 0;
+    QObject* context = new QObject();
+    wheel.start(10, context, [&fired]() { fired++; });
+    wheel.start(10, &wheel, [&fired]() { fired += 10; });
+    delete context;
+
+    QTRY_COMPARE_WITH_TIMEOUT(wheel.count(), 0, 1000);
+    QCOMPARE(fired, 10);
+}
+
+void TimingWheelTest::testBackoff()
+{
+    QCOMPARE(TimingWheel::backoff(100, 0, 1000), 100);
+    QCOMPARE(TimingWheel::backoff(100, 3, 1000), 800);
+    QCOMPARE(TimingWheel::backoff(100, 4, 1000), 1000);
+    QCOMPARE(TimingWheel::backoff(100, 40, 1000), 1000); // No shift overflow
+}
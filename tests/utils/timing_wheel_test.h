@@ -0,0 +1,17 @@
+#ifndef TIMING_WHEEL_TEST_H
+#define TIMING_WHEEL_TEST_H
+
+#include <QTest>
+
+class TimingWheelTest: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testCascading();
+    void testStop();
+    void testContext();
+    void testBackoff();
+};
+
+#endif // TIMING_WHEEL_TEST_H